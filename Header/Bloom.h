@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+
+// Glow post-process. Emissive sprites are drawn a second time, straight into
+// a half or quarter resolution target, blurred there with a separable
+// Gaussian and added over the frame, so the fill cost scales with the small
+// target rather than the screen.
+struct BloomOptions {
+    int divisor = 2;         // 1, 2 or 4: target resolution is the screen's / divisor; 0 disables
+    int passes = 2;          // Horizontal + vertical blur pairs; each widens the glow
+    float strength = 1.0f;   // Composite weight
+};
+
+struct BloomStats {
+    int width = 0, height = 0;   // Target size
+    uint64_t timed = 0;          // Frames with a GPU time
+    double avgGpuMs = 0.0;       // Emissive draw, blur and composite on the GPU
+    double maxGpuMs = 0.0;
+};
+
+class Bloom {
+public:
+    ~Bloom();
+
+    bool init(const BloomOptions& options, int screenWidth, int screenHeight);
+    void shutdown();
+    bool enabled() const { return framebuffers[0] != 0; }
+
+    // Clears the emissive target and directs drawing to it; draw the
+    // emissive sprites, then call apply().
+    void beginEmissive();
+    // Blurs the target and adds it over the framebuffer and viewport that
+    // were current at beginEmissive().
+    void apply();
+
+    BloomStats stats() const;
+    void report(std::ostream& out) const;
+
+private:
+    static constexpr int kQueries = 4;
+
+    void collectQueries();
+
+    BloomOptions opts;
+    int width = 0, height = 0;
+    unsigned int textures[2] = {};
+    unsigned int framebuffers[2] = {};
+    unsigned int blurShader = 0;
+    unsigned int compositeShader = 0;
+    unsigned int vao = 0;
+    int prevFramebuffer = 0;
+    int prevViewport[4] = {};
+
+    // GPU timers, read a few frames late so the CPU never waits on them.
+    unsigned int queries[kQueries] = {};
+    bool pending[kQueries] = {};
+    int nextQuery = 0;
+    bool timing = false;
+    uint64_t timed = 0;
+    double gpuMsTotal = 0.0, gpuMsMax = 0.0;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+struct Vec2 {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vec2 operator+(const Vec2& o) const { return { x + o.x, y + o.y }; }
+    Vec2 operator-(const Vec2& o) const { return { x - o.x, y - o.y }; }
+    Vec2 operator*(float s) const { return { x * s, y * s }; }
+    Vec2& operator+=(const Vec2& o) { x += o.x; y += o.y; return *this; }
+};
+
+inline float length(const Vec2& v) { return std::sqrt(v.x * v.x + v.y * v.y); }
+
+// Draw order of machine sprites, back to front. Sprites on the same layer
+// draw in creation order.
+enum RenderLayer : int {
+    LayerBackground,
+    LayerCabinet,
+    LayerGlass,
+    LayerPrize,
+    LayerPrizeGlow,
+    LayerPrizeToy,
+    LayerTokenSlot,
+    LayerHole,
+    LayerToys,
+    LayerRail,
+    LayerRope,
+    LayerClaw,
+    LayerLamp,
+    kLayerCount
+};
+
+enum class ToyState {
+    Resting,
+    Grabbed,
+    Falling,
+    InHole,   // Falling through the hole chute towards the prize compartment
+    InPrize
+};
+
+enum class EntityKind : uint8_t {
+    Decor,
+    Toy,
+    Claw,
+    Hole,
+    Prize,
+    TokenSlot,
+    Lamp
+};
+
+struct Transform {
+    Vec2 pos{ 0.0f, 0.0f };
+    Vec2 size{ 1.0f, 1.0f };
+    float rotation = 0.0f;
+};
+
+// Time-based sprite animation. The shaders evaluate it from the sprite's
+// parameters and one time uniform, so gameplay only writes it when an
+// animation starts or stops.
+enum class AnimCurve : uint8_t {
+    None,
+    Pulse,   // Alpha swings by amplitude around color[3], sinusoidally
+    Blink    // color for the first half of each period, to for the second
+};
+
+struct SpriteAnim {
+    AnimCurve curve = AnimCurve::None;
+    float start = 0.0f;       // Seconds after the animation epoch it started; see animationStart()
+    float period = 1.0f;      // Seconds per cycle
+    float amplitude = 0.0f;
+    std::array<float, 4> to{ 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+// Animations are timed from an epoch that moves forward in whole steps. The
+// seconds since it are the only time the shaders see, and they stay small
+// enough for a float at any uptime.
+constexpr double kAnimEpochStep = 1024.0;
+inline double animationEpoch(double clock) { return std::floor(clock / kAnimEpochStep) * kAnimEpochStep; }
+inline float animationClock(double clock) { return float(clock - animationEpoch(clock)); }
+// A start on the machine clock as SpriteAnim keeps it. One more than a period
+// before the epoch is moved up by whole periods, which no curve can tell.
+inline float animationStart(double start, double epoch, float period)
+{
+    const double since = epoch - start;
+    return since < double(period) ? float(start - epoch) : -float(std::fmod(since, double(period)));
+}
+
+struct Sprite {
+    unsigned int texture = 0;                          // 0 draws a flat color quad
+    std::array<float, 4> color{ 1.0f, 1.0f, 1.0f, 1.0f };  // Flat color, or tint when textured
+    SpriteAnim anim;
+    float emissive = 0.0f;                             // Bloom brightness; 0 keeps the sprite out of the glow
+    int layer = LayerBackground;
+    bool visible = true;
+    uint32_t order = 0;                                // Assigned by the registry
+};
+
+struct Body {
+    Vec2 velocity{ 0.0f, 0.0f };
+    float gravity = 0.0f;
+    bool simulate = false;
+};
+
+struct Gameplay {
+    EntityKind kind = EntityKind::Decor;
+    ToyState toy = ToyState::Resting;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "Components.h"
+
+// Q16.16 fixed point: 16 integer bits, 16 fraction bits, in an int32. Every
+// operation is integer arithmetic with one rounding rule, so the same inputs
+// give the same bits on any compiler, flag set or CPU; there is no FMA
+// contraction, excess precision or libm to differ. Results saturate at the
+// ends of the range instead of wrapping.
+struct Fixed {
+    int32_t raw = 0;
+};
+
+constexpr int kFixedFracBits = 16;
+constexpr int32_t kFixedOne = 1 << kFixedFracBits;
+
+// The right shifts below must be arithmetic; they are on every compiler and
+// CPU this builds for, and C++20 requires it.
+static_assert((-3 >> 1) == -2, "signed right shift must be arithmetic");
+
+constexpr Fixed fixedRaw(int32_t raw) { return Fixed{ raw }; }
+constexpr Fixed fixedInt(int32_t v) { return Fixed{ v * kFixedOne }; }
+
+// Nearest value, halves rounded up. Exact for any float that is a multiple
+// of 2^-16 in range; NaN reads as 0.
+constexpr Fixed fixedFromFloat(float v)
+{
+    if (!(v == v)) return Fixed{};
+    const double scaled = double(v) * double(kFixedOne) + 0.5;
+    if (scaled >= 2147483647.0) return Fixed{ INT32_MAX };
+    if (scaled <= -2147483648.0) return Fixed{ INT32_MIN };
+    int64_t r = static_cast<int64_t>(scaled);
+    if (double(r) > scaled) r--;
+    return Fixed{ static_cast<int32_t>(r) };
+}
+
+// Exact while |value| < 256, where raw fits float's 24-bit mantissa; every
+// coordinate a machine uses does, so a float field can carry a Fixed without
+// loss.
+inline float fixedToFloat(Fixed a) { return float(a.raw) / float(kFixedOne); }
+
+// Branch free: overflow flips the sign of the result against both operands,
+// and then the result is replaced by the limit on a's side.
+inline Fixed fixedAdd(Fixed a, Fixed b)
+{
+    const uint32_t ua = uint32_t(a.raw), ub = uint32_t(b.raw);
+    const uint32_t sum = ua + ub;
+    const uint32_t limit = (ua >> 31) + uint32_t(INT32_MAX);
+    const uint32_t overflow = 0u - (((ua ^ sum) & (ub ^ sum)) >> 31);
+    return Fixed{ int32_t((sum & ~overflow) | (limit & overflow)) };
+}
+
+inline Fixed fixedSub(Fixed a, Fixed b)
+{
+    const uint32_t ua = uint32_t(a.raw), ub = uint32_t(b.raw);
+    const uint32_t diff = ua - ub;
+    const uint32_t limit = (ua >> 31) + uint32_t(INT32_MAX);
+    const uint32_t overflow = 0u - (((ua ^ ub) & (ua ^ diff)) >> 31);
+    return Fixed{ int32_t((diff & ~overflow) | (limit & overflow)) };
+}
+
+inline int32_t fixedSaturate(int64_t v)
+{
+    const int64_t lo = INT32_MIN, hi = INT32_MAX;
+    return static_cast<int32_t>(v < lo ? lo : (v > hi ? hi : v));
+}
+
+// Rounded to nearest, halves up. The result is bits 16..47 of the rounded
+// product; it fits when bits 47..63 all match, and is otherwise replaced by
+// the limit on the product's sign. Only the multiply is 64-bit.
+inline Fixed fixedMul(Fixed a, Fixed b)
+{
+    const int64_t q = int64_t(a.raw) * int64_t(b.raw) + (kFixedOne >> 1);
+    const int32_t hi = int32_t(q >> 32);
+    const uint32_t r = (uint32_t(hi) << kFixedFracBits) | (uint32_t(q) >> kFixedFracBits);
+    const uint32_t overflow = 0u - uint32_t((hi >> 15) != (int32_t(r) >> 31));
+    const uint32_t limit = (uint32_t(hi) >> 31) + uint32_t(INT32_MAX);
+    return Fixed{ int32_t((r & ~overflow) | (limit & overflow)) };
+}
+
+// a * b / c with a 64-bit intermediate, truncated towards zero; dividing by
+// zero gives the limit on the sign of a * b.
+inline Fixed fixedMulDiv(Fixed a, Fixed b, Fixed c)
+{
+    const int64_t p = int64_t(a.raw) * int64_t(b.raw);
+    if (c.raw == 0) return Fixed{ p < 0 ? INT32_MIN : INT32_MAX };
+    return Fixed{ fixedSaturate(p / c.raw) };
+}
+
+inline Fixed fixedDiv(Fixed a, Fixed b) { return fixedMulDiv(a, fixedRaw(kFixedOne), b); }
+
+inline Fixed fixedNeg(Fixed a) { return fixedSub(Fixed{}, a); }
+// Branch free: the sign mask flips a negative value and adds one. Only
+// INT32_MIN is still negative after that, and it saturates like fixedNeg().
+inline Fixed fixedAbs(Fixed a)
+{
+    const uint32_t sign = 0u - (uint32_t(a.raw) >> 31);
+    const uint32_t abs = (uint32_t(a.raw) ^ sign) - sign;
+    const uint32_t overflow = 0u - (abs >> 31);
+    return Fixed{ int32_t((abs & ~overflow) | (uint32_t(INT32_MAX) & overflow)) };
+}
+inline Fixed fixedMin(Fixed a, Fixed b) { return a.raw < b.raw ? a : b; }
+inline Fixed fixedMax(Fixed a, Fixed b) { return a.raw > b.raw ? a : b; }
+inline Fixed fixedClamp(Fixed v, Fixed lo, Fixed hi) { return fixedMin(fixedMax(v, lo), hi); }
+
+inline Fixed operator+(Fixed a, Fixed b) { return fixedAdd(a, b); }
+inline Fixed operator-(Fixed a, Fixed b) { return fixedSub(a, b); }
+inline Fixed operator-(Fixed a) { return fixedNeg(a); }
+inline Fixed operator*(Fixed a, Fixed b) { return fixedMul(a, b); }
+inline Fixed operator/(Fixed a, Fixed b) { return fixedDiv(a, b); }
+inline bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+inline bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+inline bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+inline bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+inline bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+struct FixedVec2 {
+    Fixed x;
+    Fixed y;
+    FixedVec2 operator+(const FixedVec2& o) const { return { x + o.x, y + o.y }; }
+    FixedVec2 operator-(const FixedVec2& o) const { return { x - o.x, y - o.y }; }
+    FixedVec2 operator*(Fixed s) const { return { x * s, y * s }; }
+};
+
+inline FixedVec2 fixedFromVec2(const Vec2& v) { return { fixedFromFloat(v.x), fixedFromFloat(v.y) }; }
+inline Vec2 fixedToVec2(const FixedVec2& v) { return { fixedToFloat(v.x), fixedToFloat(v.y) }; }
+
+// Square root of the raw value's square sum, rounded down: the length is
+// taken in 64 bits, so short vectors keep all their precision.
+Fixed fixedLength(const FixedVec2& v);
+
+// Batch forms over raw arrays, for systems that keep many values side by
+// side; out may alias an input. At -O3 GCC vectorizes fixedAdd and
+// fixedMulAdd for any x86-64. fixedMul multiplies two varying signed values
+// into 64 bits, which needs SSE4.1 (-msse4.1 or -march), and stays scalar
+// without it.
+void fixedAdd(const int32_t* a, const int32_t* b, int32_t* out, std::size_t n);
+void fixedMul(const int32_t* a, const int32_t* b, int32_t* out, std::size_t n);
+// acc[i] += v[i] * k, the integration step of a physics system.
+void fixedMulAdd(int32_t* acc, const int32_t* v, Fixed k, std::size_t n);
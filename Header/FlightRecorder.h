@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Crash-surviving event log. Records go into a file mapped MAP_SHARED and
+// used as a ring, so whatever was written before the process dies is already
+// in the page cache and survives it. Writers never lock: a slot is claimed
+// with one fetch_add and published by storing its sequence number last, so a
+// record torn by a crash reads back as empty. ClawFlightDump decodes the file.
+constexpr uint32_t kFlightMagic = 0x52464C43;  // "CLFR"
+constexpr uint32_t kFlightVersion = 1;
+constexpr uint32_t kFlightDefaultRecords = 1u << 16;  // 4 MB, ~14 min of frames at 75 Hz
+
+enum class FlightEvent : uint16_t {
+    Session = 1,   // code: 0 opened, 1 clean shutdown; value: pid
+    Frame,         // value: sim tick; f: frame, update, render ms and dt ms
+    State,         // code: from, value: to (GameState)
+    Click,         // code: FlightClick, value: click id; f: GL position
+    Collect,       // code: had a prize, value: toy slot index
+    Message,       // code: FlightMessage; text
+    Rewind,        // value: tick resumed from
+    Crash          // value: signal number
+};
+
+enum class FlightClick : uint16_t {
+    Miss,
+    Prize,
+    TokenSlot,
+    Start
+};
+
+enum class FlightMessage : uint16_t {
+    Fatal,
+    ShaderRead,
+    ShaderCompile,
+    ProgramValidate,
+    TextureLoad,
+    CursorLoad
+};
+
+struct FlightHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;              // Power of two
+    std::atomic<uint64_t> head;     // Records ever claimed
+    int64_t startUnixNs;            // Wall clock when the recorder opened
+    uint32_t pid;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(FlightHeader) == 64, "FlightHeader layout changed");
+
+struct FlightRecord {
+    std::atomic<uint64_t> sequence; // 1-based; 0 while the slot is being written
+    uint64_t timeNs;                // Since the recorder opened
+    uint16_t type;
+    uint16_t code;
+    uint32_t value;
+    union {
+        float f[10];
+        char text[40];
+    };
+};
+static_assert(sizeof(FlightRecord) == 64, "FlightRecord layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Flight recorder needs lock-free 64-bit atomics");
+
+// Writer side. Every call is a no-op until the recorder is open.
+bool openFlightRecorder(const std::string& path, uint32_t records = kFlightDefaultRecords);
+void closeFlightRecorder();
+// Records fatal signals before letting them kill the process.
+void installFlightCrashHandler();
+
+void flightRecord(FlightEvent type, uint16_t code, uint32_t value,
+    float f0 = 0.0f, float f1 = 0.0f, float f2 = 0.0f, float f3 = 0.0f);
+void flightMessage(FlightMessage code, const char* text);
+
+// Reader side, for the decoder tool.
+struct FlightEntry {
+    uint64_t sequence;
+    uint64_t timeNs;
+    FlightEvent type;
+    uint16_t code;
+    uint32_t value;
+    float f[4];
+    std::string text;
+};
+
+struct FlightLog {
+    uint32_t capacity = 0;
+    uint64_t written = 0;
+    int64_t startUnixNs = 0;
+    uint32_t pid = 0;
+    std::vector<FlightEntry> entries;   // Oldest first
+};
+
+bool readFlightLog(const std::string& path, FlightLog& out);
+const char* flightEventName(FlightEvent type);
+const char* flightClickName(FlightClick hit);
+const char* flightMessageName(FlightMessage code);
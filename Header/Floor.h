@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Machine.h"
+#include "Scheduler.h"
+#include "SpriteBatch.h"
+#include "Telemetry.h"
+
+struct FloorStats {
+    int machines = 0;
+    int visible = 0;
+    int impostors = 0;
+    int impostorRefreshes = 0;
+    int drawCalls = 0;
+    std::size_t instances = 0;
+    double updateMs = 0.0;
+    double renderMs = 0.0;
+};
+
+// Arcade floor: many independent machines laid out on a grid and drawn in one
+// batched pass. Machines outside the view are culled; machines that would be
+// smaller than kImpostorThresholdPx on screen are drawn from a cached
+// snapshot in an impostor atlas that refreshes at a lower rate.
+class ArcadeFloor {
+public:
+    static constexpr float kCellSize = 1.8f;
+    static constexpr float kImpostorThresholdPx = 96.0f;
+    static constexpr float kImpostorRefreshSeconds = 0.25f;
+    static constexpr int kMaxRefreshesPerFrame = 48;
+    static constexpr int kAtlasSize = 2048;
+    static constexpr int kTileSize = 64;
+
+    ~ArcadeFloor();
+
+    bool init(int machineCount, const MachineTextures& textures, SpriteBatch& batch);
+    // Simulates every machine one tick; machines are spread over the pool.
+    void update(float dt, WorkStealingPool& pool);
+    // Records every machine's plays into log, as machine 1..N; null stops.
+    void setTelemetry(TelemetryLog* log);
+    void render(int framebufferWidth, int framebufferHeight);
+
+    // Operator view controls.
+    void fitView();
+    void pan(const Vec2& delta);
+    void zoom(float factor);
+
+    int machineCount() const { return static_cast<int>(cabinets.size()); }
+    Machine& machine(int i) { return *cabinets[i].machine; }
+    const FloorStats& stats() const { return frameStats; }
+
+private:
+    struct Cabinet {
+        std::unique_ptr<Machine> machine;
+        Vec2 offset;
+        AttractPlayer attract;
+        float impostorAge = 0.0f;
+        bool impostorValid = false;
+    };
+
+    void refreshImpostors(const std::vector<int>& stale);
+    bool tileRect(int index, float& u0, float& v0, float& u1, float& v1) const;
+    // Machines step in lockstep, so any one's clock times every animation.
+    double animationTime() const { return cabinets.empty() ? 0.0 : cabinets.front().machine->clock; }
+
+    std::vector<Cabinet> cabinets;
+    SpriteBatch* batch = nullptr;
+    ViewTransform view;
+    Vec2 floorMin;
+    Vec2 floorMax;
+    unsigned int atlasTexture = 0;
+    unsigned int atlasFramebuffer = 0;
+    FloorStats frameStats;
+    std::vector<int> staleImpostors;
+    TelemetryLog* telemetry = nullptr;
+};
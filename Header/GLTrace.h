@@ -0,0 +1,316 @@
+#pragma once
+#include <GL/glew.h>
+#include <ostream>
+#include <string>
+
+// Optional GL call interception, compiled in with the CLAW_GL_TRACE CMake
+// option. Every translation unit that calls GL includes this header (or
+// Util.h, which does) instead of GLEW, so no GL call escapes. In a traced
+// build each GL entry point the game uses goes through a wrapper that counts
+// it, flags it when it repeats state already set (same program, texture,
+// buffer binding, uniform value...) and, while a capture is armed, writes it
+// as one line of text. A capture replays with --gl-replay in a game started
+// with the same options: it refers to the objects startup creates, and
+// objects the frame itself creates are mapped to the ones replay creates.
+// Without the option none of this exists: no macros, and the control
+// functions below are empty inlines.
+
+#ifdef CLAW_GL_TRACE
+
+constexpr bool kGLTraceBuilt = true;
+
+// Frame boundary: folds the frame's counts into the totals and starts or
+// finishes an armed capture.
+void glTraceEndFrame();
+// Writes the whole of the next frame's call stream to path.
+void glTraceCaptureNextFrame(const std::string& path);
+// Per function calls and redundant calls, last frame and average.
+void glTraceReport(std::ostream& out);
+// Loads a capture for glTraceReplayFrame; false if it cannot be read.
+bool glTraceLoadReplay(const std::string& path);
+void glTraceReplayFrame();
+
+// One wrapper per GL entry point the game calls.
+void traceUseProgram(GLuint program);
+GLint traceGetUniformLocation(GLuint program, const GLchar* name);
+void traceUniform1i(GLint location, GLint v0);
+void traceUniform1f(GLint location, GLfloat v0);
+void traceUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void traceUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void traceActiveTexture(GLenum unit);
+void traceBindTexture(GLenum target, GLuint texture);
+void traceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+void traceTexParameteri(GLenum target, GLenum pname, GLint param);
+void tracePixelStorei(GLenum pname, GLint param);
+void traceBindVertexArray(GLuint vao);
+void traceBindBuffer(GLenum target, GLuint buffer);
+void traceBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void traceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void traceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void* traceMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+GLboolean traceUnmapBuffer(GLenum target);
+void traceVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+void traceEnableVertexAttribArray(GLuint index);
+void traceVertexAttribDivisor(GLuint index, GLuint divisor);
+void traceDrawArrays(GLenum mode, GLint first, GLsizei count);
+void traceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+void traceDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void traceBeginTransformFeedback(GLenum primitiveMode);
+void traceEndTransformFeedback();
+void traceBindFramebuffer(GLenum target, GLuint framebuffer);
+void traceFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+void traceFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer);
+GLenum traceCheckFramebufferStatus(GLenum target);
+void traceBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void traceRenderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height);
+void traceBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+void traceReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+void traceViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void traceScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void traceClear(GLbitfield mask);
+void traceClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+void traceEnable(GLenum cap);
+void traceDisable(GLenum cap);
+void traceBlendFunc(GLenum src, GLenum dst);
+void traceBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+void traceGetIntegerv(GLenum pname, GLint* data);
+void traceBeginQuery(GLenum target, GLuint query);
+void traceEndQuery(GLenum target);
+void traceGetQueryObjectiv(GLuint query, GLenum pname, GLint* params);
+void traceGetQueryObjectui64v(GLuint query, GLenum pname, GLuint64* params);
+GLsync traceFenceSync(GLenum condition, GLbitfield flags);
+GLenum traceClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void traceDeleteSync(GLsync sync);
+void traceFinish();
+void traceGenTextures(GLsizei n, GLuint* names);
+void traceGenBuffers(GLsizei n, GLuint* names);
+void traceGenVertexArrays(GLsizei n, GLuint* names);
+void traceGenFramebuffers(GLsizei n, GLuint* names);
+void traceGenRenderbuffers(GLsizei n, GLuint* names);
+void traceGenQueries(GLsizei n, GLuint* names);
+void traceDeleteTextures(GLsizei n, const GLuint* names);
+void traceDeleteBuffers(GLsizei n, const GLuint* names);
+void traceDeleteVertexArrays(GLsizei n, const GLuint* names);
+void traceDeleteFramebuffers(GLsizei n, const GLuint* names);
+void traceDeleteRenderbuffers(GLsizei n, const GLuint* names);
+void traceDeleteQueries(GLsizei n, const GLuint* names);
+GLboolean traceIsTexture(GLuint name);
+GLboolean traceIsBuffer(GLuint name);
+GLboolean traceIsVertexArray(GLuint name);
+GLboolean traceIsFramebuffer(GLuint name);
+GLboolean traceIsRenderbuffer(GLuint name);
+GLboolean traceIsQuery(GLuint name);
+GLboolean traceIsProgram(GLuint name);
+GLboolean traceIsShader(GLuint name);
+GLuint traceCreateShader(GLenum type);
+void traceShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths);
+void traceCompileShader(GLuint shader);
+void traceGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+void traceGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* log);
+void traceDeleteShader(GLuint shader);
+GLuint traceCreateProgram();
+void traceAttachShader(GLuint program, GLuint shader);
+void traceDetachShader(GLuint program, GLuint shader);
+void traceTransformFeedbackVaryings(GLuint program, GLsizei count, const GLchar* const* varyings, GLenum bufferMode);
+void traceLinkProgram(GLuint program);
+void traceValidateProgram(GLuint program);
+void traceGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void traceGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* log);
+void traceDeleteProgram(GLuint program);
+
+// GLTrace.cpp calls the real entry points.
+#ifndef CLAW_GL_TRACE_IMPLEMENTATION
+#undef glUseProgram
+#undef glGetUniformLocation
+#undef glUniform1i
+#undef glUniform1f
+#undef glUniform2f
+#undef glUniform4f
+#undef glActiveTexture
+#undef glBindTexture
+#undef glTexImage2D
+#undef glTexParameteri
+#undef glPixelStorei
+#undef glBindVertexArray
+#undef glBindBuffer
+#undef glBindBufferBase
+#undef glBufferData
+#undef glBufferSubData
+#undef glMapBufferRange
+#undef glUnmapBuffer
+#undef glVertexAttribPointer
+#undef glEnableVertexAttribArray
+#undef glVertexAttribDivisor
+#undef glDrawArrays
+#undef glDrawArraysInstanced
+#undef glDrawElements
+#undef glBeginTransformFeedback
+#undef glEndTransformFeedback
+#undef glBindFramebuffer
+#undef glFramebufferTexture2D
+#undef glFramebufferRenderbuffer
+#undef glCheckFramebufferStatus
+#undef glBindRenderbuffer
+#undef glRenderbufferStorage
+#undef glBlitFramebuffer
+#undef glReadPixels
+#undef glViewport
+#undef glScissor
+#undef glClear
+#undef glClearColor
+#undef glEnable
+#undef glDisable
+#undef glBlendFunc
+#undef glBlendFuncSeparate
+#undef glGetIntegerv
+#undef glBeginQuery
+#undef glEndQuery
+#undef glGetQueryObjectiv
+#undef glGetQueryObjectui64v
+#undef glFenceSync
+#undef glClientWaitSync
+#undef glDeleteSync
+#undef glFinish
+#undef glGenTextures
+#undef glGenBuffers
+#undef glGenVertexArrays
+#undef glGenFramebuffers
+#undef glGenRenderbuffers
+#undef glGenQueries
+#undef glDeleteTextures
+#undef glDeleteBuffers
+#undef glDeleteVertexArrays
+#undef glDeleteFramebuffers
+#undef glDeleteRenderbuffers
+#undef glDeleteQueries
+#undef glIsTexture
+#undef glIsBuffer
+#undef glIsVertexArray
+#undef glIsFramebuffer
+#undef glIsRenderbuffer
+#undef glIsQuery
+#undef glIsProgram
+#undef glIsShader
+#undef glCreateShader
+#undef glShaderSource
+#undef glCompileShader
+#undef glGetShaderiv
+#undef glGetShaderInfoLog
+#undef glDeleteShader
+#undef glCreateProgram
+#undef glAttachShader
+#undef glDetachShader
+#undef glTransformFeedbackVaryings
+#undef glLinkProgram
+#undef glValidateProgram
+#undef glGetProgramiv
+#undef glGetProgramInfoLog
+#undef glDeleteProgram
+#define glUseProgram(program) traceUseProgram(program)
+#define glGetUniformLocation(program, name) traceGetUniformLocation(program, name)
+#define glUniform1i(location, v0) traceUniform1i(location, v0)
+#define glUniform1f(location, v0) traceUniform1f(location, v0)
+#define glUniform2f(location, v0, v1) traceUniform2f(location, v0, v1)
+#define glUniform4f(location, v0, v1, v2, v3) traceUniform4f(location, v0, v1, v2, v3)
+#define glActiveTexture(unit) traceActiveTexture(unit)
+#define glBindTexture(target, texture) traceBindTexture(target, texture)
+#define glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels) \
+    traceTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels)
+#define glTexParameteri(target, pname, param) traceTexParameteri(target, pname, param)
+#define glPixelStorei(pname, param) tracePixelStorei(pname, param)
+#define glBindVertexArray(vao) traceBindVertexArray(vao)
+#define glBindBuffer(target, buffer) traceBindBuffer(target, buffer)
+#define glBindBufferBase(target, index, buffer) traceBindBufferBase(target, index, buffer)
+#define glBufferData(target, size, data, usage) traceBufferData(target, size, data, usage)
+#define glBufferSubData(target, offset, size, data) traceBufferSubData(target, offset, size, data)
+#define glMapBufferRange(target, offset, length, access) traceMapBufferRange(target, offset, length, access)
+#define glUnmapBuffer(target) traceUnmapBuffer(target)
+#define glVertexAttribPointer(index, size, type, normalized, stride, pointer) \
+    traceVertexAttribPointer(index, size, type, normalized, stride, pointer)
+#define glEnableVertexAttribArray(index) traceEnableVertexAttribArray(index)
+#define glVertexAttribDivisor(index, divisor) traceVertexAttribDivisor(index, divisor)
+#define glDrawArrays(mode, first, count) traceDrawArrays(mode, first, count)
+#define glDrawArraysInstanced(mode, first, count, instances) traceDrawArraysInstanced(mode, first, count, instances)
+#define glDrawElements(mode, count, type, indices) traceDrawElements(mode, count, type, indices)
+#define glBeginTransformFeedback(primitiveMode) traceBeginTransformFeedback(primitiveMode)
+#define glEndTransformFeedback() traceEndTransformFeedback()
+#define glBindFramebuffer(target, framebuffer) traceBindFramebuffer(target, framebuffer)
+#define glFramebufferTexture2D(target, attachment, textarget, texture, level) \
+    traceFramebufferTexture2D(target, attachment, textarget, texture, level)
+#define glFramebufferRenderbuffer(target, attachment, renderbufferTarget, renderbuffer) \
+    traceFramebufferRenderbuffer(target, attachment, renderbufferTarget, renderbuffer)
+#define glCheckFramebufferStatus(target) traceCheckFramebufferStatus(target)
+#define glBindRenderbuffer(target, renderbuffer) traceBindRenderbuffer(target, renderbuffer)
+#define glRenderbufferStorage(target, internalFormat, width, height) \
+    traceRenderbufferStorage(target, internalFormat, width, height)
+#define glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter) \
+    traceBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter)
+#define glReadPixels(x, y, width, height, format, type, pixels) \
+    traceReadPixels(x, y, width, height, format, type, pixels)
+#define glViewport(x, y, width, height) traceViewport(x, y, width, height)
+#define glScissor(x, y, width, height) traceScissor(x, y, width, height)
+#define glClear(mask) traceClear(mask)
+#define glClearColor(r, g, b, a) traceClearColor(r, g, b, a)
+#define glEnable(cap) traceEnable(cap)
+#define glDisable(cap) traceDisable(cap)
+#define glBlendFunc(src, dst) traceBlendFunc(src, dst)
+#define glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha) \
+    traceBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha)
+#define glGetIntegerv(pname, data) traceGetIntegerv(pname, data)
+#define glBeginQuery(target, query) traceBeginQuery(target, query)
+#define glEndQuery(target) traceEndQuery(target)
+#define glGetQueryObjectiv(query, pname, params) traceGetQueryObjectiv(query, pname, params)
+#define glGetQueryObjectui64v(query, pname, params) traceGetQueryObjectui64v(query, pname, params)
+#define glFenceSync(condition, flags) traceFenceSync(condition, flags)
+#define glClientWaitSync(sync, flags, timeout) traceClientWaitSync(sync, flags, timeout)
+#define glDeleteSync(sync) traceDeleteSync(sync)
+#define glFinish() traceFinish()
+#define glGenTextures(n, names) traceGenTextures(n, names)
+#define glGenBuffers(n, names) traceGenBuffers(n, names)
+#define glGenVertexArrays(n, names) traceGenVertexArrays(n, names)
+#define glGenFramebuffers(n, names) traceGenFramebuffers(n, names)
+#define glGenRenderbuffers(n, names) traceGenRenderbuffers(n, names)
+#define glGenQueries(n, names) traceGenQueries(n, names)
+#define glDeleteTextures(n, names) traceDeleteTextures(n, names)
+#define glDeleteBuffers(n, names) traceDeleteBuffers(n, names)
+#define glDeleteVertexArrays(n, names) traceDeleteVertexArrays(n, names)
+#define glDeleteFramebuffers(n, names) traceDeleteFramebuffers(n, names)
+#define glDeleteRenderbuffers(n, names) traceDeleteRenderbuffers(n, names)
+#define glDeleteQueries(n, names) traceDeleteQueries(n, names)
+#define glIsTexture(name) traceIsTexture(name)
+#define glIsBuffer(name) traceIsBuffer(name)
+#define glIsVertexArray(name) traceIsVertexArray(name)
+#define glIsFramebuffer(name) traceIsFramebuffer(name)
+#define glIsRenderbuffer(name) traceIsRenderbuffer(name)
+#define glIsQuery(name) traceIsQuery(name)
+#define glIsProgram(name) traceIsProgram(name)
+#define glIsShader(name) traceIsShader(name)
+#define glCreateShader(type) traceCreateShader(type)
+#define glShaderSource(shader, count, strings, lengths) traceShaderSource(shader, count, strings, lengths)
+#define glCompileShader(shader) traceCompileShader(shader)
+#define glGetShaderiv(shader, pname, params) traceGetShaderiv(shader, pname, params)
+#define glGetShaderInfoLog(shader, bufSize, length, log) traceGetShaderInfoLog(shader, bufSize, length, log)
+#define glDeleteShader(shader) traceDeleteShader(shader)
+#define glCreateProgram() traceCreateProgram()
+#define glAttachShader(program, shader) traceAttachShader(program, shader)
+#define glDetachShader(program, shader) traceDetachShader(program, shader)
+#define glTransformFeedbackVaryings(program, count, varyings, bufferMode) \
+    traceTransformFeedbackVaryings(program, count, varyings, bufferMode)
+#define glLinkProgram(program) traceLinkProgram(program)
+#define glValidateProgram(program) traceValidateProgram(program)
+#define glGetProgramiv(program, pname, params) traceGetProgramiv(program, pname, params)
+#define glGetProgramInfoLog(program, bufSize, length, log) traceGetProgramInfoLog(program, bufSize, length, log)
+#define glDeleteProgram(program) traceDeleteProgram(program)
+#endif
+
+#else
+
+constexpr bool kGLTraceBuilt = false;
+
+inline void glTraceEndFrame() {}
+inline void glTraceCaptureNextFrame(const std::string&) {}
+inline void glTraceReport(std::ostream&) {}
+inline bool glTraceLoadReplay(const std::string&) { return false; }
+inline void glTraceReplayFrame() {}
+
+#endif
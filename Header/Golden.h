@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Framebuffer images for golden-image checks, RGB with the top row first.
+// Goldens are kept in the repository run-length encoded, as a frame is mostly
+// flat colour; failed checks write binary PPM so any image viewer opens them.
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> rgb;
+};
+
+bool readPPM(const std::string& path, Image& image);
+bool writePPM(const std::string& path, const Image& image);
+// "CRLE" then width and height as text, like a PPM header, then runs: the
+// run length minus one as a little-endian base-128 varint, then R, G, B.
+bool readRunLength(const std::string& path, Image& image);
+bool writeRunLength(const std::string& path, const Image& image);
+
+struct ImageDiff {
+    std::size_t differing = 0;   // Pixels past the threshold
+    float maxDelta = 0.0f;       // Largest perceptual difference, 0..1
+    bool sizeMismatch = false;
+};
+
+// Perceptual comparison in YIQ space, weighted towards brightness the way
+// the eye is: a pixel differs when its difference exceeds threshold (0..1,
+// 0.1 hides rounding and blending noise). When diff is given it receives
+// the expected image faded to grey with differing pixels in red.
+ImageDiff compareImages(const Image& expected, const Image& actual, float threshold, Image* diff);
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Frame hitch detector. Tracks a rolling baseline of frame wall time and,
+// when a frame runs past max(minMs, baseline * factor), captures what that
+// frame looked like: its phase and per-system timings, the game state, heap
+// allocations, the most recent GL calls and the thread's context switches
+// and page faults. Captures are kept in a small ring for F4 and exit, and
+// appended to a log file up to a fixed count per run.
+struct HitchOptions {
+    float minMs = 20.0f;       // Never a hitch below this (1.5 frames at 75 Hz)
+    float factor = 2.0f;       // ... or below this multiple of the baseline
+    std::string logPath;       // Empty: keep captures in memory only
+    int maxLogged = 200;       // Captures written to the log per run
+    std::size_t kept = 32;     // Captures kept in memory
+};
+
+struct HitchTiming {
+    std::string name;
+    float ms;
+};
+
+struct HitchCapture {
+    uint64_t frame = 0;
+    uint32_t tick = 0;
+    double atSeconds = 0.0;
+    float frameMs = 0.0f;
+    float baselineMs = 0.0f;
+    float thresholdMs = 0.0f;
+    const char* gameState = "";
+    std::vector<HitchTiming> phases;   // Where the frame's wall time went
+    std::vector<HitchTiming> systems;  // Scheduler systems or floor steps in this frame
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t allocatedBytes = 0;
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+    long minorFaults = 0;
+    long majorFaults = 0;
+    std::vector<std::string> glCalls;  // Oldest first
+};
+
+// Heap activity of the whole process, counted by the replacement global
+// operator new/delete in HeapCount.cpp.
+uint64_t heapAllocations();
+uint64_t heapFrees();
+uint64_t heapAllocatedBytes();
+
+// Remembers a GL call in a small ring for hitch captures. Render thread only.
+void recordGLCall(const char* name, uint32_t arg = 0);
+
+class HitchDetector {
+public:
+    ~HitchDetector();
+
+    void init(const HitchOptions& options);
+    // Call at the start of every frame.
+    void beginFrame();
+    // Call when the frame is over, sleep included. Returns true on a hitch;
+    // phases and systems are only read then.
+    bool endFrame(double atSeconds, uint32_t tick, float frameMs, const char* gameState,
+        const std::vector<HitchTiming>& phases, const std::vector<HitchTiming>& systems);
+
+    uint64_t frames() const { return frameCount; }
+    uint64_t hitches() const { return hitchCount; }
+    float baselineMs() const { return baseline; }
+    void report(std::ostream& out) const;
+
+private:
+    void write(std::FILE* f, const HitchCapture& c) const;
+
+    HitchOptions opts;
+    std::deque<HitchCapture> captures;
+    std::FILE* log = nullptr;
+    int logged = 0;
+    uint64_t frameCount = 0;
+    uint64_t hitchCount = 0;
+    float baseline = 0.0f;
+    uint64_t allocStart = 0, freeStart = 0, bytesStart = 0;
+    long volStart = 0, involStart = 0, minorStart = 0, majorStart = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Durable accounting of coins in and prizes out. Every event becomes one
+// checksummed record appended to DIR/ledger.journal. A writer thread commits
+// records in groups: it collects whatever arrives within a short window,
+// writes the batch with one write() and makes it durable with one fdatasync.
+// When the journal grows past a limit its totals are folded into
+// DIR/ledger.snapshot (written to a temp file and renamed) and the journal is
+// emptied. On open, the snapshot is loaded and the journal replayed up to the
+// first torn or corrupt record, which is cut off.
+enum class LedgerEntryType : uint8_t {
+    Credit = 1,   // Coin inserted
+    Payout = 2    // Prize collected
+};
+
+struct LedgerRecord {
+    uint64_t sequence;   // 1-based, gapless across snapshots
+    int64_t unixMs;
+    uint32_t tick;
+    int32_t amount;
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t crc;        // CRC-32 of the bytes before it
+};
+static_assert(sizeof(LedgerRecord) == 32, "LedgerRecord layout changed");
+
+struct LedgerTotals {
+    uint64_t credits = 0;
+    uint64_t payouts = 0;
+    uint64_t lastSequence = 0;
+};
+
+struct LedgerOptions {
+    float groupWindowMs = 2.0f;          // How long a batch stays open after its first record
+    std::size_t compactRecords = 4096;   // Journal length that triggers a snapshot
+};
+
+struct LedgerRecovery {
+    bool hadSnapshot = false;
+    std::size_t replayed = 0;       // Journal records applied on top of the snapshot
+    std::size_t skipped = 0;        // Already covered by the snapshot
+    std::size_t truncatedBytes = 0; // Torn or corrupt tail that was cut off
+};
+
+struct LedgerStats {
+    uint64_t appended = 0;
+    uint64_t durable = 0;      // Highest sequence known to be on disk
+    uint64_t batches = 0;
+    uint64_t compactions = 0;
+    double avgAppendUs = 0.0;  // Time spent on the caller's thread
+    double maxAppendUs = 0.0;
+    double avgSyncMs = 0.0;
+};
+
+class Ledger {
+public:
+    ~Ledger();
+
+    // Recovers DIR (creating it if needed) and starts the writer thread.
+    bool open(const std::string& dir, const LedgerOptions& options = LedgerOptions{});
+    // Commits everything appended so far, then stops the writer.
+    void close();
+
+    // Queues one event and returns its sequence number. Never touches the disk.
+    uint64_t append(LedgerEntryType type, int32_t amount, uint32_t tick);
+
+    LedgerTotals totals() const;          // Including records not yet durable
+    uint64_t durableSequence() const { return durable.load(std::memory_order_acquire); }
+    const LedgerRecovery& recovery() const { return recovered; }
+    LedgerStats stats() const;
+
+    // Loads the snapshot and replays the journal without starting a writer,
+    // cutting off a torn tail. Used by open() and by the crash checker.
+    static bool recover(const std::string& dir, LedgerTotals& totals, LedgerRecovery& info);
+
+private:
+    void run();
+    bool writeBatch(const std::vector<LedgerRecord>& batch);
+    bool compact();
+
+    std::string directory;
+    LedgerOptions opts;
+    int journalFd = -1;
+    std::thread writer;
+    LedgerRecovery recovered;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<LedgerRecord> pending;
+    LedgerTotals queuedTotals;   // Everything appended, durable or not
+    bool stopping = false;
+
+    // Writer thread only.
+    LedgerTotals durableTotals;
+    std::size_t journalRecords = 0;
+    std::vector<LedgerRecord> batch;
+
+    std::atomic<uint64_t> durable{ 0 };
+    std::atomic<uint64_t> batchCount{ 0 };
+    std::atomic<uint64_t> compactionCount{ 0 };
+    std::atomic<uint64_t> syncNsTotal{ 0 };
+    uint64_t appendCount = 0;       // Guarded by mutex
+    double appendUsTotal = 0.0;
+    double appendUsMax = 0.0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Live per-frame stats in POSIX shared memory, for on-cabinet monitors that
+// want to sample faster than any socket round trip allows. The game rewrites
+// one LiveStats a frame under a seqlock: the sequence is odd while a write is
+// in progress, so a reader copies the payload and keeps it only if the
+// sequence was even and unchanged around the copy. Readers never write to
+// the segment and never make a system call after mapping it.
+constexpr uint32_t kLiveStatsMagic = 0x534C4C43;  // "CLLS"
+constexpr uint32_t kLiveStatsVersion = 1;
+constexpr const char* kLiveStatsDefaultName = "/clawmachine-stats";
+constexpr int kLiveStatsWindow = 256;             // Frames behind fps and percentiles
+
+struct LiveStats {
+    uint64_t frame;          // Frames published since the segment opened
+    uint64_t timeNs;         // Steady clock at publish, since the segment opened
+    uint32_t tick;           // Simulation tick
+    uint8_t gameState;       // GameState
+    uint8_t lampMode;        // LampMode
+    uint8_t lampBlink;       // Blink phase: 1 green, 0 red
+    uint8_t rewinding;
+    float fps;               // Over the window
+    float frameMs;           // Work time of the last frame, before the cap sleep
+    float p50Ms;             // Frame work time percentiles over the window,
+    float p95Ms;             // to 0.25 ms resolution
+    float p99Ms;
+    float maxMs;
+    float clawX;
+    float clawY;
+    float ropeLength;
+    uint32_t coinsInserted;
+    uint32_t prizesPaid;
+    uint32_t reserved;
+};
+static_assert(sizeof(LiveStats) % sizeof(uint32_t) == 0, "LiveStats is copied as 32-bit words");
+
+constexpr std::size_t kLiveStatsWords = sizeof(LiveStats) / sizeof(uint32_t);
+
+struct LiveStatsSegment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t payloadSize;    // sizeof(LiveStats) of the writer
+    uint32_t pid;
+    alignas(64) std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> words[kLiveStatsWords];
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Live stats need lock-free 32-bit atomics");
+
+// Writer side. publishLiveStats is a no-op until the segment is open.
+bool openLiveStats(const std::string& name = kLiveStatsDefaultName);
+void closeLiveStats();
+struct Machine;
+void publishLiveStats(const Machine& m, uint32_t tick, float frameMs, float dt, bool rewinding);
+
+// Reader side. sample() spins only while a write is in flight; it returns
+// false if the segment is not open or the writer kept it busy for too long.
+class LiveStatsReader {
+public:
+    ~LiveStatsReader();
+
+    bool open(const std::string& name = kLiveStatsDefaultName);
+    void close();
+    bool sample(LiveStats& out);
+    uint32_t writerPid() const { return segment ? segment->pid : 0; }
+    uint64_t retries() const { return retryCount; }
+
+private:
+    const LiveStatsSegment* segment = nullptr;
+    uint64_t retryCount = 0;
+};
@@ -0,0 +1,267 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Components.h"
+#include "Philox.h"
+#include "Plush.h"
+#include "Registry.h"
+#include "Rope.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+
+enum class GameState {
+    Idle,
+    ActiveNoToy,
+    ActiveCarrying,
+    ToyFalling,
+    PrizeWaiting
+};
+
+const char* gameStateName(GameState s);
+
+enum class LampMode {
+    Off,
+    Blue,
+    Blink
+};
+
+struct Lamp {
+    LampMode mode = LampMode::Off;
+    double blinkStart = 0.0;   // Machine clock when blinking started
+    float interval = 0.5f;     // Seconds per color while blinking
+};
+
+struct Claw {
+    Vec2 anchor{ 0.0f, 0.70f };  // Rope start (just above glass)
+    float ropeLength = 0.16f;
+    float minLength = 0.16f;
+    float maxLength = 1.18f;
+    float moveSpeed = 0.65f;
+    float lowerSpeed = 0.80f;
+    float raiseSpeed = 0.80f;
+    float width = 0.12f;
+    float height = 0.10f;
+    Vec2 pos;                    // Where the claw hangs: the rope's end mass
+    Vec2 prevPos;                // pos one tick earlier; Verlet keeps velocity as the difference
+    float swingDamping = 2.0f;   // Fraction of swing velocity lost per second
+    bool open = false;
+    bool movingDown = false;
+    bool movingUp = false;
+};
+
+struct Hole {
+    Vec2 center{ 0.48f, -0.28f };
+    float radius = 0.085f;
+};
+
+struct PrizeCompartment {
+    Vec2 pos{ 0.48f, -0.54f };
+    Vec2 size{ 0.26f, 0.16f };
+    bool hasToy = false;
+    Entity toy;
+};
+
+struct TokenSlot {
+    Vec2 pos{ -0.48f, -0.58f };
+    Vec2 size{ 0.18f, 0.08f };
+};
+
+// Held controls for one tick, sampled on the main thread so that systems
+// never call into GLFW.
+struct InputState {
+    bool left = false;
+    bool right = false;
+    bool down = false;
+    bool up = false;
+};
+
+// What each system reads or writes, for the scheduler's dependency graph.
+// Machine fields outside the registry get bits of their own: a system that
+// touches one without declaring it races whatever else does.
+enum SystemAccess : AccessMask {
+    AccessInput = 1u << 0,
+    AccessGameState = 1u << 1,
+    AccessClaw = 1u << 2,
+    AccessLamp = 1u << 3,
+    AccessPrize = 1u << 4,
+    AccessRope = 1u << 5,        // Machine::rope
+    AccessTransform = 1u << 6,
+    AccessSprite = 1u << 7,
+    AccessBody = 1u << 8,
+    AccessGameplay = 1u << 9,
+    AccessTelemetry = 1u << 10,
+    AccessPlush = 1u << 11,
+    AccessClock = 1u << 12,      // Machine::clock, read by every play event
+    AccessHeldToy = 1u << 13,    // Machine::grabbedToy and fallingToy
+    AccessAll = 0xFFFFFFFFu
+};
+
+// Bounds for the glass box
+const Vec2 boxCenter{ 0.0f, 0.12f };
+const Vec2 boxSize{ 1.26f, 1.06f };
+const float boxLeft = boxCenter.x - boxSize.x * 0.5f;
+const float boxRight = boxCenter.x + boxSize.x * 0.5f;
+const float boxTop = boxCenter.y + boxSize.y * 0.5f;
+const float boxBottom = boxCenter.y - boxSize.y * 0.5f;
+const float floorY = boxBottom + 0.035f;
+const float anchorStartY = boxTop + 0.08f;
+
+// Everything a machine draws lies inside these local-space bounds.
+const Vec2 kMachineBoundsMin{ -0.80f, -0.70f };
+const Vec2 kMachineBoundsMax{ 0.80f, 0.95f };
+
+constexpr int kInitialToys = 4;
+const Vec2 kToySize{ 0.11f, 0.11f };
+const float kToyGravity = -2.6f;
+const float kClawGravity = -4.0f;
+const float kRopeWidth = 0.012f;
+const float kPrizePulsePeriod = 6.2831853f / 6.0f;   // Seconds per prize glow pulse
+const float kPrizeToyScale = 1.1f;                    // A won toy is shown this much larger in the compartment
+
+const std::array<Vec2, 6> spawnPositions = {
+    Vec2{ -0.58f, -0.44f }, Vec2{ -0.32f, -0.44f }, Vec2{ -0.06f, -0.44f },
+    Vec2{ 0.16f, -0.44f }, Vec2{ 0.36f, -0.44f }, Vec2{ 0.56f, -0.44f }
+};
+
+struct MachineTextures {
+    unsigned int toyA = 0;
+    unsigned int toyB = 0;
+    unsigned int toyC = 0;
+    unsigned int hole = 0;
+};
+
+// Sprites of the moving machine parts, re-posed from gameplay state each tick.
+struct MachineParts {
+    Entity prizeGlow;
+    Entity railJoint;
+    Entity rope;
+    Entity clawShadow;
+    Entity clawBody;
+    Entity jawLeft;
+    Entity jawRight;
+    Entity lampLight;
+};
+
+// Timestamps of the play in progress, for telemetry.
+struct PlayTrace {
+    double startTime = 0.0;
+    double releaseTime = 0.0;
+    double prizeReadyTime = 0.0;
+    bool awaitingGrab = false;
+};
+
+// Complete simulation state of one cabinet. Large; keep it on the heap.
+struct Machine {
+    GameState gameState = GameState::Idle;
+    Lamp lamp;
+    Claw claw;
+    Hole hole;
+    PrizeCompartment prize;
+    TokenSlot tokenSlot;
+    Registry registry;
+    MachineParts parts;
+    Rope rope;              // Drawn rope; simulated only when setRopeSegments() gave it segments
+    bool plushEnabled = false;
+    PlushSolver plush;      // Drawn soft bodies, one per toy, while plushEnabled
+    bool fixedPoint = false;   // Run the play-deciding systems on Q16.16, for bit-exact replays
+    MachineTextures textures;
+    InputState input;
+    Entity grabbedToy;
+    Entity fallingToy;
+    int nextSpawnSlot = 0;
+    bool sWasDown = false;
+    bool pendingPrizeClick = false;
+    double prizePulseStart = 0.0;   // Machine clock when the prize arrived
+    PhiloxRng rng{ 1337 };   // Keyed by the machine's seed; snapshots keep the seed and draw count
+    // Lifetime counts for accounting; deliberately not part of snapshots, so
+    // restoring an earlier state never takes back a coin or a payout.
+    uint32_t coinsInserted = 0;
+    uint32_t prizesPaid = 0;
+    // Per-play telemetry, also outside snapshots. Gameplay appends to
+    // playEvents when recordPlays is set; the owner drains it between ticks.
+    bool recordPlays = false;
+    std::vector<PlayEvent> playEvents;
+    PlayTrace trace;
+    // Seconds simulated. Summed in float it drifts seconds an hour and stops
+    // after three days, so it stays a double all the way to the renderer.
+    double clock = 0.0;
+    double animEpoch = 0.0;  // animationEpoch() the sprites' animation starts are relative to
+    bool logEvents = true;   // Print gameplay diagnostics and flight-record transitions
+};
+
+// Setup
+void initMachine(Machine& m, const MachineTextures& textures, uint32_t seed);
+void resetMachine(Machine& m);
+void configureLayout(Machine& m);
+void spawnToys(Machine& m);
+Entity spawnToy(Machine& m, Vec2 spawn, unsigned int texture);
+void createMachineEntities(Machine& m);
+// Sizes the drawn rope and lays it straight. With 0 segments the rope is a
+// straight sprite, as on the floor, and costs nothing to simulate.
+void setRopeSegments(Machine& m, int segments);
+// Turns on the toys' drawn soft bodies. Off, as on the floor, the toys are
+// drawn as rigid sprites and nothing is simulated for them.
+void setPlushEnabled(Machine& m, bool enabled);
+
+// Gameplay helpers
+void startGame(Machine& m);
+void startLowering(Machine& m);
+void attachToy(Machine& m, Entity toy);
+void releaseToy(Machine& m);
+void collectPrize(Machine& m);
+void clickMachine(Machine& m, const Vec2& p, int clickId);
+Vec2 clawPosition(const Machine& m);
+Vec2 clawGrabPoint(const Machine& m);
+bool pointInRect(const Vec2& p, const Vec2& center, const Vec2& size);
+bool pointInPrizeArea(const Machine& m, const Vec2& p);
+
+// Systems
+void updateClawMotion(Machine& m, float dt);
+void updateControls(Machine& m, float dt);
+// Swings the claw under the carriage and steps the drawn rope.
+void updateClawSwing(Machine& m, float dt);
+void updateAttachment(Machine& m);
+void physicsSystem(Registry& reg, float dt);
+void updateFallingToy(Machine& m);
+void updatePrizeClaim(Machine& m);
+// Q16.16 forms of the systems above, which stepMachine() and the scheduler
+// run instead when m.fixedPoint is set. updateControls() and clawGrabPoint()
+// switch on the flag themselves.
+void updateClawMotionFixed(Machine& m, float dt);
+void updateClawSwingFixed(Machine& m, float dt);
+void physicsSystemFixed(Registry& reg, float dt);
+void updateFallingToyFixed(Machine& m);
+void clawPoseSystem(Machine& m);
+// Keeps one soft body per toy and steps them towards where gameplay put the toys.
+void plushSystem(Machine& m, float dt);
+// Lamp color and prize glow. Time-based parts are sprite animations, so this
+// only runs when the lamp or the prize changes, not every tick.
+void machineSpriteSystem(Machine& m);
+// Blink phase at the machine's current clock: true while the lamp is green.
+bool lampBlinkOn(const Machine& m);
+
+// Self-play used by attract screens and headless tools: starts a game, grabs
+// at a random toy slot, carries the toy to the hole and collects the prize.
+struct AttractPlayer {
+    std::minstd_rand rng;
+    float timer = 0.0f;
+    float targetX = 0.0f;
+};
+
+void initAttract(AttractPlayer& a, uint32_t seed);
+// Writes this tick's input into m.input; call before stepping the machine.
+void driveAttract(Machine& m, AttractPlayer& a, float dt);
+// Helpers for anything that plays the machine through its input: the attract
+// player and the soak bot. A drop waits for the swing to die down, or the claw
+// misses; steerClaw holds left or right until the carriage is within of x.
+bool clawSettled(const Machine& m);
+bool steerClaw(const Machine& m, InputState& in, float x, float within);
+
+// Registers the machine's systems with a scheduler, in the order stepMachine
+// runs them.
+void registerMachineSystems(Scheduler& sched, Machine& m);
+// Runs one tick of every system serially on the calling thread.
+void stepMachine(Machine& m, float dt);
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Process-wide counters, gauges and histograms, exported in the Prometheus
+// text exposition format. Metrics are registered once at startup and then
+// updated by id from any thread. Counters and histograms are written into a
+// per-thread shard with plain relaxed stores (each shard has one writer), so
+// recording never locks or contends; a scrape sums the shards. Gauges hold a
+// single current value.
+using MetricId = int;
+
+constexpr int kMaxMetrics = 32;
+constexpr int kMaxMetricBuckets = 16;
+constexpr int kMaxMetricShards = 64;   // Threads beyond this share the last shard
+
+// Registration is not thread-safe with itself; do it before starting threads.
+// Returns -1 when the registry is full. Updates to id -1 are ignored.
+MetricId registerCounter(const char* name, const char* help);
+MetricId registerGauge(const char* name, const char* help);
+// Upper bounds in increasing order; a +Inf bucket is added.
+MetricId registerHistogram(const char* name, const char* help, std::initializer_list<double> bounds);
+
+void metricAdd(MetricId id, uint64_t n = 1);
+void metricSet(MetricId id, double value);
+void metricObserve(MetricId id, double value);
+
+// The whole registry in text exposition format.
+std::string renderMetrics();
+
+// Metrics the game records; ids stay -1 until registerGameMetrics().
+struct GameMetrics {
+    MetricId frameSeconds = -1;
+    MetricId simSteps = -1;
+    MetricId drawCalls = -1;
+    MetricId playsStarted = -1;
+    MetricId prizesWon = -1;
+    MetricId textureBytes = -1;
+};
+extern GameMetrics gameMetrics;
+void registerGameMetrics();
+
+// Serves renderMetrics() at GET /metrics on 127.0.0.1:port from its own
+// thread. Sockets are non-blocking and every request is answered and closed
+// in one pass, so a slow or stuck scraper only holds its own connection.
+class MetricsServer {
+public:
+    ~MetricsServer();
+
+    bool start(int port);
+    void stop();
+    uint64_t scrapes() const { return scrapeCount.load(); }
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string request;
+        std::string response;
+        std::size_t sent = 0;
+        int64_t openedMs = 0;
+    };
+
+    void run();
+    void acceptConnections();
+    bool readRequest(Connection& c);
+    bool writeResponse(Connection& c);
+    void closeConnection(std::size_t i);
+
+    int port = 0;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::vector<Connection> connections;   // Server thread only
+    std::atomic<uint64_t> scrapeCount{ 0 };
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "Components.h"
+
+// One spray of particles. Each particle draws its direction, speed and
+// lifetime uniformly from the ranges and its color from the palette.
+struct ParticleBurst {
+    uint32_t count = 0;
+    Vec2 pos{ 0.0f, 0.0f };
+    Vec2 jitter{ 0.0f, 0.0f };       // Half extents of the spawn box
+    float direction = 1.5707963f;    // Radians, 0 is +x
+    float spread = 3.1415927f;       // Half angle either side of direction
+    float speedMin = 0.1f, speedMax = 1.0f;
+    float lifeMin = 1.0f, lifeMax = 2.0f;
+    float gravity = 0.0f;            // Units per second squared, downwards
+    float drag = 0.0f;               // Fraction of velocity lost per second
+    float size = 0.01f;
+    float spin = 0.0f;               // Up to this many radians per second either way; 0 draws upright squares
+    std::vector<std::array<uint8_t, 4>> palette{ { 255, 255, 255, 255 } };
+};
+
+// Confetti out of the prize compartment, and sparkles at the token slot.
+ParticleBurst confettiBurst(const Vec2& at);
+ParticleBurst sparkleBurst(const Vec2& at);
+
+struct ParticleStats {
+    bool gpu = false;          // Transform feedback, or the CPU fallback
+    int capacity = 0;
+    uint32_t used = 0;         // Slots updated and drawn this frame
+    uint32_t peakUsed = 0;
+    uint64_t bursts = 0;
+    uint64_t emitted = 0;
+    uint64_t updates = 0;
+    double avgUpdateMs = 0.0;  // Render thread time per update(), GPU work excluded
+    double maxUpdateMs = 0.0;
+};
+
+// Fixed-capacity particle pool that lives in GPU buffers. Each frame a
+// vertex shader advances every particle into a second buffer with transform
+// feedback, and the buffers swap; one instanced draw renders them all. New
+// particles overwrite the oldest slots. When every particle has died the
+// pool costs nothing until the next burst. If the feedback program does not
+// link, or the CPU path is asked for, particles are advanced on the CPU in
+// structure-of-arrays loops and uploaded each frame instead.
+class ParticleSystem {
+public:
+    ~ParticleSystem();
+
+    bool init(int capacity, bool cpuFallback);
+    void shutdown();
+    bool enabled() const { return capacity > 0; }
+
+    void emit(const ParticleBurst& burst);
+    void update(float dt);
+    void render();
+
+    ParticleStats stats() const;
+    void report(std::ostream& out) const;
+
+private:
+    // Advanced every frame; the layout the feedback shader reads and writes.
+    struct State {
+        float x, y, vx, vy;
+        float age, life, gravity, drag;
+    };
+    // Fixed at emission; read only by the draw.
+    struct Look {
+        uint8_t rgba[4];
+        float size;
+        float spin;
+    };
+
+    void setupDrawVao(unsigned int vao, unsigned int stateBuffer);
+    void writeSlots(uint32_t first, const State* states, const Look* looks, uint32_t count);
+    void updateOnCpu(float dt);
+
+    int capacity = 0;
+    unsigned int stateBuffers[2] = {};
+    unsigned int lookBuffer = 0;
+    unsigned int updateVaos[2] = {};
+    unsigned int drawVaos[2] = {};
+    unsigned int feedbackShader = 0;
+    unsigned int drawShader = 0;
+    int current = 0;             // stateBuffers index holding the latest state
+
+    uint32_t cursor = 0;         // Next slot to overwrite
+    uint32_t used = 0;           // Slots [0, used) have been written since the pool was last empty
+    float aliveFor = 0.0f;       // Seconds until the last live particle dies; a countdown, so it never grows with uptime
+    std::vector<State> stateStaging;
+    std::vector<Look> lookStaging;
+    std::vector<uint32_t> randomStaging;   // Philox draws, eight per particle
+
+    // CPU fallback state, one array per field (see stepParticles).
+    std::vector<float> px, py, pvx, pvy, page, plife, pgravity, pdrag;
+
+    uint32_t peakUsed = 0;
+    uint64_t bursts = 0, emitted = 0, updates = 0;
+    double updateMsTotal = 0.0, updateMsMax = 0.0;
+};
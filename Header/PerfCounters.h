@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+
+// Optional hardware counter attribution (Linux perf_event_open). When
+// enabled, every thread that enters a PerfScope opens its own counter group
+// for itself, and the scope adds the group's deltas to its region. Regions
+// nest and their counts are inclusive. Counters the machine or the
+// perf_event_paranoid setting does not allow are left out of the group;
+// without any, scopes cost one branch.
+enum PerfCounter {
+    PerfCycles,
+    PerfInstructions,
+    PerfL1DMisses,        // L1 data cache read misses
+    PerfLLCMisses,        // Last level cache misses
+    PerfBranchMisses,
+    PerfTaskClock,        // Software: ns on a CPU
+    PerfPageFaults,       // Software
+    kPerfCounterCount
+};
+
+constexpr int kMaxPerfRegions = 64;
+
+// Opens a group on the calling thread to see what is allowed and turns
+// scopes on. Prints what is missing; false when no counter can be opened.
+bool enablePerfCounters();
+bool perfCountersEnabled();
+
+// Finds or adds a region; call once per site and keep the id.
+int perfRegion(const char* name);
+
+class PerfScope {
+public:
+    explicit PerfScope(int region);
+    ~PerfScope();
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    int region = -1;
+    uint64_t start[kPerfCounterCount];
+};
+
+// Per-region calls, IPC and misses per thousand instructions.
+void reportPerfCounters(std::ostream& out);
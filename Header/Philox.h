@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"): ten rounds of multiplies and XORs turn a 128-bit counter and a 64-bit
+// key into four 32-bit outputs. There is no state beyond the counter, so any
+// draw can be computed on its own, in any order and on any thread.
+using PhiloxCounter = std::array<uint32_t, 4>;
+using PhiloxKey = std::array<uint32_t, 2>;
+
+PhiloxCounter philox4x32(PhiloxCounter c, PhiloxKey k);
+
+// Fills out with 4 * blocks draws of stream (seed, stream), starting at
+// block firstBlock; block b holds draws 4b to 4b + 3. Each block depends only
+// on its own counter, so a range can be split across threads with the same
+// result.
+void philoxFill(uint32_t seed, uint32_t stream, uint64_t firstBlock, uint32_t* out, std::size_t blocks);
+
+// Top 24 bits of a draw as a float in [0, 1).
+inline float philoxUnit(uint32_t x) { return float(x >> 8) * (1.0f / 16777216.0f); }
+
+// Counter-based generator usable with <random> distributions. Draw n of
+// stream (seed, stream) is a pure function of the three, so the full state
+// is the seed and the draw count and a restore seeks in O(1), however many
+// draws came before. Separate streams of one seed are independent: a machine
+// can key one per purpose or per tick.
+class PhiloxRng {
+public:
+    using result_type = uint32_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    explicit PhiloxRng(uint32_t s = 1337, uint32_t stream = 0) : streamId(stream) { seed(s); }
+    void seed(uint32_t s) { restore(s, 0); }
+    void restore(uint32_t s, uint64_t draws) { seedValue = s; drawCount = draws; refill(); }
+    result_type operator()()
+    {
+        const result_type v = block[drawCount & 3];
+        if ((++drawCount & 3) == 0) refill();
+        return v;
+    }
+
+    uint32_t initialSeed() const { return seedValue; }
+    uint32_t stream() const { return streamId; }
+    uint64_t draws() const { return drawCount; }
+
+private:
+    void refill()
+    {
+        const uint64_t b = drawCount >> 2;
+        block = philox4x32({ uint32_t(b), uint32_t(b >> 32), streamId, 0 }, { seedValue, 0 });
+    }
+
+    PhiloxCounter block{};
+    uint64_t drawCount = 0;
+    uint32_t seedValue = 0;
+    uint32_t streamId = 0;
+};
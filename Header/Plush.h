@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Components.h"
+#include "Registry.h"
+
+class WorkStealingPool;
+
+constexpr int kPlushGrid = 4;                          // Particles per side of a toy
+constexpr int kPlushPoints = kPlushGrid * kPlushGrid;  // Row-major from the bottom left
+
+// Where gameplay put a toy this tick; its soft body chases this pose.
+struct PlushTarget {
+    Vec2 pos;             // Rigid centre, from the toy's Transform
+    Vec2 size;
+    float floorY = 0.0f;  // No particle sinks below this
+    float grip = 0.0f;    // When > 0, the top half is squeezed to this half width about pos.x
+};
+
+// Plush toys as 2D position-based soft bodies. Each toy is a small particle
+// lattice, one array per coordinate across every toy, held to its rest
+// square by shape matching and pulled towards the rigid pose gameplay gives
+// it, so it sags on the floor, squashes when it lands and pinches in the
+// claw. Only drawing uses it; gameplay and snapshots keep the rigid toys.
+class PlushSolver {
+public:
+    float gravity = -2.6f;
+    float shape = 0.05f;     // Pull towards the matched rest shape per sweep
+    float anchor = 0.02f;    // Pull of the centre towards the rigid pose per sweep
+    float upright = 0.1f;    // Fraction of the matched rotation undone per sweep
+    float damping = 6.0f;    // Fraction of velocity lost per second
+    int iterations = 2;
+
+    // Adds a body at rest on target and returns its index.
+    int add(Entity owner, const PlushTarget& target);
+    // Swap-removes: the last body takes over index.
+    void remove(int index);
+    void clear();
+    int count() const { return static_cast<int>(owners.size()); }
+    int find(Entity owner) const;
+    Entity owner(int index) const { return owners[index]; }
+    PlushTarget& target(int index) { return targets[index]; }
+
+    // Advances every body one step; with a pool, bodies are split into chunks
+    // across its threads.
+    void step(float dt, WorkStealingPool* pool = nullptr);
+
+    // kPlushPoints particle positions of one body.
+    const float* xs(int index) const { return &x[std::size_t(index) * kPlushPoints]; }
+    const float* ys(int index) const { return &y[std::size_t(index) * kPlushPoints]; }
+
+private:
+    void reset(int index);
+    void stepRange(std::size_t first, std::size_t last, float dt);
+
+    std::vector<float> x, y, px, py;
+    std::vector<PlushTarget> targets;
+    std::vector<Entity> owners;
+};
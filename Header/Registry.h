@@ -0,0 +1,167 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Components.h"
+#include "SlotMap.h"
+
+using Entity = SlotHandle;
+constexpr std::size_t kMaxEntities = 256;
+
+// Sparse set of one component type. Values are packed at the front of a fixed
+// array so systems iterate them linearly; the sparse side maps an entity's
+// slot index to its packed position. Removal swap-removes.
+template <typename T>
+class ComponentArray {
+public:
+    static constexpr uint32_t kNoIndex = 0xFFFFFFFFu;
+
+    ComponentArray() { sparse.fill(kNoIndex); }
+
+    // Null for a null or out-of-range entity, as SlotMap::get.
+    T* add(Entity e, const T& value)
+    {
+        if (e.isNull() || e.index >= kMaxEntities) return nullptr;
+        if (T* existing = get(e)) {
+            *existing = value;
+            return existing;
+        }
+        uint32_t dense = static_cast<uint32_t>(count++);
+        values[dense] = value;
+        owners[dense] = e;
+        sparse[e.index] = dense;
+        return &values[dense];
+    }
+
+    void remove(Entity e)
+    {
+        if (!has(e)) return;
+        uint32_t dense = sparse[e.index];
+        uint32_t last = static_cast<uint32_t>(count - 1);
+        if (dense != last) {
+            values[dense] = values[last];
+            owners[dense] = owners[last];
+            sparse[owners[dense].index] = dense;
+        }
+        sparse[e.index] = kNoIndex;
+        --count;
+    }
+
+    bool has(Entity e) const
+    {
+        if (e.index >= kMaxEntities) return false;
+        uint32_t dense = sparse[e.index];
+        return dense != kNoIndex && owners[dense] == e;
+    }
+
+    T* get(Entity e) { return has(e) ? &values[sparse[e.index]] : nullptr; }
+    const T* get(Entity e) const { return has(e) ? &values[sparse[e.index]] : nullptr; }
+
+    // Stable insertion sort of the packed range; cheap when nearly sorted.
+    template <typename Less>
+    void sort(Less less)
+    {
+        for (std::size_t i = 1; i < count; ++i) {
+            T value = values[i];
+            Entity owner = owners[i];
+            std::size_t j = i;
+            while (j > 0 && less(value, values[j - 1])) {
+                values[j] = values[j - 1];
+                owners[j] = owners[j - 1];
+                sparse[owners[j].index] = static_cast<uint32_t>(j);
+                --j;
+            }
+            values[j] = value;
+            owners[j] = owner;
+            sparse[owner.index] = static_cast<uint32_t>(j);
+        }
+    }
+
+    void clear()
+    {
+        for (std::size_t i = 0; i < count; ++i) sparse[owners[i].index] = kNoIndex;
+        count = 0;
+    }
+
+    std::size_t size() const { return count; }
+    Entity entityAt(std::size_t dense) const { return owners[dense]; }
+    T& at(std::size_t dense) { return values[dense]; }
+    const T& at(std::size_t dense) const { return values[dense]; }
+
+    T* begin() { return values.data(); }
+    T* end() { return values.data() + count; }
+    const T* begin() const { return values.data(); }
+    const T* end() const { return values.data() + count; }
+
+private:
+    std::array<T, kMaxEntities> values{};
+    std::array<Entity, kMaxEntities> owners{};
+    std::array<uint32_t, kMaxEntities> sparse{};
+    std::size_t count = 0;
+};
+
+// Entity-component registry for one machine. Entity ids come from a
+// generational SlotMap, so handles to destroyed entities stop resolving.
+class Registry {
+public:
+    Entity create() { return entities.insert(EntityRecord{}); }
+
+    void destroy(Entity e)
+    {
+        if (!entities.contains(e)) return;
+        transforms.remove(e);
+        sprites.remove(e);
+        bodies.remove(e);
+        gameplay.remove(e);
+        entities.erase(e);
+    }
+
+    bool alive(Entity e) const { return entities.contains(e); }
+    std::size_t entityCount() const { return entities.size(); }
+
+    void clear()
+    {
+        entities.clear();
+        transforms.clear();
+        sprites.clear();
+        bodies.clear();
+        gameplay.clear();
+        nextSpriteOrder = 0;
+    }
+
+    Transform* add(Entity e, const Transform& c) { return transforms.add(e, c); }
+    Body* add(Entity e, const Body& c) { return bodies.add(e, c); }
+    Gameplay* add(Entity e, const Gameplay& c) { return gameplay.add(e, c); }
+    Sprite* add(Entity e, const Sprite& c)
+    {
+        Sprite* s = sprites.add(e, c);
+        if (s) s->order = nextSpriteOrder++;
+        return s;
+    }
+
+    // Keeps sprites packed in draw order (layer, then creation order). Only
+    // re-sorts after a spawn, despawn or layer change disturbed the order.
+    void sortSprites()
+    {
+        auto less = [](const Sprite& a, const Sprite& b) {
+            return a.layer != b.layer ? a.layer < b.layer : a.order < b.order;
+        };
+        for (std::size_t i = 1; i < sprites.size(); ++i) {
+            if (less(sprites.at(i), sprites.at(i - 1))) {
+                sprites.sort(less);
+                return;
+            }
+        }
+    }
+
+    ComponentArray<Transform> transforms;
+    ComponentArray<Sprite> sprites;
+    ComponentArray<Body> bodies;
+    ComponentArray<Gameplay> gameplay;
+
+private:
+    struct EntityRecord {};
+    SlotMap<EntityRecord, kMaxEntities> entities;
+    uint32_t nextSpriteOrder = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "Components.h"
+#include "Plush.h"
+#include "Registry.h"
+#include "Rope.h"
+
+// Compiles the quad shaders and uploads the shared unit quad. Needs a
+// current GL context.
+bool initRenderer();
+// Unit quad: vec2 position at location 0, vec2 UV at location 1.
+unsigned int quadVertexBuffer();
+
+void drawQuadColor(const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& color,
+    const SpriteAnim& anim = SpriteAnim{});
+void drawQuadTexture(unsigned int tex, const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& tint,
+    const SpriteAnim& anim = SpriteAnim{});
+// The rope's points as one triangle strip of the given width.
+void drawRope(const Rope& rope, float width, const std::array<float, 4>& color);
+// A texture stretched over one soft body's particle lattice.
+void drawPlush(unsigned int tex, const float* xs, const float* ys, const std::array<float, 4>& tint);
+
+// Draws a machine's sprites back to front; walks only sprites and transforms.
+// time is the machine's clock, for sprite animations. Textured sprites with a
+// body in plush are drawn deformed, in their place in the order.
+void renderSystem(Registry& reg, double time, const PlushSolver* plush = nullptr);
+// Draws only the emissive sprites, brightened by their emissive weight, for
+// the bloom target.
+void renderEmissive(Registry& reg, double time);
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Snapshot.h"
+
+struct RewindStats {
+    std::size_t memoryBytes = 0;    // Fixed at init, never grows
+    std::size_t bytesUsed = 0;
+    std::size_t ticks = 0;
+    double secondsCovered = 0.0;
+    double avgRecordUs = 0.0;
+    double maxRecordUs = 0.0;
+};
+
+// Fixed-memory history of one machine: every tick is a delta against the
+// tick before it, with a keyframe every kKeyframeInterval ticks. Records live
+// in a byte ring; when it fills, the oldest keyframe and its deltas are
+// dropped together so the history always starts on a keyframe.
+// Longest history the game accepts; an hour is about 15 MB.
+constexpr float kMaxRewindSeconds = 3600.0f;
+
+class RewindBuffer {
+public:
+    static constexpr int kKeyframeInterval = 30;
+
+    // Sizes the ring for `seconds` of history at up to `tickRate` ticks/s.
+    void init(float seconds, float tickRate);
+    void clear();
+
+    // time is seconds simulated, kept in double so it never stalls.
+    void record(const Machine& m, uint32_t tick, double time);
+
+    // Index 0 is the oldest tick held, size() - 1 the newest.
+    std::size_t size() const { return count; }
+    bool stateAt(std::size_t index, MachineSnapshot& out) const;
+    double timeAt(std::size_t index) const;
+    // Drops everything newer than index, so recording continues from there.
+    void truncateAfter(std::size_t index);
+
+    RewindStats stats() const;
+
+private:
+    struct Entry {
+        uint32_t tick;
+        double time;
+        uint32_t offset;
+        uint16_t length;
+        uint8_t keyframe;
+    };
+
+    const Entry& entry(std::size_t index) const { return entries[(first + index) % entries.size()]; }
+    void evictOldestGroup();
+    bool reserve(std::size_t length, uint32_t& offset);
+
+    std::vector<Entry> entries;
+    std::vector<uint8_t> arena;
+    std::size_t first = 0;
+    std::size_t count = 0;
+    std::size_t writePos = 0;
+    std::size_t bytesUsed = 0;
+    int sinceKeyframe = 0;
+    MachineSnapshot previous{};
+    bool havePrevious = false;
+    std::vector<uint8_t> scratch;
+    double totalRecordUs = 0.0;
+    double maxRecordUs = 0.0;
+    uint64_t recordCount = 0;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+
+#include "Components.h"
+
+// The claw's rope as a chain of Verlet points, one array per coordinate.
+// Point 0 hangs from the carriage and the last point from the claw; both are
+// pinned every step, since the claw is far heavier than the rope and swings
+// on its own. The points in between sag and ripple behind the motion.
+struct Rope {
+    int segments = 0;                    // 0: no chain; the machine draws a straight sprite
+    int iterations = 8;                  // Constraint sweeps per step
+    float damping = 2.0f;                // Fraction of velocity lost per second
+    std::vector<float> x, y, px, py;     // Position now and one step ago, segments + 1 points
+    std::vector<float> w;                // Inverse mass; 0 pins the two ends
+};
+
+// Sizes the chain. Call resetRope() before stepping it.
+void initRope(Rope& r, int segments);
+// Lays the chain straight and at rest from top to bottom.
+void resetRope(Rope& r, const Vec2& top, const Vec2& bottom);
+// Pins the ends to top and bottom, integrates the free points and pulls every
+// segment back towards length / segments, or the distance between the ends
+// over segments when that is longer. Each sweep clamps every point to its
+// tether from both ends, then solves the segments in two batches, even then
+// odd; no two segments in a batch share a point, so no pass carries anything
+// from one point to the next. GCC vectorizes the integration, tether and
+// segment loops at -O3, given the -fno-math-errno CMakeLists.txt sets here.
+void stepRope(Rope& r, const Vec2& top, const Vec2& bottom, float length, float gravity, float dt);
+// stepRope() in Q16.16, for machines on the fixed-point path. The points stay
+// in the float arrays, which carry Q16.16 values exactly. Each divide is 64-bit,
+// so these loops do not vectorize; a rope of 16 points does not need them to.
+void stepRopeFixed(Rope& r, const Vec2& top, const Vec2& bottom, float length, float gravity, float dt);
+// Largest relative stretch of any segment against the rest length stepRope()
+// uses.
+float ropeStretch(const Rope& r, float length);
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Thread pool with one deque per worker. Workers pop their own deque LIFO and
+// steal FIFO from the others when it runs dry. Threads that are not workers
+// submit into a shared injection queue and may help drain work via runOne().
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned workerCount);
+    ~WorkStealingPool();
+
+    void submit(std::function<void()> task);
+    // Runs one queued task on the calling thread; false when nothing was queued.
+    bool runOne();
+    // Splits [0, count) into chunks and runs them across the pool, returning
+    // once every chunk has finished. The calling thread helps.
+    void parallelFor(std::size_t count, std::size_t chunk, const std::function<void(std::size_t, std::size_t)>& body);
+    unsigned workerCount() const { return static_cast<unsigned>(threads.size()); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    bool popOrSteal(unsigned self, std::function<void()>& out);
+
+    std::vector<std::unique_ptr<Queue>> queues;   // [0, workers) per worker, last is injection
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{ 0 };
+    std::atomic<bool> stopping{ false };
+};
+
+// Bitmask of the data a system reads or writes; the meaning of each bit is
+// up to the caller.
+using AccessMask = uint32_t;
+
+// Runs a fixed set of systems once per tick. The scheduler orders systems by
+// their declared accesses: a later-registered system depends on an earlier
+// one when either writes something the other touches. The graph is built on
+// the first tick after a system is added and reused after that. Independent
+// systems run concurrently on the pool; in deterministic mode everything runs
+// serially in registration order on the calling thread, for replays.
+class Scheduler {
+public:
+    struct SystemStats {
+        std::string name;
+        double lastMs = 0.0;
+        double avgMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    explicit Scheduler(unsigned workerCount);
+
+    void add(const std::string& name, AccessMask reads, AccessMask writes, std::function<void(float)> run);
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+    bool isDeterministic() const { return deterministic; }
+
+    void tick(float dt);
+
+    const std::vector<SystemStats>& stats() const { return systemStats; }
+    double lastTickMs() const { return tickMs; }
+    // Longest dependency chain of the last tick, weighted by measured time.
+    double criticalPathMs() const { return criticalMs; }
+    void report(std::ostream& out) const;
+
+    WorkStealingPool& threadPool() { return pool; }
+
+private:
+    struct System {
+        std::string name;
+        AccessMask reads = 0;
+        AccessMask writes = 0;
+        std::function<void(float)> run;
+        int perfRegion = -1;
+    };
+
+    void buildGraph();
+    void runParallel();
+    void launch(std::size_t index);
+    void runSystem(std::size_t index);
+
+    WorkStealingPool pool;
+    std::vector<System> systems;
+    std::vector<SystemStats> systemStats;
+    std::vector<std::vector<std::size_t>> successors;
+    std::vector<std::size_t> predecessorCount;
+    // One pool task per system, made with the graph; each captures only its
+    // index so copying it into the pool never allocates.
+    std::vector<std::function<void()>> tasks;
+    std::unique_ptr<std::atomic<int>[]> pendingPredecessors;
+    std::vector<double> startMs;
+    std::vector<double> durationMs;
+    std::vector<double> longestMs;
+    std::atomic<int> remaining{ 0 };
+    std::chrono::steady_clock::time_point tickStart;
+    float tickDt = 0.0f;
+    bool graphBuilt = false;
+    bool deterministic = false;
+    double tickMs = 0.0;
+    double criticalMs = 0.0;
+    uint64_t tickCount = 0;
+};
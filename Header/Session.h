@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Machine.h"
+
+// Recorded input session: the player machine's per-tick input and every
+// click, enough to step a freshly started game through the same ticks.
+// Clicks are applied before the tick they are stamped with, which is where
+// the main loop lands them. Host byte order, like the other record formats.
+constexpr uint32_t kSessionMagic = 0x4E534C43;   // "CLSN"
+constexpr uint32_t kSessionVersion = 1;
+
+enum SessionKeys : uint8_t {
+    SessionLeft = 1u << 0,
+    SessionRight = 1u << 1,
+    SessionDown = 1u << 2,
+    SessionUp = 1u << 3
+};
+
+struct SessionTick {
+    float dt;
+    float mouseX, mouseY;   // Cursor in GL coordinates
+    uint8_t keys;           // SessionKeys
+    uint8_t reserved[3];
+};
+static_assert(sizeof(SessionTick) == 16, "SessionTick layout changed");
+
+struct SessionClick {
+    uint32_t tick;          // Index of the tick the click comes before
+    float x, y;
+};
+static_assert(sizeof(SessionClick) == 12, "SessionClick layout changed");
+
+struct SessionFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ticks;
+    uint32_t clicks;
+};
+
+struct Session {
+    std::vector<SessionTick> ticks;
+    std::vector<SessionClick> clicks;
+};
+
+uint8_t packSessionKeys(const InputState& input);
+InputState unpackSessionKeys(uint8_t keys);
+
+// Drops everything from tick onwards, for when the rewind debugger rewrites
+// history.
+void truncateSession(Session& s, uint32_t tick);
+
+bool saveSession(const std::string& path, const Session& s);
+bool loadSession(const std::string& path, Session& s);
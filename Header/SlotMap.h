@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Generational handle into a SlotMap. Once the object is erased the slot's
+// generation moves on, so an old handle stops resolving instead of silently
+// aliasing whatever is spawned into the same slot later.
+struct SlotHandle {
+    uint32_t index = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == 0xFFFFFFFFu; }
+    bool operator==(const SlotHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const SlotHandle& o) const { return !(*this == o); }
+};
+
+// Fixed-capacity slot map: O(1) insert/erase/lookup, no heap allocation, and
+// live values kept densely packed so iteration never visits dead slots.
+// Erase swap-removes, so it reorders the dense range and must not be called
+// while iterating over it.
+template <typename T, std::size_t Capacity>
+class SlotMap {
+public:
+    static constexpr uint32_t kNoIndex = 0xFFFFFFFFu;
+
+    SlotMap() { reset(); }
+
+    SlotHandle insert(const T& value)
+    {
+        if (freeHead == kNoIndex) return SlotHandle{};
+        uint32_t slotIndex = freeHead;
+        Slot& slot = slots[slotIndex];
+        freeHead = slot.nextFree;
+
+        uint32_t dense = static_cast<uint32_t>(count++);
+        values[dense] = value;
+        denseToSlot[dense] = slotIndex;
+        slot.denseIndex = dense;
+        slot.nextFree = kNoIndex;
+        return SlotHandle{ slotIndex, slot.generation };
+    }
+
+    bool erase(SlotHandle h)
+    {
+        if (!contains(h)) return false;
+        Slot& slot = slots[h.index];
+        uint32_t dense = slot.denseIndex;
+        uint32_t last = static_cast<uint32_t>(count - 1);
+        if (dense != last) {
+            values[dense] = values[last];
+            denseToSlot[dense] = denseToSlot[last];
+            slots[denseToSlot[dense]].denseIndex = dense;
+        }
+        --count;
+
+        slot.denseIndex = kNoIndex;
+        slot.generation++;
+        slot.nextFree = freeHead;
+        freeHead = h.index;
+        return true;
+    }
+
+    // Removes every live value; outstanding handles all become stale.
+    void clear()
+    {
+        while (count > 0) {
+            uint32_t slotIndex = denseToSlot[count - 1];
+            erase(SlotHandle{ slotIndex, slots[slotIndex].generation });
+        }
+    }
+
+    bool contains(SlotHandle h) const
+    {
+        if (h.index >= Capacity) return false;
+        const Slot& slot = slots[h.index];
+        return slot.generation == h.generation && slot.denseIndex != kNoIndex;
+    }
+
+    T* get(SlotHandle h) { return contains(h) ? &values[slots[h.index].denseIndex] : nullptr; }
+    const T* get(SlotHandle h) const { return contains(h) ? &values[slots[h.index].denseIndex] : nullptr; }
+
+    // Handle of the value at a dense position, for iteration that needs ids.
+    SlotHandle handleAt(std::size_t dense) const
+    {
+        uint32_t slotIndex = denseToSlot[dense];
+        return SlotHandle{ slotIndex, slots[slotIndex].generation };
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    T* begin() { return values.data(); }
+    T* end() { return values.data() + count; }
+    const T* begin() const { return values.data(); }
+    const T* end() const { return values.data() + count; }
+
+private:
+    struct Slot {
+        uint32_t generation = 1;
+        uint32_t denseIndex = kNoIndex;
+        uint32_t nextFree = kNoIndex;
+    };
+
+    void reset()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots[i].generation = 1;
+            slots[i].denseIndex = kNoIndex;
+            slots[i].nextFree = (i + 1 < Capacity) ? static_cast<uint32_t>(i + 1) : kNoIndex;
+        }
+        freeHead = Capacity > 0 ? 0 : kNoIndex;
+        count = 0;
+    }
+
+    std::array<T, Capacity> values{};
+    std::array<uint32_t, Capacity> denseToSlot{};
+    std::array<Slot, Capacity> slots{};
+    uint32_t freeHead = kNoIndex;
+    std::size_t count = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Machine.h"
+
+// Versioned, fixed-layout snapshot of everything that evolves in a Machine.
+// The struct has no padding and no pointers, so it is written with a single
+// memcpy and a received buffer can be read in place through viewSnapshot().
+// Layout constants (hole, prize, token slot) and textures are not stored;
+// textures are recorded as an index into MachineTextures. Host byte order.
+constexpr uint32_t kSnapshotMagic = 0x57414C43;  // "CLAW"
+constexpr uint16_t kSnapshotVersion = 3;   // 3: rngDraws counts Philox draws, not mt19937
+constexpr int kSnapshotMaxToys = 8;
+constexpr uint8_t kSnapshotNoToy = 0xFF;
+
+enum SnapshotFlags : uint8_t {
+    SnapClawOpen = 1u << 0,
+    SnapClawMovingDown = 1u << 1,
+    SnapClawMovingUp = 1u << 2,
+    SnapPrizeHasToy = 1u << 3,
+    SnapSWasDown = 1u << 4,
+    SnapPendingPrizeClick = 1u << 5,
+    SnapLampBlinkOn = 1u << 6
+};
+
+struct SnapshotToy {
+    float x, y, w, h;
+    float vx, vy, gravity;
+    uint8_t state;        // ToyState
+    uint8_t textureSlot;  // 0..2 = toyA..toyC
+    uint8_t layer;
+    uint8_t simulate;
+};
+
+struct MachineSnapshot {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t tick;
+    uint32_t rngSeed;
+    uint64_t rngDraws;      // Restored in O(1): the generator is counter-based
+    uint8_t gameState;
+    uint8_t lampMode;
+    uint8_t flags;
+    uint8_t toyCount;
+    uint8_t grabbedToy;   // Index into toys, or kSnapshotNoToy
+    uint8_t fallingToy;
+    uint8_t prizeToy;
+    uint8_t nextSpawnSlot;
+    float lampTimer;        // Seconds into the lamp's blink cycle
+    float clawX;
+    float clawY;
+    float ropeLength;
+    float prizePulseTime;   // Seconds into the prize glow's pulse cycle
+    float clawPosX;         // Swinging claw, and where it was a tick earlier
+    float clawPosY;
+    float clawPrevX;
+    float clawPrevY;
+    uint32_t reserved;
+    SnapshotToy toys[kSnapshotMaxToys];
+};
+
+static_assert(sizeof(SnapshotToy) == 32, "SnapshotToy layout changed");
+static_assert(sizeof(MachineSnapshot) == 72 + 32 * kSnapshotMaxToys, "MachineSnapshot layout changed; bump kSnapshotVersion");
+
+// Fills out from m. Unused bytes are zeroed so equal states give equal bytes.
+void captureSnapshot(const Machine& m, uint32_t tick, MachineSnapshot& out);
+// Rebuilds m's gameplay state and toys from s; the static scene is kept.
+// False, with m untouched, if s is not a snapshot of this version or holds
+// an out-of-range game state, lamp mode, toy state or layer.
+bool restoreSnapshot(Machine& m, const MachineSnapshot& s);
+// Zero-copy view over a buffer, or nullptr if it is not a snapshot of this
+// version or is misaligned.
+const MachineSnapshot* viewSnapshot(const void* data, std::size_t size);
+
+// Delta coding: the snapshot is XORed with a base and the result is stored as
+// (zero run, literal length, literal bytes) groups with varint lengths.
+// Unchanged fields cost nothing; a keyframe is a delta against all zeroes.
+void encodeDelta(const MachineSnapshot& base, const MachineSnapshot& current, std::vector<uint8_t>& out);
+bool decodeDelta(const MachineSnapshot& base, const uint8_t* data, std::size_t size, MachineSnapshot& out);
+void encodeKeyframe(const MachineSnapshot& current, std::vector<uint8_t>& out);
+bool decodeKeyframe(const uint8_t* data, std::size_t size, MachineSnapshot& out);
+
+// 64-bit FNV-1a over the snapshot's bytes. With Machine::fixedPoint set, the
+// same inputs give the same hash on every build, so a hash per tick shows
+// the first tick at which two replays part.
+uint64_t snapshotHash(const MachineSnapshot& s);
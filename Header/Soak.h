@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Machine.h"
+#include "Philox.h"
+#include "Util.h"
+
+// Autoplay bot for soak runs. It plays the way a person does: it looks at
+// the machine, waits a reaction time, then clicks the token slot or the prize
+// and holds A, D, S and W. The caller feeds its clicks and keys through the
+// game's own input handling, so a soak covers the same path as a player.
+enum class BotStrategy {
+    Skilled,     // Lines up on a resting toy, waits for the swing to settle, carries it to the hole
+    Impatient,   // Drops without waiting, clicks the prize and the slot while the toy is still falling
+    Random,      // Holds random keys and clicks near the slot, near the prize or anywhere
+    Mixed        // One of the others per play; a random play turns skilled after a while
+};
+
+const char* botStrategyName(BotStrategy s);
+bool parseBotStrategy(const std::string& name, BotStrategy& out);
+
+// One tick of input.
+struct BotAction {
+    InputState keys;
+    Vec2 mouse{ 0.0f, 0.0f };
+    bool click = false;   // Left click at mouse before the tick
+};
+
+struct BotPlayer {
+    BotStrategy strategy = BotStrategy::Mixed;
+    BotStrategy playing = BotStrategy::Skilled;   // This play's strategy
+    PhiloxRng rng{ 1 };   // Reseeded by initBot
+    GameState seen = GameState::Idle;   // State the current reaction time is for
+    float wait = 0.0f;         // Reaction time left before the bot acts on seen
+    float playTime = 0.0f;     // Seconds since the coin went in
+    float targetX = 0.0f;
+    float holdS = 0.0f;        // Seconds S stays down
+    InputState held;           // Random play: keys held until holdTime runs out
+    float holdTime = 0.0f;
+    float clickTime = 0.0f;    // Impatient and random plays: seconds to the next extra click
+    Vec2 mouse{ 0.0f, 0.0f };
+};
+
+void initBot(BotPlayer& b, BotStrategy strategy, uint32_t seed);
+// Decides this tick's input from what is on screen; does not touch m.
+BotAction driveBot(const Machine& m, BotPlayer& b, float dt);
+
+struct SoakOptions {
+    double days = 1.0;              // Simulated days to play
+    BotStrategy strategy = BotStrategy::Mixed;
+    uint32_t seed = 1;
+    int renderEvery = 75;           // Draw every Nth tick; 0 never draws
+    float driftLimit = 1.5f;        // Fail when a window's median cost passes the first window's by this factor
+    double rssLimitMB = 32.0;       // Fail when resident memory grows by more than this after the first window
+    float stuckSeconds = 120.0f;    // Fail when Idle, ToyFalling or PrizeWaiting, or a pending prize click, lasts longer
+    float playSeconds = 900.0f;     // Fail when one coin lasts longer; not checked for random bots
+    std::string reportPath;         // CSV with one row per window
+};
+
+// Resident set size of the process; 0 where the OS does not say.
+int64_t residentBytes();
+
+// One stretch of a soak run: costs are medians over the stretch, memory and
+// GL objects are as at its end.
+struct SoakWindow {
+    double simSeconds = 0.0;     // Simulated time at the end
+    double wallSeconds = 0.0;    // Wall time at the end
+    double tickUs = 0.0;         // Median wall time per tick, one sample per simulated second
+    double frameMs = 0.0;        // Median drawn frame
+    double frameMaxMs = 0.0;
+    int64_t rssBytes = 0;
+    int64_t heapLive = 0;        // Allocations not yet freed
+    GLObjectCounts gl;
+    uint32_t plays = 0;          // Coins and prizes so far
+    uint32_t prizes = 0;
+};
+
+// Watches the player machine through a soak: wall cost of ticks and frames,
+// memory and GL objects per window, and the game state machine's coverage,
+// dwell times and stuck states. Collects failures as it goes.
+class SoakMonitor {
+public:
+    void begin(const SoakOptions& options, const Machine& m);
+    // After every tick, with the wall time it took.
+    void tick(const Machine& m, float dt, double seconds);
+    void frame(double seconds);
+    // Closes the current window and checks it against the first.
+    void endWindow(const Machine& m, double wallSeconds, const GLObjectCounts& gl);
+    // Checks that the run covered every step of a play.
+    void finish();
+
+    void report(std::ostream& out) const;
+    bool writeCsv(const std::string& path) const;
+    const std::vector<std::string>& failures() const { return failed; }
+    double simSeconds() const { return simulated; }
+
+private:
+    static constexpr int kStates = 5;
+    void fail(const std::string& what);
+
+    SoakOptions opts;
+    double simulated = 0.0;
+    GameState state = GameState::Idle;
+    double stateSince = 0.0;
+    double playSince = 0.0;
+    double pendingSince = -1.0;          // Simulated time pendingPrizeClick was set, or -1
+    std::array<uint64_t, kStates> visits{};
+    std::array<double, kStates> maxDwell{};
+    std::array<std::array<uint64_t, kStates>, kStates> transitions{};
+    double maxPlay = 0.0;
+    uint64_t pendingSets = 0;
+    double maxPending = 0.0;
+    double clockStart = 0.0;             // Machine clock at begin()
+    uint32_t reported = 0;               // Checks that have failed, so each is reported once
+
+    double secondCost = 0.0;             // Wall time of this simulated second's ticks
+    int secondTicks = 0;
+    double secondSim = 0.0;
+    std::vector<double> tickSamples;     // This window's per-tick costs, one per simulated second
+    std::vector<double> frameSamples;    // This window's drawn frames
+    std::vector<SoakWindow> windows;
+    std::vector<std::string> failed;
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Snapshot.h"
+
+// Wire format: every message is a StreamHeader followed by `length` bytes of
+// keyframe or delta payload (see Snapshot.h). A delta applies to the snapshot
+// carried by the previous message on the same connection.
+constexpr uint32_t kStreamMagic = 0x50534C43;  // "CLSP"
+
+enum class StreamMessage : uint8_t {
+    Keyframe = 1,
+    Delta = 2
+};
+
+struct StreamHeader {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t length;
+    uint32_t tick;
+};
+static_assert(sizeof(StreamHeader) == 12, "StreamHeader layout changed");
+
+struct StreamEndpoint {
+    std::string socketPath = "/tmp/clawmachine-spectate.sock";
+    int tcpPort = 0;   // > 0 listens on 127.0.0.1:tcpPort instead of the socket path
+};
+
+struct PublisherOptions {
+    StreamEndpoint endpoint;
+    float rateHz = 30.0f;
+    int keyframeInterval = 60;              // Messages between forced keyframes
+    std::size_t maxQueuedBytes = 32 * 1024; // Unsent bytes before a subscriber is demoted
+};
+
+struct PublisherStats {
+    uint64_t published = 0;
+    uint64_t bytesSent = 0;
+    uint64_t dropped = 0;      // Keyframes skipped for subscribers still draining
+    int subscribers = 0;
+    int keyframeOnly = 0;
+};
+
+// Bytes waiting to go to one subscriber, kept message by message so a slow
+// subscriber can be cut back to the message already on the wire.
+struct StreamQueue {
+    std::vector<uint8_t> bytes;
+    std::vector<std::size_t> messageEnds;  // Offsets into bytes of the messages not fully sent
+    std::size_t head = 0;                  // Where the first of those starts
+    std::size_t sent = 0;                  // Bytes already written
+};
+
+void queueMessage(StreamQueue& q, const std::vector<uint8_t>& message);
+inline std::size_t queueUnsent(const StreamQueue& q) { return q.bytes.size() - q.sent; }
+// Records n more bytes as written. Messages that have fully gone are
+// forgotten, and the buffer is compacted once they fill over half of it.
+void queueSent(StreamQueue& q, std::size_t n);
+// Keeps the message partly on the wire and drops the ones behind it.
+// Returns how many were dropped.
+std::size_t queueDropUnstarted(StreamQueue& q);
+
+// Streams one machine's state to local spectators. publish() runs on the
+// simulation thread and only copies a snapshot into a mailbox when one is due
+// and someone is watching. Encoding and all socket I/O happen on the
+// publisher's own thread with edge-triggered epoll. A subscriber that falls
+// more than maxQueuedBytes behind is switched to keyframe-only mode for the
+// rest of its connection, so no spectator can stall the game.
+class SpectatorPublisher {
+public:
+    ~SpectatorPublisher();
+
+    bool start(const PublisherOptions& options);
+    void stop();
+    void publish(const Machine& m, uint32_t tick, float dt);
+    PublisherStats stats() const;
+
+private:
+    struct Subscriber {
+        int fd = -1;
+        StreamQueue queue;
+        bool needsKeyframe = true;
+        bool keyframeOnly = false;
+    };
+
+    void run();
+    void acceptSubscribers();
+    void broadcast(const MachineSnapshot& snap);
+    bool flush(Subscriber& s);
+    void demote(Subscriber& s);
+    void closeSubscriber(std::size_t i);
+    Subscriber* findSubscriber(int fd);
+
+    PublisherOptions opts;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread worker;
+    std::atomic<bool> running{ false };
+
+    // Simulation thread -> publisher thread.
+    std::mutex mailboxMutex;
+    MachineSnapshot mailbox{};
+    bool mailboxFull = false;
+    float sinceLastPublish = 0.0f;
+
+    // Publisher thread only.
+    std::vector<Subscriber> subscribers;
+    MachineSnapshot lastSnapshot{};
+    bool haveLast = false;
+    int sinceKeyframe = 0;
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> keyframeMessage;
+    std::vector<uint8_t> deltaMessage;
+
+    std::atomic<uint64_t> publishedCount{ 0 };
+    std::atomic<uint64_t> bytesSent{ 0 };
+    std::atomic<uint64_t> droppedCount{ 0 };
+    std::atomic<int> subscriberCount{ 0 };
+    std::atomic<int> keyframeOnlyCount{ 0 };
+};
+
+// Receiving end used by the spectator viewer. Never blocks after connect().
+class SpectatorClient {
+public:
+    ~SpectatorClient();
+
+    bool connect(const StreamEndpoint& endpoint);
+    // Applies every complete message that has arrived. Returns the number of
+    // snapshots applied, or -1 once the publisher has gone away.
+    int poll();
+
+    bool hasState() const { return haveState; }
+    const MachineSnapshot& state() const { return current; }
+    uint64_t keyframes() const { return keyframeCount; }
+    uint64_t deltas() const { return deltaCount; }
+
+private:
+    int fd = -1;
+    std::vector<uint8_t> buffer;
+    MachineSnapshot current{};
+    bool haveState = false;
+    uint64_t keyframeCount = 0;
+    uint64_t deltaCount = 0;
+};
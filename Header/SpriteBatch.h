@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Components.h"
+#include "Registry.h"
+
+struct SpriteInstance {
+    float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+    float rotation = 0.0f;
+    float animCurve = 0.0f, animStart = 0.0f, animPeriod = 1.0f, animAmplitude = 0.0f;   // SpriteAnim
+    float toR = 1.0f, toG = 1.0f, toB = 1.0f, toA = 1.0f;
+};
+
+// World-to-NDC mapping: ndc = (world - center) * scale.
+struct ViewTransform {
+    Vec2 center{ 0.0f, 0.0f };
+    Vec2 scale{ 1.0f, 1.0f };
+};
+
+// Collects sprites from any number of registries and draws them with one
+// instanced draw per (layer, texture) bucket, so the draw count does not grow
+// with the number of machines. Flat-color sprites sample a 1x1 white texture.
+class SpriteBatch {
+public:
+    bool init();
+
+    // time is the machines' clock; sprite animation starts are relative to
+    // its animationEpoch().
+    void begin(double time = 0.0);
+    // Queues every visible sprite of a registry, scaled about the local
+    // origin and then moved to offset.
+    void addRegistry(Registry& reg, const Vec2& offset, float scale);
+    void addInstance(unsigned int texture, int layer, const SpriteInstance& inst);
+    void flush(const ViewTransform& view);
+
+    int lastDrawCalls() const { return drawCalls; }
+    std::size_t lastInstanceCount() const { return instanceCount; }
+
+private:
+    struct Bucket {
+        unsigned int texture = 0;
+        std::vector<SpriteInstance> items;
+    };
+
+    std::vector<SpriteInstance>& bucketFor(unsigned int texture, int layer);
+
+    std::array<std::vector<Bucket>, kLayerCount> layers;
+    std::vector<SpriteInstance> staging;
+    unsigned int shader = 0;
+    unsigned int vao = 0;
+    unsigned int instanceVBO = 0;
+    std::size_t vboCapacity = 0;
+    unsigned int whiteTexture = 0;
+    float animTime = 0.0f;   // uTime: animationClock() of the time passed to begin()
+    int drawCalls = 0;
+    std::size_t instanceCount = 0;
+};
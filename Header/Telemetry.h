@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Per-play analytics. Gameplay code appends PlayEvents to its machine (see
+// Machine::playEvents); the owner of the machine drains them into a
+// TelemetryLog between ticks, so capture never locks or touches the disk.
+enum class PlayEventType : uint8_t {
+    Start = 1,   // Coin in; value 0
+    Drop,        // value: seconds from start to this drop
+    Grab,        // flag: toy caught; value: claw x
+    Release,     // value: claw x
+    Landing,     // flag: toy went into the hole; value: seconds since release
+    Collect,     // value: seconds from prize ready to collection
+    Count
+};
+
+struct PlayEvent {
+    PlayEventType type;
+    uint8_t flag;
+    uint32_t play;    // Play number on this machine
+    float time;       // Machine clock, seconds
+    float value;
+};
+
+const char* playEventName(PlayEventType type);
+
+// File layout: a 64-byte header, then chunks. Each chunk is a 64-byte header
+// followed by its columns, each padded to 64 bytes so a mapped file can be
+// scanned column by column with aligned loads:
+//   uint32 machine[n], uint32 play[n], float time[n], float value[n],
+//   uint8 type[n], uint8 flag[n]
+constexpr uint32_t kTelemetryMagic = 0x4C544C43;       // "CLTL"
+constexpr uint32_t kTelemetryChunkMagic = 0x4B4E4843;  // "CHNK"
+constexpr uint32_t kTelemetryVersion = 1;
+constexpr uint32_t kTelemetryChunkEvents = 1u << 16;
+
+struct TelemetryFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t startUnixMs;
+    uint8_t reserved[48];
+};
+static_assert(sizeof(TelemetryFileHeader) == 64, "TelemetryFileHeader layout changed");
+
+struct TelemetryChunkHeader {
+    uint32_t magic;
+    uint32_t count;
+    uint64_t bytes;       // Column bytes following this header
+    uint8_t reserved[48];
+};
+static_assert(sizeof(TelemetryChunkHeader) == 64, "TelemetryChunkHeader layout changed");
+
+// Offsets of each column from the end of a chunk header.
+struct TelemetryColumns {
+    std::size_t machine, play, time, value, type, flag, bytes;
+};
+TelemetryColumns telemetryColumns(uint32_t count);
+
+// Append-only writer. Events are buffered column-wise and written a whole
+// chunk at a time, when a chunk fills and on close.
+class TelemetryLog {
+public:
+    ~TelemetryLog();
+
+    bool open(const std::string& path, uint32_t chunkEvents = kTelemetryChunkEvents);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    void append(uint32_t machine, const PlayEvent& e);
+    void append(uint32_t machine, std::vector<PlayEvent>& events);  // Drains events
+    void flush();
+
+    uint64_t eventsWritten() const { return written; }
+
+private:
+    std::FILE* file = nullptr;
+    uint32_t capacity = 0;
+    uint64_t written = 0;
+    std::vector<uint32_t> machines;
+    std::vector<uint32_t> plays;
+    std::vector<float> times;
+    std::vector<float> values;
+    std::vector<uint8_t> types;
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> chunk;
+};
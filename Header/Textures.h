@@ -0,0 +1,23 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Machine.h"
+
+// Procedural RGBA images, row 0 first.
+std::vector<unsigned char> makeCircleTexture(int size, const std::array<unsigned char, 4>& fill);
+std::vector<unsigned char> makeRingTexture(int size, const std::array<unsigned char, 4>& inner, const std::array<unsigned char, 4>& outer);
+std::vector<unsigned char> makeToyTextureDots(int size);
+std::vector<unsigned char> makeToyTextureStripes(int size);
+std::vector<unsigned char> makeToyTextureChecks(int size);
+std::vector<unsigned char> makeCoinTexture(int size);
+std::vector<unsigned char> makeLeverTexture(int size);
+std::unordered_map<char, std::array<uint8_t, 7>> fontGlyphs();
+std::vector<unsigned char> makeLabelTexture(int width, int height, const std::string& text);
+
+// Uploads the toy and hole textures every machine shares. Needs a current GL
+// context.
+MachineTextures createMachineTextures();
@@ -1,11 +1,38 @@
 #pragma once
-#include <GL/glew.h>
+#include "GLTrace.h"
 #include <GLFW/glfw3.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 int endProgram(const std::string& message);
 unsigned int createShader(const char* vsSource, const char* fsSource);
+// Vertex-only program whose outputs are captured with transform feedback,
+// interleaved in the order given. Returns 0 if it does not link.
+unsigned int createFeedbackShader(const char* vsSource, const std::vector<const char*>& varyings);
 unsigned int loadImageToTexture(const char* filePath);
 unsigned int createTextureFromRGBA(const std::vector<unsigned char>& data, int width, int height);
 GLFWcursor* loadImageToCursor(const char* filePath);
+// Running total of texture storage allocated through these helpers; code
+// that creates or deletes textures itself reports them here.
+void trackTextureMemory(int64_t bytes);
+int64_t textureMemoryBytes();
+// Running total of GL draw calls. Every draw path counts its own right where
+// it issues them, so the total covers bloom, particles and batches alike.
+void countDrawCalls(uint64_t calls = 1);
+uint64_t drawCallsIssued();
+
+// Live GL objects by kind, found by asking glIs* about every name up to
+// maxName. Costs a few thousand calls; meant for occasional leak checks.
+struct GLObjectCounts {
+    int textures = 0;
+    int buffers = 0;
+    int vertexArrays = 0;
+    int framebuffers = 0;
+    int renderbuffers = 0;
+    int programs = 0;
+    int shaders = 0;
+    int queries = 0;
+    int total() const { return textures + buffers + vertexArrays + framebuffers + renderbuffers + programs + shaders + queries; }
+};
+GLObjectCounts countGLObjects(unsigned int maxName = 4096);
@@ -0,0 +1,85 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Gameplay clip recorder. Each frame's back buffer is read into one of a
+// ring of pixel pack buffers with a fence; the buffer is mapped a frame or
+// two later, once the fence says the copy is done, so the render thread
+// never waits for the GPU. The encoder thread converts straight out of the
+// mapped buffer and hands it back to be unmapped, so the render thread never
+// copies pixels either. Output is a Y4M file or a directory of PPM frames.
+// When the GPU or the encoder falls behind, frames are dropped rather than
+// stalling the game.
+struct VideoOptions {
+    std::string path;    // *.y4m: one Y4M file (4:2:0); anything else: a directory of PPM frames
+    int scale = 1;       // 1, 2 or 4: downscale on the GPU before readback
+    int fps = 75;        // Frame rate written to the Y4M header
+};
+
+struct VideoStats {
+    uint64_t captured = 0;   // Readbacks issued
+    uint64_t written = 0;    // Frames the encoder wrote
+    uint64_t dropped = 0;    // GPU or encoder was behind
+    uint64_t bytes = 0;
+    double avgCaptureMs = 0.0;   // Render thread time per capture() call
+    double maxCaptureMs = 0.0;
+};
+
+class VideoRecorder {
+public:
+    ~VideoRecorder();
+
+    // Records the default framebuffer of width x height.
+    bool start(const VideoOptions& options, int width, int height);
+    // Call once a frame is drawn and before the swap.
+    void capture();
+    // Collects the frames still in flight and waits for the encoder.
+    void stop();
+    bool recording() const { return active; }
+    VideoStats stats() const;
+
+private:
+    static constexpr int kRing = 4;
+
+    enum class SlotState { Free, Reading, Mapped, Written };
+    struct Slot {
+        unsigned int pbo = 0;
+        void* fence = nullptr;   // GLsync while Reading
+        const unsigned char* pixels = nullptr;   // While Mapped
+        SlotState state = SlotState::Free;
+    };
+
+    void releaseWritten();
+    void collect(int slot);
+    void encodeLoop();
+    bool writeFrame(const unsigned char* rgba);
+
+    VideoOptions opts;
+    bool active = false;
+    bool y4m = false;
+    int srcWidth = 0, srcHeight = 0;
+    int width = 0, height = 0;   // Recorded size: scaled and even for 4:2:0
+    unsigned int downscaleFbo = 0, downscaleRbo = 0;
+    Slot slots[kRing];
+    std::deque<int> reading;     // Slots with a readback in flight, oldest first
+    std::FILE* out = nullptr;
+    uint64_t frameIndex = 0;
+    std::vector<unsigned char> yuv;
+    std::vector<unsigned char> rgb;
+
+    std::thread encoder;
+    mutable std::mutex mutex;    // Guards slot states past Reading, the queue and the counters
+    std::condition_variable wake;
+    std::deque<int> queue;       // Mapped slots for the encoder
+    bool finishing = false;
+
+    uint64_t captured = 0, written = 0, dropped = 0, bytes = 0;
+    double captureMsTotal = 0.0, captureMsMax = 0.0;
+    uint64_t captureCalls = 0;
+};
@@ -0,0 +1,182 @@
+#include "../Header/Bloom.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "../Header/Renderer.h"
+#include "../Header/Util.h"
+
+Bloom::~Bloom()
+{
+    shutdown();
+}
+
+bool Bloom::init(const BloomOptions& options, int screenWidth, int screenHeight)
+{
+    shutdown();
+    opts = options;
+    if (opts.divisor <= 0) return true;
+    opts.divisor = opts.divisor >= 4 ? 4 : opts.divisor >= 2 ? 2 : 1;
+    opts.passes = std::clamp(opts.passes, 1, 8);
+    width = std::max(1, screenWidth / opts.divisor);
+    height = std::max(1, screenHeight / opts.divisor);
+
+    bool complete = true;
+    glGenTextures(2, textures);
+    glGenFramebuffers(2, framebuffers);
+    for (int i = 0; i < 2; ++i) {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        trackTextureMemory(int64_t(width) * height * 4);
+        // Linear filtering is what lets the blur and the upscale share taps.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[i], 0);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    blurShader = createShader("Source/Shaders/fullscreen.vert", "Source/Shaders/bloom_blur.frag");
+    compositeShader = createShader("Source/Shaders/fullscreen.vert", "Source/Shaders/bloom_composite.frag");
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVertexBuffer());
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glGenQueries(kQueries, queries);
+
+    if (!complete || blurShader == 0 || compositeShader == 0) {
+        std::printf("[BLOOM] %dx%d target unavailable; glow disabled\n", width, height);
+        shutdown();
+        return false;
+    }
+    return true;
+}
+
+void Bloom::shutdown()
+{
+    if (framebuffers[0]) {
+        glDeleteFramebuffers(2, framebuffers);
+        glDeleteTextures(2, textures);
+        trackTextureMemory(-2 * int64_t(width) * height * 4);
+        glDeleteQueries(kQueries, queries);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(blurShader);
+        glDeleteProgram(compositeShader);
+    }
+    for (int i = 0; i < 2; ++i) framebuffers[i] = textures[i] = 0;
+    for (int i = 0; i < kQueries; ++i) {
+        queries[i] = 0;
+        pending[i] = false;
+    }
+    vao = blurShader = compositeShader = 0;
+    nextQuery = 0;
+    timing = false;
+    timed = 0;
+    gpuMsTotal = gpuMsMax = 0.0;
+}
+
+// Reads back every timer the GPU has finished with; never waits.
+void Bloom::collectQueries()
+{
+    for (int i = 0; i < kQueries; ++i) {
+        if (!pending[i]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+        pending[i] = false;
+        const double ms = double(ns) / 1e6;
+        gpuMsTotal += ms;
+        gpuMsMax = std::max(gpuMsMax, ms);
+        timed++;
+    }
+}
+
+void Bloom::beginEmissive()
+{
+    if (!enabled()) return;
+    collectQueries();
+    // A timer still in flight from kQueries frames ago means the GPU is far
+    // behind; skip timing this frame rather than reuse it.
+    timing = !pending[nextQuery];
+    if (timing) glBeginQuery(GL_TIME_ELAPSED, queries[nextQuery]);
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[0]);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void Bloom::apply()
+{
+    if (!enabled()) return;
+    glDisable(GL_BLEND);
+    glBindVertexArray(vao);
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(blurShader);
+    glUniform1i(glGetUniformLocation(blurShader, "uTex"), 0);
+    const GLint stepLoc = glGetUniformLocation(blurShader, "uStep");
+    // Ping-pong: horizontal into the second target, vertical back into the first.
+    for (int pass = 0; pass < opts.passes; ++pass) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[1]);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glUniform2f(stepLoc, 1.0f / width, 0.0f);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[0]);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+        glUniform2f(stepLoc, 0.0f, 1.0f / height);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        countDrawCalls(2);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glUseProgram(compositeShader);
+    glUniform1i(glGetUniformLocation(compositeShader, "uTex"), 0);
+    glUniform1f(glGetUniformLocation(compositeShader, "uStrength"), opts.strength);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    countDrawCalls();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(0);
+
+    if (timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[nextQuery] = true;
+        nextQuery = (nextQuery + 1) % kQueries;
+    }
+}
+
+BloomStats Bloom::stats() const
+{
+    BloomStats s;
+    s.width = width;
+    s.height = height;
+    s.timed = timed;
+    s.avgGpuMs = timed > 0 ? gpuMsTotal / double(timed) : 0.0;
+    s.maxGpuMs = gpuMsMax;
+    return s;
+}
+
+void Bloom::report(std::ostream& out) const
+{
+    if (!enabled()) return;
+    BloomStats s = stats();
+    char line[160];
+    std::snprintf(line, sizeof(line), "[BLOOM] %dx%d target (1/%d), %d blur passes: GPU avg %.3f ms max %.3f ms over %llu frames\n",
+        s.width, s.height, opts.divisor, opts.passes, s.avgGpuMs, s.maxGpuMs, static_cast<unsigned long long>(s.timed));
+    out << line;
+}
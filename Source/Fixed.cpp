@@ -0,0 +1,44 @@
+#include "../Header/Fixed.h"
+
+// Bit by bit, one result bit per round: 32 rounds of shifts, compares and
+// subtracts, with no floating point anywhere.
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t result = 0;
+    uint64_t bit = uint64_t(1) << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(result);
+}
+
+Fixed fixedLength(const FixedVec2& v)
+{
+    // Raw squares are Q32.32, so their root is Q16.16 as it stands.
+    const int64_t x = v.x.raw, y = v.y.raw;
+    const uint64_t r = isqrt64(uint64_t(x * x) + uint64_t(y * y));
+    return Fixed{ static_cast<int32_t>(r > uint64_t(INT32_MAX) ? uint64_t(INT32_MAX) : r) };
+}
+
+void fixedAdd(const int32_t* a, const int32_t* b, int32_t* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) out[i] = fixedAdd(Fixed{ a[i] }, Fixed{ b[i] }).raw;
+}
+
+void fixedMul(const int32_t* a, const int32_t* b, int32_t* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) out[i] = fixedMul(Fixed{ a[i] }, Fixed{ b[i] }).raw;
+}
+
+void fixedMulAdd(int32_t* acc, const int32_t* v, Fixed k, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) acc[i] = fixedAdd(Fixed{ acc[i] }, fixedMul(Fixed{ v[i] }, k)).raw;
+}
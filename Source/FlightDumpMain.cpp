@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include "../Header/FlightRecorder.h"
+#include "../Header/Machine.h"
+
+// Offline decoder for the flight recorder file. Prints the events of the last
+// N seconds, frames that took too long, and a per-second frame time summary.
+// Works on the file of a crashed process or of one still running.
+
+struct DumpOptions {
+    std::string path = "/tmp/clawmachine-flight.bin";
+    double seconds = 10.0;
+    float hitchMs = 25.0f;   // Frames with a longer dt are listed as events
+    bool frames = false;     // List every frame instead of per-second summaries
+};
+
+DumpOptions parseArgs(int argc, char** argv)
+{
+    DumpOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) opts.seconds = std::atof(argv[++i]);
+        else if (arg == "--hitch" && i + 1 < argc) opts.hitchMs = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--frames") opts.frames = true;
+        else if (!arg.empty() && arg[0] != '-') opts.path = arg;
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    return opts;
+}
+
+std::string wallClock(int64_t unixNs)
+{
+    std::time_t secs = static_cast<std::time_t>(unixNs / 1000000000);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", std::localtime(&secs));
+    return text;
+}
+
+const char* signalName(uint32_t sig)
+{
+    switch (sig) {
+    case 4: return "SIGILL";
+    case 6: return "SIGABRT";
+    case 7: return "SIGBUS";
+    case 8: return "SIGFPE";
+    case 11: return "SIGSEGV";
+    default: return "signal";
+    }
+}
+
+void printEvent(const FlightEntry& e, double at)
+{
+    std::printf("%9.3f s  %-8s ", at, flightEventName(e.type));
+    switch (e.type) {
+    case FlightEvent::Session:
+        std::printf("%s (pid %u)\n", e.code ? "clean shutdown" : "started", e.value);
+        break;
+    case FlightEvent::Frame:
+        std::printf("hitch: dt %.1f ms, work %.1f ms (update %.1f, render %.1f), tick %u\n",
+            e.f[3], e.f[0], e.f[1], e.f[2], e.value);
+        break;
+    case FlightEvent::State:
+        std::printf("%s -> %s\n", gameStateName(static_cast<GameState>(e.code)), gameStateName(static_cast<GameState>(e.value)));
+        break;
+    case FlightEvent::Click:
+        std::printf("#%u (%.3f, %.3f) %s\n", e.value, e.f[0], e.f[1], flightClickName(static_cast<FlightClick>(e.code)));
+        break;
+    case FlightEvent::Collect:
+        std::printf("%s, toy %u\n", e.code ? "prize collected" : "nothing to collect", e.value);
+        break;
+    case FlightEvent::Message:
+        std::printf("%s: %s\n", flightMessageName(static_cast<FlightMessage>(e.code)), e.text.c_str());
+        break;
+    case FlightEvent::Rewind:
+        std::printf("resumed from tick %u\n", e.value);
+        break;
+    case FlightEvent::Crash:
+        std::printf("%s (%u)\n", signalName(e.value), e.value);
+        break;
+    default:
+        std::printf("type %u code %u value %u\n", unsigned(e.type), e.code, e.value);
+        break;
+    }
+}
+
+struct FrameSummary {
+    int frames = 0;
+    double dtSum = 0.0;
+    float dtMax = 0.0f;
+    double updateSum = 0.0;
+    double renderSum = 0.0;
+};
+
+int main(int argc, char** argv)
+{
+    DumpOptions opts = parseArgs(argc, argv);
+    FlightLog log;
+    if (!readFlightLog(opts.path, log)) {
+        std::cout << "Could not read a flight recorder file at " << opts.path << std::endl;
+        return -1;
+    }
+
+    std::printf("[FLIGHT] %s: pid %u, opened %s, %llu records written, %zu readable\n",
+        opts.path.c_str(), log.pid, wallClock(log.startUnixNs).c_str(),
+        static_cast<unsigned long long>(log.written), log.entries.size());
+    if (log.entries.empty()) return 0;
+
+    const FlightEntry& newest = log.entries.back();
+    const uint64_t endNs = newest.timeNs;
+    const uint64_t windowNs = static_cast<uint64_t>(opts.seconds * 1e9);
+    const uint64_t fromNs = endNs > windowNs ? endNs - windowNs : 0;
+    bool clean = newest.type == FlightEvent::Session && newest.code == 1;
+    std::printf("[FLIGHT] last record at %s (%.3f s after open), %s\n",
+        wallClock(log.startUnixNs + int64_t(endNs)).c_str(), endNs / 1e9,
+        clean ? "clean shutdown" : "no clean shutdown recorded");
+    std::printf("[FLIGHT] events of the last %.1f s (times relative to the last record):\n", opts.seconds);
+
+    auto firstInWindow = std::find_if(log.entries.begin(), log.entries.end(),
+        [&](const FlightEntry& e) { return e.timeNs >= fromNs; });
+    for (auto it = firstInWindow; it != log.entries.end(); ++it) {
+        const FlightEntry& e = *it;
+        double at = -double(endNs - e.timeNs) / 1e9;
+        if (e.type != FlightEvent::Frame || e.f[3] > opts.hitchMs) printEvent(e, at);
+    }
+
+    std::printf("[FRAMES] %s:\n", opts.frames ? "every frame" : "per second");
+    FrameSummary bucket;
+    long currentSecond = 0;
+    auto flushBucket = [&]() {
+        if (bucket.frames == 0) return;
+        std::printf("%7ld s  %4d frames  dt avg %5.1f ms max %5.1f ms  update %5.2f ms  render %5.2f ms\n",
+            currentSecond, bucket.frames, bucket.dtSum / bucket.frames, bucket.dtMax,
+            bucket.updateSum / bucket.frames, bucket.renderSum / bucket.frames);
+        bucket = FrameSummary{};
+    };
+    for (auto it = firstInWindow; it != log.entries.end(); ++it) {
+        const FlightEntry& e = *it;
+        if (e.type != FlightEvent::Frame) continue;
+        double at = -double(endNs - e.timeNs) / 1e9;
+        if (opts.frames) {
+            std::printf("%9.3f s  tick %u  dt %5.1f ms  work %5.2f ms (update %5.2f, render %5.2f)\n",
+                at, e.value, e.f[3], e.f[0], e.f[1], e.f[2]);
+            continue;
+        }
+        long second = static_cast<long>(std::floor(at));
+        if (second != currentSecond) {
+            flushBucket();
+            currentSecond = second;
+        }
+        bucket.frames++;
+        bucket.dtSum += e.f[3];
+        bucket.dtMax = std::max(bucket.dtMax, e.f[3]);
+        bucket.updateSum += e.f[1];
+        bucket.renderSum += e.f[2];
+    }
+    flushBucket();
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include "../Header/FlightRecorder.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+std::atomic<FlightHeader*> gHeader{ nullptr };
+FlightRecord* gRecords = nullptr;
+uint64_t gMask = 0;
+std::size_t gMappedBytes = 0;
+std::chrono::steady_clock::time_point gStart;
+
+// Claims the next slot and marks it unpublished. The caller fills it in and
+// calls commit(); nothing here can block or allocate, so it is safe from
+// worker threads and from a signal handler.
+FlightRecord* claim(FlightHeader* h, uint64_t& seq)
+{
+    seq = h->head.fetch_add(1, std::memory_order_relaxed) + 1;
+    FlightRecord* r = &gRecords[(seq - 1) & gMask];
+    r->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    r->timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - gStart).count());
+    return r;
+}
+
+void commit(FlightRecord* r, uint64_t seq)
+{
+    r->sequence.store(seq, std::memory_order_release);
+}
+}
+
+void flightRecord(FlightEvent type, uint16_t code, uint32_t value, float f0, float f1, float f2, float f3)
+{
+    FlightHeader* h = gHeader.load(std::memory_order_acquire);
+    if (!h) return;
+    uint64_t seq;
+    FlightRecord* r = claim(h, seq);
+    r->type = static_cast<uint16_t>(type);
+    r->code = code;
+    r->value = value;
+    std::memset(r->f, 0, sizeof(r->f));
+    r->f[0] = f0;
+    r->f[1] = f1;
+    r->f[2] = f2;
+    r->f[3] = f3;
+    commit(r, seq);
+}
+
+void flightMessage(FlightMessage code, const char* text)
+{
+    FlightHeader* h = gHeader.load(std::memory_order_acquire);
+    if (!h) return;
+    uint64_t seq;
+    FlightRecord* r = claim(h, seq);
+    r->type = static_cast<uint16_t>(FlightEvent::Message);
+    r->code = static_cast<uint16_t>(code);
+    r->value = 0;
+    // Truncated to the slot; the log is for finding where to look, not for
+    // keeping whole shader logs.
+    std::strncpy(r->text, text ? text : "", sizeof(r->text) - 1);
+    r->text[sizeof(r->text) - 1] = '\0';
+    commit(r, seq);
+}
+
+const char* flightEventName(FlightEvent type)
+{
+    switch (type) {
+    case FlightEvent::Session: return "SESSION";
+    case FlightEvent::Frame: return "FRAME";
+    case FlightEvent::State: return "STATE";
+    case FlightEvent::Click: return "CLICK";
+    case FlightEvent::Collect: return "COLLECT";
+    case FlightEvent::Message: return "MESSAGE";
+    case FlightEvent::Rewind: return "REWIND";
+    case FlightEvent::Crash: return "CRASH";
+    default: return "UNKNOWN";
+    }
+}
+
+const char* flightClickName(FlightClick hit)
+{
+    switch (hit) {
+    case FlightClick::Miss: return "miss";
+    case FlightClick::Prize: return "prize";
+    case FlightClick::TokenSlot: return "token slot";
+    case FlightClick::Start: return "token slot, game started";
+    default: return "unknown";
+    }
+}
+
+const char* flightMessageName(FlightMessage code)
+{
+    switch (code) {
+    case FlightMessage::Fatal: return "fatal";
+    case FlightMessage::ShaderRead: return "shader read failed";
+    case FlightMessage::ShaderCompile: return "shader compile failed";
+    case FlightMessage::ProgramValidate: return "program validation failed";
+    case FlightMessage::TextureLoad: return "texture not loaded";
+    case FlightMessage::CursorLoad: return "cursor not loaded";
+    default: return "unknown";
+    }
+}
+
+#ifndef _WIN32
+
+bool openFlightRecorder(const std::string& path, uint32_t records)
+{
+    closeFlightRecorder();
+    uint32_t capacity = 1;
+    while (capacity < records) capacity <<= 1;
+
+    // Keep the previous run's log: after a crash the cabinet is usually
+    // restarted before anyone gets to look at it.
+    std::rename(path.c_str(), (path + ".prev").c_str());
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cout << "[FLIGHT] could not open " << path << std::endl;
+        return false;
+    }
+    std::size_t bytes = sizeof(FlightHeader) + std::size_t(capacity) * sizeof(FlightRecord);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        std::cout << "[FLIGHT] could not size " << path << std::endl;
+        return false;
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cout << "[FLIGHT] could not map " << path << std::endl;
+        return false;
+    }
+
+    // A fresh file reads as zeroes, so every slot starts unpublished.
+    FlightHeader* h = static_cast<FlightHeader*>(base);
+    h->magic = kFlightMagic;
+    h->version = kFlightVersion;
+    h->recordSize = sizeof(FlightRecord);
+    h->capacity = capacity;
+    h->head.store(0, std::memory_order_relaxed);
+    h->startUnixNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    h->pid = static_cast<uint32_t>(getpid());
+
+    gRecords = reinterpret_cast<FlightRecord*>(static_cast<uint8_t*>(base) + sizeof(FlightHeader));
+    gMask = capacity - 1;
+    gMappedBytes = bytes;
+    gStart = std::chrono::steady_clock::now();
+    gHeader.store(h, std::memory_order_release);
+
+    flightRecord(FlightEvent::Session, 0, h->pid);
+    std::cout << "[FLIGHT] recording to " << path << " (" << capacity << " records)" << std::endl;
+    return true;
+}
+
+void closeFlightRecorder()
+{
+    if (FlightHeader* live = gHeader.load(std::memory_order_acquire)) flightRecord(FlightEvent::Session, 1, live->pid);
+    FlightHeader* h = gHeader.exchange(nullptr, std::memory_order_acq_rel);
+    if (!h) return;
+    msync(h, gMappedBytes, MS_SYNC);
+    munmap(h, gMappedBytes);
+    gRecords = nullptr;
+    gMappedBytes = 0;
+}
+
+namespace {
+void onFatalSignal(int sig)
+{
+    flightRecord(FlightEvent::Crash, 0, static_cast<uint32_t>(sig));
+    // SA_RESETHAND restored the default action; let it finish the process.
+    raise(sig);
+}
+}
+
+void installFlightCrashHandler()
+{
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onFatalSignal;
+    sa.sa_flags = SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+    for (int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT }) sigaction(sig, &sa, nullptr);
+}
+
+bool readFlightLog(const std::string& path, FlightLog& out)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(FlightHeader)) {
+        close(fd);
+        return false;
+    }
+    std::size_t bytes = std::size_t(st.st_size);
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    const FlightHeader* h = static_cast<const FlightHeader*>(base);
+    bool valid = h->magic == kFlightMagic && h->version == kFlightVersion && h->recordSize == sizeof(FlightRecord)
+        && h->capacity > 0 && (h->capacity & (h->capacity - 1)) == 0
+        && bytes >= sizeof(FlightHeader) + std::size_t(h->capacity) * sizeof(FlightRecord);
+    if (!valid) {
+        munmap(base, bytes);
+        return false;
+    }
+
+    out.capacity = h->capacity;
+    out.written = h->head.load(std::memory_order_acquire);
+    out.startUnixNs = h->startUnixNs;
+    out.pid = h->pid;
+    out.entries.clear();
+
+    // Only the newest `capacity` sequence numbers can still be in the ring;
+    // anything else is a slot a writer had claimed but not yet published.
+    const uint64_t oldest = out.written > h->capacity ? out.written - h->capacity + 1 : 1;
+    const FlightRecord* records = reinterpret_cast<const FlightRecord*>(static_cast<const uint8_t*>(base) + sizeof(FlightHeader));
+    for (uint64_t seq = oldest; seq <= out.written; ++seq) {
+        const FlightRecord& r = records[(seq - 1) & (h->capacity - 1)];
+        if (r.sequence.load(std::memory_order_acquire) != seq) continue;
+        FlightEntry e;
+        e.sequence = seq;
+        e.timeNs = r.timeNs;
+        e.type = static_cast<FlightEvent>(r.type);
+        e.code = r.code;
+        e.value = r.value;
+        if (e.type == FlightEvent::Message) {
+            e.text.assign(r.text, strnlen(r.text, sizeof(r.text)));
+            std::memset(e.f, 0, sizeof(e.f));
+        }
+        else {
+            std::memcpy(e.f, r.f, sizeof(e.f));
+        }
+        out.entries.push_back(std::move(e));
+    }
+    munmap(base, bytes);
+    return true;
+}
+
+#else
+
+bool openFlightRecorder(const std::string&, uint32_t)
+{
+    std::cout << "[FLIGHT] flight recorder needs mmap (POSIX)" << std::endl;
+    return false;
+}
+
+void closeFlightRecorder() {}
+void installFlightCrashHandler() {}
+bool readFlightLog(const std::string&, FlightLog&) { return false; }
+
+#endif
@@ -0,0 +1,238 @@
+#include "../Header/Floor.h"
+#include "../Header/Hitch.h"
+#include "../Header/PerfCounters.h"
+#include "../Header/Util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+const Vec2 kBoundsCenter = (kMachineBoundsMin + kMachineBoundsMax) * 0.5f;
+const float kImpostorSide = std::max(kMachineBoundsMax.x - kMachineBoundsMin.x, kMachineBoundsMax.y - kMachineBoundsMin.y);
+
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+ArcadeFloor::~ArcadeFloor()
+{
+    if (atlasFramebuffer) glDeleteFramebuffers(1, &atlasFramebuffer);
+    if (atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
+        trackTextureMemory(-int64_t(kAtlasSize) * kAtlasSize * 4);
+    }
+}
+
+bool ArcadeFloor::init(int machineCount, const MachineTextures& textures, SpriteBatch& spriteBatch)
+{
+    batch = &spriteBatch;
+    cabinets.clear();
+    cabinets.resize(std::max(machineCount, 1));
+    int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(cabinets.size()))));
+    for (std::size_t i = 0; i < cabinets.size(); ++i) {
+        Cabinet& c = cabinets[i];
+        c.machine = std::make_unique<Machine>();
+        c.machine->logEvents = false;
+        initMachine(*c.machine, textures, 1337u + static_cast<uint32_t>(i));
+        int col = static_cast<int>(i) % cols;
+        int row = static_cast<int>(i) / cols;
+        c.offset = { col * kCellSize, -row * kCellSize };
+        initAttract(c.attract, static_cast<uint32_t>(i) + 1u);
+    }
+    int rows = (static_cast<int>(cabinets.size()) + cols - 1) / cols;
+    floorMin = { kMachineBoundsMin.x, -(rows - 1) * kCellSize + kMachineBoundsMin.y };
+    floorMax = { (cols - 1) * kCellSize + kMachineBoundsMax.x, kMachineBoundsMax.y };
+
+    if (!atlasTexture) {
+        glGenTextures(1, &atlasTexture);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kAtlasSize, kAtlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        trackTextureMemory(int64_t(kAtlasSize) * kAtlasSize * 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenFramebuffers(1, &atlasFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, atlasFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlasTexture, 0);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!complete) return false;
+    }
+    fitView();
+    return true;
+}
+
+void ArcadeFloor::fitView()
+{
+    Vec2 extent = floorMax - floorMin;
+    view.center = (floorMin + floorMax) * 0.5f;
+    float s = 1.9f / std::max(extent.x, extent.y);
+    view.scale = { s, s };
+}
+
+void ArcadeFloor::pan(const Vec2& delta)
+{
+    view.center += delta;
+}
+
+void ArcadeFloor::zoom(float factor)
+{
+    view.scale = view.scale * factor;
+}
+
+void ArcadeFloor::update(float dt, WorkStealingPool& pool)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    static const int cabinetsRegion = perfRegion("floor cabinets");
+    pool.parallelFor(cabinets.size(), 16, [this, dt](std::size_t begin, std::size_t end) {
+        PerfScope scope(cabinetsRegion);
+        for (std::size_t i = begin; i < end; ++i) {
+            Cabinet& c = cabinets[i];
+            driveAttract(*c.machine, c.attract, dt);
+            stepMachine(*c.machine, dt);
+            c.impostorAge += dt;
+        }
+    });
+    // Machines buffer their own events, so draining after the parallel step
+    // keeps the log single-threaded.
+    if (telemetry) {
+        for (std::size_t i = 0; i < cabinets.size(); ++i) telemetry->append(static_cast<uint32_t>(i + 1), cabinets[i].machine->playEvents);
+    }
+    frameStats.updateMs = msSince(t0);
+}
+
+void ArcadeFloor::setTelemetry(TelemetryLog* log)
+{
+    telemetry = log;
+    for (Cabinet& c : cabinets) {
+        c.machine->recordPlays = log != nullptr;
+        c.machine->playEvents.clear();
+    }
+}
+
+bool ArcadeFloor::tileRect(int index, float& u0, float& v0, float& u1, float& v1) const
+{
+    const int tilesPerRow = kAtlasSize / kTileSize;
+    if (index >= tilesPerRow * tilesPerRow) return false;
+    float t = static_cast<float>(kTileSize) / kAtlasSize;
+    u0 = (index % tilesPerRow) * t;
+    v0 = (index / tilesPerRow) * t;
+    u1 = u0 + t;
+    v1 = v0 + t;
+    return true;
+}
+
+void ArcadeFloor::refreshImpostors(const std::vector<int>& stale)
+{
+    GLint prevViewport[4];
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFramebuffer);
+    recordGLCall("glBindFramebuffer atlas", static_cast<uint32_t>(stale.size()));
+    glViewport(0, 0, kAtlasSize, kAtlasSize);
+
+    const int tilesPerRow = kAtlasSize / kTileSize;
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    for (int idx : stale) {
+        glScissor((idx % tilesPerRow) * kTileSize, (idx / tilesPerRow) * kTileSize, kTileSize, kTileSize);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    // Keep destination alpha meaningful so impostors composite cleanly.
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    float tileNdc = 2.0f / tilesPerRow;
+    float scale = tileNdc / kImpostorSide;
+    batch->begin(animationTime());
+    for (int idx : stale) {
+        Vec2 tileCenter = { -1.0f + ((idx % tilesPerRow) + 0.5f) * tileNdc, -1.0f + ((idx / tilesPerRow) + 0.5f) * tileNdc };
+        batch->addRegistry(cabinets[idx].machine->registry, tileCenter - kBoundsCenter * scale, scale);
+        cabinets[idx].impostorAge = 0.0f;
+        cabinets[idx].impostorValid = true;
+    }
+    batch->flush(ViewTransform{});
+    frameStats.drawCalls += batch->lastDrawCalls();
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+}
+
+void ArcadeFloor::render(int framebufferWidth, int framebufferHeight)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    frameStats.machines = static_cast<int>(cabinets.size());
+    frameStats.visible = 0;
+    frameStats.impostors = 0;
+    frameStats.impostorRefreshes = 0;
+    frameStats.drawCalls = 0;
+
+    // Classify: culled, drawn in full, or drawn as an impostor.
+    std::vector<int> full;
+    std::vector<int> impostor;
+    staleImpostors.clear();
+    for (std::size_t i = 0; i < cabinets.size(); ++i) {
+        Cabinet& c = cabinets[i];
+        Vec2 lo = (c.offset + kMachineBoundsMin - view.center);
+        Vec2 hi = (c.offset + kMachineBoundsMax - view.center);
+        lo = { lo.x * view.scale.x, lo.y * view.scale.y };
+        hi = { hi.x * view.scale.x, hi.y * view.scale.y };
+        if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f) continue;
+        frameStats.visible++;
+
+        float heightPx = (hi.y - lo.y) * 0.5f * framebufferHeight;
+        float u0, v0, u1, v1;
+        if (heightPx < kImpostorThresholdPx && tileRect(static_cast<int>(i), u0, v0, u1, v1)) {
+            if (!c.impostorValid || c.impostorAge >= kImpostorRefreshSeconds) staleImpostors.push_back(static_cast<int>(i));
+            impostor.push_back(static_cast<int>(i));
+        }
+        else {
+            full.push_back(static_cast<int>(i));
+        }
+    }
+    (void)framebufferWidth;
+
+    // Refresh the stalest impostors first, within the per-frame budget.
+    if (!staleImpostors.empty()) {
+        std::sort(staleImpostors.begin(), staleImpostors.end(), [this](int a, int b) {
+            const Cabinet& ca = cabinets[a];
+            const Cabinet& cb = cabinets[b];
+            if (ca.impostorValid != cb.impostorValid) return !ca.impostorValid;
+            return ca.impostorAge > cb.impostorAge;
+        });
+        if (staleImpostors.size() > static_cast<std::size_t>(kMaxRefreshesPerFrame)) staleImpostors.resize(kMaxRefreshesPerFrame);
+        refreshImpostors(staleImpostors);
+        frameStats.impostorRefreshes = static_cast<int>(staleImpostors.size());
+    }
+
+    batch->begin(animationTime());
+    for (int i : impostor) {
+        Cabinet& c = cabinets[i];
+        if (!c.impostorValid) {
+            full.push_back(i);
+            continue;
+        }
+        SpriteInstance inst;
+        Vec2 center = c.offset + kBoundsCenter;
+        inst.x = center.x;
+        inst.y = center.y;
+        inst.w = kImpostorSide;
+        inst.h = kImpostorSide;
+        tileRect(i, inst.u0, inst.v0, inst.u1, inst.v1);
+        batch->addInstance(atlasTexture, LayerBackground, inst);
+        frameStats.impostors++;
+    }
+    for (int i : full) {
+        batch->addRegistry(cabinets[i].machine->registry, cabinets[i].offset, 1.0f);
+    }
+    batch->flush(view);
+    frameStats.drawCalls += batch->lastDrawCalls();
+    frameStats.instances = batch->lastInstanceCount();
+    frameStats.renderMs = msSince(t0);
+}
@@ -0,0 +1,1304 @@
+#ifdef CLAW_GL_TRACE
+
+#define CLAW_GL_TRACE_IMPLEMENTATION
+#include "../Header/GLTrace.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+enum Fn {
+    FnUseProgram, FnGetUniformLocation, FnUniform1i, FnUniform1f, FnUniform2f, FnUniform4f, FnActiveTexture,
+    FnBindTexture, FnTexImage2D, FnTexParameteri, FnPixelStorei, FnBindVertexArray, FnBindBuffer,
+    FnBindBufferBase, FnBufferData, FnBufferSubData, FnMapBufferRange, FnUnmapBuffer, FnVertexAttribPointer,
+    FnEnableVertexAttribArray, FnVertexAttribDivisor, FnDrawArrays, FnDrawArraysInstanced, FnDrawElements,
+    FnBeginTransformFeedback, FnEndTransformFeedback, FnBindFramebuffer, FnFramebufferTexture2D,
+    FnFramebufferRenderbuffer, FnCheckFramebufferStatus, FnBindRenderbuffer, FnRenderbufferStorage,
+    FnBlitFramebuffer, FnReadPixels, FnViewport, FnScissor, FnClear, FnClearColor, FnEnable, FnDisable,
+    FnBlendFunc, FnBlendFuncSeparate, FnGetIntegerv, FnBeginQuery, FnEndQuery, FnGetQueryObjectiv,
+    FnGetQueryObjectui64v, FnFenceSync, FnClientWaitSync, FnDeleteSync, FnFinish, FnGenTextures,
+    FnGenBuffers, FnGenVertexArrays, FnGenFramebuffers, FnGenRenderbuffers, FnGenQueries, FnDeleteTextures,
+    FnDeleteBuffers, FnDeleteVertexArrays, FnDeleteFramebuffers, FnDeleteRenderbuffers, FnDeleteQueries,
+    FnIsTexture, FnIsBuffer, FnIsVertexArray, FnIsFramebuffer, FnIsRenderbuffer, FnIsQuery, FnIsProgram,
+    FnIsShader, FnCreateShader, FnShaderSource, FnCompileShader, FnGetShaderiv, FnGetShaderInfoLog,
+    FnDeleteShader, FnCreateProgram, FnAttachShader, FnDetachShader, FnTransformFeedbackVaryings,
+    FnLinkProgram, FnValidateProgram, FnGetProgramiv, FnGetProgramInfoLog, FnDeleteProgram, kFnCount
+};
+
+// Name, and the arguments a capture line holds in order: i integer, f float,
+// s word, d hex data or "-", o buffer offset or "-" for client memory, n a
+// count and that many names.
+struct FnInfo {
+    const char* name;
+    const char* args;
+};
+
+const FnInfo kFns[kFnCount] = {
+    { "glUseProgram", "i" },
+    { "glGetUniformLocation", "is" },
+    { "glUniform1i", "ii" },
+    { "glUniform1f", "if" },
+    { "glUniform2f", "iff" },
+    { "glUniform4f", "iffff" },
+    { "glActiveTexture", "i" },
+    { "glBindTexture", "ii" },
+    { "glTexImage2D", "iiiiiiiid" },
+    { "glTexParameteri", "iii" },
+    { "glPixelStorei", "ii" },
+    { "glBindVertexArray", "i" },
+    { "glBindBuffer", "ii" },
+    { "glBindBufferBase", "iii" },
+    { "glBufferData", "iiid" },
+    { "glBufferSubData", "iiid" },
+    { "glMapBufferRange", "iiii" },
+    { "glUnmapBuffer", "i" },
+    { "glVertexAttribPointer", "iiiiii" },
+    { "glEnableVertexAttribArray", "i" },
+    { "glVertexAttribDivisor", "ii" },
+    { "glDrawArrays", "iii" },
+    { "glDrawArraysInstanced", "iiii" },
+    { "glDrawElements", "iiii" },
+    { "glBeginTransformFeedback", "i" },
+    { "glEndTransformFeedback", "" },
+    { "glBindFramebuffer", "ii" },
+    { "glFramebufferTexture2D", "iiiii" },
+    { "glFramebufferRenderbuffer", "iiii" },
+    { "glCheckFramebufferStatus", "i" },
+    { "glBindRenderbuffer", "ii" },
+    { "glRenderbufferStorage", "iiii" },
+    { "glBlitFramebuffer", "iiiiiiiiii" },
+    { "glReadPixels", "iiiiiio" },
+    { "glViewport", "iiii" },
+    { "glScissor", "iiii" },
+    { "glClear", "i" },
+    { "glClearColor", "ffff" },
+    { "glEnable", "i" },
+    { "glDisable", "i" },
+    { "glBlendFunc", "ii" },
+    { "glBlendFuncSeparate", "iiii" },
+    { "glGetIntegerv", "i" },
+    { "glBeginQuery", "ii" },
+    { "glEndQuery", "i" },
+    { "glGetQueryObjectiv", "ii" },
+    { "glGetQueryObjectui64v", "ii" },
+    { "glFenceSync", "iii" },
+    { "glClientWaitSync", "iii" },
+    { "glDeleteSync", "i" },
+    { "glFinish", "" },
+    { "glGenTextures", "n" },
+    { "glGenBuffers", "n" },
+    { "glGenVertexArrays", "n" },
+    { "glGenFramebuffers", "n" },
+    { "glGenRenderbuffers", "n" },
+    { "glGenQueries", "n" },
+    { "glDeleteTextures", "n" },
+    { "glDeleteBuffers", "n" },
+    { "glDeleteVertexArrays", "n" },
+    { "glDeleteFramebuffers", "n" },
+    { "glDeleteRenderbuffers", "n" },
+    { "glDeleteQueries", "n" },
+    { "glIsTexture", "i" },
+    { "glIsBuffer", "i" },
+    { "glIsVertexArray", "i" },
+    { "glIsFramebuffer", "i" },
+    { "glIsRenderbuffer", "i" },
+    { "glIsQuery", "i" },
+    { "glIsProgram", "i" },
+    { "glIsShader", "i" },
+    { "glCreateShader", "ii" },
+    { "glShaderSource", "id" },
+    { "glCompileShader", "i" },
+    { "glGetShaderiv", "ii" },
+    { "glGetShaderInfoLog", "ii" },
+    { "glDeleteShader", "i" },
+    { "glCreateProgram", "i" },
+    { "glAttachShader", "ii" },
+    { "glDetachShader", "ii" },
+    { "glTransformFeedbackVaryings", "isi" },
+    { "glLinkProgram", "i" },
+    { "glValidateProgram", "i" },
+    { "glGetProgramiv", "ii" },
+    { "glGetProgramInfoLog", "ii" },
+    { "glDeleteProgram", "i" },
+};
+
+constexpr GLuint kUnknown = 0xFFFFFFFFu;
+constexpr int kTextureUnits = 32;
+
+// What the game last asked GL for, to spot calls that change nothing. Starts
+// unknown, so the first call of each kind is never redundant.
+struct Shadow {
+    GLuint program = kUnknown;
+    GLenum activeUnit = kUnknown;
+    GLuint textures[kTextureUnits];
+    GLuint vao = kUnknown;
+    std::unordered_map<GLenum, GLuint> buffers;   // Generic binding per target
+    GLuint readFramebuffer = kUnknown;
+    GLuint drawFramebuffer = kUnknown;
+    GLuint renderbuffer = kUnknown;
+    std::array<GLint, 4> viewport{ -1, -1, -1, -1 };
+    std::array<GLint, 4> scissor{ -1, -1, -1, -1 };
+    std::array<uint32_t, 4> clearColor{ kUnknown, kUnknown, kUnknown, kUnknown };
+    std::array<GLenum, 4> blend{ kUnknown, kUnknown, kUnknown, kUnknown };
+    std::unordered_map<GLenum, bool> caps;
+    std::unordered_map<GLenum, GLint> pixelStore;
+    std::unordered_map<uint64_t, std::array<uint32_t, 4>> uniforms;   // (program, location) -> value bits
+    std::unordered_set<std::string> locations;                        // "program:name" looked up before
+
+    Shadow() { std::fill(std::begin(textures), std::end(textures), kUnknown); }
+};
+
+Shadow shadow;
+uint32_t frameCalls[kFnCount] = {};
+uint32_t frameRedundant[kFnCount] = {};
+uint32_t lastCalls[kFnCount] = {};
+uint32_t lastRedundant[kFnCount] = {};
+uint64_t totalCalls[kFnCount] = {};
+uint64_t totalRedundant[kFnCount] = {};
+uint64_t frames = 0;
+
+std::string armedPath;
+std::FILE* capture = nullptr;
+uint64_t captureFrame = 0;
+
+// Counts the call; returns true when it should also be written.
+bool tally(Fn fn, bool redundant)
+{
+    frameCalls[fn]++;
+    if (redundant) frameRedundant[fn]++;
+    return capture != nullptr;
+}
+
+void line(Fn fn, bool redundant, const char* format, ...)
+{
+    std::fputs(kFns[fn].name, capture);
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(capture, format, args);
+    va_end(args);
+    std::fputs(redundant ? "  # redundant\n" : "\n", capture);
+}
+
+void hex(const void* data, std::size_t size)
+{
+    if (!data) {
+        std::fputs(" -", capture);
+        return;
+    }
+    static const char digits[] = "0123456789abcdef";
+    std::fputc(' ', capture);
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::fputc(digits[p[i] >> 4], capture);
+        std::fputc(digits[p[i] & 15], capture);
+    }
+}
+
+// Gen and delete calls: the count, then every name.
+void nameList(Fn fn, GLsizei n, const GLuint* names)
+{
+    std::fprintf(capture, "%s %d", kFns[fn].name, n);
+    for (GLsizei i = 0; i < n; ++i) std::fprintf(capture, " %u", names[i]);
+    std::fputc('\n', capture);
+}
+
+uint32_t bits(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// Remembers a uniform value of the current program; true if it was already set.
+bool sameUniform(GLint location, std::array<uint32_t, 4> value)
+{
+    const uint64_t key = (uint64_t(shadow.program) << 32) | uint32_t(location);
+    auto it = shadow.uniforms.find(key);
+    if (it != shadow.uniforms.end() && it->second == value) return true;
+    shadow.uniforms[key] = value;
+    return false;
+}
+
+// Linking resets a program's uniforms and may move its locations; deleting
+// frees its name for reuse. Either way the shadow forgets it.
+void forgetProgram(GLuint program)
+{
+    for (auto it = shadow.uniforms.begin(); it != shadow.uniforms.end();) {
+        if (GLuint(it->first >> 32) == program) it = shadow.uniforms.erase(it);
+        else ++it;
+    }
+    const std::string prefix = std::to_string(program) + ":";
+    for (auto it = shadow.locations.begin(); it != shadow.locations.end();) {
+        if (it->compare(0, prefix.size(), prefix) == 0) it = shadow.locations.erase(it);
+        else ++it;
+    }
+}
+
+template <typename T>
+bool exchange(T& slot, T value)
+{
+    if (slot == value) return true;
+    slot = value;
+    return false;
+}
+
+template <typename K, typename V>
+bool exchange(std::unordered_map<K, V>& map, K key, V value)
+{
+    auto it = map.find(key);
+    if (it != map.end() && it->second == value) return true;
+    map[key] = value;
+    return false;
+}
+
+std::size_t texelBytes(GLenum format, GLenum type, GLsizei width, GLsizei height)
+{
+    if (type != GL_UNSIGNED_BYTE) return 0;
+    const std::size_t channels = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RED ? 1 : 0;
+    return channels * std::size_t(width) * std::size_t(height);
+}
+
+GLuint boundBuffer(GLenum target)
+{
+    auto it = shadow.buffers.find(target);
+    return it == shadow.buffers.end() ? 0 : it->second;
+}
+}
+
+// ---------------------- Wrappers: programs and uniforms ---------------------- //
+void traceUseProgram(GLuint program)
+{
+    bool r = exchange(shadow.program, program);
+    if (tally(FnUseProgram, r)) line(FnUseProgram, r, " %u", program);
+    glUseProgram(program);
+}
+
+GLint traceGetUniformLocation(GLuint program, const GLchar* name)
+{
+    bool r = !shadow.locations.insert(std::to_string(program) + ":" + name).second;
+    if (tally(FnGetUniformLocation, r)) line(FnGetUniformLocation, r, " %u %s", program, name);
+    return glGetUniformLocation(program, name);
+}
+
+void traceUniform1i(GLint location, GLint v0)
+{
+    bool r = sameUniform(location, { uint32_t(v0), 0, 0, 0 });
+    if (tally(FnUniform1i, r)) line(FnUniform1i, r, " %d %d", location, v0);
+    glUniform1i(location, v0);
+}
+
+void traceUniform1f(GLint location, GLfloat v0)
+{
+    bool r = sameUniform(location, { bits(v0), 0, 0, 0 });
+    if (tally(FnUniform1f, r)) line(FnUniform1f, r, " %d %.9g", location, v0);
+    glUniform1f(location, v0);
+}
+
+void traceUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    bool r = sameUniform(location, { bits(v0), bits(v1), 0, 0 });
+    if (tally(FnUniform2f, r)) line(FnUniform2f, r, " %d %.9g %.9g", location, v0, v1);
+    glUniform2f(location, v0, v1);
+}
+
+void traceUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    bool r = sameUniform(location, { bits(v0), bits(v1), bits(v2), bits(v3) });
+    if (tally(FnUniform4f, r)) line(FnUniform4f, r, " %d %.9g %.9g %.9g %.9g", location, v0, v1, v2, v3);
+    glUniform4f(location, v0, v1, v2, v3);
+}
+
+GLuint traceCreateShader(GLenum type)
+{
+    GLuint shader = glCreateShader(type);
+    if (tally(FnCreateShader, false)) line(FnCreateShader, false, " 0x%x %u", type, shader);
+    return shader;
+}
+
+void traceShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    if (tally(FnShaderSource, false)) {
+        std::string source;
+        for (GLsizei i = 0; i < count; ++i) {
+            if (lengths && lengths[i] >= 0) source.append(strings[i], std::size_t(lengths[i]));
+            else source.append(strings[i]);
+        }
+        std::fprintf(capture, "%s %u", kFns[FnShaderSource].name, shader);
+        hex(source.data(), source.size());
+        std::fputc('\n', capture);
+    }
+    glShaderSource(shader, count, strings, lengths);
+}
+
+void traceCompileShader(GLuint shader)
+{
+    if (tally(FnCompileShader, false)) line(FnCompileShader, false, " %u", shader);
+    glCompileShader(shader);
+}
+
+void traceGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    if (tally(FnGetShaderiv, false)) line(FnGetShaderiv, false, " %u 0x%x", shader, pname);
+    glGetShaderiv(shader, pname, params);
+}
+
+void traceGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* log)
+{
+    if (tally(FnGetShaderInfoLog, false)) line(FnGetShaderInfoLog, false, " %u %d", shader, bufSize);
+    glGetShaderInfoLog(shader, bufSize, length, log);
+}
+
+void traceDeleteShader(GLuint shader)
+{
+    if (tally(FnDeleteShader, false)) line(FnDeleteShader, false, " %u", shader);
+    glDeleteShader(shader);
+}
+
+GLuint traceCreateProgram()
+{
+    GLuint program = glCreateProgram();
+    if (tally(FnCreateProgram, false)) line(FnCreateProgram, false, " %u", program);
+    return program;
+}
+
+void traceAttachShader(GLuint program, GLuint shader)
+{
+    if (tally(FnAttachShader, false)) line(FnAttachShader, false, " %u %u", program, shader);
+    glAttachShader(program, shader);
+}
+
+void traceDetachShader(GLuint program, GLuint shader)
+{
+    if (tally(FnDetachShader, false)) line(FnDetachShader, false, " %u %u", program, shader);
+    glDetachShader(program, shader);
+}
+
+void traceTransformFeedbackVaryings(GLuint program, GLsizei count, const GLchar* const* varyings, GLenum bufferMode)
+{
+    if (tally(FnTransformFeedbackVaryings, false)) {
+        std::string names;
+        for (GLsizei i = 0; i < count; ++i) names += (i ? "," : "") + std::string(varyings[i]);
+        line(FnTransformFeedbackVaryings, false, " %u %s 0x%x", program, names.empty() ? "-" : names.c_str(), bufferMode);
+    }
+    glTransformFeedbackVaryings(program, count, varyings, bufferMode);
+}
+
+void traceLinkProgram(GLuint program)
+{
+    forgetProgram(program);
+    if (tally(FnLinkProgram, false)) line(FnLinkProgram, false, " %u", program);
+    glLinkProgram(program);
+}
+
+void traceValidateProgram(GLuint program)
+{
+    if (tally(FnValidateProgram, false)) line(FnValidateProgram, false, " %u", program);
+    glValidateProgram(program);
+}
+
+void traceGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    if (tally(FnGetProgramiv, false)) line(FnGetProgramiv, false, " %u 0x%x", program, pname);
+    glGetProgramiv(program, pname, params);
+}
+
+void traceGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* log)
+{
+    if (tally(FnGetProgramInfoLog, false)) line(FnGetProgramInfoLog, false, " %u %d", program, bufSize);
+    glGetProgramInfoLog(program, bufSize, length, log);
+}
+
+void traceDeleteProgram(GLuint program)
+{
+    // A current program stays bound until another is used; only its state goes.
+    forgetProgram(program);
+    if (tally(FnDeleteProgram, false)) line(FnDeleteProgram, false, " %u", program);
+    glDeleteProgram(program);
+}
+
+// ---------------------- Wrappers: textures ---------------------- //
+void traceActiveTexture(GLenum unit)
+{
+    bool r = exchange(shadow.activeUnit, unit);
+    if (tally(FnActiveTexture, r)) line(FnActiveTexture, r, " 0x%x", unit);
+    glActiveTexture(unit);
+}
+
+void traceBindTexture(GLenum target, GLuint texture)
+{
+    const GLenum unit = shadow.activeUnit == kUnknown ? 0 : shadow.activeUnit - GL_TEXTURE0;
+    bool r = target == GL_TEXTURE_2D && unit < GLenum(kTextureUnits) && exchange(shadow.textures[unit], texture);
+    if (tally(FnBindTexture, r)) line(FnBindTexture, r, " 0x%x %u", target, texture);
+    glBindTexture(target, texture);
+}
+
+void traceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    if (tally(FnTexImage2D, false)) {
+        std::fprintf(capture, "%s 0x%x %d 0x%x %d %d %d 0x%x 0x%x", kFns[FnTexImage2D].name, target, level, internalFormat, width, height, border, format, type);
+        const std::size_t size = texelBytes(format, type, width, height);
+        hex(size > 0 ? pixels : nullptr, size);
+        std::fputc('\n', capture);
+    }
+    glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+void traceTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    if (tally(FnTexParameteri, false)) line(FnTexParameteri, false, " 0x%x 0x%x 0x%x", target, pname, param);
+    glTexParameteri(target, pname, param);
+}
+
+void tracePixelStorei(GLenum pname, GLint param)
+{
+    bool r = exchange(shadow.pixelStore, pname, param);
+    if (tally(FnPixelStorei, r)) line(FnPixelStorei, r, " 0x%x %d", pname, param);
+    glPixelStorei(pname, param);
+}
+
+void traceGenTextures(GLsizei n, GLuint* names)
+{
+    glGenTextures(n, names);
+    if (tally(FnGenTextures, false)) nameList(FnGenTextures, n, names);
+}
+
+void traceDeleteTextures(GLsizei n, const GLuint* names)
+{
+    // Deleting a bound texture binds 0 in its place.
+    for (GLsizei i = 0; i < n; ++i) {
+        for (GLuint& bound : shadow.textures) {
+            if (bound == names[i]) bound = 0;
+        }
+    }
+    if (tally(FnDeleteTextures, false)) nameList(FnDeleteTextures, n, names);
+    glDeleteTextures(n, names);
+}
+
+GLboolean traceIsTexture(GLuint name)
+{
+    if (tally(FnIsTexture, false)) line(FnIsTexture, false, " %u", name);
+    return glIsTexture(name);
+}
+
+// ---------------------- Wrappers: buffers and vertex arrays ---------------------- //
+void traceBindVertexArray(GLuint vao)
+{
+    bool r = exchange(shadow.vao, vao);
+    // The element buffer binding belongs to the vertex array.
+    if (!r) shadow.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    if (tally(FnBindVertexArray, r)) line(FnBindVertexArray, r, " %u", vao);
+    glBindVertexArray(vao);
+}
+
+void traceBindBuffer(GLenum target, GLuint buffer)
+{
+    bool r = exchange(shadow.buffers, target, buffer);
+    if (tally(FnBindBuffer, r)) line(FnBindBuffer, r, " 0x%x %u", target, buffer);
+    glBindBuffer(target, buffer);
+}
+
+void traceBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // Binds the generic target too; indexed bindings are not shadowed.
+    shadow.buffers[target] = buffer;
+    if (tally(FnBindBufferBase, false)) line(FnBindBufferBase, false, " 0x%x %u %u", target, index, buffer);
+    glBindBufferBase(target, index, buffer);
+}
+
+void traceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (tally(FnBufferData, false)) {
+        std::fprintf(capture, "%s 0x%x %lld 0x%x", kFns[FnBufferData].name, target, static_cast<long long>(size), usage);
+        hex(data, std::size_t(size));
+        std::fputc('\n', capture);
+    }
+    glBufferData(target, size, data, usage);
+}
+
+void traceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (tally(FnBufferSubData, false)) {
+        std::fprintf(capture, "%s 0x%x %lld %lld", kFns[FnBufferSubData].name, target, static_cast<long long>(offset), static_cast<long long>(size));
+        hex(data, std::size_t(size));
+        std::fputc('\n', capture);
+    }
+    glBufferSubData(target, offset, size, data);
+}
+
+void* traceMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    if (tally(FnMapBufferRange, false)) {
+        line(FnMapBufferRange, false, " 0x%x %lld %lld 0x%x", target, static_cast<long long>(offset), static_cast<long long>(length), access);
+    }
+    return glMapBufferRange(target, offset, length, access);
+}
+
+GLboolean traceUnmapBuffer(GLenum target)
+{
+    if (tally(FnUnmapBuffer, false)) line(FnUnmapBuffer, false, " 0x%x", target);
+    return glUnmapBuffer(target);
+}
+
+void traceVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+    if (tally(FnVertexAttribPointer, false)) {
+        line(FnVertexAttribPointer, false, " %u %d 0x%x %d %d %llu", index, size, type, int(normalized), stride,
+            static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(pointer)));
+    }
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+void traceEnableVertexAttribArray(GLuint index)
+{
+    if (tally(FnEnableVertexAttribArray, false)) line(FnEnableVertexAttribArray, false, " %u", index);
+    glEnableVertexAttribArray(index);
+}
+
+void traceVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    if (tally(FnVertexAttribDivisor, false)) line(FnVertexAttribDivisor, false, " %u %u", index, divisor);
+    glVertexAttribDivisor(index, divisor);
+}
+
+void traceGenBuffers(GLsizei n, GLuint* names)
+{
+    glGenBuffers(n, names);
+    if (tally(FnGenBuffers, false)) nameList(FnGenBuffers, n, names);
+}
+
+void traceDeleteBuffers(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        for (auto& bound : shadow.buffers) {
+            if (bound.second == names[i]) bound.second = 0;
+        }
+    }
+    if (tally(FnDeleteBuffers, false)) nameList(FnDeleteBuffers, n, names);
+    glDeleteBuffers(n, names);
+}
+
+GLboolean traceIsBuffer(GLuint name)
+{
+    if (tally(FnIsBuffer, false)) line(FnIsBuffer, false, " %u", name);
+    return glIsBuffer(name);
+}
+
+void traceGenVertexArrays(GLsizei n, GLuint* names)
+{
+    glGenVertexArrays(n, names);
+    if (tally(FnGenVertexArrays, false)) nameList(FnGenVertexArrays, n, names);
+}
+
+void traceDeleteVertexArrays(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        if (shadow.vao == names[i]) {
+            shadow.vao = 0;
+            shadow.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+    if (tally(FnDeleteVertexArrays, false)) nameList(FnDeleteVertexArrays, n, names);
+    glDeleteVertexArrays(n, names);
+}
+
+GLboolean traceIsVertexArray(GLuint name)
+{
+    if (tally(FnIsVertexArray, false)) line(FnIsVertexArray, false, " %u", name);
+    return glIsVertexArray(name);
+}
+
+// ---------------------- Wrappers: drawing ---------------------- //
+void traceDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (tally(FnDrawArrays, false)) line(FnDrawArrays, false, " 0x%x %d %d", mode, first, count);
+    glDrawArrays(mode, first, count);
+}
+
+void traceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+    if (tally(FnDrawArraysInstanced, false)) line(FnDrawArraysInstanced, false, " 0x%x %d %d %d", mode, first, count, instances);
+    glDrawArraysInstanced(mode, first, count, instances);
+}
+
+void traceDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    // The game always draws from an element buffer, so indices is an offset.
+    if (tally(FnDrawElements, false)) {
+        line(FnDrawElements, false, " 0x%x %d 0x%x %llu", mode, count, type,
+            static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(indices)));
+    }
+    glDrawElements(mode, count, type, indices);
+}
+
+void traceBeginTransformFeedback(GLenum primitiveMode)
+{
+    if (tally(FnBeginTransformFeedback, false)) line(FnBeginTransformFeedback, false, " 0x%x", primitiveMode);
+    glBeginTransformFeedback(primitiveMode);
+}
+
+void traceEndTransformFeedback()
+{
+    if (tally(FnEndTransformFeedback, false)) line(FnEndTransformFeedback, false, "");
+    glEndTransformFeedback();
+}
+
+void traceClear(GLbitfield mask)
+{
+    if (tally(FnClear, false)) line(FnClear, false, " 0x%x", mask);
+    glClear(mask);
+}
+
+void traceClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    bool r = exchange(shadow.clearColor, { bits(red), bits(green), bits(blue), bits(alpha) });
+    if (tally(FnClearColor, r)) line(FnClearColor, r, " %.9g %.9g %.9g %.9g", red, green, blue, alpha);
+    glClearColor(red, green, blue, alpha);
+}
+
+void traceViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool r = exchange(shadow.viewport, { x, y, width, height });
+    if (tally(FnViewport, r)) line(FnViewport, r, " %d %d %d %d", x, y, width, height);
+    glViewport(x, y, width, height);
+}
+
+void traceScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool r = exchange(shadow.scissor, { x, y, width, height });
+    if (tally(FnScissor, r)) line(FnScissor, r, " %d %d %d %d", x, y, width, height);
+    glScissor(x, y, width, height);
+}
+
+void traceEnable(GLenum cap)
+{
+    bool r = exchange(shadow.caps, cap, true);
+    if (tally(FnEnable, r)) line(FnEnable, r, " 0x%x", cap);
+    glEnable(cap);
+}
+
+void traceDisable(GLenum cap)
+{
+    bool r = exchange(shadow.caps, cap, false);
+    if (tally(FnDisable, r)) line(FnDisable, r, " 0x%x", cap);
+    glDisable(cap);
+}
+
+void traceBlendFunc(GLenum src, GLenum dst)
+{
+    bool r = exchange(shadow.blend, { src, dst, src, dst });
+    if (tally(FnBlendFunc, r)) line(FnBlendFunc, r, " 0x%x 0x%x", src, dst);
+    glBlendFunc(src, dst);
+}
+
+void traceBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    bool r = exchange(shadow.blend, { srcRGB, dstRGB, srcAlpha, dstAlpha });
+    if (tally(FnBlendFuncSeparate, r)) line(FnBlendFuncSeparate, r, " 0x%x 0x%x 0x%x 0x%x", srcRGB, dstRGB, srcAlpha, dstAlpha);
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+// ---------------------- Wrappers: framebuffers ---------------------- //
+void traceBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool r = false;
+    if (target == GL_FRAMEBUFFER) {
+        r = shadow.readFramebuffer == framebuffer && shadow.drawFramebuffer == framebuffer;
+        shadow.readFramebuffer = shadow.drawFramebuffer = framebuffer;
+    }
+    else if (target == GL_READ_FRAMEBUFFER) r = exchange(shadow.readFramebuffer, framebuffer);
+    else if (target == GL_DRAW_FRAMEBUFFER) r = exchange(shadow.drawFramebuffer, framebuffer);
+    if (tally(FnBindFramebuffer, r)) line(FnBindFramebuffer, r, " 0x%x %u", target, framebuffer);
+    glBindFramebuffer(target, framebuffer);
+}
+
+void traceFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    if (tally(FnFramebufferTexture2D, false)) {
+        line(FnFramebufferTexture2D, false, " 0x%x 0x%x 0x%x %u %d", target, attachment, textarget, texture, level);
+    }
+    glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+void traceFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer)
+{
+    if (tally(FnFramebufferRenderbuffer, false)) {
+        line(FnFramebufferRenderbuffer, false, " 0x%x 0x%x 0x%x %u", target, attachment, renderbufferTarget, renderbuffer);
+    }
+    glFramebufferRenderbuffer(target, attachment, renderbufferTarget, renderbuffer);
+}
+
+GLenum traceCheckFramebufferStatus(GLenum target)
+{
+    if (tally(FnCheckFramebufferStatus, false)) line(FnCheckFramebufferStatus, false, " 0x%x", target);
+    return glCheckFramebufferStatus(target);
+}
+
+void traceBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    bool r = exchange(shadow.renderbuffer, renderbuffer);
+    if (tally(FnBindRenderbuffer, r)) line(FnBindRenderbuffer, r, " 0x%x %u", target, renderbuffer);
+    glBindRenderbuffer(target, renderbuffer);
+}
+
+void traceRenderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+    if (tally(FnRenderbufferStorage, false)) line(FnRenderbufferStorage, false, " 0x%x 0x%x %d %d", target, internalFormat, width, height);
+    glRenderbufferStorage(target, internalFormat, width, height);
+}
+
+void traceBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    if (tally(FnBlitFramebuffer, false)) {
+        line(FnBlitFramebuffer, false, " %d %d %d %d %d %d %d %d 0x%x 0x%x", srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+    }
+    glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void traceReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+{
+    if (tally(FnReadPixels, false)) {
+        // Into a pack buffer pixels is an offset; into memory replay uses its own.
+        std::fprintf(capture, "%s %d %d %d %d 0x%x 0x%x", kFns[FnReadPixels].name, x, y, width, height, format, type);
+        if (boundBuffer(GL_PIXEL_PACK_BUFFER) != 0) {
+            std::fprintf(capture, " %llu\n", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(pixels)));
+        }
+        else std::fputs(" -\n", capture);
+    }
+    glReadPixels(x, y, width, height, format, type, pixels);
+}
+
+void traceGenFramebuffers(GLsizei n, GLuint* names)
+{
+    glGenFramebuffers(n, names);
+    if (tally(FnGenFramebuffers, false)) nameList(FnGenFramebuffers, n, names);
+}
+
+void traceDeleteFramebuffers(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        if (shadow.readFramebuffer == names[i]) shadow.readFramebuffer = 0;
+        if (shadow.drawFramebuffer == names[i]) shadow.drawFramebuffer = 0;
+    }
+    if (tally(FnDeleteFramebuffers, false)) nameList(FnDeleteFramebuffers, n, names);
+    glDeleteFramebuffers(n, names);
+}
+
+GLboolean traceIsFramebuffer(GLuint name)
+{
+    if (tally(FnIsFramebuffer, false)) line(FnIsFramebuffer, false, " %u", name);
+    return glIsFramebuffer(name);
+}
+
+void traceGenRenderbuffers(GLsizei n, GLuint* names)
+{
+    glGenRenderbuffers(n, names);
+    if (tally(FnGenRenderbuffers, false)) nameList(FnGenRenderbuffers, n, names);
+}
+
+void traceDeleteRenderbuffers(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        if (shadow.renderbuffer == names[i]) shadow.renderbuffer = 0;
+    }
+    if (tally(FnDeleteRenderbuffers, false)) nameList(FnDeleteRenderbuffers, n, names);
+    glDeleteRenderbuffers(n, names);
+}
+
+GLboolean traceIsRenderbuffer(GLuint name)
+{
+    if (tally(FnIsRenderbuffer, false)) line(FnIsRenderbuffer, false, " %u", name);
+    return glIsRenderbuffer(name);
+}
+
+// ---------------------- Wrappers: queries, syncs and reads ---------------------- //
+void traceGetIntegerv(GLenum pname, GLint* data)
+{
+    // A query stalls until GL catches up; flag the ones the shadow could answer.
+    bool r = (pname == GL_VIEWPORT && shadow.viewport[0] != -1) ||
+        (pname == GL_DRAW_FRAMEBUFFER_BINDING && shadow.drawFramebuffer != kUnknown) ||
+        (pname == GL_READ_FRAMEBUFFER_BINDING && shadow.readFramebuffer != kUnknown) ||
+        (pname == GL_CURRENT_PROGRAM && shadow.program != kUnknown);
+    if (tally(FnGetIntegerv, r)) line(FnGetIntegerv, r, " 0x%x", pname);
+    glGetIntegerv(pname, data);
+}
+
+void traceGenQueries(GLsizei n, GLuint* names)
+{
+    glGenQueries(n, names);
+    if (tally(FnGenQueries, false)) nameList(FnGenQueries, n, names);
+}
+
+void traceDeleteQueries(GLsizei n, const GLuint* names)
+{
+    if (tally(FnDeleteQueries, false)) nameList(FnDeleteQueries, n, names);
+    glDeleteQueries(n, names);
+}
+
+GLboolean traceIsQuery(GLuint name)
+{
+    if (tally(FnIsQuery, false)) line(FnIsQuery, false, " %u", name);
+    return glIsQuery(name);
+}
+
+GLboolean traceIsProgram(GLuint name)
+{
+    if (tally(FnIsProgram, false)) line(FnIsProgram, false, " %u", name);
+    return glIsProgram(name);
+}
+
+GLboolean traceIsShader(GLuint name)
+{
+    if (tally(FnIsShader, false)) line(FnIsShader, false, " %u", name);
+    return glIsShader(name);
+}
+
+void traceBeginQuery(GLenum target, GLuint query)
+{
+    if (tally(FnBeginQuery, false)) line(FnBeginQuery, false, " 0x%x %u", target, query);
+    glBeginQuery(target, query);
+}
+
+void traceEndQuery(GLenum target)
+{
+    if (tally(FnEndQuery, false)) line(FnEndQuery, false, " 0x%x", target);
+    glEndQuery(target);
+}
+
+void traceGetQueryObjectiv(GLuint query, GLenum pname, GLint* params)
+{
+    if (tally(FnGetQueryObjectiv, false)) line(FnGetQueryObjectiv, false, " %u 0x%x", query, pname);
+    glGetQueryObjectiv(query, pname, params);
+}
+
+void traceGetQueryObjectui64v(GLuint query, GLenum pname, GLuint64* params)
+{
+    if (tally(FnGetQueryObjectui64v, false)) line(FnGetQueryObjectui64v, false, " %u 0x%x", query, pname);
+    glGetQueryObjectui64v(query, pname, params);
+}
+
+// Sync objects are pointers; a capture names them by value.
+GLsync traceFenceSync(GLenum condition, GLbitfield flags)
+{
+    GLsync sync = glFenceSync(condition, flags);
+    if (tally(FnFenceSync, false)) {
+        line(FnFenceSync, false, " 0x%x 0x%x %llu", condition, flags, static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(sync)));
+    }
+    return sync;
+}
+
+GLenum traceClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    if (tally(FnClientWaitSync, false)) {
+        line(FnClientWaitSync, false, " %llu 0x%x %llu", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(sync)), flags,
+            static_cast<unsigned long long>(timeout));
+    }
+    return glClientWaitSync(sync, flags, timeout);
+}
+
+void traceDeleteSync(GLsync sync)
+{
+    if (tally(FnDeleteSync, false)) line(FnDeleteSync, false, " %llu", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(sync)));
+    glDeleteSync(sync);
+}
+
+void traceFinish()
+{
+    if (tally(FnFinish, false)) line(FnFinish, false, "");
+    glFinish();
+}
+
+// ---------------------- Frames and reports ---------------------- //
+void glTraceEndFrame()
+{
+    for (int f = 0; f < kFnCount; ++f) {
+        lastCalls[f] = frameCalls[f];
+        lastRedundant[f] = frameRedundant[f];
+        totalCalls[f] += frameCalls[f];
+        totalRedundant[f] += frameRedundant[f];
+        frameCalls[f] = frameRedundant[f] = 0;
+    }
+    frames++;
+
+    if (capture) {
+        std::fclose(capture);
+        capture = nullptr;
+        std::cout << "[GLTRACE] frame " << captureFrame << " captured to " << armedPath << std::endl;
+        armedPath.clear();
+    }
+    else if (!armedPath.empty()) {
+        capture = std::fopen(armedPath.c_str(), "w");
+        if (!capture) {
+            std::cout << "[GLTRACE] could not write " << armedPath << std::endl;
+            armedPath.clear();
+            return;
+        }
+        captureFrame = frames + 1;
+        std::fprintf(capture, "# clawmachine GL capture v2, frame %llu\n", static_cast<unsigned long long>(captureFrame));
+    }
+}
+
+void glTraceCaptureNextFrame(const std::string& path)
+{
+    if (capture || !armedPath.empty()) return;
+    armedPath = path;
+}
+
+void glTraceReport(std::ostream& out)
+{
+    if (frames == 0) return;
+    int order[kFnCount];
+    for (int f = 0; f < kFnCount; ++f) order[f] = f;
+    std::sort(order, order + kFnCount, [](int a, int b) { return totalCalls[a] > totalCalls[b]; });
+
+    char row[160];
+    std::snprintf(row, sizeof(row), "[GLTRACE] %llu frames; per frame: calls last / avg, redundant last / avg\n",
+        static_cast<unsigned long long>(frames));
+    out << row;
+    uint64_t calls = 0, redundant = 0, last = 0, lastR = 0;
+    for (int f : order) {
+        if (totalCalls[f] == 0) continue;
+        calls += totalCalls[f];
+        redundant += totalRedundant[f];
+        last += lastCalls[f];
+        lastR += lastRedundant[f];
+        std::snprintf(row, sizeof(row), "  %-28s %7u %9.1f %7u %9.1f\n", kFns[f].name,
+            lastCalls[f], double(totalCalls[f]) / double(frames), lastRedundant[f], double(totalRedundant[f]) / double(frames));
+        out << row;
+    }
+    std::snprintf(row, sizeof(row), "  %-28s %7llu %9.1f %7llu %9.1f\n", "total",
+        static_cast<unsigned long long>(last), double(calls) / double(frames),
+        static_cast<unsigned long long>(lastR), double(redundant) / double(frames));
+    out << row;
+    out.flush();
+}
+
+// ---------------------- Replay ---------------------- //
+namespace {
+struct ReplayCall {
+    Fn fn;
+    std::vector<long long> ints;
+    std::vector<float> floats;
+    std::string text;
+    std::vector<unsigned char> data;
+    bool hasData = false;
+    bool clientMemory = false;   // An "o" argument was "-"
+};
+
+std::vector<ReplayCall> replayCalls;
+
+// Objects the captured frame created, by captured name. Everything else was
+// made at startup and has the same name in the replaying run.
+enum Kind { KindTexture, KindBuffer, KindVertexArray, KindFramebuffer, KindRenderbuffer, KindQuery, KindShader, KindProgram, KindSync, kKinds };
+std::unordered_map<uint64_t, uint64_t> liveNames[kKinds];
+std::vector<unsigned char> scratch;
+
+uint64_t live(Kind kind, long long captured)
+{
+    auto it = liveNames[kind].find(uint64_t(captured));
+    return it == liveNames[kind].end() ? uint64_t(captured) : it->second;
+}
+
+GLuint tex(long long n) { return GLuint(live(KindTexture, n)); }
+GLuint buf(long long n) { return GLuint(live(KindBuffer, n)); }
+GLuint fbo(long long n) { return GLuint(live(KindFramebuffer, n)); }
+GLuint rbo(long long n) { return GLuint(live(KindRenderbuffer, n)); }
+GLuint query(long long n) { return GLuint(live(KindQuery, n)); }
+GLuint shader(long long n) { return GLuint(live(KindShader, n)); }
+GLuint program(long long n) { return GLuint(live(KindProgram, n)); }
+
+// A frame that creates objects creates them on its first replay and reuses
+// them after, so replaying it over and over does not leak.
+void replayGen(Kind kind, const ReplayCall& c, void (*gen)(GLsizei, GLuint*))
+{
+    for (std::size_t k = 1; k < c.ints.size(); ++k) {
+        const uint64_t captured = uint64_t(c.ints[k]);
+        if (liveNames[kind].count(captured)) continue;
+        GLuint name = 0;
+        gen(1, &name);
+        liveNames[kind][captured] = name;
+    }
+}
+
+void replayDelete(Kind kind, const ReplayCall& c, void (*del)(GLsizei, const GLuint*))
+{
+    for (std::size_t k = 1; k < c.ints.size(); ++k) {
+        const GLuint name = GLuint(live(kind, c.ints[k]));
+        del(1, &name);
+        liveNames[kind].erase(uint64_t(c.ints[k]));
+    }
+}
+
+// Replay goes through these rather than the GLEW macros, which are not
+// plain functions.
+void genTextures(GLsizei n, GLuint* names) { glGenTextures(n, names); }
+void genBuffers(GLsizei n, GLuint* names) { glGenBuffers(n, names); }
+void genVertexArrays(GLsizei n, GLuint* names) { glGenVertexArrays(n, names); }
+void genFramebuffers(GLsizei n, GLuint* names) { glGenFramebuffers(n, names); }
+void genRenderbuffers(GLsizei n, GLuint* names) { glGenRenderbuffers(n, names); }
+void genQueries(GLsizei n, GLuint* names) { glGenQueries(n, names); }
+void deleteTextures(GLsizei n, const GLuint* names) { glDeleteTextures(n, names); }
+void deleteBuffers(GLsizei n, const GLuint* names) { glDeleteBuffers(n, names); }
+void deleteVertexArrays(GLsizei n, const GLuint* names) { glDeleteVertexArrays(n, names); }
+void deleteFramebuffers(GLsizei n, const GLuint* names) { glDeleteFramebuffers(n, names); }
+void deleteRenderbuffers(GLsizei n, const GLuint* names) { glDeleteRenderbuffers(n, names); }
+void deleteQueries(GLsizei n, const GLuint* names) { glDeleteQueries(n, names); }
+
+GLuint vao(long long n) { return GLuint(live(KindVertexArray, n)); }
+
+GLsync sync(long long n)
+{
+    auto it = liveNames[KindSync].find(uint64_t(n));
+    return it == liveNames[KindSync].end() ? nullptr : reinterpret_cast<GLsync>(uintptr_t(it->second));
+}
+
+const void* offset(long long n)
+{
+    return reinterpret_cast<const void*>(uintptr_t(n));
+}
+
+bool unhex(const std::string& s, std::vector<unsigned char>& out)
+{
+    if (s.size() % 2 != 0) return false;
+    out.resize(s.size() / 2);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        char* end = nullptr;
+        char pair[3] = { s[2 * i], s[2 * i + 1], 0 };
+        out[i] = static_cast<unsigned char>(std::strtoul(pair, &end, 16));
+        if (*end != 0) return false;
+    }
+    return true;
+}
+
+// Integers go through unsigned parsing so sync pointers above 2^63 survive;
+// "-1" still comes back as -1.
+long long integer(const std::string& word)
+{
+    return static_cast<long long>(std::strtoull(word.c_str(), nullptr, 0));
+}
+}
+
+bool glTraceLoadReplay(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "[GLTRACE] cannot read " << path << std::endl;
+        return false;
+    }
+    replayCalls.clear();
+    std::string text;
+    int lineNo = 0;
+    while (std::getline(in, text)) {
+        lineNo++;
+        text = text.substr(0, text.find('#'));
+        std::istringstream words(text);
+        std::string name;
+        if (!(words >> name)) continue;
+        const FnInfo* found = std::find_if(std::begin(kFns), std::end(kFns), [&](const FnInfo& f) { return name == f.name; });
+        if (found == std::end(kFns)) {
+            std::cout << "[GLTRACE] " << path << ":" << lineNo << ": unknown call " << name << std::endl;
+            return false;
+        }
+        ReplayCall call;
+        call.fn = static_cast<Fn>(found - std::begin(kFns));
+        bool ok = true;
+        for (const char* a = found->args; *a && ok; ++a) {
+            std::string word;
+            if (!(words >> word)) ok = false;
+            else if (*a == 'i') call.ints.push_back(integer(word));
+            else if (*a == 'f') call.floats.push_back(std::strtof(word.c_str(), nullptr));
+            else if (*a == 's') call.text = word;
+            else if (*a == 'o') {
+                call.clientMemory = word == "-";
+                call.ints.push_back(call.clientMemory ? 0 : integer(word));
+            }
+            else if (*a == 'n') {
+                const long long n = integer(word);
+                call.ints.push_back(n);
+                for (long long k = 0; k < n && ok; ++k) {
+                    ok = static_cast<bool>(words >> word);
+                    if (ok) call.ints.push_back(integer(word));
+                }
+            }
+            else if (word != "-") ok = call.hasData = unhex(word, call.data);
+        }
+        if (!ok) {
+            std::cout << "[GLTRACE] " << path << ":" << lineNo << ": bad arguments for " << name << std::endl;
+            return false;
+        }
+        replayCalls.push_back(std::move(call));
+    }
+    for (auto& names : liveNames) names.clear();
+    std::cout << "[GLTRACE] replaying " << replayCalls.size() << " calls from " << path << std::endl;
+    return true;
+}
+
+void glTraceReplayFrame()
+{
+    GLint ints[16];
+    GLuint64 wide = 0;
+    for (const ReplayCall& c : replayCalls) {
+        const long long* i = c.ints.data();
+        const float* f = c.floats.data();
+        const void* data = c.hasData ? c.data.data() : nullptr;
+        switch (c.fn) {
+        case FnUseProgram: glUseProgram(program(i[0])); break;
+        case FnGetUniformLocation: glGetUniformLocation(program(i[0]), c.text.c_str()); break;
+        case FnUniform1i: glUniform1i(GLint(i[0]), GLint(i[1])); break;
+        case FnUniform1f: glUniform1f(GLint(i[0]), f[0]); break;
+        case FnUniform2f: glUniform2f(GLint(i[0]), f[0], f[1]); break;
+        case FnUniform4f: glUniform4f(GLint(i[0]), f[0], f[1], f[2], f[3]); break;
+        case FnActiveTexture: glActiveTexture(GLenum(i[0])); break;
+        case FnBindTexture: glBindTexture(GLenum(i[0]), tex(i[1])); break;
+        case FnTexImage2D:
+            glTexImage2D(GLenum(i[0]), GLint(i[1]), GLint(i[2]), GLsizei(i[3]), GLsizei(i[4]), GLint(i[5]), GLenum(i[6]), GLenum(i[7]), data);
+            break;
+        case FnTexParameteri: glTexParameteri(GLenum(i[0]), GLenum(i[1]), GLint(i[2])); break;
+        case FnPixelStorei: glPixelStorei(GLenum(i[0]), GLint(i[1])); break;
+        case FnBindVertexArray: glBindVertexArray(vao(i[0])); break;
+        case FnBindBuffer: glBindBuffer(GLenum(i[0]), buf(i[1])); break;
+        case FnBindBufferBase: glBindBufferBase(GLenum(i[0]), GLuint(i[1]), buf(i[2])); break;
+        case FnBufferData: glBufferData(GLenum(i[0]), GLsizeiptr(i[1]), data, GLenum(i[2])); break;
+        case FnBufferSubData:
+            if (data) glBufferSubData(GLenum(i[0]), GLintptr(i[1]), GLsizeiptr(i[2]), data);
+            break;
+        case FnMapBufferRange: glMapBufferRange(GLenum(i[0]), GLintptr(i[1]), GLsizeiptr(i[2]), GLbitfield(i[3])); break;
+        case FnUnmapBuffer: glUnmapBuffer(GLenum(i[0])); break;
+        case FnVertexAttribPointer:
+            glVertexAttribPointer(GLuint(i[0]), GLint(i[1]), GLenum(i[2]), GLboolean(i[3]), GLsizei(i[4]), offset(i[5]));
+            break;
+        case FnEnableVertexAttribArray: glEnableVertexAttribArray(GLuint(i[0])); break;
+        case FnVertexAttribDivisor: glVertexAttribDivisor(GLuint(i[0]), GLuint(i[1])); break;
+        case FnDrawArrays: glDrawArrays(GLenum(i[0]), GLint(i[1]), GLsizei(i[2])); break;
+        case FnDrawArraysInstanced: glDrawArraysInstanced(GLenum(i[0]), GLint(i[1]), GLsizei(i[2]), GLsizei(i[3])); break;
+        case FnDrawElements: glDrawElements(GLenum(i[0]), GLsizei(i[1]), GLenum(i[2]), offset(i[3])); break;
+        case FnBeginTransformFeedback: glBeginTransformFeedback(GLenum(i[0])); break;
+        case FnEndTransformFeedback: glEndTransformFeedback(); break;
+        case FnBindFramebuffer: glBindFramebuffer(GLenum(i[0]), fbo(i[1])); break;
+        case FnFramebufferTexture2D: glFramebufferTexture2D(GLenum(i[0]), GLenum(i[1]), GLenum(i[2]), tex(i[3]), GLint(i[4])); break;
+        case FnFramebufferRenderbuffer: glFramebufferRenderbuffer(GLenum(i[0]), GLenum(i[1]), GLenum(i[2]), rbo(i[3])); break;
+        case FnCheckFramebufferStatus: glCheckFramebufferStatus(GLenum(i[0])); break;
+        case FnBindRenderbuffer: glBindRenderbuffer(GLenum(i[0]), rbo(i[1])); break;
+        case FnRenderbufferStorage: glRenderbufferStorage(GLenum(i[0]), GLenum(i[1]), GLsizei(i[2]), GLsizei(i[3])); break;
+        case FnBlitFramebuffer:
+            glBlitFramebuffer(GLint(i[0]), GLint(i[1]), GLint(i[2]), GLint(i[3]), GLint(i[4]), GLint(i[5]), GLint(i[6]), GLint(i[7]), GLbitfield(i[8]), GLenum(i[9]));
+            break;
+        case FnReadPixels: {
+            void* pixels = const_cast<void*>(offset(i[6]));
+            if (c.clientMemory) {
+                // Room for four 32-bit channels, whatever the format.
+                scratch.resize(std::size_t(i[2]) * std::size_t(i[3]) * 16);
+                pixels = scratch.data();
+            }
+            glReadPixels(GLint(i[0]), GLint(i[1]), GLsizei(i[2]), GLsizei(i[3]), GLenum(i[4]), GLenum(i[5]), pixels);
+            break;
+        }
+        case FnViewport: glViewport(GLint(i[0]), GLint(i[1]), GLsizei(i[2]), GLsizei(i[3])); break;
+        case FnScissor: glScissor(GLint(i[0]), GLint(i[1]), GLsizei(i[2]), GLsizei(i[3])); break;
+        case FnClear: glClear(GLbitfield(i[0])); break;
+        case FnClearColor: glClearColor(f[0], f[1], f[2], f[3]); break;
+        case FnEnable: glEnable(GLenum(i[0])); break;
+        case FnDisable: glDisable(GLenum(i[0])); break;
+        case FnBlendFunc: glBlendFunc(GLenum(i[0]), GLenum(i[1])); break;
+        case FnBlendFuncSeparate: glBlendFuncSeparate(GLenum(i[0]), GLenum(i[1]), GLenum(i[2]), GLenum(i[3])); break;
+        case FnGetIntegerv: glGetIntegerv(GLenum(i[0]), ints); break;
+        case FnBeginQuery: glBeginQuery(GLenum(i[0]), query(i[1])); break;
+        case FnEndQuery: glEndQuery(GLenum(i[0])); break;
+        case FnGetQueryObjectiv: glGetQueryObjectiv(query(i[0]), GLenum(i[1]), ints); break;
+        case FnGetQueryObjectui64v: glGetQueryObjectui64v(query(i[0]), GLenum(i[1]), &wide); break;
+        case FnFenceSync: {
+            // One-shot: a fence from the previous replay is replaced.
+            if (GLsync old = sync(i[2])) glDeleteSync(old);
+            GLsync fence = glFenceSync(GLenum(i[0]), GLbitfield(i[1]));
+            liveNames[KindSync][uint64_t(i[2])] = uint64_t(reinterpret_cast<uintptr_t>(fence));
+            break;
+        }
+        case FnClientWaitSync:
+            // Fences from frames before the capture do not exist here.
+            if (GLsync s = sync(i[0])) glClientWaitSync(s, GLbitfield(i[1]), GLuint64(i[2]));
+            break;
+        case FnDeleteSync:
+            if (GLsync s = sync(i[0])) glDeleteSync(s);
+            liveNames[KindSync].erase(uint64_t(i[0]));
+            break;
+        case FnFinish: glFinish(); break;
+        case FnGenTextures: replayGen(KindTexture, c, genTextures); break;
+        case FnGenBuffers: replayGen(KindBuffer, c, genBuffers); break;
+        case FnGenVertexArrays: replayGen(KindVertexArray, c, genVertexArrays); break;
+        case FnGenFramebuffers: replayGen(KindFramebuffer, c, genFramebuffers); break;
+        case FnGenRenderbuffers: replayGen(KindRenderbuffer, c, genRenderbuffers); break;
+        case FnGenQueries: replayGen(KindQuery, c, genQueries); break;
+        case FnDeleteTextures: replayDelete(KindTexture, c, deleteTextures); break;
+        case FnDeleteBuffers: replayDelete(KindBuffer, c, deleteBuffers); break;
+        case FnDeleteVertexArrays: replayDelete(KindVertexArray, c, deleteVertexArrays); break;
+        case FnDeleteFramebuffers: replayDelete(KindFramebuffer, c, deleteFramebuffers); break;
+        case FnDeleteRenderbuffers: replayDelete(KindRenderbuffer, c, deleteRenderbuffers); break;
+        case FnDeleteQueries: replayDelete(KindQuery, c, deleteQueries); break;
+        case FnIsTexture: glIsTexture(tex(i[0])); break;
+        case FnIsBuffer: glIsBuffer(buf(i[0])); break;
+        case FnIsVertexArray: glIsVertexArray(vao(i[0])); break;
+        case FnIsFramebuffer: glIsFramebuffer(fbo(i[0])); break;
+        case FnIsRenderbuffer: glIsRenderbuffer(rbo(i[0])); break;
+        case FnIsQuery: glIsQuery(query(i[0])); break;
+        case FnIsProgram: glIsProgram(program(i[0])); break;
+        case FnIsShader: glIsShader(shader(i[0])); break;
+        case FnCreateShader:
+            if (!liveNames[KindShader].count(uint64_t(i[1]))) liveNames[KindShader][uint64_t(i[1])] = glCreateShader(GLenum(i[0]));
+            break;
+        case FnShaderSource: {
+            const std::string source(c.data.begin(), c.data.end());
+            const GLchar* text = source.c_str();
+            glShaderSource(shader(i[0]), 1, &text, nullptr);
+            break;
+        }
+        case FnCompileShader: glCompileShader(shader(i[0])); break;
+        case FnGetShaderiv: glGetShaderiv(shader(i[0]), GLenum(i[1]), ints); break;
+        case FnGetShaderInfoLog:
+            scratch.resize(std::size_t(std::max(i[1], 1LL)));
+            glGetShaderInfoLog(shader(i[0]), GLsizei(scratch.size()), nullptr, reinterpret_cast<GLchar*>(scratch.data()));
+            break;
+        case FnDeleteShader:
+            glDeleteShader(shader(i[0]));
+            liveNames[KindShader].erase(uint64_t(i[0]));
+            break;
+        case FnCreateProgram:
+            if (!liveNames[KindProgram].count(uint64_t(i[0]))) liveNames[KindProgram][uint64_t(i[0])] = glCreateProgram();
+            break;
+        case FnAttachShader: glAttachShader(program(i[0]), shader(i[1])); break;
+        case FnDetachShader: glDetachShader(program(i[0]), shader(i[1])); break;
+        case FnTransformFeedbackVaryings: {
+            std::vector<std::string> names;
+            std::istringstream list(c.text == "-" ? "" : c.text);
+            for (std::string name; std::getline(list, name, ',');) names.push_back(name);
+            std::vector<const GLchar*> pointers;
+            for (const std::string& name : names) pointers.push_back(name.c_str());
+            glTransformFeedbackVaryings(program(i[0]), GLsizei(pointers.size()), pointers.data(), GLenum(i[1]));
+            break;
+        }
+        case FnLinkProgram: glLinkProgram(program(i[0])); break;
+        case FnValidateProgram: glValidateProgram(program(i[0])); break;
+        case FnGetProgramiv: glGetProgramiv(program(i[0]), GLenum(i[1]), ints); break;
+        case FnGetProgramInfoLog:
+            scratch.resize(std::size_t(std::max(i[1], 1LL)));
+            glGetProgramInfoLog(program(i[0]), GLsizei(scratch.size()), nullptr, reinterpret_cast<GLchar*>(scratch.data()));
+            break;
+        case FnDeleteProgram:
+            glDeleteProgram(program(i[0]));
+            liveNames[KindProgram].erase(uint64_t(i[0]));
+            break;
+        default: break;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "../Header/Golden.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+// Next header number of a PPM, skipping whitespace and comments.
+bool readHeaderNumber(std::FILE* f, int& value)
+{
+    int c = std::fgetc(f);
+    for (;;) {
+        while (c == ' ' || c == '\t' || c == '\n' || c == '\r') c = std::fgetc(f);
+        if (c != '#') break;
+        while (c != '\n' && c != EOF) c = std::fgetc(f);
+    }
+    if (c < '0' || c > '9') return false;
+    value = 0;
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        c = std::fgetc(f);
+    }
+    return true;   // The single whitespace after the number is consumed
+}
+
+// Largest possible YIQ delta, black against white.
+constexpr float kMaxYIQDelta = 35215.0f;
+
+float yiqDelta(const unsigned char* a, const unsigned char* b)
+{
+    const float dr = float(a[0]) - float(b[0]);
+    const float dg = float(a[1]) - float(b[1]);
+    const float db = float(a[2]) - float(b[2]);
+    const float y = dr * 0.29889531f + dg * 0.58662247f + db * 0.11448223f;
+    const float i = dr * 0.59597799f - dg * 0.27417610f - db * 0.32180189f;
+    const float q = dr * 0.21147017f - dg * 0.52261711f + db * 0.31114694f;
+    return 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+}
+}
+
+bool readPPM(const std::string& path, Image& image)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int maxValue = 0;
+    bool ok = std::fgetc(f) == 'P' && std::fgetc(f) == '6'
+        && readHeaderNumber(f, image.width) && readHeaderNumber(f, image.height) && readHeaderNumber(f, maxValue)
+        && maxValue == 255 && image.width > 0 && image.height > 0;
+    if (ok) {
+        image.rgb.resize(std::size_t(image.width) * std::size_t(image.height) * 3);
+        ok = std::fread(image.rgb.data(), 1, image.rgb.size(), f) == image.rgb.size();
+    }
+    std::fclose(f);
+    return ok;
+}
+
+bool writePPM(const std::string& path, const Image& image)
+{
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", image.width, image.height);
+    bool ok = std::fwrite(image.rgb.data(), 1, image.rgb.size(), f) == image.rgb.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool readRunLength(const std::string& path, Image& image)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    bool ok = std::fgetc(f) == 'C' && std::fgetc(f) == 'R' && std::fgetc(f) == 'L' && std::fgetc(f) == 'E'
+        && readHeaderNumber(f, image.width) && readHeaderNumber(f, image.height) && image.width > 0 && image.height > 0;
+    if (ok) {
+        const std::size_t pixels = std::size_t(image.width) * std::size_t(image.height);
+        image.rgb.resize(pixels * 3);
+        std::size_t at = 0;
+        while (ok && at < pixels) {
+            std::size_t run = 0;
+            int shift = 0, c;
+            do {
+                c = std::fgetc(f);
+                ok = c != EOF && shift < 32;
+                run |= std::size_t(c & 0x7f) << shift;
+                shift += 7;
+            } while (ok && (c & 0x80));
+            unsigned char color[3];
+            ok = ok && ++run <= pixels - at && std::fread(color, 1, 3, f) == 3;
+            for (std::size_t i = 0; ok && i < run; ++i, ++at) std::copy(color, color + 3, &image.rgb[at * 3]);
+        }
+        ok = ok && std::fgetc(f) == EOF;
+    }
+    std::fclose(f);
+    return ok;
+}
+
+bool writeRunLength(const std::string& path, const Image& image)
+{
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "CRLE\n%d %d\n", image.width, image.height);
+    std::vector<unsigned char> out;
+    const std::size_t pixels = image.rgb.size() / 3;
+    for (std::size_t p = 0; p < pixels;) {
+        const unsigned char* color = &image.rgb[p * 3];
+        std::size_t end = p + 1;
+        while (end < pixels && std::equal(color, color + 3, &image.rgb[end * 3])) end++;
+        for (std::size_t rest = end - p - 1; ; rest >>= 7) {
+            out.push_back(static_cast<unsigned char>((rest & 0x7f) | (rest > 0x7f ? 0x80 : 0)));
+            if (rest <= 0x7f) break;
+        }
+        out.insert(out.end(), color, color + 3);
+        p = end;
+    }
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+ImageDiff compareImages(const Image& expected, const Image& actual, float threshold, Image* diff)
+{
+    ImageDiff result;
+    if (expected.width != actual.width || expected.height != actual.height) {
+        result.sizeMismatch = true;
+        return result;
+    }
+    const float limit = kMaxYIQDelta * threshold * threshold;
+    float maxDelta = 0.0f;
+    if (diff) {
+        diff->width = expected.width;
+        diff->height = expected.height;
+        diff->rgb.resize(expected.rgb.size());
+    }
+    for (std::size_t p = 0; p < expected.rgb.size(); p += 3) {
+        const float delta = yiqDelta(&expected.rgb[p], &actual.rgb[p]);
+        maxDelta = std::max(maxDelta, delta);
+        const bool differs = delta > limit;
+        if (differs) result.differing++;
+        if (!diff) continue;
+        if (differs) {
+            diff->rgb[p] = 255;
+            diff->rgb[p + 1] = 0;
+            diff->rgb[p + 2] = 0;
+        }
+        else {
+            const unsigned char* e = &expected.rgb[p];
+            const float luma = e[0] * 0.299f + e[1] * 0.587f + e[2] * 0.114f;
+            const unsigned char grey = static_cast<unsigned char>(255.0f - 0.1f * (255.0f - luma));
+            diff->rgb[p] = diff->rgb[p + 1] = diff->rgb[p + 2] = grey;
+        }
+    }
+    result.maxDelta = std::sqrt(maxDelta / kMaxYIQDelta);
+    return result;
+}
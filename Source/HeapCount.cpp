@@ -0,0 +1,40 @@
+#include "../Header/Hitch.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacement global operator new/delete that count heap activity for the
+// hitch detector. They live alone in this file so the compiler never inlines
+// them into container code it can see. The array and nothrow forms forward
+// to these by default.
+namespace {
+std::atomic<uint64_t> gAllocations{ 0 };
+std::atomic<uint64_t> gFrees{ 0 };
+std::atomic<uint64_t> gAllocatedBytes{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = std::malloc(size > 0 ? size : 1);
+    if (!p) throw std::bad_alloc();
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (!p) return;
+    gFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+uint64_t heapAllocations() { return gAllocations.load(std::memory_order_relaxed); }
+uint64_t heapFrees() { return gFrees.load(std::memory_order_relaxed); }
+uint64_t heapAllocatedBytes() { return gAllocatedBytes.load(std::memory_order_relaxed); }
@@ -0,0 +1,168 @@
+#include "../Header/Hitch.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// ---------------------- GL call ring ---------------------- //
+namespace {
+constexpr int kGLRing = 32;
+struct GLCall {
+    const char* name;
+    uint32_t arg;
+};
+GLCall gGLCalls[kGLRing];
+uint64_t gGLCallCount = 0;
+
+struct Usage {
+    long voluntary = 0;
+    long involuntary = 0;
+    long minor = 0;
+    long major = 0;
+};
+
+// The calling thread's counts where the OS can tell threads apart.
+Usage threadUsage()
+{
+    Usage u;
+#ifndef _WIN32
+    rusage r;
+#ifdef RUSAGE_THREAD
+    const int who = RUSAGE_THREAD;
+#else
+    const int who = RUSAGE_SELF;
+#endif
+    if (getrusage(who, &r) == 0) {
+        u.voluntary = r.ru_nvcsw;
+        u.involuntary = r.ru_nivcsw;
+        u.minor = r.ru_minflt;
+        u.major = r.ru_majflt;
+    }
+#endif
+    return u;
+}
+
+constexpr uint64_t kWarmupFrames = 30;
+constexpr float kBaselineWeight = 0.05f;
+}
+
+void recordGLCall(const char* name, uint32_t arg)
+{
+    gGLCalls[gGLCallCount % kGLRing] = { name, arg };
+    gGLCallCount++;
+}
+
+// ---------------------- HitchDetector ---------------------- //
+HitchDetector::~HitchDetector()
+{
+    if (log) std::fclose(log);
+}
+
+void HitchDetector::init(const HitchOptions& options)
+{
+    opts = options;
+    captures.clear();
+    if (log) std::fclose(log);
+    log = nullptr;
+    if (!opts.logPath.empty()) {
+        log = std::fopen(opts.logPath.c_str(), "a");
+        if (!log) std::cout << "[HITCH] could not open " << opts.logPath << std::endl;
+    }
+    logged = 0;
+    frameCount = hitchCount = 0;
+    baseline = 0.0f;
+}
+
+void HitchDetector::beginFrame()
+{
+    allocStart = heapAllocations();
+    freeStart = heapFrees();
+    bytesStart = heapAllocatedBytes();
+    Usage u = threadUsage();
+    volStart = u.voluntary;
+    involStart = u.involuntary;
+    minorStart = u.minor;
+    majorStart = u.major;
+}
+
+bool HitchDetector::endFrame(double atSeconds, uint32_t tick, float frameMs, const char* gameState,
+    const std::vector<HitchTiming>& phases, const std::vector<HitchTiming>& systems)
+{
+    frameCount++;
+    const float threshold = std::max(opts.minMs, baseline * opts.factor);
+    if (frameCount <= kWarmupFrames || frameMs <= threshold) {
+        // Hitches stay out of the baseline so one bad frame cannot hide the next.
+        baseline = baseline == 0.0f ? frameMs : baseline + kBaselineWeight * (frameMs - baseline);
+        return false;
+    }
+    hitchCount++;
+
+    // Sample before building the capture, which allocates itself.
+    const uint64_t allocations = heapAllocations() - allocStart;
+    const uint64_t frees = heapFrees() - freeStart;
+    const uint64_t allocatedBytes = heapAllocatedBytes() - bytesStart;
+    const Usage u = threadUsage();
+
+    HitchCapture c;
+    c.frame = frameCount;
+    c.tick = tick;
+    c.atSeconds = atSeconds;
+    c.frameMs = frameMs;
+    c.baselineMs = baseline;
+    c.thresholdMs = threshold;
+    c.gameState = gameState;
+    c.phases = phases;
+    c.systems = systems;
+    c.allocations = allocations;
+    c.frees = frees;
+    c.allocatedBytes = allocatedBytes;
+    c.voluntarySwitches = u.voluntary - volStart;
+    c.involuntarySwitches = u.involuntary - involStart;
+    c.minorFaults = u.minor - minorStart;
+    c.majorFaults = u.major - majorStart;
+    const uint64_t first = gGLCallCount > uint64_t(kGLRing) ? gGLCallCount - kGLRing : 0;
+    for (uint64_t i = first; i < gGLCallCount; ++i) {
+        const GLCall& call = gGLCalls[i % kGLRing];
+        c.glCalls.push_back(std::string(call.name) + "(" + std::to_string(call.arg) + ")");
+    }
+
+    if (log && logged < opts.maxLogged) {
+        write(log, c);
+        std::fflush(log);
+        if (++logged == opts.maxLogged) std::fprintf(log, "[HITCH] log limit of %d captures reached for this run\n", opts.maxLogged);
+    }
+    captures.push_back(std::move(c));
+    while (captures.size() > opts.kept) captures.pop_front();
+    return true;
+}
+
+void HitchDetector::write(std::FILE* f, const HitchCapture& c) const
+{
+    std::fprintf(f, "[HITCH] frame %llu tick %u at %.3f s: %.2f ms (baseline %.2f ms, threshold %.2f ms), state %s\n",
+        static_cast<unsigned long long>(c.frame), c.tick, c.atSeconds, c.frameMs, c.baselineMs, c.thresholdMs, c.gameState);
+    std::fprintf(f, "  phases:");
+    for (const HitchTiming& t : c.phases) std::fprintf(f, " %s %.2f", t.name.c_str(), t.ms);
+    std::fprintf(f, " ms\n  systems:");
+    for (const HitchTiming& t : c.systems) std::fprintf(f, " %s %.3f", t.name.c_str(), t.ms);
+    std::fprintf(f, " ms\n  heap: %llu new (%llu B), %llu delete\n",
+        static_cast<unsigned long long>(c.allocations), static_cast<unsigned long long>(c.allocatedBytes), static_cast<unsigned long long>(c.frees));
+    std::fprintf(f, "  os: %ld voluntary / %ld involuntary context switches, %ld minor / %ld major page faults\n",
+        c.voluntarySwitches, c.involuntarySwitches, c.minorFaults, c.majorFaults);
+    std::fprintf(f, "  recent GL:");
+    for (const std::string& call : c.glCalls) std::fprintf(f, " %s", call.c_str());
+    std::fprintf(f, "\n");
+}
+
+void HitchDetector::report(std::ostream& out) const
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "[HITCH] %llu hitches in %llu frames, baseline %.2f ms; last %zu:\n",
+        static_cast<unsigned long long>(hitchCount), static_cast<unsigned long long>(frameCount), baseline, captures.size());
+    out << line;
+    out.flush();
+    for (const HitchCapture& c : captures) write(stdout, c);
+    std::fflush(stdout);
+}
@@ -0,0 +1,371 @@
+#include "../Header/Ledger.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr uint32_t kSnapshotFileMagic = 0x474C4C43;  // "CLLG"
+constexpr uint32_t kSnapshotFileVersion = 1;
+
+struct LedgerSnapshotFile {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t credits;
+    uint64_t payouts;
+    uint64_t lastSequence;
+    uint32_t crc;
+    uint32_t reserved;
+};
+static_assert(sizeof(LedgerSnapshotFile) == 40, "LedgerSnapshotFile layout changed");
+
+uint32_t crc32(const void* data, std::size_t size)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t c = 0xFFFFFFFFu;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint32_t recordCrc(const LedgerRecord& r)
+{
+    return crc32(&r, offsetof(LedgerRecord, crc));
+}
+
+uint32_t snapshotCrc(const LedgerSnapshotFile& s)
+{
+    return crc32(&s, offsetof(LedgerSnapshotFile, crc));
+}
+
+void applyRecord(LedgerTotals& t, const LedgerRecord& r)
+{
+    if (r.type == static_cast<uint8_t>(LedgerEntryType::Credit)) t.credits += r.amount;
+    else t.payouts += r.amount;
+    t.lastSequence = r.sequence;
+}
+
+int64_t unixMillis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}
+
+Ledger::~Ledger()
+{
+    close();
+}
+
+uint64_t Ledger::append(LedgerEntryType type, int32_t amount, uint32_t tick)
+{
+    if (journalFd < 0) return 0;
+    auto start = std::chrono::steady_clock::now();
+    LedgerRecord r{};
+    r.unixMs = unixMillis();
+    r.tick = tick;
+    r.amount = amount;
+    r.type = static_cast<uint8_t>(type);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        r.sequence = queuedTotals.lastSequence + 1;
+        r.crc = recordCrc(r);
+        pending.push_back(r);
+        applyRecord(queuedTotals, r);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        appendCount++;
+        appendUsTotal += us;
+        appendUsMax = std::max(appendUsMax, us);
+    }
+    wake.notify_one();
+    return r.sequence;
+}
+
+LedgerTotals Ledger::totals() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedTotals;
+}
+
+LedgerStats Ledger::stats() const
+{
+    LedgerStats s;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        s.appended = appendCount;
+        s.avgAppendUs = appendCount ? appendUsTotal / appendCount : 0.0;
+        s.maxAppendUs = appendUsMax;
+    }
+    s.durable = durable.load(std::memory_order_acquire);
+    s.batches = batchCount.load(std::memory_order_relaxed);
+    s.compactions = compactionCount.load(std::memory_order_relaxed);
+    s.avgSyncMs = s.batches ? syncNsTotal.load(std::memory_order_relaxed) / 1e6 / s.batches : 0.0;
+    return s;
+}
+
+#ifndef _WIN32
+
+namespace {
+std::string journalPath(const std::string& dir) { return dir + "/ledger.journal"; }
+std::string snapshotPath(const std::string& dir) { return dir + "/ledger.snapshot"; }
+
+bool writeAll(int fd, const void* data, std::size_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+int syncData(int fd)
+{
+#ifdef __APPLE__
+    return fsync(fd);
+#else
+    return fdatasync(fd);
+#endif
+}
+
+// Makes a rename inside dir durable.
+void syncDirectory(const std::string& dir)
+{
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    ::close(fd);
+}
+}
+
+bool Ledger::recover(const std::string& dir, LedgerTotals& totals, LedgerRecovery& info)
+{
+    totals = LedgerTotals{};
+    info = LedgerRecovery{};
+    mkdir(dir.c_str(), 0755);
+    // A temp snapshot is only ever renamed into place once complete.
+    std::remove((snapshotPath(dir) + ".tmp").c_str());
+
+    int sfd = ::open(snapshotPath(dir).c_str(), O_RDONLY);
+    if (sfd >= 0) {
+        LedgerSnapshotFile s{};
+        ssize_t n = ::read(sfd, &s, sizeof(s));
+        ::close(sfd);
+        if (n != ssize_t(sizeof(s)) || s.magic != kSnapshotFileMagic || s.version != kSnapshotFileVersion || s.crc != snapshotCrc(s)) {
+            std::cout << "[LEDGER] snapshot " << snapshotPath(dir) << " is damaged; refusing to guess the totals" << std::endl;
+            return false;
+        }
+        totals.credits = s.credits;
+        totals.payouts = s.payouts;
+        totals.lastSequence = s.lastSequence;
+        info.hadSnapshot = true;
+    }
+
+    int fd = ::open(journalPath(dir).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cout << "[LEDGER] could not open " << journalPath(dir) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    std::vector<uint8_t> bytes(std::size_t(st.st_size));
+    std::size_t got = 0;
+    while (got < bytes.size()) {
+        ssize_t n = ::read(fd, bytes.data() + got, bytes.size() - got);
+        if (n <= 0) break;
+        got += std::size_t(n);
+    }
+
+    // Replay up to the first record that is short, fails its checksum or
+    // breaks the sequence; a crash can only damage the tail.
+    std::size_t good = 0;
+    uint64_t expected = 0;
+    while (good + sizeof(LedgerRecord) <= got) {
+        LedgerRecord r;
+        std::memcpy(&r, bytes.data() + good, sizeof(r));
+        if (r.crc != recordCrc(r)) break;
+        if (expected != 0 && r.sequence != expected) break;
+        if (r.sequence <= totals.lastSequence) {
+            info.skipped++;
+        }
+        else if (r.sequence == totals.lastSequence + 1) {
+            applyRecord(totals, r);
+            info.replayed++;
+        }
+        else {
+            break;
+        }
+        expected = r.sequence + 1;
+        good += sizeof(LedgerRecord);
+    }
+    if (good < std::size_t(st.st_size)) {
+        info.truncatedBytes = std::size_t(st.st_size) - good;
+        if (ftruncate(fd, static_cast<off_t>(good)) != 0 || fsync(fd) != 0) {
+            ::close(fd);
+            return false;
+        }
+    }
+    ::close(fd);
+    return true;
+}
+
+bool Ledger::open(const std::string& dir, const LedgerOptions& options)
+{
+    close();
+    LedgerTotals t;
+    if (!recover(dir, t, recovered)) return false;
+
+    journalFd = ::open(journalPath(dir).c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (journalFd < 0) return false;
+    struct stat st;
+    journalRecords = fstat(journalFd, &st) == 0 ? std::size_t(st.st_size) / sizeof(LedgerRecord) : 0;
+
+    directory = dir;
+    opts = options;
+    queuedTotals = t;
+    durableTotals = t;
+    durable.store(t.lastSequence, std::memory_order_release);
+    pending.clear();
+    pending.reserve(64);
+    stopping = false;
+    writer = std::thread(&Ledger::run, this);
+    return true;
+}
+
+void Ledger::close()
+{
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    ::close(journalFd);
+    journalFd = -1;
+}
+
+void Ledger::run()
+{
+    const auto window = std::chrono::duration<float, std::milli>(opts.groupWindowMs);
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) break;
+        // Hold the batch open briefly so a burst shares one fdatasync.
+        if (!stopping) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(window);
+            wake.wait_until(lock, deadline, [this] { return stopping; });
+        }
+        batch.swap(pending);
+        lock.unlock();
+
+        if (!writeBatch(batch)) {
+            // Cut any partial write so the journal stays gapless, and retry
+            // the batch ahead of anything queued since.
+            std::cout << "[LEDGER] journal write failed: " << std::strerror(errno) << std::endl;
+            if (ftruncate(journalFd, static_cast<off_t>(journalRecords * sizeof(LedgerRecord))) != 0) {
+                std::cout << "[LEDGER] could not trim the journal after a failed write" << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            lock.lock();
+            pending.insert(pending.begin(), batch.begin(), batch.end());
+            batch.clear();
+            continue;
+        }
+        if (journalRecords >= opts.compactRecords && !compact()) {
+            std::cout << "[LEDGER] compaction failed: " << std::strerror(errno) << std::endl;
+        }
+        batch.clear();
+        lock.lock();
+    }
+}
+
+bool Ledger::writeBatch(const std::vector<LedgerRecord>& records)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (!writeAll(journalFd, records.data(), records.size() * sizeof(LedgerRecord))) return false;
+    if (syncData(journalFd) != 0) return false;
+    for (const LedgerRecord& r : records) applyRecord(durableTotals, r);
+    journalRecords += records.size();
+    durable.store(durableTotals.lastSequence, std::memory_order_release);
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    syncNsTotal.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+    return true;
+}
+
+// Snapshot first, then empty the journal. A crash in between leaves records
+// the snapshot already covers, which recovery skips by sequence number.
+bool Ledger::compact()
+{
+    LedgerSnapshotFile s{};
+    s.magic = kSnapshotFileMagic;
+    s.version = kSnapshotFileVersion;
+    s.credits = durableTotals.credits;
+    s.payouts = durableTotals.payouts;
+    s.lastSequence = durableTotals.lastSequence;
+    s.crc = snapshotCrc(s);
+
+    const std::string tmp = snapshotPath(directory) + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = writeAll(fd, &s, sizeof(s)) && fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tmp.c_str(), snapshotPath(directory).c_str()) != 0) return false;
+    syncDirectory(directory);
+
+    if (ftruncate(journalFd, 0) != 0 || fsync(journalFd) != 0) return false;
+    journalRecords = 0;
+    compactionCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+#else
+
+bool Ledger::recover(const std::string&, LedgerTotals& totals, LedgerRecovery& info)
+{
+    totals = LedgerTotals{};
+    info = LedgerRecovery{};
+    return false;
+}
+
+bool Ledger::open(const std::string&, const LedgerOptions&)
+{
+    std::cout << "[LEDGER] the durable ledger needs POSIX file syncing" << std::endl;
+    return false;
+}
+
+void Ledger::close() {}
+void Ledger::run() {}
+bool Ledger::writeBatch(const std::vector<LedgerRecord>&) { return false; }
+bool Ledger::compact() { return false; }
+
+#endif
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../Header/Ledger.h"
+
+// Crash-consistency check for the ledger. Each round forks a writer that
+// appends a known pattern of events as fast as it can and reports every
+// sequence number the ledger has made durable through a pipe. The writer is
+// SIGKILLed at a random moment, sometimes a torn record is appended to the
+// journal as a write cut short would leave it, and the ledger is recovered.
+// Recovery must keep every acknowledged event, cut off anything damaged, and
+// reproduce the totals the pattern implies. Rounds continue the same ledger,
+// so crashes also land during compaction.
+
+struct CheckOptions {
+    std::string dir = "/tmp/clawmachine-ledger-check";
+    int rounds = 50;
+    uint32_t seed = 1;
+};
+
+CheckOptions parseArgs(int argc, char** argv)
+{
+    CheckOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) opts.dir = argv[++i];
+        else if (arg == "--rounds" && i + 1 < argc) opts.rounds = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc) opts.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    return opts;
+}
+
+// The event with a given sequence number is fully determined by it.
+LedgerEntryType patternType(uint64_t seq) { return seq % 3 == 0 ? LedgerEntryType::Payout : LedgerEntryType::Credit; }
+int32_t patternAmount(uint64_t seq) { return seq % 3 == 0 ? 1 : int32_t(seq % 5) + 1; }
+
+LedgerTotals expectedTotals(uint64_t last)
+{
+    LedgerTotals t;
+    for (uint64_t seq = 1; seq <= last; ++seq) {
+        if (patternType(seq) == LedgerEntryType::Credit) t.credits += patternAmount(seq);
+        else t.payouts += patternAmount(seq);
+    }
+    t.lastSequence = last;
+    return t;
+}
+
+[[noreturn]] void runWriter(const std::string& dir, int ackFd, uint32_t seed)
+{
+    Ledger ledger;
+    LedgerOptions options;
+    options.groupWindowMs = 0.5f;
+    options.compactRecords = 512;
+    if (!ledger.open(dir, options)) _exit(2);
+    std::minstd_rand rng(seed);
+    uint64_t reported = ledger.durableSequence();
+    for (;;) {
+        uint64_t next = ledger.totals().lastSequence + 1;
+        ledger.append(patternType(next), patternAmount(next), static_cast<uint32_t>(next));
+        uint64_t durable = ledger.durableSequence();
+        if (durable != reported) {
+            reported = durable;
+            if (write(ackFd, &durable, sizeof(durable)) != ssize_t(sizeof(durable))) _exit(3);
+        }
+        if (rng() % 8 == 0) std::this_thread::sleep_for(std::chrono::microseconds(rng() % 200));
+    }
+}
+
+// Appends part of a plausible next record, as a write cut short would.
+void tearJournal(const std::string& dir, uint64_t nextSequence, std::size_t bytes)
+{
+    LedgerRecord r{};
+    r.sequence = nextSequence;
+    r.amount = patternAmount(nextSequence);
+    r.type = static_cast<uint8_t>(patternType(nextSequence));
+    int fd = open((dir + "/ledger.journal").c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) return;
+    if (write(fd, &r, bytes) != ssize_t(bytes)) std::cout << "[CHECK] could not tear the journal" << std::endl;
+    close(fd);
+}
+
+int main(int argc, char** argv)
+{
+    CheckOptions opts = parseArgs(argc, argv);
+    std::remove((opts.dir + "/ledger.journal").c_str());
+    std::remove((opts.dir + "/ledger.snapshot").c_str());
+    std::mt19937 rng(opts.seed);
+
+    int failures = 0;
+    uint64_t lastRecovered = 0;
+    std::size_t totalTruncated = 0;
+    for (int round = 1; round <= opts.rounds; ++round) {
+        int fds[2];
+        if (pipe(fds) != 0) return -1;
+        pid_t child = fork();
+        if (child < 0) return -1;
+        if (child == 0) {
+            close(fds[0]);
+            runWriter(opts.dir, fds[1], rng());
+        }
+        close(fds[1]);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5 + rng() % 60));
+        kill(child, SIGKILL);
+        int status = 0;
+        waitpid(child, &status, 0);
+
+        uint64_t acked = 0;
+        uint64_t value;
+        while (read(fds[0], &value, sizeof(value)) == ssize_t(sizeof(value))) acked = std::max(acked, value);
+        close(fds[0]);
+        if (WIFEXITED(status)) {
+            std::printf("[CHECK] round %d: writer exited with %d before the kill\n", round, WEXITSTATUS(status));
+            failures++;
+            continue;
+        }
+
+        LedgerTotals before;
+        LedgerRecovery info;
+        bool torn = rng() % 3 == 0;
+        if (torn && Ledger::recover(opts.dir, before, info)) {
+            tearJournal(opts.dir, before.lastSequence + 1, 1 + rng() % (sizeof(LedgerRecord) - 1));
+        }
+
+        LedgerTotals t;
+        bool ok = Ledger::recover(opts.dir, t, info);
+        LedgerTotals want = expectedTotals(t.lastSequence);
+        bool consistent = ok && t.lastSequence >= acked && t.credits == want.credits && t.payouts == want.payouts;
+        bool cutTear = !torn || info.truncatedBytes > 0;
+        if (!consistent || !cutTear) failures++;
+        lastRecovered = t.lastSequence;
+        totalTruncated += info.truncatedBytes;
+        std::printf("[CHECK] round %3d: acked %6llu, recovered %6llu (snapshot %s, %zu replayed, %zu torn bytes cut)%s\n",
+            round, static_cast<unsigned long long>(acked), static_cast<unsigned long long>(t.lastSequence),
+            info.hadSnapshot ? "yes" : "no", info.replayed, info.truncatedBytes,
+            consistent && cutTear ? "" : "  FAILED");
+    }
+
+    std::printf("[CHECK] %d rounds, %d failed; ledger holds %llu events, %zu torn bytes cut in total\n",
+        opts.rounds, failures, static_cast<unsigned long long>(lastRecovered), totalTruncated);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#include "../Header/LiveStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "../Header/Machine.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+LiveStatsSegment* gSegment = nullptr;
+std::string gName;
+std::chrono::steady_clock::time_point gStart;
+
+// Sliding window over the last kLiveStatsWindow frames. Frame times are kept
+// as 0.25 ms bins with a running histogram, so percentiles are one short walk
+// instead of a sort every frame. The maximum is rescanned only when the frame
+// leaving the window was the maximum.
+constexpr int kFrameBins = 257;          // 0..64 ms, the last bin holds the rest
+constexpr float kBinsPerMs = 4.0f;
+
+struct FrameWindow {
+    float frameMs[kLiveStatsWindow] = {};
+    float dt[kLiveStatsWindow] = {};
+    uint16_t bin[kLiveStatsWindow] = {};
+    uint16_t histogram[kFrameBins] = {};
+    double dtSum = 0.0;
+    float maxMs = 0.0f;
+    uint64_t frames = 0;
+};
+FrameWindow gWindow;
+
+void addFrame(FrameWindow& w, float frameMs, float dt)
+{
+    const int slot = static_cast<int>(w.frames % kLiveStatsWindow);
+    const bool full = w.frames >= uint64_t(kLiveStatsWindow);
+    const bool evictsMax = full && w.frameMs[slot] >= w.maxMs;
+    if (full) {
+        w.histogram[w.bin[slot]]--;
+        w.dtSum -= w.dt[slot];
+    }
+    const int b = std::min(static_cast<int>(std::max(frameMs, 0.0f) * kBinsPerMs), kFrameBins - 1);
+    w.frameMs[slot] = frameMs;
+    w.dt[slot] = dt;
+    w.bin[slot] = static_cast<uint16_t>(b);
+    w.histogram[b]++;
+    w.dtSum += dt;
+    w.frames++;
+    if (evictsMax && frameMs < w.maxMs) w.maxMs = *std::max_element(w.frameMs, w.frameMs + kLiveStatsWindow);
+    else w.maxMs = std::max(w.maxMs, frameMs);
+}
+
+// Upper edges of the bins holding the 50th, 95th and 99th percentiles.
+void percentiles(const FrameWindow& w, float& p50, float& p95, float& p99)
+{
+    const int n = static_cast<int>(std::min<uint64_t>(w.frames, kLiveStatsWindow));
+    const int target[3] = { (n * 50 + 99) / 100, (n * 95 + 99) / 100, (n * 99 + 99) / 100 };
+    float* out[3] = { &p50, &p95, &p99 };
+    int next = 0;
+    int seen = 0;
+    for (int b = 0; b < kFrameBins && next < 3; ++b) {
+        seen += w.histogram[b];
+        while (next < 3 && seen >= target[next]) *out[next++] = (b + 1) / kBinsPerMs;
+    }
+}
+}
+
+bool openLiveStats(const std::string& name)
+{
+    closeLiveStats();
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cout << "[STATS] could not open shared memory " << name << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(LiveStatsSegment)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        std::cout << "[STATS] could not size shared memory " << name << std::endl;
+        return false;
+    }
+    void* base = mmap(nullptr, sizeof(LiveStatsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        std::cout << "[STATS] could not map shared memory " << name << std::endl;
+        return false;
+    }
+
+    // Truncation zeroed the segment: sequence 0 means nothing published yet.
+    LiveStatsSegment* seg = static_cast<LiveStatsSegment*>(base);
+    seg->magic = kLiveStatsMagic;
+    seg->version = kLiveStatsVersion;
+    seg->payloadSize = sizeof(LiveStats);
+    seg->pid = static_cast<uint32_t>(getpid());
+    gWindow = FrameWindow{};
+    gStart = std::chrono::steady_clock::now();
+    gName = name;
+    gSegment = seg;
+    std::cout << "[STATS] publishing live stats to shared memory " << name << std::endl;
+    return true;
+}
+
+void closeLiveStats()
+{
+    if (!gSegment) return;
+    munmap(gSegment, sizeof(LiveStatsSegment));
+    shm_unlink(gName.c_str());
+    gSegment = nullptr;
+}
+
+void publishLiveStats(const Machine& m, uint32_t tick, float frameMs, float dt, bool rewinding)
+{
+    LiveStatsSegment* seg = gSegment;
+    if (!seg) return;
+    addFrame(gWindow, frameMs, dt);
+
+    LiveStats s{};
+    s.frame = gWindow.frames;
+    s.timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gStart).count());
+    s.tick = tick;
+    s.gameState = static_cast<uint8_t>(m.gameState);
+    s.lampMode = static_cast<uint8_t>(m.lamp.mode);
+    s.lampBlink = lampBlinkOn(m) ? 1 : 0;
+    s.rewinding = rewinding ? 1 : 0;
+    const int n = static_cast<int>(std::min<uint64_t>(gWindow.frames, kLiveStatsWindow));
+    s.fps = gWindow.dtSum > 0.0 ? float(n / gWindow.dtSum) : 0.0f;
+    s.frameMs = frameMs;
+    percentiles(gWindow, s.p50Ms, s.p95Ms, s.p99Ms);
+    s.maxMs = gWindow.maxMs;
+    Vec2 claw = clawPosition(m);
+    s.clawX = claw.x;
+    s.clawY = claw.y;
+    s.ropeLength = m.claw.ropeLength;
+    s.coinsInserted = m.coinsInserted;
+    s.prizesPaid = m.prizesPaid;
+
+    uint32_t words[kLiveStatsWords];
+    std::memcpy(words, &s, sizeof(s));
+    const uint32_t seq = seg->sequence.load(std::memory_order_relaxed);
+    seg->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kLiveStatsWords; ++i) seg->words[i].store(words[i], std::memory_order_relaxed);
+    seg->sequence.store(seq + 2, std::memory_order_release);
+}
+
+LiveStatsReader::~LiveStatsReader()
+{
+    close();
+}
+
+bool LiveStatsReader::open(const std::string& name)
+{
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(LiveStatsSegment)) {
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, sizeof(LiveStatsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+    const LiveStatsSegment* seg = static_cast<const LiveStatsSegment*>(base);
+    if (seg->magic != kLiveStatsMagic || seg->version != kLiveStatsVersion || seg->payloadSize != sizeof(LiveStats)) {
+        munmap(base, sizeof(LiveStatsSegment));
+        return false;
+    }
+    segment = seg;
+    retryCount = 0;
+    return true;
+}
+
+void LiveStatsReader::close()
+{
+    if (!segment) return;
+    munmap(const_cast<LiveStatsSegment*>(segment), sizeof(LiveStatsSegment));
+    segment = nullptr;
+}
+
+bool LiveStatsReader::sample(LiveStats& out)
+{
+    if (!segment) return false;
+    uint32_t words[kLiveStatsWords];
+    for (int attempt = 0; attempt < 10000; ++attempt) {
+        const uint32_t before = segment->sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            retryCount++;
+            continue;
+        }
+        for (std::size_t i = 0; i < kLiveStatsWords; ++i) words[i] = segment->words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->sequence.load(std::memory_order_relaxed) == before) {
+            std::memcpy(&out, words, sizeof(out));
+            return before != 0;
+        }
+        retryCount++;
+    }
+    return false;
+}
+
+#else
+
+bool openLiveStats(const std::string&)
+{
+    std::cout << "[STATS] live stats need POSIX shared memory" << std::endl;
+    return false;
+}
+
+void closeLiveStats() {}
+void publishLiveStats(const Machine&, uint32_t, float, float, bool) {}
+LiveStatsReader::~LiveStatsReader() {}
+bool LiveStatsReader::open(const std::string&) { return false; }
+void LiveStatsReader::close() {}
+bool LiveStatsReader::sample(LiveStats&) { return false; }
+
+#endif
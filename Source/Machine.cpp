@@ -0,0 +1,984 @@
+#include "../Header/Machine.h"
+#include "../Header/Fixed.h"
+#include "../Header/FlightRecorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+const char* gameStateName(GameState s) {
+    switch (s) {
+    case GameState::Idle: return "Idle";
+    case GameState::ActiveNoToy: return "ActiveNoToy";
+    case GameState::ActiveCarrying: return "ActiveCarrying";
+    case GameState::ToyFalling: return "ToyFalling";
+    case GameState::PrizeWaiting: return "PrizeWaiting";
+    default: return "Unknown";
+    }
+}
+
+// Transitions of a logged machine also go to the flight recorder.
+static void setGameState(Machine& m, GameState s)
+{
+    if (m.logEvents && s != m.gameState) {
+        flightRecord(FlightEvent::State, static_cast<uint16_t>(m.gameState), static_cast<uint32_t>(s));
+    }
+    m.gameState = s;
+}
+
+static void emitPlayEvent(Machine& m, PlayEventType type, uint8_t flag, float value)
+{
+    if (m.recordPlays) m.playEvents.push_back({ type, flag, m.coinsInserted, float(m.clock), value });
+}
+
+// ---------------------- Setup ---------------------- //
+void initMachine(Machine& m, const MachineTextures& textures, uint32_t seed)
+{
+    m.textures = textures;
+    m.rng.seed(seed);
+    m.registry.clear();
+    spawnToys(m);
+    resetMachine(m);
+    createMachineEntities(m);
+}
+
+// Where the drawn rope meets the claw: the middle of its top edge.
+static Vec2 ropeBottom(const Machine& m)
+{
+    return m.claw.pos + Vec2{ 0.0f, m.claw.height * 0.5f };
+}
+
+// Claw at rest straight below the carriage, rope straight.
+static void hangClaw(Machine& m)
+{
+    m.claw.pos = m.claw.prevPos = m.claw.anchor - Vec2{ 0.0f, m.claw.ropeLength };
+    resetRope(m.rope, m.claw.anchor, ropeBottom(m));
+}
+
+void resetMachine(Machine& m)
+{
+    configureLayout(m);
+
+    setGameState(m, GameState::Idle);
+    m.lamp.mode = LampMode::Off;
+    m.lamp.blinkStart = 0.0;
+
+    m.claw.anchor = { 0.0f, anchorStartY };
+    m.claw.ropeLength = m.claw.minLength;
+    m.claw.open = false;
+    m.claw.movingDown = false;
+    m.claw.movingUp = false;
+    hangClaw(m);
+
+    m.prize.hasToy = false;
+    m.prize.toy = Entity{};
+    m.grabbedToy = Entity{};
+    m.fallingToy = Entity{};
+    m.sWasDown = false;
+}
+
+void configureLayout(Machine& m)
+{
+    m.hole.center = { boxRight - 0.20f, floorY + 0.11f };
+    m.hole.radius = 0.085f;
+
+    m.prize.pos = { boxRight - 0.10f, boxBottom - 0.16f };
+    m.prize.size = { 0.32f, 0.16f };
+
+    m.tokenSlot.pos = { boxLeft + 0.30f, boxBottom - 0.14f };
+    m.tokenSlot.size = { 0.22f, 0.08f };
+
+    m.claw.anchor = { 0.0f, anchorStartY };
+    m.claw.ropeLength = m.claw.minLength;
+}
+
+void setRopeSegments(Machine& m, int segments)
+{
+    initRope(m.rope, segments);
+    resetRope(m.rope, m.claw.anchor, ropeBottom(m));
+    if (!m.parts.rope.isNull()) clawPoseSystem(m);
+}
+
+void setPlushEnabled(Machine& m, bool enabled)
+{
+    m.plushEnabled = enabled;
+    m.plush.clear();
+    m.plush.gravity = kToyGravity;
+}
+
+static Entity addSprite(Machine& m, const Vec2& pos, const Vec2& size, float rot, unsigned int texture, const std::array<float, 4>& color, int layer, EntityKind kind)
+{
+    Entity e = m.registry.create();
+    if (e.isNull()) return e;
+    m.registry.add(e, Transform{ pos, size, rot });
+    Sprite s;
+    s.texture = texture;
+    s.color = color;
+    s.layer = layer;
+    m.registry.add(e, s);
+    m.registry.add(e, Gameplay{ kind, ToyState::Resting });
+    return e;
+}
+
+Entity spawnToy(Machine& m, Vec2 spawn, unsigned int texture)
+{
+    spawn.y = floorY + kToySize.y * 0.5f;
+    Entity e = addSprite(m, spawn, kToySize, 0.0f, texture, { 1.0f,1.0f,1.0f,1.0f }, LayerToys, EntityKind::Toy);
+    if (!e.isNull()) m.registry.add(e, Body{});
+    return e;
+}
+
+void spawnToys(Machine& m)
+{
+    std::uniform_int_distribution<int> slotDist(0, static_cast<int>(spawnPositions.size()) - 1);
+    int startSlot = slotDist(m.rng);
+    std::array<unsigned int, 3> toyTextures = { m.textures.toyA, m.textures.toyB, m.textures.toyC };
+    // Walk backwards: destroying swap-removes an already visited entry into slot i.
+    for (std::size_t i = m.registry.gameplay.size(); i-- > 0;) {
+        if (m.registry.gameplay.at(i).kind == EntityKind::Toy) m.registry.destroy(m.registry.gameplay.entityAt(i));
+    }
+    for (int i = 0; i < kInitialToys; ++i) {
+        Vec2 spawn = spawnPositions[(startSlot + i) % spawnPositions.size()];
+        spawnToy(m, spawn, toyTextures[i % toyTextures.size()]);
+    }
+    m.nextSpawnSlot = (startSlot + kInitialToys) % spawnPositions.size();
+}
+
+static void createCabinetEntities(Machine& m)
+{
+    std::array<float, 4> cyan = { 0.15f, 0.68f, 0.74f, 1.0f };
+    std::array<float, 4> darkBlue = { 0.10f, 0.24f, 0.34f, 1.0f };
+    std::array<float, 4> brown = { 0.38f, 0.27f, 0.17f, 1.0f };
+
+    Vec2 cabinetCenter = { 0.0f, boxCenter.y - 0.03f };
+    Vec2 cabinetSize = { boxSize.x + 0.24f, boxSize.y + 0.36f };
+    addSprite(m, cabinetCenter, cabinetSize, 0.0f, 0, cyan, LayerCabinet, EntityKind::Decor);
+
+    // Side trims
+    float trimWidth = 0.08f;
+    addSprite(m, { boxLeft - trimWidth * 0.5f, boxCenter.y }, { trimWidth, boxSize.y + 0.32f }, 0.0f, 0, brown, LayerCabinet, EntityKind::Decor);
+    addSprite(m, { boxRight + trimWidth * 0.5f, boxCenter.y }, { trimWidth, boxSize.y + 0.32f }, 0.0f, 0, brown, LayerCabinet, EntityKind::Decor);
+
+    // Top cover
+    addSprite(m, { cabinetCenter.x, boxTop + 0.16f }, { cabinetSize.x, 0.18f }, 0.0f, 0, darkBlue, LayerCabinet, EntityKind::Decor);
+    addSprite(m, { cabinetCenter.x, boxTop + 0.24f }, { cabinetSize.x, 0.04f }, 0.0f, 0, brown, LayerCabinet, EntityKind::Decor);
+
+    // Bottom control area
+    addSprite(m, { cabinetCenter.x, boxBottom - 0.18f }, { cabinetSize.x, 0.26f }, 0.0f, 0, darkBlue, LayerCabinet, EntityKind::Decor);
+    addSprite(m, { cabinetCenter.x, boxBottom - 0.28f }, { cabinetSize.x, 0.06f }, 0.0f, 0, brown, LayerCabinet, EntityKind::Decor);
+}
+
+static void createGlassBoxEntities(Machine& m)
+{
+    // Glass tint
+    addSprite(m, boxCenter, boxSize, 0.0f, 0, { 0.75f, 0.95f, 0.98f, 0.20f }, LayerGlass, EntityKind::Decor);
+    // Inner overlay to darken a bit
+    addSprite(m, boxCenter, boxSize, 0.0f, 0, { 0.08f, 0.10f, 0.12f, 0.18f }, LayerGlass, EntityKind::Decor);
+
+    // Top band inside glass
+    addSprite(m, { boxCenter.x, boxTop - 0.04f }, { boxSize.x, 0.04f }, 0.0f, 0, { 0.12f,0.20f,0.28f,0.45f }, LayerGlass, EntityKind::Decor);
+    // Floor strip
+    addSprite(m, { boxCenter.x, floorY - 0.01f }, { boxSize.x, 0.04f }, 0.0f, 0, { 0.06f,0.08f,0.10f,0.35f }, LayerGlass, EntityKind::Decor);
+}
+
+static void createPrizeEntities(Machine& m)
+{
+    const PrizeCompartment& prize = m.prize;
+    addSprite(m, prize.pos, prize.size, 0.0f, 0, { 0.12f,0.20f,0.28f,1.0f }, LayerPrize, EntityKind::Prize);
+    addSprite(m, prize.pos + Vec2{ 0.0f, prize.size.y * 0.20f }, { prize.size.x * 1.05f, 0.02f }, 0.0f, 0, { 0.40f,0.50f,0.55f,1.0f }, LayerPrize, EntityKind::Prize);
+    m.parts.prizeGlow = addSprite(m, prize.pos, prize.size * 1.15f, 0.0f, 0, { 0.95f, 0.95f, 0.35f, 0.0f }, LayerPrizeGlow, EntityKind::Prize);
+}
+
+static void createTokenSlotEntities(Machine& m)
+{
+    const TokenSlot& tokenSlot = m.tokenSlot;
+    addSprite(m, tokenSlot.pos, tokenSlot.size, 0.0f, 0, { 0.38f,0.27f,0.17f,1.0f }, LayerTokenSlot, EntityKind::TokenSlot);
+    addSprite(m, tokenSlot.pos + Vec2{ 0.0f, 0.01f }, { tokenSlot.size.x * 0.75f, 0.012f }, 0.0f, 0, { 0.96f,0.80f,0.32f,1.0f }, LayerTokenSlot, EntityKind::TokenSlot);
+}
+
+static void createHoleEntities(Machine& m)
+{
+    addSprite(m, m.hole.center, { m.hole.radius * 2.0f, m.hole.radius * 2.0f }, 0.0f, m.textures.hole, { 0.9f,0.9f,0.95f,0.85f }, LayerHole, EntityKind::Hole);
+}
+
+static void createClawEntities(Machine& m)
+{
+    std::array<float, 4> rail = { 0.18f,0.45f,0.75f,1.0f };
+    std::array<float, 4> joint = { 0.10f,0.24f,0.34f,1.0f };
+    float railY = boxTop - 0.04f;
+    addSprite(m, { (boxLeft + boxRight) * 0.5f, railY }, { boxSize.x, 0.03f }, 0.0f, 0, rail, LayerRail, EntityKind::Claw);
+    m.parts.railJoint = addSprite(m, { m.claw.anchor.x, railY - 0.04f }, { 0.08f, 0.08f }, 0.0f, 0, joint, LayerRail, EntityKind::Claw);
+
+    m.parts.rope = addSprite(m, {}, {}, 0.0f, 0, { 0.85f,0.85f,0.90f,1.0f }, LayerRope, EntityKind::Claw);
+
+    m.parts.clawShadow = addSprite(m, {}, { m.claw.width, m.claw.height }, 0.0f, 0, { 0.08f,0.10f,0.12f,0.35f }, LayerClaw, EntityKind::Claw);
+    m.parts.clawBody = addSprite(m, {}, { m.claw.width, m.claw.height }, 0.0f, 0, {}, LayerClaw, EntityKind::Claw);
+    m.parts.jawLeft = addSprite(m, {}, {}, 0.0f, 0, {}, LayerClaw, EntityKind::Claw);
+    m.parts.jawRight = addSprite(m, {}, {}, 0.0f, 0, {}, LayerClaw, EntityKind::Claw);
+}
+
+static void createLampEntities(Machine& m)
+{
+    Vec2 lampPos = { boxCenter.x, boxTop + 0.18f };
+    addSprite(m, lampPos, { 0.16f, 0.10f }, 0.0f, 0, { 0.08f,0.08f,0.10f,1.0f }, LayerLamp, EntityKind::Lamp);
+    m.parts.lampLight = addSprite(m, lampPos, { 0.12f, 0.08f }, 0.0f, 0, {}, LayerLamp, EntityKind::Lamp);
+}
+
+// Builds the static scene; expects configureLayout() to have run.
+void createMachineEntities(Machine& m)
+{
+    createCabinetEntities(m);
+    createGlassBoxEntities(m);
+    createPrizeEntities(m);
+    createTokenSlotEntities(m);
+    createHoleEntities(m);
+    createClawEntities(m);
+    createLampEntities(m);
+    clawPoseSystem(m);
+    machineSpriteSystem(m);
+}
+
+// ---------------------- Gameplay helpers ---------------------- //
+void startGame(Machine& m)
+{
+    if (m.gameState != GameState::Idle) return;
+    m.coinsInserted++;
+    m.trace = PlayTrace{};
+    m.trace.startTime = m.clock;
+    emitPlayEvent(m, PlayEventType::Start, 0, 0.0f);
+    m.lamp.mode = LampMode::Blue;
+    m.claw.open = true;
+    setGameState(m, GameState::ActiveNoToy);
+    machineSpriteSystem(m);
+}
+
+void startLowering(Machine& m)
+{
+    if (m.claw.movingDown || m.claw.movingUp) return;
+    m.claw.movingDown = true;
+    m.trace.awaitingGrab = true;
+    emitPlayEvent(m, PlayEventType::Drop, 0, m.clock - m.trace.startTime);
+}
+
+void attachToy(Machine& m, Entity toy)
+{
+    Gameplay* g = m.registry.gameplay.get(toy);
+    Body* b = m.registry.bodies.get(toy);
+    if (!g || !b) return;
+    m.grabbedToy = toy;
+    g->toy = ToyState::Grabbed;
+    b->velocity = { 0.0f, 0.0f };
+    m.claw.open = false;
+    setGameState(m, GameState::ActiveCarrying);
+    if (m.trace.awaitingGrab) emitPlayEvent(m, PlayEventType::Grab, 1, m.claw.anchor.x);
+    m.trace.awaitingGrab = false;
+    m.claw.movingDown = false;
+    m.claw.movingUp = true;
+}
+
+void releaseToy(Machine& m)
+{
+    Gameplay* g = m.registry.gameplay.get(m.grabbedToy);
+    Body* b = m.registry.bodies.get(m.grabbedToy);
+    Transform* t = m.registry.transforms.get(m.grabbedToy);
+    if (!g || !b || !t) return;
+    g->toy = ToyState::Falling;
+    b->velocity = { 0.0f, 0.0f };
+    b->gravity = kToyGravity;
+    b->simulate = true;
+    t->pos = clawGrabPoint(m);
+    m.fallingToy = m.grabbedToy;
+    m.grabbedToy = Entity{};
+    m.claw.open = true;
+    setGameState(m, GameState::ToyFalling);
+    m.trace.releaseTime = m.clock;
+    emitPlayEvent(m, PlayEventType::Release, 0, m.claw.anchor.x);
+}
+
+void collectPrize(Machine& m)
+{
+    if (m.logEvents) {
+        std::cout << "[COLLECT] collectPrize() called. prize.hasToy=" << (m.prize.hasToy ? 1 : 0)
+            << " toy=" << m.prize.toy.index << ":" << m.prize.toy.generation
+            << " stateBefore=" << gameStateName(m.gameState) << std::endl;
+    }
+
+    if (m.logEvents) flightRecord(FlightEvent::Collect, m.prize.hasToy ? 1 : 0, m.prize.toy.index);
+
+    const Sprite* won = m.registry.sprites.get(m.prize.toy);
+    if (!m.prize.hasToy || !won) return;
+    unsigned int texture = won->texture;
+    m.registry.destroy(m.prize.toy);
+    m.prizesPaid++;
+    emitPlayEvent(m, PlayEventType::Collect, 0, m.clock - m.trace.prizeReadyTime);
+    // Respawn a toy to keep the machine playable.
+    spawnToy(m, spawnPositions[m.nextSpawnSlot], texture);
+    m.nextSpawnSlot = (m.nextSpawnSlot + 1) % spawnPositions.size();
+
+    m.prize.hasToy = false;
+    m.prize.toy = Entity{};
+    m.pendingPrizeClick = false;
+    resetMachine(m);
+    m.lamp.mode = LampMode::Off;
+    m.claw.open = false;
+    machineSpriteSystem(m);
+
+    if (m.logEvents) {
+        std::cout << "[COLLECT] DONE: prize cleared, stateAfter=" << gameStateName(m.gameState)
+            << " prize.hasToy=" << (m.prize.hasToy ? 1 : 0) << std::endl;
+    }
+}
+
+void clickMachine(Machine& m, const Vec2& p, int clickId)
+{
+    if (m.logEvents) {
+        std::cout << "\n[CLICK #" << clickId << "] mouseGL=(" << p.x << ", " << p.y << ")"
+            << " state=" << gameStateName(m.gameState)
+            << " prize.hasToy=" << (m.prize.hasToy ? 1 : 0)
+            << " prize.toy=" << m.prize.toy.index << ":" << m.prize.toy.generation
+            << std::endl;
+    }
+
+    // Prize collection: if clicked slightly early while toy is on the way, remember the intent.
+    if (m.prize.hasToy && pointInPrizeArea(m, p)) {
+        // Always collect immediately when a prize exists; no state gating to avoid timing misses.
+        if (m.logEvents) std::cout << "[CLICK #" << clickId << "] HIT: prize area, prize.hasToy=1 -> collectPrize()" << std::endl;
+        flightRecord(FlightEvent::Click, static_cast<uint16_t>(FlightClick::Prize), clickId, p.x, p.y);
+        collectPrize(m);
+        return;
+    }
+
+    if (pointInRect(p, m.tokenSlot.pos, m.tokenSlot.size)) {
+        if (m.logEvents) std::cout << "[CLICK #" << clickId << "] HIT: token slot, state=" << gameStateName(m.gameState) << std::endl;
+        if (m.gameState == GameState::Idle) {
+            if (m.logEvents) std::cout << "[CLICK #" << clickId << "] ACTION: startGame()" << std::endl;
+            flightRecord(FlightEvent::Click, static_cast<uint16_t>(FlightClick::Start), clickId, p.x, p.y);
+            startGame(m);
+            return;
+        }
+        flightRecord(FlightEvent::Click, static_cast<uint16_t>(FlightClick::TokenSlot), clickId, p.x, p.y);
+        return;
+    }
+    flightRecord(FlightEvent::Click, static_cast<uint16_t>(FlightClick::Miss), clickId, p.x, p.y);
+}
+
+Vec2 clawPosition(const Machine& m)
+{
+    return m.claw.pos;
+}
+
+Vec2 clawGrabPoint(const Machine& m)
+{
+    Vec2 pos = clawPosition(m);
+    if (m.fixedPoint) {
+        const Fixed depth = fixedFromFloat(m.claw.height) * fixedFromFloat(0.35f);
+        return { pos.x, fixedToFloat(fixedFromFloat(pos.y) - depth) };
+    }
+    return { pos.x, pos.y - m.claw.height * 0.35f };
+}
+
+bool pointInRect(const Vec2& p, const Vec2& center, const Vec2& size)
+{
+    return std::abs(p.x - center.x) <= size.x * 0.5f && std::abs(p.y - center.y) <= size.y * 0.5f;
+}
+
+bool pointInPrizeArea(const Machine& m, const Vec2& p)
+{
+    // Enlarge clickable area to match visual glow and reduce miss clicks.
+    return pointInRect(p, m.prize.pos, m.prize.size * 1.40f);
+}
+
+// ---------------------- Systems ---------------------- //
+void updateClawMotion(Machine& m, float dt)
+{
+    Claw& claw = m.claw;
+    // Horizontal movement
+    if (m.gameState == GameState::ActiveNoToy || m.gameState == GameState::ActiveCarrying || m.gameState == GameState::ToyFalling) {
+        float moveDir = 0.0f;
+        if (m.input.left) moveDir -= 1.0f;
+        if (m.input.right) moveDir += 1.0f;
+        claw.anchor.x += moveDir * claw.moveSpeed * dt;
+        claw.anchor.x = std::clamp(claw.anchor.x, boxLeft + 0.10f, boxRight - 0.10f);
+    }
+
+    if (claw.movingDown) {
+        claw.ropeLength += claw.lowerSpeed * dt;
+        claw.ropeLength = std::min(claw.ropeLength, claw.maxLength);
+        Vec2 cPos = clawPosition(m);
+        if (cPos.y - claw.height * 0.5f <= floorY) {
+            claw.movingDown = false;
+            claw.movingUp = true;
+        }
+        for (std::size_t i = 0; i < m.registry.gameplay.size(); ++i) {
+            const Gameplay& g = m.registry.gameplay.at(i);
+            if (g.kind != EntityKind::Toy) continue;
+            if (g.toy == ToyState::Falling || g.toy == ToyState::InHole || g.toy == ToyState::InPrize) continue;
+            Entity toy = m.registry.gameplay.entityAt(i);
+            const Transform& t = *m.registry.transforms.get(toy);
+            float dx = std::abs(cPos.x - t.pos.x);
+            float dy = std::abs(cPos.y - t.pos.y);
+            if (dx <= (claw.width * 0.5f + t.size.x * 0.35f) && dy <= (claw.height * 0.5f + t.size.y * 0.35f)) {
+                attachToy(m, toy);
+                break;
+            }
+        }
+    }
+    if (claw.movingUp) {
+        claw.ropeLength -= claw.raiseSpeed * dt;
+        if (claw.ropeLength <= claw.minLength) {
+            claw.ropeLength = claw.minLength;
+            claw.movingUp = false;
+            // Back at the top with nothing caught.
+            if (m.trace.awaitingGrab && m.gameState == GameState::ActiveNoToy) emitPlayEvent(m, PlayEventType::Grab, 0, claw.anchor.x);
+            m.trace.awaitingGrab = false;
+        }
+    }
+}
+
+void updateControls(Machine& m, float dt)
+{
+    Claw& claw = m.claw;
+    bool sDown = m.input.down;
+    bool wDown = m.input.up;
+    if (sDown && !m.sWasDown) {
+        if (m.gameState == GameState::ActiveNoToy && !claw.movingDown && !claw.movingUp) startLowering(m);
+        else if (m.gameState == GameState::ActiveCarrying) releaseToy(m);
+    }
+    // Manual vertical control when not auto-raising and gameplay is active.
+    bool allowManual = (m.gameState == GameState::ActiveNoToy || m.gameState == GameState::ActiveCarrying) && !claw.movingUp && !claw.movingDown;
+    if (allowManual) {
+        if (m.fixedPoint) {
+            const Fixed step = fixedFromFloat(dt);
+            Fixed length = fixedFromFloat(claw.ropeLength);
+            if (sDown) length = fixedMin(length + fixedFromFloat(claw.lowerSpeed) * step, fixedFromFloat(claw.maxLength));
+            if (wDown) length = fixedMax(length - fixedFromFloat(claw.raiseSpeed) * step, fixedFromFloat(claw.minLength));
+            claw.ropeLength = fixedToFloat(length);
+        }
+        else {
+            if (sDown) {
+                claw.ropeLength = std::min(claw.ropeLength + claw.lowerSpeed * dt, claw.maxLength);
+            }
+            if (wDown) {
+                claw.ropeLength = std::max(claw.ropeLength - claw.raiseSpeed * dt, claw.minLength);
+            }
+        }
+    }
+    m.sWasDown = sDown;
+}
+
+// The glass stops the swing, but a rope only pulls: when a long rope swings
+// wide, the clamp can leave the claw above its carriage, where the lowering
+// never finishes. The claw then drops to as far below. Returns true when it
+// dropped, so the caller can take the swing out of it.
+static bool clampClawToGlass(const Claw& claw, Vec2& pos)
+{
+    pos.x = std::clamp(pos.x, boxLeft + claw.width * 0.5f, boxRight - claw.width * 0.5f);
+    if (pos.y <= claw.anchor.y) return false;
+    pos.y = 2.0f * claw.anchor.y - pos.y;
+    return true;
+}
+
+static bool clampClawToGlass(const Claw& claw, FixedVec2& pos)
+{
+    const Fixed halfW = fixedFromFloat(claw.width) * fixedFromFloat(0.5f);
+    pos.x = fixedClamp(pos.x, fixedFromFloat(boxLeft) + halfW, fixedFromFloat(boxRight) - halfW);
+    const Fixed anchorY = fixedFromFloat(claw.anchor.y);
+    if (pos.y <= anchorY) return false;
+    pos.y = anchorY + anchorY - pos.y;
+    return true;
+}
+
+// The claw is a Verlet point held exactly ropeLength from the carriage, so
+// moving the carriage or winding the rope swings it. The drawn rope hangs
+// between the two and never pulls on the claw.
+void updateClawSwing(Machine& m, float dt)
+{
+    Claw& claw = m.claw;
+    const Vec2 velocity = (claw.pos - claw.prevPos) * std::max(1.0f - claw.swingDamping * dt, 0.0f);
+    claw.prevPos = claw.pos;
+    claw.pos += velocity + Vec2{ 0.0f, kClawGravity * dt * dt };
+
+    Vec2 hang = claw.pos - claw.anchor;
+    float d = length(hang);
+    claw.pos = d > 1e-6f ? claw.anchor + hang * (claw.ropeLength / d) : claw.anchor - Vec2{ 0.0f, claw.ropeLength };
+    if (clampClawToGlass(claw, claw.pos)) claw.prevPos = claw.pos;
+
+    stepRope(m.rope, claw.anchor, ropeBottom(m), claw.ropeLength - claw.height * 0.5f, kClawGravity, dt);
+}
+
+// Keep grabbed toy attached
+void updateAttachment(Machine& m)
+{
+    if (Transform* t = m.registry.transforms.get(m.grabbedToy)) {
+        t->pos = clawGrabPoint(m);
+    }
+}
+
+void physicsSystem(Registry& reg, float dt)
+{
+    for (std::size_t i = 0; i < reg.bodies.size(); ++i) {
+        Body& b = reg.bodies.at(i);
+        if (!b.simulate) continue;
+        Transform* t = reg.transforms.get(reg.bodies.entityAt(i));
+        if (!t) continue;
+        b.velocity.y += b.gravity * dt;
+        t->pos += b.velocity * dt;
+    }
+}
+
+// The falling toy's components, or false, and no falling toy, once it is no
+// longer falling.
+static bool fallingToyParts(Machine& m, Transform*& t, Body*& b, Gameplay*& g)
+{
+    Registry& reg = m.registry;
+    t = reg.transforms.get(m.fallingToy);
+    b = reg.bodies.get(m.fallingToy);
+    g = reg.gameplay.get(m.fallingToy);
+    if (!t || !b || !g || (g->toy != ToyState::Falling && g->toy != ToyState::InHole)) {
+        m.fallingToy = Entity{};
+        return false;
+    }
+    return true;
+}
+
+static void toyEnteredHole(Machine& m, Transform& t, Gameplay& g, float x)
+{
+    g.toy = ToyState::InHole;
+    t.pos.x = x;
+    emitPlayEvent(m, PlayEventType::Landing, 1, m.clock - m.trace.releaseTime);
+}
+
+// shownSize is the toy's size scaled up for the compartment window, worked
+// out by the caller on its own path.
+static void toyReachedPrize(Machine& m, Transform& t, Body& b, Gameplay& g, const Vec2& shownSize)
+{
+    b.velocity = { 0.0f, 0.0f };
+    b.simulate = false;
+    g.toy = ToyState::InPrize;
+    // Show the won toy in the compartment window.
+    t.pos = m.prize.pos;
+    t.size = shownSize;
+    if (Sprite* s = m.registry.sprites.get(m.fallingToy)) s->layer = LayerPrizeToy;
+    m.prize.hasToy = true;
+    m.prize.toy = m.fallingToy;
+    m.lamp.mode = LampMode::Blink;
+    m.lamp.blinkStart = m.clock;
+    m.prizePulseStart = m.clock;
+    machineSpriteSystem(m);
+    setGameState(m, GameState::PrizeWaiting);
+    m.trace.prizeReadyTime = m.clock;
+    m.claw.open = false;
+    m.claw.movingDown = false;
+    m.claw.movingUp = true;
+    m.fallingToy = Entity{};
+}
+
+static void toyLanded(Machine& m, Transform& t, Body& b, Gameplay& g, float restY)
+{
+    t.pos.y = restY;
+    b.velocity = { 0.0f, 0.0f };
+    b.simulate = false;
+    g.toy = ToyState::Resting;
+    m.fallingToy = Entity{};
+    setGameState(m, GameState::ActiveNoToy);
+    emitPlayEvent(m, PlayEventType::Landing, 0, m.clock - m.trace.releaseTime);
+}
+
+// Collision and state transitions for the falling toy; the physics system has
+// already integrated it for this tick.
+void updateFallingToy(Machine& m)
+{
+    Transform* ft;
+    Body* fb;
+    Gameplay* fg;
+    if (!fallingToyParts(m, ft, fb, fg)) return;
+    Transform& t = *ft;
+    Gameplay& g = *fg;
+
+    if (g.toy != ToyState::InHole) {
+        float holeDist = length({ t.pos.x - m.hole.center.x, t.pos.y - m.hole.center.y });
+        if (holeDist < m.hole.radius * 0.75f && t.pos.y <= m.hole.center.y + 0.02f) toyEnteredHole(m, t, g, m.hole.center.x);
+    }
+
+    if (g.toy == ToyState::InHole) {
+        float prizeBottom = m.prize.pos.y - m.prize.size.y * 0.5f + t.size.y * 0.5f;
+        if (t.pos.y <= prizeBottom) toyReachedPrize(m, t, *fb, g, t.size * kPrizeToyScale);
+        return;
+    }
+
+    // Floor hit
+    float minY = floorY + t.size.y * 0.5f;
+    if (t.pos.y <= minY) toyLanded(m, t, *fb, g, minY);
+}
+
+// ---------------------- Fixed-point path ---------------------- //
+// With Machine::fixedPoint set, the systems that decide a play, and the rope
+// drawn under the claw, do their arithmetic in Q16.16 instead, so a replay
+// comes out bit for bit the same on any compiler, flag set or CPU. State stays in the float fields: values are
+// read with fixedFromFloat() and written back with fixedToFloat(), which is
+// exact in the machine's range, so snapshots, drawing and the rest of the
+// game see no difference.
+
+void updateClawMotionFixed(Machine& m, float dt)
+{
+    Claw& claw = m.claw;
+    const Fixed step = fixedFromFloat(dt);
+    const Fixed half = fixedFromFloat(0.5f);
+    if (m.gameState == GameState::ActiveNoToy || m.gameState == GameState::ActiveCarrying || m.gameState == GameState::ToyFalling) {
+        int moveDir = 0;
+        if (m.input.left) moveDir -= 1;
+        if (m.input.right) moveDir += 1;
+        const Fixed x = fixedFromFloat(claw.anchor.x) + fixedFromFloat(claw.moveSpeed) * step * fixedInt(moveDir);
+        claw.anchor.x = fixedToFloat(fixedClamp(x, fixedFromFloat(boxLeft + 0.10f), fixedFromFloat(boxRight - 0.10f)));
+    }
+
+    if (claw.movingDown) {
+        const Fixed length = fixedFromFloat(claw.ropeLength) + fixedFromFloat(claw.lowerSpeed) * step;
+        claw.ropeLength = fixedToFloat(fixedMin(length, fixedFromFloat(claw.maxLength)));
+        const FixedVec2 cPos = fixedFromVec2(clawPosition(m));
+        const Fixed halfW = fixedFromFloat(claw.width) * half;
+        const Fixed halfH = fixedFromFloat(claw.height) * half;
+        if (cPos.y - halfH <= fixedFromFloat(floorY)) {
+            claw.movingDown = false;
+            claw.movingUp = true;
+        }
+        const Fixed reach = fixedFromFloat(0.35f);
+        for (std::size_t i = 0; i < m.registry.gameplay.size(); ++i) {
+            const Gameplay& g = m.registry.gameplay.at(i);
+            if (g.kind != EntityKind::Toy) continue;
+            if (g.toy == ToyState::Falling || g.toy == ToyState::InHole || g.toy == ToyState::InPrize) continue;
+            Entity toy = m.registry.gameplay.entityAt(i);
+            const Transform& t = *m.registry.transforms.get(toy);
+            const FixedVec2 pos = fixedFromVec2(t.pos);
+            const FixedVec2 size = fixedFromVec2(t.size);
+            if (fixedAbs(cPos.x - pos.x) <= halfW + size.x * reach && fixedAbs(cPos.y - pos.y) <= halfH + size.y * reach) {
+                attachToy(m, toy);
+                break;
+            }
+        }
+    }
+    if (claw.movingUp) {
+        const Fixed length = fixedFromFloat(claw.ropeLength) - fixedFromFloat(claw.raiseSpeed) * step;
+        const Fixed minLength = fixedFromFloat(claw.minLength);
+        claw.ropeLength = fixedToFloat(fixedMax(length, minLength));
+        if (length <= minLength) {
+            claw.movingUp = false;
+            if (m.trace.awaitingGrab && m.gameState == GameState::ActiveNoToy) emitPlayEvent(m, PlayEventType::Grab, 0, claw.anchor.x);
+            m.trace.awaitingGrab = false;
+        }
+    }
+}
+
+void updateClawSwingFixed(Machine& m, float dt)
+{
+    Claw& claw = m.claw;
+    const Fixed step = fixedFromFloat(dt);
+    const FixedVec2 anchor = fixedFromVec2(claw.anchor);
+    const FixedVec2 prev = fixedFromVec2(claw.prevPos);
+    FixedVec2 pos = fixedFromVec2(claw.pos);
+    const Fixed keep = fixedMax(fixedInt(1) - fixedFromFloat(claw.swingDamping) * step, Fixed{});
+    // Gravity times dt, then times dt again; dt squared alone would round
+    // away most of its bits.
+    const Fixed fall = fixedFromFloat(kClawGravity) * step * step;
+    pos = pos + (pos - prev) * keep + FixedVec2{ Fixed{}, fall };
+    claw.prevPos = claw.pos;
+
+    const FixedVec2 hang = pos - anchor;
+    const Fixed d = fixedLength(hang);
+    const Fixed length = fixedFromFloat(claw.ropeLength);
+    if (d.raw > 0) pos = anchor + FixedVec2{ fixedMulDiv(hang.x, length, d), fixedMulDiv(hang.y, length, d) };
+    else pos = FixedVec2{ anchor.x, anchor.y - length };
+    const bool dropped = clampClawToGlass(claw, pos);
+    claw.pos = fixedToVec2(pos);
+    if (dropped) claw.prevPos = claw.pos;
+
+    stepRopeFixed(m.rope, claw.anchor, ropeBottom(m), claw.ropeLength - claw.height * 0.5f, kClawGravity, dt);
+}
+
+// Gathers the simulated bodies side by side so that the integration is three
+// batch calls.
+void physicsSystemFixed(Registry& reg, float dt)
+{
+    std::array<Transform*, kMaxEntities> transforms;
+    std::array<Body*, kMaxEntities> bodies;
+    std::array<int32_t, kMaxEntities> x{}, y{}, vx{}, vy{}, gravity{};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < reg.bodies.size(); ++i) {
+        Body& b = reg.bodies.at(i);
+        if (!b.simulate) continue;
+        Transform* t = reg.transforms.get(reg.bodies.entityAt(i));
+        if (!t) continue;
+        transforms[n] = t;
+        bodies[n] = &b;
+        x[n] = fixedFromFloat(t->pos.x).raw;
+        y[n] = fixedFromFloat(t->pos.y).raw;
+        vx[n] = fixedFromFloat(b.velocity.x).raw;
+        vy[n] = fixedFromFloat(b.velocity.y).raw;
+        gravity[n] = fixedFromFloat(b.gravity).raw;
+        n++;
+    }
+    const Fixed step = fixedFromFloat(dt);
+    fixedMulAdd(vy.data(), gravity.data(), step, n);
+    fixedMulAdd(x.data(), vx.data(), step, n);
+    fixedMulAdd(y.data(), vy.data(), step, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        bodies[i]->velocity.y = fixedToFloat(Fixed{ vy[i] });
+        transforms[i]->pos = { fixedToFloat(Fixed{ x[i] }), fixedToFloat(Fixed{ y[i] }) };
+    }
+}
+
+void updateFallingToyFixed(Machine& m)
+{
+    Transform* ft;
+    Body* fb;
+    Gameplay* fg;
+    if (!fallingToyParts(m, ft, fb, fg)) return;
+    Transform& t = *ft;
+    Gameplay& g = *fg;
+    const Fixed half = fixedFromFloat(0.5f);
+    const FixedVec2 pos = fixedFromVec2(t.pos);
+    const Fixed halfH = fixedFromFloat(t.size.y) * half;
+
+    if (g.toy != ToyState::InHole) {
+        const FixedVec2 hole = fixedFromVec2(m.hole.center);
+        const Fixed holeDist = fixedLength(pos - hole);
+        if (holeDist < fixedFromFloat(m.hole.radius) * fixedFromFloat(0.75f) && pos.y <= hole.y + fixedFromFloat(0.02f)) {
+            toyEnteredHole(m, t, g, fixedToFloat(hole.x));
+        }
+    }
+
+    if (g.toy == ToyState::InHole) {
+        const Fixed prizeBottom = fixedFromFloat(m.prize.pos.y) - fixedFromFloat(m.prize.size.y) * half + halfH;
+        if (pos.y <= prizeBottom) toyReachedPrize(m, t, *fb, g, fixedToVec2(fixedFromVec2(t.size) * fixedFromFloat(kPrizeToyScale)));
+        return;
+    }
+
+    const Fixed minY = fixedFromFloat(floorY) + halfH;
+    if (pos.y <= minY) toyLanded(m, t, *fb, g, fixedToFloat(minY));
+}
+
+// Auto-honor a pending prize click once state is ready.
+void updatePrizeClaim(Machine& m)
+{
+    if (m.pendingPrizeClick && m.prize.hasToy && m.gameState == GameState::PrizeWaiting) {
+        collectPrize(m);
+        m.pendingPrizeClick = false;
+    }
+}
+
+void clawPoseSystem(Machine& m)
+{
+    Registry& reg = m.registry;
+    const Claw& claw = m.claw;
+    Vec2 cPos = clawPosition(m);
+    reg.transforms.get(m.parts.railJoint)->pos.x = claw.anchor.x;
+
+    // A simulated rope is drawn as a strip; otherwise the sprite spans the
+    // carriage to the claw, tilted with the swing.
+    Transform* rope = reg.transforms.get(m.parts.rope);
+    Vec2 span = claw.anchor - cPos;
+    rope->pos = (claw.anchor + cPos) * 0.5f;
+    rope->size = { kRopeWidth, length(span) };
+    rope->rotation = std::atan2(span.x, span.y);
+    reg.sprites.get(m.parts.rope)->visible = m.rope.segments == 0;
+
+    std::array<float, 4> clawColor = claw.open ? std::array<float, 4>{ 0.90f,0.92f,0.96f,1.0f } : std::array<float, 4>{ 0.64f,0.66f,0.72f,1.0f };
+    reg.transforms.get(m.parts.clawShadow)->pos = cPos + Vec2{ 0.01f, -0.01f };
+    reg.transforms.get(m.parts.clawBody)->pos = cPos;
+    reg.sprites.get(m.parts.clawBody)->color = clawColor;
+
+    // Small jaws
+    float jawOffset = claw.width * 0.25f;
+    float jawWidth = claw.width * 0.18f;
+    float jawHeight = claw.height * 0.6f;
+    Transform* jawL = reg.transforms.get(m.parts.jawLeft);
+    Transform* jawR = reg.transforms.get(m.parts.jawRight);
+    if (claw.open) {
+        *jawL = Transform{ cPos + Vec2{ -jawOffset, -jawHeight * 0.25f }, { jawWidth, jawHeight }, 0.35f };
+        *jawR = Transform{ cPos + Vec2{ jawOffset, -jawHeight * 0.25f }, { jawWidth, jawHeight }, -0.35f };
+    }
+    else {
+        *jawL = Transform{ cPos + Vec2{ -jawOffset * 0.6f, -jawHeight * 0.2f }, { jawWidth, jawHeight }, 0.05f };
+        *jawR = Transform{ cPos + Vec2{ jawOffset * 0.6f, -jawHeight * 0.2f }, { jawWidth, jawHeight }, -0.05f };
+    }
+    reg.sprites.get(m.parts.jawLeft)->color = clawColor;
+    reg.sprites.get(m.parts.jawRight)->color = clawColor;
+}
+
+void plushSystem(Machine& m, float dt)
+{
+    if (!m.plushEnabled) return;
+    PlushSolver& plush = m.plush;
+    Registry& reg = m.registry;
+    for (int i = plush.count(); i-- > 0;) {
+        if (!reg.alive(plush.owner(i))) plush.remove(i);
+    }
+    for (std::size_t i = 0; i < reg.gameplay.size(); ++i) {
+        const Gameplay& g = reg.gameplay.at(i);
+        if (g.kind != EntityKind::Toy) continue;
+        Entity toy = reg.gameplay.entityAt(i);
+        const Transform* t = reg.transforms.get(toy);
+        if (!t) continue;
+        PlushTarget target{ t->pos, t->size, floorY, 0.0f };
+        // Down the chute nothing holds it up; in the prize window it sits on the compartment.
+        if (g.toy == ToyState::InHole) target.floorY = -2.0f;
+        else if (g.toy == ToyState::InPrize) target.floorY = t->pos.y - t->size.y * 0.5f;
+        else if (g.toy == ToyState::Grabbed) target.grip = t->size.x * 0.30f;
+        int index = plush.find(toy);
+        if (index < 0) plush.add(toy, target);
+        else plush.target(index) = target;
+    }
+    plush.step(dt);
+}
+
+// Lamp color and prize glow, derived from gameplay state.
+void machineSpriteSystem(Machine& m)
+{
+    std::array<float, 4> off = { 0.15f,0.15f,0.15f,1.0f };
+    std::array<float, 4> blue = { 0.2f,0.5f,1.0f,1.0f };
+    std::array<float, 4> green = { 0.1f,0.9f,0.3f,1.0f };
+    std::array<float, 4> red = { 0.95f,0.1f,0.1f,1.0f };
+    m.animEpoch = animationEpoch(m.clock);
+    Sprite* lamp = m.registry.sprites.get(m.parts.lampLight);
+    lamp->anim = SpriteAnim{};
+    lamp->color = off;
+    lamp->emissive = m.lamp.mode == LampMode::Off ? 0.0f : 1.0f;
+    if (m.lamp.mode == LampMode::Blue) lamp->color = blue;
+    else if (m.lamp.mode == LampMode::Blink) {
+        // Red first, then green, each for one interval.
+        lamp->color = red;
+        const float period = m.lamp.interval * 2.0f;
+        lamp->anim = SpriteAnim{ AnimCurve::Blink, animationStart(m.lamp.blinkStart, m.animEpoch, period), period, 0.0f, green };
+    }
+
+    Sprite* glow = m.registry.sprites.get(m.parts.prizeGlow);
+    glow->visible = m.prize.hasToy;
+    glow->emissive = 1.0f;
+    glow->color[3] = 0.45f;
+    glow->anim = SpriteAnim{ AnimCurve::Pulse, animationStart(m.prizePulseStart, m.animEpoch, kPrizePulsePeriod), kPrizePulsePeriod, 0.35f };
+}
+
+bool lampBlinkOn(const Machine& m)
+{
+    if (m.lamp.mode != LampMode::Blink) return false;
+    return std::fmod(m.clock - m.lamp.blinkStart, double(m.lamp.interval) * 2.0) >= m.lamp.interval;
+}
+
+// ---------------------- Attract mode ---------------------- //
+bool clawSettled(const Machine& m)
+{
+    return std::abs(m.claw.pos.x - m.claw.anchor.x) <= 0.01f && std::abs(m.claw.pos.x - m.claw.prevPos.x) <= 0.001f;
+}
+
+bool steerClaw(const Machine& m, InputState& in, float x, float within)
+{
+    float dx = x - m.claw.anchor.x;
+    if (std::abs(dx) <= within) return true;
+    in.left = dx < 0.0f;
+    in.right = dx > 0.0f;
+    return false;
+}
+
+void initAttract(AttractPlayer& a, uint32_t seed)
+{
+    a.rng.seed(seed);
+    a.timer = std::uniform_real_distribution<float>(0.2f, 2.5f)(a.rng);
+    a.targetX = 0.0f;
+}
+
+void driveAttract(Machine& m, AttractPlayer& a, float dt)
+{
+    InputState in;
+    auto pickTarget = [&a] {
+        std::uniform_int_distribution<int> slot(0, static_cast<int>(spawnPositions.size()) - 1);
+        // Same travel limits as updateClawMotion, or the claw never arrives.
+        a.targetX = std::clamp(spawnPositions[slot(a.rng)].x, boxLeft + 0.10f, boxRight - 0.10f);
+    };
+
+    switch (m.gameState) {
+    case GameState::Idle:
+        a.timer -= dt;
+        if (a.timer <= 0.0f) {
+            startGame(m);
+            pickTarget();
+        }
+        break;
+    case GameState::ActiveNoToy:
+        if (!m.claw.movingDown && !m.claw.movingUp && steerClaw(m, in, a.targetX, 0.02f) && clawSettled(m)) {
+            in.down = !m.sWasDown;
+            if (in.down) pickTarget();
+        }
+        break;
+    case GameState::ActiveCarrying:
+        if (!m.claw.movingUp && steerClaw(m, in, m.hole.center.x, 0.02f) && clawSettled(m)) in.down = !m.sWasDown;
+        break;
+    case GameState::PrizeWaiting:
+        m.pendingPrizeClick = true;
+        a.timer = std::uniform_real_distribution<float>(1.0f, 4.0f)(a.rng);
+        break;
+    default:
+        break;
+    }
+    m.input = in;
+}
+
+// ---------------------- Scheduling ---------------------- //
+namespace {
+struct MachineSystem {
+    const char* name;
+    AccessMask reads;
+    AccessMask writes;
+    void (*run)(Machine& m, float dt);
+};
+
+// Registration order is the serial order the game has always used; the
+// scheduler only overlaps systems whose declared accesses do not conflict.
+const MachineSystem kMachineSystems[] = {
+    { "clock", AccessClock | AccessLamp | AccessPrize, AccessClock | AccessSprite | AccessTelemetry, [](Machine& m, float dt) {
+        m.clock += dt;
+        // Sprite animation starts are relative to the epoch, so they are
+        // rewritten only when it moves on, every kAnimEpochStep seconds.
+        if (animationEpoch(m.clock) != m.animEpoch) machineSpriteSystem(m);
+    } },
+    { "clawMotion", AccessInput | AccessGameState | AccessClaw | AccessTransform | AccessGameplay | AccessClock,
+        AccessClaw | AccessGameState | AccessGameplay | AccessBody | AccessTelemetry | AccessHeldToy, [](Machine& m, float dt) {
+            if (m.fixedPoint) updateClawMotionFixed(m, dt);
+            else updateClawMotion(m, dt);
+        } },
+    { "controls", AccessInput | AccessGameState | AccessClaw | AccessGameplay | AccessClock | AccessHeldToy,
+        AccessClaw | AccessGameState | AccessGameplay | AccessBody | AccessTransform | AccessTelemetry | AccessHeldToy,
+        [](Machine& m, float dt) { updateControls(m, dt); } },
+    { "clawSwing", AccessClaw | AccessRope, AccessClaw | AccessRope, [](Machine& m, float dt) {
+        if (m.fixedPoint) updateClawSwingFixed(m, dt);
+        else updateClawSwing(m, dt);
+    } },
+    { "attachment", AccessClaw | AccessHeldToy, AccessTransform, [](Machine& m, float) { updateAttachment(m); } },
+    { "physics", AccessBody | AccessTransform, AccessBody | AccessTransform, [](Machine& m, float dt) {
+        if (m.fixedPoint) physicsSystemFixed(m.registry, dt);
+        else physicsSystem(m.registry, dt);
+    } },
+    { "fallingToy", AccessGameState | AccessPrize | AccessTransform | AccessBody | AccessGameplay | AccessClock | AccessHeldToy,
+        AccessGameState | AccessClaw | AccessLamp | AccessPrize | AccessTransform | AccessBody | AccessGameplay | AccessSprite
+            | AccessTelemetry | AccessHeldToy,
+        [](Machine& m, float) {
+            if (m.fixedPoint) updateFallingToyFixed(m);
+            else updateFallingToy(m);
+        } },
+    { "prizeClaim", AccessAll, AccessAll, [](Machine& m, float) { updatePrizeClaim(m); } },
+    { "clawPose", AccessClaw | AccessRope, AccessTransform | AccessSprite, [](Machine& m, float) { clawPoseSystem(m); } },
+    { "plush", AccessTransform | AccessGameplay, AccessPlush, [](Machine& m, float dt) { plushSystem(m, dt); } },
+};
+}
+
+void registerMachineSystems(Scheduler& sched, Machine& m)
+{
+    for (const MachineSystem& sys : kMachineSystems) {
+        auto run = sys.run;
+        sched.add(sys.name, sys.reads, sys.writes, [&m, run](float dt) { run(m, dt); });
+    }
+}
+
+void stepMachine(Machine& m, float dt)
+{
+    for (const MachineSystem& sys : kMachineSystems) sys.run(m, dt);
+}
@@ -1,196 +1,162 @@
-#include <GL/glew.h>
+#include "../Header/GLTrace.h"   // Before GLFW, as GLEW must come before gl.h
 #include <GLFW/glfw3.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
-#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
-#include <random>
+#include <memory>
 #include <string>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
+#include "../Header/Bloom.h"
+#include "../Header/Fixed.h"
+#include "../Header/FlightRecorder.h"
+#include "../Header/Floor.h"
+#include "../Header/Golden.h"
+#include "../Header/Hitch.h"
+#include "../Header/Ledger.h"
+#include "../Header/LiveStats.h"
+#include "../Header/Machine.h"
+#include "../Header/Metrics.h"
+#include "../Header/Particles.h"
+#include "../Header/PerfCounters.h"
+#include "../Header/Renderer.h"
+#include "../Header/Rewind.h"
+#include "../Header/Scheduler.h"
+#include "../Header/Session.h"
+#include "../Header/Snapshot.h"
+#include "../Header/Soak.h"
+#include "../Header/Spectator.h"
+#include "../Header/SpriteBatch.h"
+#include "../Header/Telemetry.h"
+#include "../Header/Textures.h"
 #include "../Header/Util.h"
-
-struct Vec2 {
-    float x = 0.0f;
-    float y = 0.0f;
-    Vec2 operator+(const Vec2& o) const { return { x + o.x, y + o.y }; }
-    Vec2 operator-(const Vec2& o) const { return { x - o.x, y - o.y }; }
-    Vec2 operator*(float s) const { return { x * s, y * s }; }
-    Vec2& operator+=(const Vec2& o) { x += o.x; y += o.y; return *this; }
-};
-
-static float length(const Vec2& v) { return std::sqrt(v.x * v.x + v.y * v.y); }
-
-enum class GameState {
-    Idle,
-    ActiveNoToy,
-    ActiveCarrying,
-    ToyFalling,
-    PrizeWaiting
-};
-
-const char* gameStateName(GameState s) {
-    switch (s) {
-    case GameState::Idle: return "Idle";
-    case GameState::ActiveNoToy: return "ActiveNoToy";
-    case GameState::ActiveCarrying: return "ActiveCarrying";
-    case GameState::ToyFalling: return "ToyFalling";
-    case GameState::PrizeWaiting: return "PrizeWaiting";
-    default: return "Unknown";
-    }
-}
-
-enum class LampMode {
-    Off,
-    Blue,
-    Blink
-};
-
-struct Lamp {
-    LampMode mode = LampMode::Off;
-    float timer = 0.0f;
-    bool blinkToggle = false;
-    float interval = 0.5f;
-};
-
-struct Claw {
-    Vec2 anchor{ 0.0f, 0.70f };  // Rope start (just above glass)
-    float ropeLength = 0.16f;
-    float minLength = 0.16f;
-    float maxLength = 1.18f;
-    float moveSpeed = 0.65f;
-    float lowerSpeed = 0.80f;
-    float raiseSpeed = 0.80f;
-    float width = 0.12f;
-    float height = 0.10f;
-    bool open = false;
-    bool movingDown = false;
-    bool movingUp = false;
-};
-
-struct Toy {
-    Vec2 pos{ 0.0f, 0.0f };
-    Vec2 size{ 0.11f, 0.11f };
-    Vec2 velocity{ 0.0f, 0.0f };
-    unsigned int texture = 0;
-    bool active = true;
-    bool grabbed = false;
-    bool falling = false;
-    bool inPrize = false;
-    bool inHole = false;
-};
-
-struct Hole {
-    Vec2 center{ 0.48f, -0.28f };
-    float radius = 0.085f;
-};
-
-struct PrizeCompartment {
-    Vec2 pos{ 0.48f, -0.54f };
-    Vec2 size{ 0.26f, 0.16f };
-    bool hasToy = false;
-    int toyIndex = -1;
-};
-
-struct TokenSlot {
-    Vec2 pos{ -0.48f, -0.58f };
-    Vec2 size{ 0.18f, 0.08f };
+#include "../Header/VideoRecorder.h"
+
+struct LaunchOptions {
+    bool deterministic = false;
+    int floorMachines = 0;      // --floor N: operator view of N machines
+    bool floorBench = false;    // --floor-bench: FPS as the floor scales
+    bool snapshotBench = false; // --bench-snapshot: headless snapshot codec numbers
+    bool publish = false;       // --publish / --publish-tcp: spectator stream
+    PublisherOptions publisher;
+    float rewindSeconds = 60.0f; // --rewind-seconds: history kept for the F5 debugger, up to kMaxRewindSeconds
+    std::string flightPath = "/tmp/clawmachine-flight.bin"; // --flight PATH / --no-flight
+    std::string ledgerDir = "clawmachine-ledger";            // --ledger DIR / --no-ledger
+    std::string telemetryPath;  // --telemetry PATH: per-play analytics log
+    int metricsPort = 9464;     // --metrics-port PORT / --no-metrics: Prometheus endpoint
+    std::string statsName = kLiveStatsDefaultName;  // --stats-shm NAME / --no-stats-shm
+    bool perf = false;          // --perf: hardware counters per region
+    bool perfBench = false;     // --bench-perf: headless counter profile of texture generation and simulation
+    HitchOptions hitch;         // --hitch-ms MS, --hitch-factor F, --hitch-log PATH / --no-hitch-log
+    std::string glReplayPath;   // --gl-replay PATH: draw a captured GL frame instead of playing
+    std::string recordPath;     // --record-session PATH: save the player's input for replays
+    std::string sessionPath;    // --session PATH: input session the golden check plays
+    std::string goldenDir;      // --golden DIR: compare frames of the session with DIR's images
+    bool goldenUpdate = false;  // --golden-update: write DIR's images instead
+    int goldenEvery = 75;       // --golden-every N: check every Nth tick and the last
+    float goldenThreshold = 0.1f;   // --golden-threshold T: perceptual difference a pixel may have
+    int goldenTolerance = 0;    // --golden-tolerance N: differing pixels a frame may have
+    VideoOptions video;         // --record-video PATH, --record-scale N: gameplay clip from launch
+    BloomOptions bloom;         // --bloom N (1, 2, 4) / --no-bloom, --bloom-passes N, --bloom-strength F
+    bool bloomBench = false;    // --bench-bloom: GPU cost of the glow at each target resolution
+    int particles = 100000;     // --particles N / --no-particles: confetti and sparkle pool size
+    bool particlesCpu = false;  // --particles-cpu: update particles on the CPU instead of transform feedback
+    bool particleBench = false; // --bench-particles: full pool cost on each update path
+    int ropeSegments = 16;      // --rope-segments N: simulated points in the drawn rope; 0 draws it straight
+    bool ropeBench = false;     // --bench-rope: headless rope cost per segment count
+    bool plush = true;          // --no-plush: draw the toys as rigid sprites
+    bool plushBench = false;    // --bench-plush: headless soft-body cost at 240 Hz per thread count
+    bool fixedPoint = false;    // --fixed-point: run the player's machine on Q16.16 for bit-exact replays
+    std::string hashLogPath;    // --hash-log PATH: write the player's state hash after every tick
+    bool fixedBench = false;    // --bench-fixed: headless fixed against float simulation cost and hashes
+    bool rngBench = false;      // --bench-rng: headless Philox against mt19937 throughput
+    bool soakRun = false;       // --soak DAYS: headless bot play at simulated speed, failing on regressions
+    SoakOptions soak;           // --soak-bot NAME, --soak-seed N, --soak-render-every N, --soak-drift F,
+                                // --soak-rss-mb MB, --soak-stuck-seconds S, --soak-report PATH
 };
 
 // Globals
 GLFWwindow* window = nullptr;
 int screenWidth = 1280;
 int screenHeight = 720;
-unsigned int colorShader = 0;
-unsigned int textureShader = 0;
-unsigned int quadVAO = 0;
-unsigned int quadVBO = 0;
-
-unsigned int toyTextureA = 0;
-unsigned int toyTextureB = 0;
-unsigned int toyTextureC = 0;
-unsigned int holeTexture = 0;
+
+MachineTextures machineTextures;
 unsigned int cursorTokenTex = 0;
 unsigned int cursorLeverTex = 0;
 unsigned int labelTex = 0;
 
-GameState gameState = GameState::Idle;
-Lamp lamp;
-Claw claw;
-Hole hole;
-PrizeCompartment prize;
-TokenSlot tokenSlot;
-std::array<Toy, 4> toys;
-std::array<Vec2, 6> spawnPositions = {
-    Vec2{ -0.58f, -0.44f }, Vec2{ -0.32f, -0.44f }, Vec2{ -0.06f, -0.44f },
-    Vec2{ 0.16f, -0.44f }, Vec2{ 0.36f, -0.44f }, Vec2{ 0.56f, -0.44f }
-};
-int nextSpawnSlot = 0;
-int grabbedToyIndex = -1;
-int fallingToyIndex = -1;
-bool sWasDown = false;
+std::unique_ptr<Machine> player;
+std::unique_ptr<Scheduler> scheduler;
+std::unique_ptr<SpriteBatch> spriteBatch;
+std::unique_ptr<ArcadeFloor> arcadeFloor;
 Vec2 mouseGL{ 0.0f, 0.0f };
-std::mt19937 rng(1337);
-bool pendingPrizeClick = false;
-float prizePulseTime = 0.0f;
 int gClickCounter = 0;
-
-// Bounds for the glass box
-const Vec2 boxCenter{ 0.0f, 0.12f };
-const Vec2 boxSize{ 1.26f, 1.06f };
-const float boxLeft = boxCenter.x - boxSize.x * 0.5f;
-const float boxRight = boxCenter.x + boxSize.x * 0.5f;
-const float boxTop = boxCenter.y + boxSize.y * 0.5f;
-const float boxBottom = boxCenter.y - boxSize.y * 0.5f;
-const float floorY = boxBottom + 0.035f;
-const float anchorStartY = boxTop + 0.08f;
+uint32_t simTick = 0;
+double simTime = 0.0;   // Summed in float, rewind times would stall after long sessions
+RewindBuffer rewindBuffer;
+bool rewinding = false;
+std::size_t rewindCursor = 0;
+std::unique_ptr<Machine> historyView;
+std::unique_ptr<SpectatorPublisher> publisher;
+Ledger ledger;
+uint32_t ledgerCoins = 0;    // Player counters already turned into ledger entries
+uint32_t ledgerPrizes = 0;
+uint32_t effectCoins = 0;    // Player counters and state already celebrated with particles
+GameState effectState = GameState::Idle;
+TelemetryLog telemetry;
+MetricsServer metricsServer;
+bool recordingSession = false;
+Session session;
+VideoRecorder videoRecorder;
+VideoOptions videoOptions;
+HitchDetector hitches;
+Bloom bloom;
+ParticleSystem particles;
+std::FILE* hashLog = nullptr;
 
 // Forward decls
 bool initGLFW();
-bool initWindow();
+bool initWindow(bool visible);
 bool initGLEW();
 void initOpenGLState();
-void createVAOs();
 void mainLoop();
+void runGLReplay();
+int runGoldenCheck(const LaunchOptions& opts);
+int runSoak(const SoakOptions& soak);
 void update(float dt);
+void stepGame(float dt);
+void sampleInput();
+void playerClick(const Vec2& p);
 void render();
+void recordPlayerEvents();
+void spawnPlayerEffects();
+void showRewindFrame();
+void handleRewindKey(int key);
+void updateFloorCamera(float dt);
+void renderFloor();
+void runFloorBenchmark();
+int runSnapshotBenchmark();
+void runPerfBenchmark();
+void runRopeBenchmark();
+void runPlushBenchmark();
+void runFixedBenchmark();
+int runRngBenchmark();
+void runBloomBenchmark();
+void runParticleBenchmark(int capacity);
 void windowToOpenGL(double mx, double my, float& glx, float& gly);
 void mouseClickCallback(GLFWwindow* window, int button, int action, int mods);
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
-void drawQuadColor(const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& color);
-void drawQuadTexture(unsigned int tex, const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& tint);
-
-// Textures + helpers
-std::vector<unsigned char> makeCircleTexture(int size, const std::array<unsigned char, 4>& fill);
-std::vector<unsigned char> makeRingTexture(int size, const std::array<unsigned char, 4>& inner, const std::array<unsigned char, 4>& outer);
-std::vector<unsigned char> makeToyTextureDots(int size);
-std::vector<unsigned char> makeToyTextureStripes(int size);
-std::vector<unsigned char> makeToyTextureChecks(int size);
-std::vector<unsigned char> makeCoinTexture(int size);
-std::vector<unsigned char> makeLeverTexture(int size);
-std::unordered_map<char, std::array<uint8_t, 7>> fontGlyphs();
-std::vector<unsigned char> makeLabelTexture(int width, int height, const std::string& text);
-
-// Gameplay helpers
-void resetMachine();
-void spawnToys();
-void startGame();
-void startLowering();
-void attachToy(int idx);
-void releaseToy();
-void collectPrize();
-void updateLamp(float dt);
-void updateClawMotion(float dt);
-void updateFallingToy(float dt);
-Vec2 clawPosition();
-Vec2 clawGrabPoint();
-bool pointInRect(const Vec2& p, const Vec2& center, const Vec2& size);
-void configureLayout();
+void toggleVideoRecording();
+
 
 bool initGLFW()
 {
@@ -201,8 +167,17 @@ bool initGLFW()
     return true;
 }
 
-bool initWindow()
+bool initWindow(bool visible)
 {
+    if (!visible) {
+        // Golden checks draw offscreen at the default size, whatever the monitor.
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(screenWidth, screenHeight, "CLAW MACHINE", NULL, NULL);
+        if (!window) return false;
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+        return true;
+    }
     GLFWmonitor* monitor = glfwGetPrimaryMonitor();
     const GLFWvidmode* mode = glfwGetVideoMode(monitor);
     screenWidth = mode->width;
@@ -235,892 +210,1380 @@ void windowToOpenGL(double mx, double my, float& glx, float& gly)
     gly = float(1.0 - (my / screenHeight) * 2.0);
 }
 
-void createVAOs()
+// ---------------------- Input ---------------------- //
+void mouseClickCallback(GLFWwindow* window, int button, int action, int mods)
 {
-    float quadVertices[] = {
-        -0.5f, -0.5f, 0.0f, 0.0f,
-         0.5f, -0.5f, 1.0f, 0.0f,
-         0.5f,  0.5f, 1.0f, 1.0f,
-        -0.5f,  0.5f, 0.0f, 1.0f,
-    };
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+    if (arcadeFloor || rewinding) return;
+    double mx, my;
+    glfwGetCursorPos(window, &mx, &my);
+    windowToOpenGL(mx, my, mouseGL.x, mouseGL.y);
+    playerClick(mouseGL);
 }
 
-// ---------------------- Texture generation helpers ---------------------- //
-std::vector<unsigned char> makeCircleTexture(int size, const std::array<unsigned char, 4>& fill)
+// A left click on the player's machine, from the mouse or a soak bot.
+void playerClick(const Vec2& p)
 {
-    std::vector<unsigned char> data(size * size * 4, 0);
-    Vec2 center = { size * 0.5f, size * 0.5f };
-    float radius = size * 0.48f;
-    float r2 = radius * radius;
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            float dx = x - center.x;
-            float dy = y - center.y;
-            if (dx * dx + dy * dy <= r2) {
-                int idx = (y * size + x) * 4;
-                data[idx + 0] = fill[0];
-                data[idx + 1] = fill[1];
-                data[idx + 2] = fill[2];
-                data[idx + 3] = fill[3];
-            }
-        }
-    }
-    return data;
+    gClickCounter++;
+    if (recordingSession) session.clicks.push_back({ simTick, p.x, p.y });
+    clickMachine(*player, p, gClickCounter);
+    recordPlayerEvents();
 }
 
-std::vector<unsigned char> makeRingTexture(int size, const std::array<unsigned char, 4>& inner, const std::array<unsigned char, 4>& outer)
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
-    std::vector<unsigned char> data(size * size * 4, 0);
-    Vec2 c = { size * 0.5f, size * 0.5f };
-    float outerR = size * 0.48f;
-    float innerR = size * 0.26f;
-    float o2 = outerR * outerR;
-    float i2 = innerR * innerR;
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            float dx = x - c.x;
-            float dy = y - c.y;
-            float d2 = dx * dx + dy * dy;
-            int idx = (y * size + x) * 4;
-            if (d2 <= i2) {
-                data[idx + 0] = inner[0];
-                data[idx + 1] = inner[1];
-                data[idx + 2] = inner[2];
-                data[idx + 3] = inner[3];
-            }
-            else if (d2 <= o2) {
-                data[idx + 0] = outer[0];
-                data[idx + 1] = outer[1];
-                data[idx + 2] = outer[2];
-                data[idx + 3] = outer[3];
-            }
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_ESCAPE) {
+        glfwSetWindowShouldClose(window, true);
     }
-    return data;
-}
-
-std::vector<unsigned char> makeToyTextureDots(int size)
-{
-    std::vector<unsigned char> data(size * size * 4, 0);
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            int idx = (y * size + x) * 4;
-            data[idx + 0] = 190;
-            data[idx + 1] = 110;
-            data[idx + 2] = 200;
-            data[idx + 3] = 255;
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_F2 && scheduler) {
+        scheduler->report(std::cout);
+        reportPerfCounters(std::cout);
     }
-    for (int by = 0; by < size; by += 8) {
-        for (int bx = 0; bx < size; bx += 8) {
-            Vec2 center = { float(bx + 4), float(by + 4) };
-            for (int y = by; y < by + 8 && y < size; ++y) {
-                for (int x = bx; x < bx + 8 && x < size; ++x) {
-                    float dx = x - center.x;
-                    float dy = y - center.y;
-                    if (dx * dx + dy * dy < 10.5f) {
-                        int idx = (y * size + x) * 4;
-                        data[idx + 0] = 250;
-                        data[idx + 1] = 220;
-                        data[idx + 2] = 120;
-                        data[idx + 3] = 255;
-                    }
-                }
-            }
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_F3) {
+        if (!kGLTraceBuilt) std::cout << "[GLTRACE] not built in; configure with -DCLAW_GL_TRACE=ON" << std::endl;
+        glTraceReport(std::cout);
+        glTraceCaptureNextFrame("clawmachine-frame.gltrace");
     }
-    return data;
-}
-
-std::vector<unsigned char> makeToyTextureStripes(int size)
-{
-    std::vector<unsigned char> data(size * size * 4, 0);
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            int idx = (y * size + x) * 4;
-            bool bright = ((x / 6) % 2) == 0;
-            data[idx + 0] = bright ? 90 : 60;
-            data[idx + 1] = bright ? 170 : 120;
-            data[idx + 2] = bright ? 230 : 180;
-            data[idx + 3] = 255;
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_F4) {
+        hitches.report(std::cout);
     }
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            if (((y / 6) % 2) == 0) {
-                int idx = (y * size + x) * 4;
-                data[idx + 0] = std::min<int>(255, data[idx + 0] + 30);
-                data[idx + 1] = std::min<int>(255, data[idx + 1] + 30);
-                data[idx + 2] = std::min<int>(255, data[idx + 2] + 10);
-            }
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_F8) {
+        toggleVideoRecording();
     }
-    return data;
-}
-
-std::vector<unsigned char> makeToyTextureChecks(int size)
-{
-    std::vector<unsigned char> data(size * size * 4, 0);
-    std::array<unsigned char, 4> c1 = { 70, 170, 220, 255 };
-    std::array<unsigned char, 4> c2 = { 35, 120, 180, 255 };
-    int block = 6;
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            bool alt = ((x / block) + (y / block)) % 2 == 0;
-            const auto& c = alt ? c1 : c2;
-            int idx = (y * size + x) * 4;
-            data[idx + 0] = c[0];
-            data[idx + 1] = c[1];
-            data[idx + 2] = c[2];
-            data[idx + 3] = c[3];
-        }
+    if (action == GLFW_PRESS && key == GLFW_KEY_HOME && arcadeFloor) {
+        arcadeFloor->fitView();
+    }
+    if ((action == GLFW_PRESS || action == GLFW_REPEAT) && !arcadeFloor) {
+        handleRewindKey(key);
     }
-    return data;
 }
 
-std::vector<unsigned char> makeCoinTexture(int size)
+// F8 starts a clip named after the current tick, so earlier clips are kept,
+// and stops it again.
+void toggleVideoRecording()
 {
-    std::vector<unsigned char> data(size * size * 4, 0);
-    Vec2 c{ size * 0.5f, size * 0.5f };
-    float r = size * 0.45f;
-    float r2 = r * r;
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            float dx = x - c.x;
-            float dy = y - c.y;
-            float d2 = dx * dx + dy * dy;
-            if (d2 <= r2) {
-                float shade = 0.75f + 0.25f * (dy / r);
-                shade = std::clamp(shade, 0.6f, 1.0f);
-                int idx = (y * size + x) * 4;
-                data[idx + 0] = static_cast<unsigned char>(230 * shade);
-                data[idx + 1] = static_cast<unsigned char>(190 * shade);
-                data[idx + 2] = static_cast<unsigned char>(70 * shade);
-                data[idx + 3] = 255;
-            }
-        }
+    if (videoRecorder.recording()) {
+        videoRecorder.stop();
+        return;
     }
-    return data;
+    VideoOptions clip = videoOptions;
+    std::filesystem::path base = clip.path.empty() ? std::filesystem::path("clawmachine-clip.y4m") : std::filesystem::path(clip.path);
+    std::filesystem::path named = base.parent_path() / (base.stem().string() + "-" + std::to_string(simTick) + base.extension().string());
+    clip.path = named.string();
+    videoRecorder.start(clip, screenWidth, screenHeight);
 }
 
-std::vector<unsigned char> makeLeverTexture(int size)
+// ---------------------- Rewind debugger ---------------------- //
+// F5 pauses and enters the history; arrows step a tick, Page Up/Down a
+// second, Home/End jump to the ends. F5 again returns to the live game;
+// Enter resumes play from the tick on screen.
+void handleRewindKey(int key)
 {
-    std::vector<unsigned char> data(size * size * 4, 0);
-    auto setPix = [&](int x, int y, const std::array<unsigned char, 4>& c) {
-        if (x < 0 || x >= size || y < 0 || y >= size) return;
-        int idx = (y * size + x) * 4;
-        data[idx + 0] = c[0];
-        data[idx + 1] = c[1];
-        data[idx + 2] = c[2];
-        data[idx + 3] = c[3];
-    };
-    std::array<unsigned char, 4> body = { 200, 200, 210, 255 };
-    std::array<unsigned char, 4> grip = { 90, 120, 230, 255 };
-
-    for (int y = 4; y < size - 4; ++y) {
-        for (int x = 6; x < 14; ++x) {
-            setPix(x, y, body);
+    if (key == GLFW_KEY_F5) {
+        rewinding = !rewinding && rewindBuffer.size() > 0;
+        if (rewinding) {
+            RewindStats rs = rewindBuffer.stats();
+            std::printf("[REWIND] %.1f s in %zu ticks, %zu of %zu bytes, record avg %.2f us max %.2f us\n",
+                rs.secondsCovered, rs.ticks, rs.bytesUsed, rs.memoryBytes, rs.avgRecordUs, rs.maxRecordUs);
+            rewindCursor = rewindBuffer.size() - 1;
+            showRewindFrame();
+        }
+        else {
+            glfwSetWindowTitle(window, "CLAW MACHINE - Boris Lahos RA 168/2022");
         }
+        return;
     }
-    for (int y = 0; y < 16; ++y) {
-        for (int x = 0; x < 20; ++x) {
-            if (x + y < 16) setPix(x, y, grip);
+    if (!rewinding) return;
+
+    const std::size_t last = rewindBuffer.size() - 1;
+    const std::size_t second = 75;
+    switch (key) {
+    case GLFW_KEY_LEFT: rewindCursor = rewindCursor > 0 ? rewindCursor - 1 : 0; break;
+    case GLFW_KEY_RIGHT: rewindCursor = std::min(rewindCursor + 1, last); break;
+    case GLFW_KEY_PAGE_UP: rewindCursor = rewindCursor > second ? rewindCursor - second : 0; break;
+    case GLFW_KEY_PAGE_DOWN: rewindCursor = std::min(rewindCursor + second, last); break;
+    case GLFW_KEY_HOME: rewindCursor = 0; break;
+    case GLFW_KEY_END: rewindCursor = last; break;
+    case GLFW_KEY_ENTER: {
+        MachineSnapshot snap;
+        if (rewindBuffer.stateAt(rewindCursor, snap) && restoreSnapshot(*player, snap)) {
+            rewindBuffer.truncateAfter(rewindCursor);
+            simTick = snap.tick;
+            if (recordingSession) truncateSession(session, simTick);
+            simTime = rewindBuffer.timeAt(rewindCursor);
+            rewinding = false;
+            glfwSetWindowTitle(window, "CLAW MACHINE - Boris Lahos RA 168/2022");
+            std::cout << "[REWIND] resumed from tick " << simTick << std::endl;
+            flightRecord(FlightEvent::Rewind, 0, simTick);
         }
+        return;
+    }
+    default: return;
     }
-    return data;
+    showRewindFrame();
 }
 
-std::unordered_map<char, std::array<uint8_t, 7>> fontGlyphs()
+void showRewindFrame()
 {
-    return {
-        { 'A',{0b01110,0b10001,0b10001,0b11111,0b10001,0b10001,0b10001} },
-        { 'B',{0b11110,0b10001,0b11110,0b10001,0b10001,0b10001,0b11110} },
-        { 'C',{0b01110,0b10001,0b10000,0b10000,0b10000,0b10001,0b01110} },
-        { 'D',{0b11100,0b10010,0b10001,0b10001,0b10001,0b10010,0b11100} },
-        { 'E',{0b11111,0b10000,0b11100,0b10000,0b10000,0b10000,0b11111} },
-        { 'F',{0b11111,0b10000,0b11100,0b10000,0b10000,0b10000,0b10000} },
-        { 'G',{0b01110,0b10001,0b10000,0b10111,0b10001,0b10001,0b01110} },
-        { 'H',{0b10001,0b10001,0b10001,0b11111,0b10001,0b10001,0b10001} },
-        { 'I',{0b11111,0b00100,0b00100,0b00100,0b00100,0b00100,0b11111} },
-        { 'J',{0b00111,0b00010,0b00010,0b00010,0b10010,0b10010,0b01100} },
-        { 'K',{0b10001,0b10010,0b10100,0b11000,0b10100,0b10010,0b10001} },
-        { 'L',{0b10000,0b10000,0b10000,0b10000,0b10000,0b10000,0b11111} },
-        { 'M',{0b10001,0b11011,0b10101,0b10101,0b10001,0b10001,0b10001} },
-        { 'N',{0b10001,0b11001,0b10101,0b10101,0b10011,0b10001,0b10001} },
-        { 'O',{0b01110,0b10001,0b10001,0b10001,0b10001,0b10001,0b01110} },
-        { 'P',{0b11110,0b10001,0b11110,0b10000,0b10000,0b10000,0b10000} },
-        { 'Q',{0b01110,0b10001,0b10001,0b10001,0b10101,0b10010,0b01101} },
-        { 'R',{0b11110,0b10001,0b11110,0b10001,0b10001,0b10001,0b10001} },
-        { 'S',{0b01111,0b10000,0b10000,0b01110,0b00001,0b00001,0b11110} },
-        { 'T',{0b11111,0b00100,0b00100,0b00100,0b00100,0b00100,0b00100} },
-        { 'U',{0b10001,0b10001,0b10001,0b10001,0b10001,0b10001,0b01110} },
-        { 'V',{0b10001,0b10001,0b10001,0b10001,0b01010,0b01010,0b00100} },
-        { 'W',{0b10001,0b10001,0b10001,0b10101,0b10101,0b11011,0b10001} },
-        { 'X',{0b10001,0b01010,0b00100,0b00100,0b00100,0b01010,0b10001} },
-        { 'Y',{0b10001,0b10001,0b01010,0b00100,0b00100,0b00100,0b00100} },
-        { 'Z',{0b11111,0b00001,0b00010,0b00100,0b01000,0b10000,0b11111} },
-        { ' ',{0,0,0,0,0,0,0} },
-        { '/',{0b00001,0b00010,0b00100,0b01000,0b10000,0,0} },
-        { '0',{0b01110,0b10001,0b10011,0b10101,0b11001,0b10001,0b01110} },
-        { '1',{0b00100,0b01100,0b00100,0b00100,0b00100,0b00100,0b01110} },
-        { '2',{0b01110,0b10001,0b00001,0b00010,0b00100,0b01000,0b11111} },
-        { '3',{0b11110,0b00001,0b00001,0b01110,0b00001,0b00001,0b11110} },
-        { '4',{0b10010,0b10010,0b10010,0b11111,0b00010,0b00010,0b00010} },
-        { '5',{0b11111,0b10000,0b11110,0b00001,0b00001,0b10001,0b01110} },
-        { '6',{0b01110,0b10000,0b11110,0b10001,0b10001,0b10001,0b01110} },
-        { '7',{0b11111,0b00001,0b00010,0b00100,0b01000,0b01000,0b01000} },
-        { '8',{0b01110,0b10001,0b01110,0b10001,0b10001,0b10001,0b01110} },
-        { '9',{0b01110,0b10001,0b10001,0b01111,0b00001,0b00001,0b11110} },
-        { '-',{0b00000,0b00000,0b00000,0b11111,0b00000,0b00000,0b00000} },
-        { ':',{0b00000,0b00100,0b00100,0b00000,0b00100,0b00100,0b00000} },
-    };
+    MachineSnapshot snap;
+    if (!rewindBuffer.stateAt(rewindCursor, snap)) return;
+    restoreSnapshot(*historyView, snap);
+    char title[128];
+    std::snprintf(title, sizeof(title), "CLAW MACHINE - REWIND tick %u  -%.2f s  %s",
+        snap.tick, simTime - rewindBuffer.timeAt(rewindCursor), gameStateName(historyView->gameState));
+    glfwSetWindowTitle(window, title);
 }
 
-std::vector<unsigned char> makeLabelTexture(int width, int height, const std::string& text)
+void sampleInput()
 {
-    std::vector<unsigned char> data(width * height * 4, 0);
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int idx = (y * width + x) * 4;
-            data[idx + 0] = 20;
-            data[idx + 1] = 24;
-            data[idx + 2] = 32;
-            data[idx + 3] = 180;
-        }
-    }
-
-    auto glyphs = fontGlyphs();
-    int scale = 2;
-    int lineHeight = 7 * scale + 6;
-    int marginX = 16;
-    int cursorX = marginX;
-    int cursorY = 28;
-    for (size_t i = 0; i < text.size(); ++i) {
-        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
-        if (c == '\n') {
-            cursorX = marginX;
-            cursorY += lineHeight;
-            continue;
-        }
-        if (glyphs.find(c) == glyphs.end()) continue;
-        const auto& rows = glyphs[c];
-        for (int row = 0; row < 7; ++row) {
-            for (int col = 0; col < 5; ++col) {
-                if (rows[row] & (1 << (4 - col))) {
-                    for (int sy = 0; sy < scale; ++sy) {
-                        for (int sx = 0; sx < scale; ++sx) {
-                            int px = cursorX + col * scale + sx;
-                            int py = cursorY + row * scale + sy;
-                            if (px >= 0 && px < width && py >= 0 && py < height) {
-                                int idx = (py * width + px) * 4;
-                                data[idx + 0] = 235;
-                                data[idx + 1] = 235;
-                                data[idx + 2] = 245;
-                                data[idx + 3] = 255;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        cursorX += 6 * scale;
-    }
-    return data;
+    InputState& input = player->input;
+    input.left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    input.down = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.up = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
 }
 
-// ---------------------- Gameplay helpers ---------------------- //
-void resetMachine()
+void update(float dt)
 {
-    configureLayout();
-
-    gameState = GameState::Idle;
-    lamp.mode = LampMode::Off;
-    lamp.timer = 0.0f;
-    lamp.blinkToggle = false;
-
-    claw.anchor = { 0.0f, anchorStartY };
-    claw.ropeLength = claw.minLength;
-    claw.open = false;
-    claw.movingDown = false;
-    claw.movingUp = false;
-
-    prize.hasToy = false;
-    prize.toyIndex = -1;
-    grabbedToyIndex = -1;
-    fallingToyIndex = -1;
-    sWasDown = false;
+    static const int region = perfRegion("update");
+    PerfScope scope(region);
+    double mx, my;
+    glfwGetCursorPos(window, &mx, &my);
+    windowToOpenGL(mx, my, mouseGL.x, mouseGL.y);
+    if (rewinding) return;
+    sampleInput();
+    if (recordingSession) session.ticks.push_back({ dt, mouseGL.x, mouseGL.y, packSessionKeys(player->input), {} });
+    stepGame(dt);
 }
 
-void spawnToys()
+// One simulation tick of the player machine and everything that follows it.
+void stepGame(float dt)
 {
-    std::uniform_int_distribution<int> slotDist(0, static_cast<int>(spawnPositions.size()) - 1);
-    int startSlot = slotDist(rng);
-    std::array<unsigned int, 3> toyTextures = { toyTextureA, toyTextureB, toyTextureC };
-    for (size_t i = 0; i < toys.size(); ++i) {
-        Vec2 spawn = spawnPositions[(startSlot + static_cast<int>(i)) % spawnPositions.size()];
-        toys[i].size = { 0.11f, 0.11f };
-        spawn.y = floorY + toys[i].size.y * 0.5f;
-        toys[i].pos = spawn;
-        toys[i].velocity = { 0.0f, 0.0f };
-        toys[i].grabbed = false;
-        toys[i].falling = false;
-        toys[i].inPrize = false;
-        toys[i].active = true;
-        toys[i].inHole = false;
-        toys[i].texture = toyTextures[i % toyTextures.size()];
+    scheduler->tick(dt);
+    metricAdd(gameMetrics.simSteps);
+    simTick++;
+    simTime += dt;
+    recordPlayerEvents();
+    spawnPlayerEffects();
+    particles.update(dt);
+    rewindBuffer.record(*player, simTick, simTime);
+    if (publisher) publisher->publish(*player, simTick, dt);
+    if (hashLog) {
+        MachineSnapshot snap;
+        captureSnapshot(*player, simTick, snap);
+        std::fprintf(hashLog, "%u %016llx\n", simTick, static_cast<unsigned long long>(snapshotHash(snap)));
     }
-    nextSpawnSlot = (startSlot + static_cast<int>(toys.size())) % spawnPositions.size();
 }
 
-void startGame()
+// Queues the player's new coins and payouts for the ledger, counts them for
+// the metrics endpoint and moves the player's play events into the telemetry
+// log.
+void recordPlayerEvents()
 {
-    if (gameState != GameState::Idle) return;
-    lamp.mode = LampMode::Blue;
-    claw.open = true;
-    gameState = GameState::ActiveNoToy;
+    for (; ledgerCoins < player->coinsInserted; ++ledgerCoins) {
+        ledger.append(LedgerEntryType::Credit, 1, simTick);
+        metricAdd(gameMetrics.playsStarted);
+    }
+    for (; ledgerPrizes < player->prizesPaid; ++ledgerPrizes) {
+        ledger.append(LedgerEntryType::Payout, 1, simTick);
+        metricAdd(gameMetrics.prizesWon);
+    }
+    if (telemetry.isOpen()) telemetry.append(0, player->playEvents);
 }
 
-void startLowering()
+// Sparkles at the token slot for each coin, confetti when a prize lands.
+void spawnPlayerEffects()
 {
-    if (claw.movingDown || claw.movingUp) return;
-    claw.movingDown = true;
+    if (effectCoins != player->coinsInserted) {
+        effectCoins = player->coinsInserted;
+        particles.emit(sparkleBurst(player->tokenSlot.pos));
+    }
+    if (player->gameState == GameState::PrizeWaiting && effectState != GameState::PrizeWaiting) {
+        particles.emit(confettiBurst(player->prize.pos));
+    }
+    effectState = player->gameState;
 }
 
-void attachToy(int idx)
+// Arrows pan, +/- zoom; speeds are in screen units so they feel the same at
+// any zoom level.
+void updateFloorCamera(float dt)
 {
-    grabbedToyIndex = idx;
-    toys[idx].grabbed = true;
-    toys[idx].falling = false;
-    toys[idx].velocity = { 0.0f, 0.0f };
-    claw.open = false;
-    gameState = GameState::ActiveCarrying;
-    claw.movingDown = false;
-    claw.movingUp = true;
+    auto held = [](int key) { return glfwGetKey(window, key) == GLFW_PRESS; };
+    Vec2 dir{ 0.0f, 0.0f };
+    if (held(GLFW_KEY_LEFT)) dir.x -= 1.0f;
+    if (held(GLFW_KEY_RIGHT)) dir.x += 1.0f;
+    if (held(GLFW_KEY_DOWN)) dir.y -= 1.0f;
+    if (held(GLFW_KEY_UP)) dir.y += 1.0f;
+    if (dir.x != 0.0f || dir.y != 0.0f) arcadeFloor->pan(dir * (1.2f * dt));
+    if (held(GLFW_KEY_EQUAL) || held(GLFW_KEY_KP_ADD)) arcadeFloor->zoom(std::exp(1.5f * dt));
+    if (held(GLFW_KEY_MINUS) || held(GLFW_KEY_KP_SUBTRACT)) arcadeFloor->zoom(std::exp(-1.5f * dt));
 }
 
-void releaseToy()
+// ---------------------- Rendering ---------------------- //
+void renderBackground()
 {
-    if (grabbedToyIndex < 0) return;
-    Toy& t = toys[grabbedToyIndex];
-    t.grabbed = false;
-    t.falling = true;
-    t.inHole = false;
-    t.velocity = { 0.0f, 0.0f };
-    t.pos = clawGrabPoint();
-    fallingToyIndex = grabbedToyIndex;
-    grabbedToyIndex = -1;
-    claw.open = true;
-    gameState = GameState::ToyFalling;
+    drawQuadColor({ 0.0f, 0.0f }, { 2.4f, 2.4f }, 0.0f, { 0.05f, 0.06f, 0.08f, 1.0f });
 }
 
-void collectPrize()
+void renderLabel()
 {
-    std::cout << "[COLLECT] collectPrize() called. prize.hasToy=" << (prize.hasToy ? 1 : 0)
-        << " toyIndex=" << prize.toyIndex
-        << " stateBefore=" << gameStateName(gameState) << std::endl;
-
-    if (!prize.hasToy || prize.toyIndex < 0) return;
-    int idx = prize.toyIndex;
-    toys[idx].inPrize = false;
-    toys[idx].falling = false;
-    toys[idx].grabbed = false;
-    toys[idx].inHole = false;
-    toys[idx].velocity = { 0.0f, 0.0f };
-    toys[idx].active = true;
-    // Respawn toy to keep the machine playable.
-    Vec2 respawn = spawnPositions[nextSpawnSlot];
-    respawn.y = floorY + toys[idx].size.y * 0.5f;
-    toys[idx].pos = respawn;
-    nextSpawnSlot = (nextSpawnSlot + 1) % spawnPositions.size();
-
-    prize.hasToy = false;
-    prize.toyIndex = -1;
-    pendingPrizeClick = false;
-    resetMachine();
-    lamp.mode = LampMode::Off;
-    claw.open = false;
-
-    std::cout << "[COLLECT] DONE: prize cleared, stateAfter=" << gameStateName(gameState)
-        << " prize.hasToy=" << (prize.hasToy ? 1 : 0) << std::endl;
+    drawQuadTexture(labelTex, { 0.0f, 0.82f }, { 1.6f, 0.28f }, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
 }
 
-void updateLamp(float dt)
+void renderCursor()
 {
-    if (lamp.mode == LampMode::Blink) {
-        lamp.timer += dt;
-        if (lamp.timer >= lamp.interval) {
-            lamp.timer = 0.0f;
-            lamp.blinkToggle = !lamp.blinkToggle;
-        }
+    bool idle = player->gameState == GameState::Idle;
+    unsigned int tex = idle ? cursorTokenTex : cursorLeverTex;
+    Vec2 size = idle ? Vec2{ 0.08f, 0.08f } : Vec2{ 0.10f, 0.10f };
+    Vec2 pos = mouseGL;
+    if (tex == cursorLeverTex) {
+        pos = mouseGL + Vec2{ size.x * 0.5f, size.y * 0.5f };
     }
+    drawQuadTexture(tex, pos, size, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
 }
 
-Vec2 clawPosition()
+void render()
 {
-    return { claw.anchor.x, claw.anchor.y - claw.ropeLength };
-}
+    static const int region = perfRegion("render");
+    PerfScope scope(region);
+    glClearColor(0.05f, 0.06f, 0.08f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-Vec2 clawGrabPoint()
-{
-    Vec2 pos = clawPosition();
-    return { pos.x, pos.y - claw.height * 0.35f };
+    renderBackground();
+    Machine& shown = rewinding ? *historyView : *player;
+    renderSystem(shown.registry, shown.clock, &shown.plush);
+    drawRope(shown.rope, kRopeWidth, shown.registry.sprites.get(shown.parts.rope)->color);
+    if (bloom.enabled()) {
+        bloom.beginEmissive();
+        renderEmissive(shown.registry, shown.clock);
+        bloom.apply();
+    }
+    particles.render();
+    renderLabel();
+    renderCursor();
 }
 
-bool pointInRect(const Vec2& p, const Vec2& center, const Vec2& size)
+void renderFloor()
 {
-    return std::abs(p.x - center.x) <= size.x * 0.5f && std::abs(p.y - center.y) <= size.y * 0.5f;
+    static const int region = perfRegion("floor render");
+    PerfScope scope(region);
+    glClearColor(0.05f, 0.06f, 0.08f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    arcadeFloor->render(screenWidth, screenHeight);
 }
 
-bool pointInPrizeArea(const Vec2& p)
+// ---------------------- Main loop ---------------------- //
+void mainLoop()
 {
-    // Enlarge clickable area to match visual glow and reduce miss clicks.
-    return pointInRect(p, prize.pos, prize.size * 1.40f);
-}
+    const double targetFrame = 1.0 / 75.0;
+    double lastTime = glfwGetTime();
+    double titleTime = lastTime;
+    int titleFrames = 0;
+    uint64_t drawsBefore = drawCallsIssued();
+    std::vector<HitchTiming> phases, systems;
+    while (!glfwWindowShouldClose(window))
+    {
+        hitches.beginFrame();
+        double now = glfwGetTime();
+        float dt = float(now - lastTime);
+        lastTime = now;
 
-void configureLayout()
-{
-    hole.center = { boxRight - 0.20f, floorY + 0.11f };
-    hole.radius = 0.085f;
+        double updated;
+        if (arcadeFloor) {
+            updateFloorCamera(dt);
+            arcadeFloor->update(dt, scheduler->threadPool());
+            updated = glfwGetTime();
+            renderFloor();
+        }
+        else {
+            update(dt);
+            updated = glfwGetTime();
+            render();
+        }
+        videoRecorder.capture();
+        double rendered = glfwGetTime();
 
-    prize.pos = { boxRight - 0.10f, boxBottom - 0.16f };
-    prize.size = { 0.32f, 0.16f };
+        recordGLCall("glfwSwapBuffers");
+        glfwSwapBuffers(window);
+        glTraceEndFrame();
+        glfwPollEvents();
+        double swapped = glfwGetTime();
+
+        titleFrames++;
+        if (arcadeFloor && now - titleTime >= 1.0) {
+            const FloorStats& s = arcadeFloor->stats();
+            char title[160];
+            std::snprintf(title, sizeof(title), "CLAW MACHINE - FLOOR %d machines - %.0f FPS - %d visible, %d impostors, %d draws",
+                s.machines, titleFrames / (now - titleTime), s.visible, s.impostors, s.drawCalls);
+            glfwSetWindowTitle(window, title);
+            titleTime = now;
+            titleFrames = 0;
+        }
 
-    tokenSlot.pos = { boxLeft + 0.30f, boxBottom - 0.14f };
-    tokenSlot.size = { 0.22f, 0.08f };
+        double frameTime = glfwGetTime() - now;
+        if (arcadeFloor) metricAdd(gameMetrics.simSteps, static_cast<uint64_t>(arcadeFloor->stats().machines));
+        metricAdd(gameMetrics.drawCalls, drawCallsIssued() - drawsBefore);
+        drawsBefore = drawCallsIssued();
+        metricObserve(gameMetrics.frameSeconds, frameTime);
+        metricSet(gameMetrics.textureBytes, double(textureMemoryBytes()));
+        publishLiveStats(*player, simTick, float(frameTime * 1000.0), dt, rewinding);
+        flightRecord(FlightEvent::Frame, 0, simTick, float(frameTime * 1000.0),
+            float((updated - now) * 1000.0), float((rendered - updated) * 1000.0), dt * 1000.0f);
+        double published = glfwGetTime();
+        if (frameTime < targetFrame) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(targetFrame - frameTime));
+        }
 
-    claw.anchor = { 0.0f, anchorStartY };
-    claw.ropeLength = claw.minLength;
+        // Wall time includes the sleep, so an oversleep is a hitch too.
+        double end = glfwGetTime();
+        phases.clear();
+        systems.clear();
+        phases.push_back({ "update", float((updated - now) * 1000.0) });
+        phases.push_back({ "render", float((rendered - updated) * 1000.0) });
+        phases.push_back({ "swap+events", float((swapped - rendered) * 1000.0) });
+        phases.push_back({ "stats", float((published - swapped) * 1000.0) });
+        phases.push_back({ "sleep", float((end - published) * 1000.0) });
+        if (arcadeFloor) {
+            systems.push_back({ "floor update", float(arcadeFloor->stats().updateMs) });
+            systems.push_back({ "floor render", float(arcadeFloor->stats().renderMs) });
+        }
+        else {
+            for (const Scheduler::SystemStats& st : scheduler->stats()) systems.push_back({ st.name, float(st.lastMs) });
+        }
+        hitches.endFrame(end, simTick, float((end - now) * 1000.0), gameStateName(player->gameState), phases, systems);
+    }
+}
+
+// Issues the loaded capture every frame in place of update and render. The
+// game set up the same objects as the captured run, so the names match.
+void runGLReplay()
+{
+    const double targetFrame = 1.0 / 75.0;
+    while (!glfwWindowShouldClose(window))
+    {
+        double now = glfwGetTime();
+        glTraceReplayFrame();
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        double frameTime = glfwGetTime() - now;
+        if (frameTime < targetFrame) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(targetFrame - frameTime));
+        }
+    }
 }
 
-void updateClawMotion(float dt)
+// Plays the input session through a fresh game at its recorded steps and
+// draws every goldenEvery-th tick into an offscreen framebuffer. Each frame is
+// either written as the new golden .rle image or compared with the stored one;
+// a frame that differs leaves .actual.ppm and .diff.ppm next to the golden.
+// Returns the number of frames that failed.
+int runGoldenCheck(const LaunchOptions& opts)
 {
-    // Horizontal movement
-    if (gameState == GameState::ActiveNoToy || gameState == GameState::ActiveCarrying || gameState == GameState::ToyFalling) {
-        float moveDir = 0.0f;
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) moveDir -= 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) moveDir += 1.0f;
-        claw.anchor.x += moveDir * claw.moveSpeed * dt;
-        claw.anchor.x = std::clamp(claw.anchor.x, boxLeft + 0.10f, boxRight - 0.10f);
+    if (!loadSession(opts.sessionPath, session)) return 1;
+    if (opts.goldenUpdate) std::filesystem::create_directories(opts.goldenDir);
+
+    unsigned int colorTex = 0, framebuffer = 0;
+    glGenTextures(1, &colorTex);
+    glBindTexture(GL_TEXTURE_2D, colorTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, screenWidth, screenHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "[GOLDEN] offscreen framebuffer is incomplete" << std::endl;
+        return 1;
     }
 
-    if (claw.movingDown) {
-        claw.ropeLength += claw.lowerSpeed * dt;
-        claw.ropeLength = std::min(claw.ropeLength, claw.maxLength);
-        Vec2 cPos = clawPosition();
-        if (cPos.y - claw.height * 0.5f <= floorY) {
-            claw.movingDown = false;
-            claw.movingUp = true;
+    std::vector<unsigned char> rgba(std::size_t(screenWidth) * std::size_t(screenHeight) * 4);
+    Image frame;
+    frame.width = screenWidth;
+    frame.height = screenHeight;
+    frame.rgb.resize(std::size_t(screenWidth) * std::size_t(screenHeight) * 3);
+    int checked = 0, failed = 0;
+    std::size_t nextClick = 0;
+    const uint32_t ticks = uint32_t(session.ticks.size());
+    for (uint32_t t = 0; t < ticks; ++t) {
+        for (; nextClick < session.clicks.size() && session.clicks[nextClick].tick <= t; ++nextClick) {
+            mouseGL = { session.clicks[nextClick].x, session.clicks[nextClick].y };
+            playerClick(mouseGL);
         }
-        for (int i = 0; i < static_cast<int>(toys.size()); ++i) {
-            Toy& t = toys[i];
-            if (!t.active || t.falling || t.inPrize) continue;
-            float dx = std::abs(cPos.x - t.pos.x);
-            float dy = std::abs(cPos.y - t.pos.y);
-            if (dx <= (claw.width * 0.5f + t.size.x * 0.35f) && dy <= (claw.height * 0.5f + t.size.y * 0.35f)) {
-                attachToy(i);
-                break;
+        const SessionTick& st = session.ticks[t];
+        mouseGL = { st.mouseX, st.mouseY };
+        player->input = unpackSessionKeys(st.keys);
+        stepGame(st.dt);
+        if ((t + 1) % uint32_t(opts.goldenEvery) != 0 && t + 1 != ticks) continue;
+
+        render();
+        glReadPixels(0, 0, screenWidth, screenHeight, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+        for (int y = 0; y < screenHeight; ++y) {
+            const unsigned char* src = &rgba[std::size_t(screenHeight - 1 - y) * screenWidth * 4];
+            unsigned char* dst = &frame.rgb[std::size_t(y) * screenWidth * 3];
+            for (int x = 0; x < screenWidth; ++x) {
+                dst[x * 3] = src[x * 4];
+                dst[x * 3 + 1] = src[x * 4 + 1];
+                dst[x * 3 + 2] = src[x * 4 + 2];
             }
         }
-    }
-    if (claw.movingUp) {
-        claw.ropeLength -= claw.raiseSpeed * dt;
-        if (claw.ropeLength <= claw.minLength) {
-            claw.ropeLength = claw.minLength;
-            claw.movingUp = false;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "tick-%06u", t + 1);
+        const std::string base = (std::filesystem::path(opts.goldenDir) / name).string();
+        checked++;
+        if (opts.goldenUpdate) {
+            if (!writeRunLength(base + ".rle", frame)) {
+                std::cout << "[GOLDEN] could not write " << base << ".rle" << std::endl;
+                failed++;
+            }
+            continue;
+        }
+        Image golden, diff;
+        if (!readRunLength(base + ".rle", golden)) {
+            std::cout << "[GOLDEN] " << name << ": no golden image at " << base << ".rle" << std::endl;
+            writePPM(base + ".actual.ppm", frame);
+            failed++;
+            continue;
+        }
+        ImageDiff d = compareImages(golden, frame, opts.goldenThreshold, &diff);
+        if (d.sizeMismatch) {
+            std::printf("[GOLDEN] %s: golden is %dx%d, frame is %dx%d\n", name, golden.width, golden.height, frame.width, frame.height);
+            writePPM(base + ".actual.ppm", frame);
+            failed++;
+        }
+        else if (d.differing > std::size_t(opts.goldenTolerance)) {
+            std::printf("[GOLDEN] %s: %zu pixels differ (max difference %.3f)\n", name, d.differing, d.maxDelta);
+            writePPM(base + ".actual.ppm", frame);
+            writePPM(base + ".diff.ppm", diff);
+            failed++;
         }
     }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTex);
+    if (opts.goldenUpdate) std::printf("[GOLDEN] wrote %d golden images to %s\n", checked - failed, opts.goldenDir.c_str());
+    else std::printf("[GOLDEN] %d of %d frames match over %u ticks\n", checked - failed, checked, ticks);
+    return failed;
 }
 
-void updateFallingToy(float dt)
+// Plays the player's machine with an autoplay bot for soak.days of simulated
+// time, as fast as it will go: the bot's clicks and keys go in through
+// playerClick() and InputState like a person's, every tick is a full
+// stepGame(), and every renderEvery-th tick is drawn to the hidden window.
+// Tick and frame cost, memory, GL objects and the state machine are checked
+// as it goes. Returns nonzero if anything regressed.
+int runSoak(const SoakOptions& soak)
 {
-    if (fallingToyIndex < 0) return;
-    Toy& t = toys[fallingToyIndex];
-    if (!t.falling) {
-        fallingToyIndex = -1;
-        return;
-    }
-    const float gravity = -2.6f;
-    t.velocity.y += gravity * dt;
-    t.pos.y += t.velocity.y * dt;
-
-    bool handleHolePath = false;
-    if (t.inHole) {
-        handleHolePath = true;
-    }
-    else {
-        float holeDist = length({ t.pos.x - hole.center.x, t.pos.y - hole.center.y });
-        if (holeDist < hole.radius * 0.75f && t.pos.y <= hole.center.y + 0.02f) {
-            t.inHole = true;
-            t.pos.x = hole.center.x;
-            handleHolePath = true;
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point from, Clock::time_point to) { return std::chrono::duration<double>(to - from).count(); };
+    const float step = 1.0f / 75.0f;
+    const double total = soak.days * 86400.0;
+    // Hour-long windows, but always enough of them to see a trend.
+    const double windowSeconds = std::min(3600.0, total / 8.0);
+
+    player->logEvents = false;
+    BotPlayer bot;
+    initBot(bot, soak.strategy, soak.seed);
+    SoakMonitor monitor;
+    monitor.begin(soak, *player);
+    std::printf("[SOAK] %.2f simulated days, %s bot, seed %u, drawing every %d ticks\n", soak.days,
+        botStrategyName(soak.strategy), soak.seed, soak.renderEvery);
+
+    const Clock::time_point start = Clock::now();
+    double nextWindow = windowSeconds;
+    uint64_t ticks = 0;
+    while (monitor.simSeconds() < total && !glfwWindowShouldClose(window)) {
+        const Clock::time_point t0 = Clock::now();
+        BotAction action = driveBot(*player, bot, step);
+        mouseGL = action.mouse;
+        if (action.click) playerClick(action.mouse);
+        player->input = action.keys;
+        stepGame(step);
+        const Clock::time_point t1 = Clock::now();
+        monitor.tick(*player, step, seconds(t0, t1));
+
+        if (soak.renderEvery > 0 && ++ticks % uint64_t(soak.renderEvery) == 0) {
+            render();
+            glFinish();
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            monitor.frame(seconds(t1, Clock::now()));
         }
-    }
-
-    if (handleHolePath) {
-        float prizeBottom = prize.pos.y - prize.size.y * 0.5f + t.size.y * 0.5f;
-        if (t.pos.y <= prizeBottom) {
-            t.pos.y = prizeBottom;
-            t.velocity = { 0.0f, 0.0f };
-            t.falling = false;
-            t.inPrize = true;
-            t.inHole = false;
-            prize.hasToy = true;
-            prize.toyIndex = fallingToyIndex;
-            lamp.mode = LampMode::Blink;
-            lamp.timer = 0.0f;
-            gameState = GameState::PrizeWaiting;
-            claw.open = false;
-            claw.movingDown = false;
-            claw.movingUp = true;
-            fallingToyIndex = -1;
+        if (monitor.simSeconds() >= nextWindow || monitor.simSeconds() >= total) {
+            monitor.endWindow(*player, seconds(start, Clock::now()), countGLObjects());
+            nextWindow += windowSeconds;
         }
-        return;
     }
-
-    // Floor hit
-    float minY = floorY + t.size.y * 0.5f;
-    if (t.pos.y <= minY) {
-        t.pos.y = minY;
-        t.velocity = { 0.0f, 0.0f };
-        t.falling = false;
-        t.inHole = false;
-        fallingToyIndex = -1;
-        gameState = GameState::ActiveNoToy;
+    monitor.finish();
+    monitor.report(std::cout);
+    if (!soak.reportPath.empty() && !monitor.writeCsv(soak.reportPath)) {
+        std::cout << "[SOAK] could not write " << soak.reportPath << std::endl;
     }
+    return monitor.failures().empty() ? 0 : 1;
 }
 
-void mouseClickCallback(GLFWwindow* window, int button, int action, int mods)
+// Renders floors of growing size with no frame cap and prints one row per
+// size. Runs at a fixed simulation step so every row does the same work.
+void runFloorBenchmark()
 {
-    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
-    gClickCounter++;
-    double mx, my;
-    glfwGetCursorPos(window, &mx, &my);
-    windowToOpenGL(mx, my, mouseGL.x, mouseGL.y);
-    std::cout << "\n[CLICK #" << gClickCounter << "] mouseGL=(" << mouseGL.x << ", " << mouseGL.y << ")"
-        << " state=" << gameStateName(gameState)
-        << " prize.hasToy=" << (prize.hasToy ? 1 : 0)
-        << " prize.toyIndex=" << prize.toyIndex
-        << std::endl;
-
-    // Prize collection: if clicked slightly early while toy is on the way, remember the intent.
-    if (prize.hasToy && pointInPrizeArea(mouseGL)) {
-        // Always collect immediately when a prize exists; no state gating to avoid timing misses.
-        std::cout << "[CLICK #" << gClickCounter << "] HIT: prize area, prize.hasToy=1 -> collectPrize()" << std::endl;
-        collectPrize();
-        return;
+    const int sizes[] = { 1, 10, 100, 1000 };
+    const float step = 1.0f / 75.0f;
+    const int warmupFrames = 60;
+    const double measureSeconds = 3.0;
+
+    std::printf("[FLOOR] %6s %8s %9s %9s %9s %6s %9s %8s %9s\n",
+        "N", "FPS", "frame ms", "update ms", "render ms", "draws", "instances", "visible", "impostors");
+    for (int n : sizes) {
+        if (glfwWindowShouldClose(window)) break;
+        arcadeFloor = std::make_unique<ArcadeFloor>();
+        if (!arcadeFloor->init(n, machineTextures, *spriteBatch)) {
+            std::cout << "[FLOOR] impostor atlas unavailable" << std::endl;
+            return;
+        }
+        double updateMs = 0.0, renderMs = 0.0;
+        int frames = 0;
+        double start = 0.0;
+        for (int f = 0;; ++f) {
+            if (f == warmupFrames) {
+                glFinish();
+                start = glfwGetTime();
+                updateMs = renderMs = 0.0;
+                frames = 0;
+            }
+            arcadeFloor->update(step, scheduler->threadPool());
+            renderFloor();
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            updateMs += arcadeFloor->stats().updateMs;
+            renderMs += arcadeFloor->stats().renderMs;
+            frames++;
+            if (f >= warmupFrames && glfwGetTime() - start >= measureSeconds) break;
+        }
+        glFinish();
+        double elapsed = glfwGetTime() - start;
+        const FloorStats& s = arcadeFloor->stats();
+        std::printf("[FLOOR] %6d %8.1f %9.3f %9.3f %9.3f %6d %9zu %8d %9d\n",
+            n, frames / elapsed, elapsed * 1000.0 / frames, updateMs / frames, renderMs / frames,
+            s.drawCalls, s.instances, s.visible, s.impostors);
     }
+    arcadeFloor.reset();
+}
 
-    if (pointInRect(mouseGL, tokenSlot.pos, tokenSlot.size)) {
-        std::cout << "[CLICK #" << gClickCounter << "] HIT: token slot, state=" << gameStateName(gameState) << std::endl;
-        if (gameState == GameState::Idle) {
-            std::cout << "[CLICK #" << gClickCounter << "] ACTION: startGame()" << std::endl;
-            startGame();
+// Renders the machine with the prize glowing and the lamp blinking, with the
+// glow off and at each target resolution, and prints one row per setting.
+// Frames are uncapped; the bloom column is GPU time from timer queries.
+void runBloomBenchmark()
+{
+    const int divisors[] = { 0, 4, 2, 1 };
+    const float step = 1.0f / 75.0f;
+    const int warmupFrames = 60;
+    const double measureSeconds = 3.0;
+
+    player->lamp.mode = LampMode::Blink;
+    player->prize.hasToy = true;
+    machineSpriteSystem(*player);
+    std::printf("[BLOOM] %6s %11s %8s %9s %13s\n", "target", "size", "FPS", "frame ms", "bloom GPU ms");
+    for (int divisor : divisors) {
+        if (glfwWindowShouldClose(window)) break;
+        BloomOptions options;
+        options.divisor = divisor;
+        if (!bloom.init(options, screenWidth, screenHeight)) continue;
+        BloomStats before;
+        int frames = 0;
+        double start = 0.0;
+        for (int f = 0;; ++f) {
+            if (f == warmupFrames) {
+                glFinish();
+                start = glfwGetTime();
+                before = bloom.stats();
+                frames = 0;
+            }
+            player->clock += step;
+            render();
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            frames++;
+            if (f >= warmupFrames && glfwGetTime() - start >= measureSeconds) break;
         }
+        glFinish();
+        double elapsed = glfwGetTime() - start;
+        BloomStats after = bloom.stats();
+        char target[16], size[24], gpu[16];
+        if (divisor > 0) std::snprintf(target, sizeof(target), "1/%d", divisor);
+        else std::snprintf(target, sizeof(target), "off");
+        std::snprintf(size, sizeof(size), "%dx%d", after.width, after.height);
+        const uint64_t timed = after.timed - before.timed;
+        const double gpuMs = after.avgGpuMs * after.timed - before.avgGpuMs * before.timed;
+        if (timed > 0) std::snprintf(gpu, sizeof(gpu), "%.3f", gpuMs / double(timed));
+        else std::snprintf(gpu, sizeof(gpu), "-");
+        std::printf("[BLOOM] %6s %11s %8.1f %9.3f %13s\n", target, divisor > 0 ? size : "-", frames / elapsed,
+            elapsed * 1000.0 / frames, gpu);
     }
+    bloom.shutdown();
 }
 
-void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+// Fills the pool with long-lived confetti and renders uncapped, finishing
+// every frame, with particles off, on transform feedback and on the CPU. One
+// row per path; the update column is render thread time only.
+void runParticleBenchmark(int capacity)
 {
-    if (action == GLFW_PRESS && key == GLFW_KEY_ESCAPE) {
-        glfwSetWindowShouldClose(window, true);
+    const float step = 1.0f / 75.0f;
+    const int warmupFrames = 60;
+    const double measureSeconds = 3.0;
+
+    std::printf("[PARTICLES] %18s %8s %8s %9s %10s\n", "path", "count", "FPS", "frame ms", "update ms");
+    for (int path = 0; path < 3; ++path) {
+        if (glfwWindowShouldClose(window)) break;
+        if (!particles.init(path == 0 ? 0 : capacity, path == 2)) continue;
+        ParticleBurst burst = confettiBurst(player->prize.pos);
+        burst.count = static_cast<uint32_t>(capacity);
+        burst.lifeMin = burst.lifeMax = 3600.0f;
+        particles.emit(burst);
+        ParticleStats before;
+        int frames = 0;
+        double start = 0.0;
+        for (int f = 0;; ++f) {
+            if (f == warmupFrames) {
+                start = glfwGetTime();
+                before = particles.stats();
+                frames = 0;
+            }
+            particles.update(step);
+            render();
+            glFinish();
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            frames++;
+            if (f >= warmupFrames && glfwGetTime() - start >= measureSeconds) break;
+        }
+        double elapsed = glfwGetTime() - start;
+        ParticleStats after = particles.stats();
+        const uint64_t updates = after.updates - before.updates;
+        const double updateMs = after.avgUpdateMs * after.updates - before.avgUpdateMs * before.updates;
+        const char* name = path == 0 ? "off" : after.gpu ? "transform feedback" : "CPU";
+        std::printf("[PARTICLES] %18s %8u %8.1f %9.3f %10.3f\n", name, after.used, frames / elapsed,
+            elapsed * 1000.0 / frames, updates > 0 ? updateMs / double(updates) : 0.0);
     }
+    particles.shutdown();
 }
 
-void update(float dt)
+// Headless: steps self-playing machines and measures snapshot capture, delta
+// coding and restore round trips. Needs no window or GL context. Returns
+// nonzero if any round trip comes back different or a corrupt snapshot restores.
+int runSnapshotBenchmark()
 {
-    double mx, my;
-    glfwGetCursorPos(window, &mx, &my);
-    windowToOpenGL(mx, my, mouseGL.x, mouseGL.y);
-
-    updateLamp(dt);
-    updateClawMotion(dt);
-
-    bool sDown = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
-    bool wDown = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
-    if (sDown && !sWasDown) {
-        if (gameState == GameState::ActiveNoToy && !claw.movingDown && !claw.movingUp) startLowering();
-        else if (gameState == GameState::ActiveCarrying) releaseToy();
+    using Clock = std::chrono::steady_clock;
+    const int machineCount = 1000;
+    const int warmupTicks = 300;
+    const int measureTicks = 600;
+    const float step = 1.0f / 75.0f;
+    const MachineTextures textures{ 1, 2, 3, 4 };
+
+    std::vector<std::unique_ptr<Machine>> machines;
+    std::vector<AttractPlayer> players(machineCount);
+    for (int i = 0; i < machineCount; ++i) {
+        machines.push_back(std::make_unique<Machine>());
+        machines[i]->logEvents = false;
+        initMachine(*machines[i], textures, 1337u + i);
+        initAttract(players[i], static_cast<uint32_t>(i) + 1u);
     }
-    // Manual vertical control when not auto-raising and gameplay is active.
-    bool allowManual = (gameState == GameState::ActiveNoToy || gameState == GameState::ActiveCarrying) && !claw.movingUp && !claw.movingDown;
-    if (allowManual) {
-        if (sDown) {
-            claw.ropeLength = std::min(claw.ropeLength + claw.lowerSpeed * dt, claw.maxLength);
+    auto stepAll = [&] {
+        for (int i = 0; i < machineCount; ++i) {
+            driveAttract(*machines[i], players[i], step);
+            stepMachine(*machines[i], step);
         }
-        if (wDown) {
-            claw.ropeLength = std::max(claw.ropeLength - claw.raiseSpeed * dt, claw.minLength);
+    };
+    for (int t = 0; t < warmupTicks; ++t) stepAll();
+
+    uint32_t tick = warmupTicks;
+    std::vector<MachineSnapshot> previous(machineCount), current(machineCount), decoded(machineCount);
+    std::vector<std::vector<uint8_t>> deltas(machineCount);
+    for (int i = 0; i < machineCount; ++i) captureSnapshot(*machines[i], tick, previous[i]);
+
+    double captureSec = 0.0, encodeSec = 0.0, decodeSec = 0.0;
+    std::size_t deltaBytes = 0;
+    int mismatches = 0;
+    for (int t = 0; t < measureTicks; ++t) {
+        stepAll();
+        ++tick;
+        auto t0 = Clock::now();
+        for (int i = 0; i < machineCount; ++i) captureSnapshot(*machines[i], tick, current[i]);
+        auto t1 = Clock::now();
+        for (int i = 0; i < machineCount; ++i) encodeDelta(previous[i], current[i], deltas[i]);
+        auto t2 = Clock::now();
+        for (int i = 0; i < machineCount; ++i) {
+            if (!decodeDelta(previous[i], deltas[i].data(), deltas[i].size(), decoded[i])) mismatches++;
+        }
+        auto t3 = Clock::now();
+        captureSec += std::chrono::duration<double>(t1 - t0).count();
+        encodeSec += std::chrono::duration<double>(t2 - t1).count();
+        decodeSec += std::chrono::duration<double>(t3 - t2).count();
+        for (int i = 0; i < machineCount; ++i) {
+            deltaBytes += deltas[i].size();
+            if (std::memcmp(&decoded[i], &current[i], sizeof(MachineSnapshot)) != 0) mismatches++;
         }
+        previous.swap(current);
     }
-    sWasDown = sDown;
 
-    // Keep grabbed toy attached
-    if (grabbedToyIndex >= 0) {
-        toys[grabbedToyIndex].pos = clawGrabPoint();
+    // Keyframes, and restore -> capture -> step -> capture against the original.
+    std::size_t keyframeBytes = 0;
+    int restoreMismatches = 0;
+    std::vector<uint8_t> keyframe;
+    Machine restored;
+    restored.logEvents = false;
+    MachineSnapshot a, b;
+    for (int i = 0; i < machineCount; ++i) {
+        encodeKeyframe(previous[i], keyframe);
+        keyframeBytes += keyframe.size();
+        initMachine(restored, textures, 0);
+        bool same = restoreSnapshot(restored, previous[i]);
+        captureSnapshot(restored, tick, a);
+        same = same && std::memcmp(&a, &previous[i], sizeof(a)) == 0;
+        machines[i]->input = InputState{};
+        restored.input = InputState{};
+        stepMachine(*machines[i], step);
+        stepMachine(restored, step);
+        captureSnapshot(*machines[i], tick + 1, a);
+        captureSnapshot(restored, tick + 1, b);
+        same = same && std::memcmp(&a, &b, sizeof(a)) == 0;
+        if (!same) restoreMismatches++;
     }
 
-    updateFallingToy(dt);
-
-    // Auto-honor a pending prize click once state is ready.
-    if (pendingPrizeClick && prize.hasToy && gameState == GameState::PrizeWaiting) {
-        collectPrize();
-        pendingPrizeClick = false;
+    // Out-of-range enum fields must be refused, not cast into the machine.
+    int corruptAccepted = 0;
+    for (int field = 0; field < 4; ++field) {
+        MachineSnapshot bad = previous[0];
+        bad.toyCount = std::max<uint8_t>(bad.toyCount, 1);
+        if (field == 0) bad.gameState = 200;
+        else if (field == 1) bad.lampMode = 200;
+        else if (field == 2) bad.toys[0].state = 200;
+        else bad.toys[0].layer = kLayerCount;
+        if (restoreSnapshot(restored, bad)) corruptAccepted++;
     }
 
-    // Advance prize pulse timer for visual cue.
-    if (prize.hasToy) prizePulseTime += dt; else prizePulseTime = 0.0f;
+    const double snapshots = double(machineCount) * measureTicks;
+    const double rawMB = snapshots * sizeof(MachineSnapshot) / (1024.0 * 1024.0);
+    std::printf("[SNAPSHOT] %d machines x %d ticks, version %u\n", machineCount, measureTicks, kSnapshotVersion);
+    std::printf("[SNAPSHOT] raw %zu B, keyframe %.1f B, delta %.1f B avg (%.1f KB per tick for the floor)\n",
+        sizeof(MachineSnapshot), double(keyframeBytes) / machineCount, deltaBytes / snapshots,
+        deltaBytes / double(measureTicks) / 1024.0);
+    std::printf("[SNAPSHOT] capture %7.1f ns/snapshot %8.1f MB/s, %.3f ms per tick\n",
+        captureSec * 1e9 / snapshots, rawMB / captureSec, captureSec * 1000.0 / measureTicks);
+    std::printf("[SNAPSHOT] encode  %7.1f ns/snapshot %8.1f MB/s, %.3f ms per tick\n",
+        encodeSec * 1e9 / snapshots, rawMB / encodeSec, encodeSec * 1000.0 / measureTicks);
+    std::printf("[SNAPSHOT] decode  %7.1f ns/snapshot %8.1f MB/s, %.3f ms per tick\n",
+        decodeSec * 1e9 / snapshots, rawMB / decodeSec, decodeSec * 1000.0 / measureTicks);
+    std::printf("[SNAPSHOT] round trip mismatches: delta %d, restore %d; corrupt snapshots accepted: %d of 4\n",
+        mismatches, restoreMismatches, corruptAccepted);
+    return mismatches == 0 && restoreMismatches == 0 && corruptAccepted == 0 ? 0 : 1;
 }
 
-// ---------------------- Rendering ---------------------- //
-void drawQuadColor(const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& color)
+// Headless: self-playing machines swing their claws while a rope per machine
+// is stepped between carriage and claw at each segment count. Prints the cost
+// of one rope per tick and how far its worst segment stretched, for choosing
+// the fidelity of each cabinet tier. Needs no window or GL context.
+void runRopeBenchmark()
 {
-    glUseProgram(colorShader);
-    glUniform2f(glGetUniformLocation(colorShader, "uPos"), pos.x, pos.y);
-    glUniform2f(glGetUniformLocation(colorShader, "uSize"), size.x, size.y);
-    glUniform1f(glGetUniformLocation(colorShader, "uRotation"), rot);
-    glUniform4f(glGetUniformLocation(colorShader, "uColor"), color[0], color[1], color[2], color[3]);
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-}
-
-void drawQuadTexture(unsigned int tex, const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& tint)
-{
-    glUseProgram(textureShader);
-    glUniform2f(glGetUniformLocation(textureShader, "uPos"), pos.x, pos.y);
-    glUniform2f(glGetUniformLocation(textureShader, "uSize"), size.x, size.y);
-    glUniform1f(glGetUniformLocation(textureShader, "uRotation"), rot);
-    glUniform4f(glGetUniformLocation(textureShader, "uTint"), tint[0], tint[1], tint[2], tint[3]);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glUniform1i(glGetUniformLocation(textureShader, "uTex"), 0);
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-}
-
-void renderBackground()
-{
-    drawQuadColor({ 0.0f, 0.0f }, { 2.4f, 2.4f }, 0.0f, { 0.05f, 0.06f, 0.08f, 1.0f });
-}
-
-void renderCabinet()
-{
-    std::array<float, 4> cyan = { 0.15f, 0.68f, 0.74f, 1.0f };
-    std::array<float, 4> darkBlue = { 0.10f, 0.24f, 0.34f, 1.0f };
-    std::array<float, 4> brown = { 0.38f, 0.27f, 0.17f, 1.0f };
-
-    Vec2 cabinetCenter = { 0.0f, boxCenter.y - 0.03f };
-    Vec2 cabinetSize = { boxSize.x + 0.24f, boxSize.y + 0.36f };
-    drawQuadColor(cabinetCenter, cabinetSize, 0.0f, cyan);
-
-    // Side trims
-    float trimWidth = 0.08f;
-    drawQuadColor({ boxLeft - trimWidth * 0.5f, boxCenter.y }, { trimWidth, boxSize.y + 0.32f }, 0.0f, brown);
-    drawQuadColor({ boxRight + trimWidth * 0.5f, boxCenter.y }, { trimWidth, boxSize.y + 0.32f }, 0.0f, brown);
-
-    // Top cover
-    drawQuadColor({ cabinetCenter.x, boxTop + 0.16f }, { cabinetSize.x, 0.18f }, 0.0f, darkBlue);
-    drawQuadColor({ cabinetCenter.x, boxTop + 0.24f }, { cabinetSize.x, 0.04f }, 0.0f, brown);
-
-    // Bottom control area
-    drawQuadColor({ cabinetCenter.x, boxBottom - 0.18f }, { cabinetSize.x, 0.26f }, 0.0f, darkBlue);
-    drawQuadColor({ cabinetCenter.x, boxBottom - 0.28f }, { cabinetSize.x, 0.06f }, 0.0f, brown);
-}
-
-void renderGlassBox()
-{
-    // Glass tint
-    drawQuadColor(boxCenter, boxSize, 0.0f, { 0.75f, 0.95f, 0.98f, 0.20f });
-    // Inner overlay to darken a bit
-    drawQuadColor(boxCenter, boxSize, 0.0f, { 0.08f, 0.10f, 0.12f, 0.18f });
-
-    // Top band inside glass
-    drawQuadColor({ boxCenter.x, boxTop - 0.04f }, { boxSize.x, 0.04f }, 0.0f, { 0.12f,0.20f,0.28f,0.45f });
-    // Floor strip
-    drawQuadColor({ boxCenter.x, floorY - 0.01f }, { boxSize.x, 0.04f }, 0.0f, { 0.06f,0.08f,0.10f,0.35f });
-}
-
-void renderHole()
-{
-    drawQuadTexture(holeTexture, hole.center, { hole.radius * 2.0f, hole.radius * 2.0f }, 0.0f, { 0.9f,0.9f,0.95f,0.85f });
-}
+    using Clock = std::chrono::steady_clock;
+    const int machineCount = 64;
+    const int warmupTicks = 300;
+    const int measureTicks = 1500;
+    const float step = 1.0f / 75.0f;
+    const MachineTextures textures{ 1, 2, 3, 4 };
+    const int tiers[] = { 16, 64, 256 };
+
+    std::printf("[ROPE] %d machines x %d ticks\n", machineCount, measureTicks);
+    std::printf("[ROPE] %8s %10s %14s %12s %12s\n", "segments", "iterations", "ns/rope/tick", "us/rope/s", "max stretch");
+    for (int segments : tiers) {
+        std::vector<std::unique_ptr<Machine>> machines;
+        std::vector<AttractPlayer> players(machineCount);
+        std::vector<Rope> ropes(machineCount);
+        for (int i = 0; i < machineCount; ++i) {
+            machines.push_back(std::make_unique<Machine>());
+            machines[i]->logEvents = false;
+            initMachine(*machines[i], textures, 1337u + i);
+            initAttract(players[i], static_cast<uint32_t>(i) + 1u);
+            initRope(ropes[i], segments);
+        }
+        auto stepAll = [&] {
+            for (int i = 0; i < machineCount; ++i) {
+                driveAttract(*machines[i], players[i], step);
+                stepMachine(*machines[i], step);
+            }
+        };
+        for (int t = 0; t < warmupTicks; ++t) stepAll();
+        for (int i = 0; i < machineCount; ++i) {
+            const Claw& c = machines[i]->claw;
+            resetRope(ropes[i], c.anchor, c.pos + Vec2{ 0.0f, c.height * 0.5f });
+        }
 
-void renderPrizeCompartment()
-{
-    drawQuadColor(prize.pos, prize.size, 0.0f, { 0.12f,0.20f,0.28f,1.0f });
-    drawQuadColor(prize.pos + Vec2{ 0.0f, prize.size.y * 0.20f }, { prize.size.x * 1.05f, 0.02f }, 0.0f, { 0.40f,0.50f,0.55f,1.0f });
-    if (prize.hasToy) {
-        float pulse = 0.45f + 0.35f * std::sin(prizePulseTime * 6.0f);
-        std::array<float, 4> glow = { 0.95f, 0.95f, 0.35f, pulse };
-        drawQuadColor(prize.pos, prize.size * 1.15f, 0.0f, glow);
-    }
-    if (prize.hasToy && prize.toyIndex >= 0) {
-        drawQuadTexture(toys[prize.toyIndex].texture, prize.pos, toys[prize.toyIndex].size * 1.1f, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
+        std::vector<uint32_t> paid(machineCount);
+        for (int i = 0; i < machineCount; ++i) paid[i] = machines[i]->prizesPaid;
+        double seconds = 0.0;
+        float stretch = 0.0f;
+        for (int t = 0; t < measureTicks; ++t) {
+            stepAll();
+            // Paying out a prize snaps the carriage home; the game lays its rope straight then too.
+            for (int i = 0; i < machineCount; ++i) {
+                if (machines[i]->prizesPaid == paid[i]) continue;
+                paid[i] = machines[i]->prizesPaid;
+                const Claw& c = machines[i]->claw;
+                resetRope(ropes[i], c.anchor, c.pos + Vec2{ 0.0f, c.height * 0.5f });
+            }
+            auto t0 = Clock::now();
+            for (int i = 0; i < machineCount; ++i) {
+                const Claw& c = machines[i]->claw;
+                stepRope(ropes[i], c.anchor, c.pos + Vec2{ 0.0f, c.height * 0.5f }, c.ropeLength - c.height * 0.5f, kClawGravity, step);
+            }
+            seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+            for (int i = 0; i < machineCount; ++i) {
+                const Claw& c = machines[i]->claw;
+                stretch = std::max(stretch, ropeStretch(ropes[i], c.ropeLength - c.height * 0.5f));
+            }
+        }
+        const double nsPerStep = seconds * 1e9 / (double(machineCount) * measureTicks);
+        std::printf("[ROPE] %8d %10d %14.1f %12.1f %11.2f%%\n", segments, ropes[0].iterations, nsPerStep,
+            nsPerStep * 75.0 / 1000.0, stretch * 100.0f);
     }
 }
 
-void renderTokenSlot()
+// Headless: 500 soft-body toys, in thirds resting on the floor, carried and
+// swung in the claw, and dropped to land and squash, stepped at 240 Hz with
+// the bodies split across 1, 2 and 4 threads. Prints the cost of a step and
+// its share of the 4.17 ms a step may take. Needs no window or GL context.
+void runPlushBenchmark()
 {
-    drawQuadColor(tokenSlot.pos, tokenSlot.size, 0.0f, { 0.38f,0.27f,0.17f,1.0f });
-    drawQuadColor(tokenSlot.pos + Vec2{ 0.0f, 0.01f }, { tokenSlot.size.x * 0.75f, 0.012f }, 0.0f, { 0.96f,0.80f,0.32f,1.0f });
-}
+    using Clock = std::chrono::steady_clock;
+    const int toyCount = 500;
+    const int warmupSteps = 240;
+    const int measureSteps = 2400;
+    const float step = 1.0f / 240.0f;
+    const Vec2 size{ 0.12f, 0.12f };
+    const unsigned threadCounts[] = { 1, 2, 4 };
+
+    // Each toy follows its own script on a 2 s cycle, offset so that landings are spread out.
+    auto targetAt = [&](int toy, int tick) {
+        const float x = -0.8f + 1.6f * float(toy % 50) / 49.0f;
+        const float phase = std::fmod(float(tick) * step + float(toy) * 0.013f, 2.0f);
+        PlushTarget t{ Vec2{ x, floorY + size.y * 0.5f }, size, floorY, 0.0f };
+        if (toy % 3 == 1) {
+            t.pos = Vec2{ x + 0.1f * std::sin(phase * 3.14159f), 0.3f };
+            t.grip = size.x * 0.30f;
+        } else if (toy % 3 == 2) {
+            t.pos.y += std::max(0.4f + 0.5f * kToyGravity * phase * phase, 0.0f);
+        }
+        return t;
+    };
 
-void renderLamp()
-{
-    std::array<float, 4> off = { 0.15f,0.15f,0.15f,1.0f };
-    std::array<float, 4> blue = { 0.2f,0.5f,1.0f,1.0f };
-    std::array<float, 4> green = { 0.1f,0.9f,0.3f,1.0f };
-    std::array<float, 4> red = { 0.95f,0.1f,0.1f,1.0f };
-    std::array<float, 4> color = off;
-    if (lamp.mode == LampMode::Blue) color = blue;
-    else if (lamp.mode == LampMode::Blink) color = lamp.blinkToggle ? green : red;
-
-    Vec2 lampPos = { boxCenter.x, boxTop + 0.18f };
-    drawQuadColor(lampPos, { 0.16f, 0.10f }, 0.0f, { 0.08f,0.08f,0.10f,1.0f });
-    drawQuadColor(lampPos, { 0.12f, 0.08f }, 0.0f, color);
+    std::printf("[PLUSH] %d toys x %d points, %d steps at 240 Hz\n", toyCount, kPlushPoints, measureSteps);
+    std::printf("[PLUSH] %8s %12s %14s %12s\n", "threads", "us/step", "steps/s", "of budget");
+    for (unsigned threads : threadCounts) {
+        PlushSolver solver;
+        for (int i = 0; i < toyCount; ++i) solver.add(Entity{ static_cast<uint32_t>(i) + 1u, 0 }, targetAt(i, 0));
+        WorkStealingPool pool(threads - 1);
+        auto stepAll = [&](int tick) {
+            for (int i = 0; i < toyCount; ++i) solver.target(i) = targetAt(i, tick);
+            solver.step(step, threads > 1 ? &pool : nullptr);
+        };
+        for (int t = 0; t < warmupSteps; ++t) stepAll(t);
+        double seconds = 0.0;
+        for (int t = 0; t < measureSteps; ++t) {
+            for (int i = 0; i < toyCount; ++i) solver.target(i) = targetAt(i, warmupSteps + t);
+            auto t0 = Clock::now();
+            solver.step(step, threads > 1 ? &pool : nullptr);
+            seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+        }
+        const double usPerStep = seconds * 1e6 / measureSteps;
+        std::printf("[PLUSH] %8u %12.1f %14.0f %11.1f%%\n", threads, usPerStep, 1e6 / usPerStep, usPerStep / (1e6 / 240.0) * 100.0);
+    }
 }
 
-void renderRopeAndClaw()
+// Headless: the same self-playing machines on the float and the Q16.16
+// simulation, then the fixed batch operations against plain float loops.
+// Prints the cost of a machine tick on each path and one hash over every
+// machine's snapshot at every tick; the fixed hash must come out the same on
+// every build, compiler and CPU, the float one need not. Halfway through, the
+// fixed machines are also restored into fresh ones that must follow them
+// hash for hash. Needs no window or GL context.
+void runFixedBenchmark()
 {
-    Vec2 cPos = clawPosition();
-    Vec2 ropeCenter = { claw.anchor.x, (claw.anchor.y + cPos.y) * 0.5f };
-    float ropeLen = claw.anchor.y - cPos.y;
-    std::array<float, 4> rail = { 0.18f,0.45f,0.75f,1.0f };
-    std::array<float, 4> joint = { 0.10f,0.24f,0.34f,1.0f };
-    float railY = boxTop - 0.04f;
-    drawQuadColor({ (boxLeft + boxRight) * 0.5f, railY }, { boxSize.x, 0.03f }, 0.0f, rail);
-    drawQuadColor({ claw.anchor.x, railY - 0.04f }, { 0.08f, 0.08f }, 0.0f, joint);
-
-    drawQuadColor(ropeCenter, { 0.012f, ropeLen }, 0.0f, { 0.85f,0.85f,0.90f,1.0f });
-
-    std::array<float, 4> clawColor = claw.open ? std::array<float, 4>{ 0.90f,0.92f,0.96f,1.0f } : std::array<float, 4>{ 0.64f,0.66f,0.72f,1.0f };
-    std::array<float, 4> clawShadow = { 0.08f,0.10f,0.12f,0.35f };
-    drawQuadColor(cPos + Vec2{ 0.01f, -0.01f }, { claw.width, claw.height }, 0.0f, clawShadow);
-    drawQuadColor(cPos, { claw.width, claw.height }, 0.0f, clawColor);
-    // Small jaws
-    float jawOffset = claw.width * 0.25f;
-    float jawWidth = claw.width * 0.18f;
-    float jawHeight = claw.height * 0.6f;
-    if (claw.open) {
-        drawQuadColor(cPos + Vec2{ -jawOffset, -jawHeight * 0.25f }, { jawWidth, jawHeight }, 0.35f, clawColor);
-        drawQuadColor(cPos + Vec2{ jawOffset, -jawHeight * 0.25f }, { jawWidth, jawHeight }, -0.35f, clawColor);
-    }
-    else {
-        drawQuadColor(cPos + Vec2{ -jawOffset * 0.6f, -jawHeight * 0.2f }, { jawWidth, jawHeight }, 0.05f, clawColor);
-        drawQuadColor(cPos + Vec2{ jawOffset * 0.6f, -jawHeight * 0.2f }, { jawWidth, jawHeight }, -0.05f, clawColor);
+    using Clock = std::chrono::steady_clock;
+    const int machineCount = 64;
+    const int ticks = 4500;
+    const float step = 1.0f / 75.0f;
+    const MachineTextures textures{ 1, 2, 3, 4 };
+    auto chainHash = [](uint64_t chain, uint64_t h) { return (chain ^ h) * 0x100000001b3ull; };
+
+    std::printf("[FIXED] %d machines x %d ticks\n", machineCount, ticks);
+    std::printf("[FIXED] %6s %16s %8s %18s\n", "path", "ns/machine/tick", "prizes", "state hash");
+    for (int fixed = 0; fixed < 2; ++fixed) {
+        std::vector<std::unique_ptr<Machine>> machines, replays;
+        std::vector<AttractPlayer> players(machineCount), replayPlayers;
+        for (int i = 0; i < machineCount; ++i) {
+            machines.push_back(std::make_unique<Machine>());
+            machines[i]->logEvents = false;
+            machines[i]->fixedPoint = fixed != 0;
+            initMachine(*machines[i], textures, 1337u + i);
+            initAttract(players[i], static_cast<uint32_t>(i) + 1u);
+        }
+        uint64_t chain = 0xcbf29ce484222325ull;
+        double seconds = 0.0;
+        int replayMismatches = 0;
+        MachineSnapshot snap, replaySnap;
+        for (int t = 0; t < ticks; ++t) {
+            if (fixed && t == ticks / 2) {
+                replayPlayers = players;
+                for (int i = 0; i < machineCount; ++i) {
+                    replays.push_back(std::make_unique<Machine>());
+                    replays[i]->logEvents = false;
+                    replays[i]->fixedPoint = true;
+                    initMachine(*replays[i], textures, 0);
+                    captureSnapshot(*machines[i], uint32_t(t), snap);
+                    if (!restoreSnapshot(*replays[i], snap)) replayMismatches++;
+                }
+            }
+            for (int i = 0; i < machineCount; ++i) driveAttract(*machines[i], players[i], step);
+            auto t0 = Clock::now();
+            for (int i = 0; i < machineCount; ++i) stepMachine(*machines[i], step);
+            seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+            for (int i = 0; i < machineCount; ++i) {
+                captureSnapshot(*machines[i], uint32_t(t + 1), snap);
+                chain = chainHash(chain, snapshotHash(snap));
+                if (replays.empty()) continue;
+                driveAttract(*replays[i], replayPlayers[i], step);
+                stepMachine(*replays[i], step);
+                captureSnapshot(*replays[i], uint32_t(t + 1), replaySnap);
+                if (snapshotHash(replaySnap) != snapshotHash(snap)) replayMismatches++;
+            }
+        }
+        uint32_t prizes = 0;
+        for (const auto& m : machines) prizes += m->prizesPaid;
+        std::printf("[FIXED] %6s %16.1f %8u   %016llx\n", fixed ? "fixed" : "float",
+            seconds * 1e9 / (double(machineCount) * ticks), prizes, static_cast<unsigned long long>(chain));
+        if (fixed) std::printf("[FIXED] restored halfway: %d of %d machine ticks differ\n", replayMismatches, machineCount * (ticks - ticks / 2));
     }
-}
 
-void renderToys()
-{
-    for (const auto& t : toys) {
-        if (!t.active || t.inPrize) continue;
-        drawQuadTexture(t.texture, t.pos, t.size, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
+    // Batch operations on arrays that stay in cache, against the float loops they replace.
+    const std::size_t n = 4096;
+    const int reps = 20000;
+    std::vector<int32_t> acc(n), v(n), out(n);
+    std::vector<float> facc(n), fv(n), fout(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = int32_t(i * 37 % 2048) - 1024;
+        fv[i] = fixedToFloat(Fixed{ v[i] });
     }
+    const Fixed k = fixedFromFloat(step);
+    auto timeLoop = [&](auto&& body) {
+        auto t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) {
+            body();
+            // Keeps the compiler from hoisting a repeated loop out of the timing.
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+        return std::chrono::duration<double>(Clock::now() - t0).count() * 1e9 / (double(n) * reps);
+    };
+    const double fixedMulAddNs = timeLoop([&] { fixedMulAdd(acc.data(), v.data(), k, n); });
+    const double floatMulAddNs = timeLoop([&] { for (std::size_t i = 0; i < n; ++i) facc[i] += fv[i] * step; });
+    const double fixedAddNs = timeLoop([&] { fixedAdd(out.data(), v.data(), out.data(), n); });
+    const double floatAddNs = timeLoop([&] { for (std::size_t i = 0; i < n; ++i) fout[i] += fv[i]; });
+    const double fixedMulNs = timeLoop([&] { fixedMul(acc.data(), v.data(), out.data(), n); });
+    const double floatMulNs = timeLoop([&] { for (std::size_t i = 0; i < n; ++i) fout[i] = facc[i] * fv[i]; });
+    std::printf("[FIXED] %8s %14s %14s\n", "batch", "fixed ns/elem", "float ns/elem");
+    std::printf("[FIXED] %8s %14.3f %14.3f\n", "mul-add", fixedMulAddNs, floatMulAddNs);
+    std::printf("[FIXED] %8s %14.3f %14.3f\n", "add", fixedAddNs, floatAddNs);
+    std::printf("[FIXED] %8s %14.3f %14.3f\n", "mul", fixedMulNs, floatMulNs);
+    // Keeps the loops from being optimized away.
+    std::printf("[FIXED] checksums %d %d %.3f %.3f\n", acc[n / 2], out[n / 3], facc[n / 2], fout[n / 3]);
 }
 
-void renderLabel()
+// Headless: checks Philox against the published known answers, then prints
+// 32-bit draws per nanosecond from mt19937, from PhiloxRng one at a time and
+// from philoxFill in bulk on one thread and on every core, and the cost of
+// seeking each generator ten million draws ahead, as a snapshot restore does.
+// Needs no window or GL context. Returns nonzero if a known answer is wrong or
+// the split fill differs from the single-threaded one.
+int runRngBenchmark()
 {
-    drawQuadTexture(labelTex, { 0.0f, 0.82f }, { 1.6f, 0.28f }, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
+    using Clock = std::chrono::steady_clock;
+    const std::size_t draws = std::size_t(1) << 26;
+    const uint64_t seekDraws = 10000000;
+    auto seconds = [](Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+    // Random123's known-answer vectors for Philox4x32-10.
+    const bool known = philox4x32({ 0, 0, 0, 0 }, { 0, 0 }) == PhiloxCounter{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u } &&
+        philox4x32({ ~0u, ~0u, ~0u, ~0u }, { ~0u, ~0u }) == PhiloxCounter{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu } &&
+        philox4x32({ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, { 0xa4093822u, 0x299f31d0u }) ==
+            PhiloxCounter{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u };
+    std::printf("[RNG] Philox4x32-10 known answers: %s\n", known ? "ok" : "MISMATCH");
+    std::printf("[RNG] state: mt19937 %zu bytes, PhiloxRng %zu bytes\n", sizeof(std::mt19937), sizeof(PhiloxRng));
+
+    uint32_t sink = 0;
+    std::mt19937 mt(1337);
+    auto t0 = Clock::now();
+    for (std::size_t i = 0; i < draws; ++i) sink ^= mt();
+    const double mtSec = seconds(t0);
+
+    PhiloxRng philox(1337);
+    t0 = Clock::now();
+    for (std::size_t i = 0; i < draws; ++i) sink ^= philox();
+    const double philoxSec = seconds(t0);
+
+    std::vector<uint32_t> bulk(draws);
+    const std::size_t blocks = draws / 4;
+    t0 = Clock::now();
+    philoxFill(1337, 0, 0, bulk.data(), blocks);
+    const double fillSec = seconds(t0);
+    sink ^= bulk[draws / 2];
+
+    // The same stream split across threads lands on the same values.
+    std::vector<uint32_t> parallel(draws);
+    unsigned hw = std::thread::hardware_concurrency();
+    WorkStealingPool pool(hw > 1 ? hw - 1 : 0);
+    t0 = Clock::now();
+    pool.parallelFor(blocks, 1 << 14, [&parallel](std::size_t first, std::size_t last) {
+        philoxFill(1337, 0, first, &parallel[first * 4], last - first);
+    });
+    const double parallelSec = seconds(t0);
+    const bool sameSplit = parallel == bulk;
+
+    std::printf("[RNG] %-22s %12s\n", "generator", "draws/ns");
+    std::printf("[RNG] %-22s %12.3f\n", "mt19937", draws / (mtSec * 1e9));
+    std::printf("[RNG] %-22s %12.3f\n", "PhiloxRng", draws / (philoxSec * 1e9));
+    std::printf("[RNG] %-22s %12.3f\n", "philoxFill", draws / (fillSec * 1e9));
+    std::printf("[RNG] %-22s %12.3f   (%u threads, %s as one thread)\n", "philoxFill parallel", draws / (parallelSec * 1e9),
+        pool.workerCount() + 1, sameSplit ? "same" : "DIFFERENT");
+
+    t0 = Clock::now();
+    mt.seed(1337);
+    mt.discard(seekDraws);
+    sink ^= mt();
+    const double mtSeekSec = seconds(t0);
+    t0 = Clock::now();
+    philox.restore(1337, seekDraws);
+    sink ^= philox();
+    const double philoxSeekSec = seconds(t0);
+    std::printf("[RNG] seek %llu draws: mt19937 %.3f ms, Philox %.3f us\n", static_cast<unsigned long long>(seekDraws),
+        mtSeekSec * 1e3, philoxSeekSec * 1e6);
+    std::printf("[RNG] checksum %08x\n", sink);
+    return known && sameSplit ? 0 : 1;
 }
 
-void renderCursor()
+// Headless: regenerates the procedural textures and steps a self-playing
+// machine through the scheduler under hardware counters, then prints the
+// per-region table. Needs no window or GL context.
+void runPerfBenchmark()
 {
-    unsigned int tex = (gameState == GameState::Idle) ? cursorTokenTex : cursorLeverTex;
-    Vec2 size = (gameState == GameState::Idle) ? Vec2{ 0.08f, 0.08f } : Vec2{ 0.10f, 0.10f };
-    Vec2 pos = mouseGL;
-    if (tex == cursorLeverTex) {
-        pos = mouseGL + Vec2{ size.x * 0.5f, size.y * 0.5f };
+    if (!enablePerfCounters()) return;
+    const int textureRounds = 200;
+    const int ticks = 20000;
+    const float step = 1.0f / 75.0f;
+    const int dotsRegion = perfRegion("makeToyTextureDots");
+    const int stripesRegion = perfRegion("makeToyTextureStripes");
+    const int checksRegion = perfRegion("makeToyTextureChecks");
+    const int ringRegion = perfRegion("makeRingTexture");
+    const int labelRegion = perfRegion("makeLabelTexture");
+    for (int i = 0; i < textureRounds; ++i) {
+        { PerfScope scope(dotsRegion); makeToyTextureDots(64); }
+        { PerfScope scope(stripesRegion); makeToyTextureStripes(64); }
+        { PerfScope scope(checksRegion); makeToyTextureChecks(64); }
+        { PerfScope scope(ringRegion); makeRingTexture(96, { 20,25,32,210 }, { 80,90,110,190 }); }
+        { PerfScope scope(labelRegion); makeLabelTexture(1024, 220, "BORIS LAHOS RA 168/2022\n\nLEFT CLICK TOKEN SLOT  - START GAME"); }
     }
-    drawQuadTexture(tex, pos, size, 0.0f, { 1.0f,1.0f,1.0f,1.0f });
-}
-
-void render()
-{
-    glClearColor(0.05f, 0.06f, 0.08f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
 
-    renderBackground();
-    renderCabinet();
-    renderGlassBox();
-    renderPrizeCompartment();
-    renderTokenSlot();
-    renderHole();
-    renderToys();
-    renderRopeAndClaw();
-    renderLamp();
-    renderLabel();
-    renderCursor();
+    Machine m;
+    m.logEvents = false;
+    initMachine(m, MachineTextures{ 1, 2, 3, 4 }, 1337u);
+    AttractPlayer attract;
+    initAttract(attract, 1u);
+    Scheduler sched(0);
+    registerMachineSystems(sched, m);
+    for (int t = 0; t < ticks; ++t) {
+        driveAttract(m, attract, step);
+        sched.tick(step);
+    }
+    reportPerfCounters(std::cout);
 }
 
-// ---------------------- Main loop ---------------------- //
-void mainLoop()
+LaunchOptions parseArgs(int argc, char** argv)
 {
-    const double targetFrame = 1.0 / 75.0;
-    double lastTime = glfwGetTime();
-    while (!glfwWindowShouldClose(window))
-    {
-        double now = glfwGetTime();
-        float dt = float(now - lastTime);
-        lastTime = now;
-
-        update(dt);
-        render();
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-
-        double frameTime = glfwGetTime() - now;
-        if (frameTime < targetFrame) {
-            std::this_thread::sleep_for(std::chrono::duration<double>(targetFrame - frameTime));
+    LaunchOptions opts;
+    opts.hitch.logPath = "clawmachine-hitches.log";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--deterministic") opts.deterministic = true;
+        else if (arg == "--floor" && i + 1 < argc) opts.floorMachines = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--floor-bench") opts.floorBench = true;
+        else if (arg == "--bench-snapshot") opts.snapshotBench = true;
+        else if (arg == "--publish" && i + 1 < argc) {
+            opts.publish = true;
+            opts.publisher.endpoint.socketPath = argv[++i];
+        }
+        else if (arg == "--publish-tcp" && i + 1 < argc) {
+            opts.publish = true;
+            opts.publisher.endpoint.tcpPort = std::atoi(argv[++i]);
+        }
+        else if (arg == "--rewind-seconds" && i + 1 < argc) opts.rewindSeconds = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--publish-rate" && i + 1 < argc) opts.publisher.rateHz = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--flight" && i + 1 < argc) opts.flightPath = argv[++i];
+        else if (arg == "--no-flight") opts.flightPath.clear();
+        else if (arg == "--ledger" && i + 1 < argc) opts.ledgerDir = argv[++i];
+        else if (arg == "--no-ledger") opts.ledgerDir.clear();
+        else if (arg == "--telemetry" && i + 1 < argc) opts.telemetryPath = argv[++i];
+        else if (arg == "--metrics-port" && i + 1 < argc) opts.metricsPort = std::atoi(argv[++i]);
+        else if (arg == "--no-metrics") opts.metricsPort = 0;
+        else if (arg == "--stats-shm" && i + 1 < argc) opts.statsName = argv[++i];
+        else if (arg == "--no-stats-shm") opts.statsName.clear();
+        else if (arg == "--perf") opts.perf = true;
+        else if (arg == "--bench-perf") opts.perfBench = true;
+        else if (arg == "--hitch-ms" && i + 1 < argc) opts.hitch.minMs = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--hitch-factor" && i + 1 < argc) opts.hitch.factor = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--hitch-log" && i + 1 < argc) opts.hitch.logPath = argv[++i];
+        else if (arg == "--no-hitch-log") opts.hitch.logPath.clear();
+        else if (arg == "--gl-replay" && i + 1 < argc) opts.glReplayPath = argv[++i];
+        else if (arg == "--record-session" && i + 1 < argc) opts.recordPath = argv[++i];
+        else if (arg == "--session" && i + 1 < argc) opts.sessionPath = argv[++i];
+        else if (arg == "--golden" && i + 1 < argc) opts.goldenDir = argv[++i];
+        else if (arg == "--golden-update") opts.goldenUpdate = true;
+        else if (arg == "--golden-every" && i + 1 < argc) opts.goldenEvery = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--golden-threshold" && i + 1 < argc) opts.goldenThreshold = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--golden-tolerance" && i + 1 < argc) opts.goldenTolerance = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--record-video" && i + 1 < argc) opts.video.path = argv[++i];
+        else if (arg == "--record-scale" && i + 1 < argc) opts.video.scale = std::atoi(argv[++i]);
+        else if (arg == "--bloom" && i + 1 < argc) opts.bloom.divisor = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--no-bloom") opts.bloom.divisor = 0;
+        else if (arg == "--bloom-passes" && i + 1 < argc) opts.bloom.passes = std::atoi(argv[++i]);
+        else if (arg == "--bloom-strength" && i + 1 < argc) opts.bloom.strength = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--bench-bloom") opts.bloomBench = true;
+        else if (arg == "--particles" && i + 1 < argc) opts.particles = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--no-particles") opts.particles = 0;
+        else if (arg == "--particles-cpu") opts.particlesCpu = true;
+        else if (arg == "--bench-particles") opts.particleBench = true;
+        else if (arg == "--rope-segments" && i + 1 < argc) opts.ropeSegments = std::clamp(std::atoi(argv[++i]), 0, 1024);
+        else if (arg == "--bench-rope") opts.ropeBench = true;
+        else if (arg == "--no-plush") opts.plush = false;
+        else if (arg == "--bench-plush") opts.plushBench = true;
+        else if (arg == "--fixed-point") opts.fixedPoint = true;
+        else if (arg == "--hash-log" && i + 1 < argc) opts.hashLogPath = argv[++i];
+        else if (arg == "--bench-fixed") opts.fixedBench = true;
+        else if (arg == "--bench-rng") opts.rngBench = true;
+        else if (arg == "--soak" && i + 1 < argc) {
+            opts.soakRun = true;
+            opts.soak.days = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--soak-bot" && i + 1 < argc) {
+            if (!parseBotStrategy(argv[++i], opts.soak.strategy)) std::cout << "Unknown soak bot: " << argv[i] << std::endl;
         }
+        else if (arg == "--soak-seed" && i + 1 < argc) opts.soak.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--soak-render-every" && i + 1 < argc) opts.soak.renderEvery = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--soak-drift" && i + 1 < argc) opts.soak.driftLimit = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--soak-rss-mb" && i + 1 < argc) opts.soak.rssLimitMB = std::atof(argv[++i]);
+        else if (arg == "--soak-stuck-seconds" && i + 1 < argc) opts.soak.stuckSeconds = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--soak-report" && i + 1 < argc) opts.soak.reportPath = argv[++i];
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
     }
+    // A golden check plays a fixed session from a fresh start, and a soak
+    // plays for days; neither may touch the ledger or anything a live game
+    // shares.
+    if (!opts.goldenDir.empty() || opts.soakRun) {
+        opts.deterministic = true;
+        opts.ledgerDir.clear();
+        opts.telemetryPath.clear();
+        opts.metricsPort = 0;
+        opts.statsName.clear();
+        opts.hitch.logPath.clear();
+        opts.floorMachines = 0;
+        opts.publish = false;
+        opts.recordPath.clear();
+        opts.video.path.clear();
+    }
+    return opts;
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    LaunchOptions opts = parseArgs(argc, argv);
+    const bool golden = !opts.goldenDir.empty();
+    const bool headless = golden || opts.soakRun;
+    if (golden && opts.sessionPath.empty()) return endProgram("--golden needs --session PATH.");
+    // The ring is sized from this up front, so a bad value must not reach it.
+    if (!(opts.rewindSeconds > 0.0f) || opts.rewindSeconds > kMaxRewindSeconds) return endProgram("--rewind-seconds needs a number of seconds above 0 and at most 3600.");
+    if (opts.snapshotBench) return runSnapshotBenchmark();
+    if (opts.perfBench) {
+        runPerfBenchmark();
+        return 0;
+    }
+    if (opts.ropeBench) {
+        runRopeBenchmark();
+        return 0;
+    }
+    if (opts.plushBench) {
+        runPlushBenchmark();
+        return 0;
+    }
+    if (opts.fixedBench) {
+        runFixedBenchmark();
+        return 0;
+    }
+    if (opts.rngBench) return runRngBenchmark();
+    if (!opts.flightPath.empty() && openFlightRecorder(opts.flightPath)) installFlightCrashHandler();
+    // Like the other sidecars, a ledger that cannot open (no POSIX syncing, a
+    // read-only directory) is reported and the game runs without it.
+    if (!opts.ledgerDir.empty() && !ledger.open(opts.ledgerDir)) {
+        std::cout << "[LEDGER] playing without a ledger" << std::endl;
+        opts.ledgerDir.clear();
+    }
+    if (!opts.ledgerDir.empty()) {
+        LedgerTotals lt = ledger.totals();
+        const LedgerRecovery& lr = ledger.recovery();
+        std::cout << "[LEDGER] " << opts.ledgerDir << ": " << lt.credits << " credits, " << lt.payouts << " payouts ("
+            << lr.replayed << " journal records replayed";
+        if (lr.truncatedBytes > 0) std::cout << ", " << lr.truncatedBytes << " torn bytes cut";
+        std::cout << ")" << std::endl;
+    }
+    registerGameMetrics();
+    if (opts.metricsPort > 0) metricsServer.start(opts.metricsPort);
+    if (!opts.statsName.empty()) openLiveStats(opts.statsName);
+    if (opts.perf) enablePerfCounters();
+    hitches.init(opts.hitch);
     if (!initGLFW()) return endProgram("GLFW init failed.");
-    if (!initWindow()) return endProgram("Window creation failed.");
+    if (!initWindow(!headless)) return endProgram("Window creation failed.");
     if (!initGLEW()) return endProgram("GLEW init failed.");
 
     glfwSetMouseButtonCallback(window, mouseClickCallback);
     glfwSetKeyCallback(window, keyCallback);
 
-    createVAOs();
-
-    colorShader = createShader("Source/Shaders/color.vert", "Source/Shaders/color.frag");
-    textureShader = createShader("Source/Shaders/texture.vert", "Source/Shaders/texture.frag");
+    if (!initRenderer()) return endProgram("Renderer init failed.");
 
-    toyTextureA = createTextureFromRGBA(makeToyTextureDots(64), 64, 64);
-    toyTextureB = createTextureFromRGBA(makeToyTextureStripes(64), 64, 64);
-    toyTextureC = createTextureFromRGBA(makeToyTextureChecks(64), 64, 64);
-    holeTexture = createTextureFromRGBA(makeRingTexture(96, { 20,25,32,210 }, { 80,90,110,190 }), 96, 96);
-    cursorTokenTex = createTextureFromRGBA(makeCoinTexture(64), 64, 64);
-    cursorLeverTex = createTextureFromRGBA(makeLeverTexture(64), 64, 64);
-    labelTex = createTextureFromRGBA(
-        makeLabelTexture(1024, 220,
+    machineTextures = createMachineTextures();
+    std::vector<unsigned char> coin, lever, label;
+    {
+        PerfScope scope(perfRegion("make UI textures"));
+        coin = makeCoinTexture(64);
+        lever = makeLeverTexture(64);
+        label = makeLabelTexture(1024, 220,
             "BORIS LAHOS RA 168/2022\n\n"
             "LEFT CLICK TOKEN SLOT  - START GAME\n"
             "A / D                  - MOVE CLAW\n"
             "S                      - LOWER / DROP\n"
             "LEFT CLICK PRIZE       - COLLECT TOY\n"
-            "ESC                    - EXIT"),
-        1024, 220);
-
-    spawnToys();
-    resetMachine();
+            "ESC                    - EXIT");
+    }
+    cursorTokenTex = createTextureFromRGBA(coin, 64, 64);
+    cursorLeverTex = createTextureFromRGBA(lever, 64, 64);
+    labelTex = createTextureFromRGBA(label, 1024, 220);
+
+    player = std::make_unique<Machine>();
+    initMachine(*player, machineTextures, 1337);
+    setRopeSegments(*player, opts.ropeSegments);
+    setPlushEnabled(*player, opts.plush);
+    player->fixedPoint = opts.fixedPoint;
+    if (!opts.hashLogPath.empty()) {
+        hashLog = std::fopen(opts.hashLogPath.c_str(), "w");
+        if (!hashLog) std::cout << "[HASH] could not open " << opts.hashLogPath << std::endl;
+    }
+    if (!opts.telemetryPath.empty() && telemetry.open(opts.telemetryPath)) player->recordPlays = true;
+    historyView = std::make_unique<Machine>();
+    historyView->logEvents = false;
+    initMachine(*historyView, machineTextures, 0);
+    // The main loop caps at 75 fps, so that bounds the tick rate.
+    rewindBuffer.init(opts.rewindSeconds, 75.0f);
     initOpenGLState();
-    mainLoop();
+
+    unsigned hw = std::thread::hardware_concurrency();
+    scheduler = std::make_unique<Scheduler>(hw > 1 ? std::min(hw - 1, 3u) : 0u);
+    scheduler->setDeterministic(opts.deterministic);
+    registerMachineSystems(*scheduler, *player);
+
+    if (opts.floorMachines > 0 || opts.floorBench) {
+        spriteBatch = std::make_unique<SpriteBatch>();
+        if (!spriteBatch->init()) return endProgram("Sprite batch init failed.");
+    }
+    // The floor draws through the sprite batch, which has no glow pass.
+    if (opts.floorMachines == 0 && !opts.floorBench && !opts.bloomBench) bloom.init(opts.bloom, screenWidth, screenHeight);
+    if (opts.floorMachines == 0 && !opts.floorBench && !opts.particleBench && !particles.init(opts.particles, opts.particlesCpu)) {
+        return endProgram("Particle system init failed.");
+    }
+    int status = 0;
+    if (golden) {
+        status = runGoldenCheck(opts) == 0 ? 0 : 1;
+    }
+    else if (opts.soakRun) {
+        status = runSoak(opts.soak);
+    }
+    else if (opts.floorBench) {
+        runFloorBenchmark();
+    }
+    else if (opts.bloomBench) {
+        runBloomBenchmark();
+    }
+    else if (opts.particleBench) {
+        runParticleBenchmark(opts.particles > 0 ? opts.particles : 100000);
+    }
+    else {
+        if (opts.floorMachines > 0) {
+            arcadeFloor = std::make_unique<ArcadeFloor>();
+            if (!arcadeFloor->init(opts.floorMachines, machineTextures, *spriteBatch)) return endProgram("Arcade floor init failed.");
+            if (telemetry.isOpen()) arcadeFloor->setTelemetry(&telemetry);
+        }
+        videoOptions = opts.video;
+        if (!opts.video.path.empty()) videoRecorder.start(opts.video, screenWidth, screenHeight);
+        if (opts.publish) {
+            publisher = std::make_unique<SpectatorPublisher>();
+            if (!publisher->start(opts.publisher)) publisher.reset();
+        }
+        if (!opts.glReplayPath.empty()) {
+            if (!kGLTraceBuilt) return endProgram("--gl-replay needs a build configured with -DCLAW_GL_TRACE=ON.");
+            if (!glTraceLoadReplay(opts.glReplayPath)) return endProgram("GL capture could not be loaded.");
+            runGLReplay();
+        }
+        else {
+            recordingSession = !opts.recordPath.empty() && !arcadeFloor;
+            mainLoop();
+            if (recordingSession && saveSession(opts.recordPath, session)) {
+                std::cout << "[SESSION] " << session.ticks.size() << " ticks and " << session.clicks.size()
+                    << " clicks saved to " << opts.recordPath << std::endl;
+            }
+        }
+        scheduler->report(std::cout);
+        reportPerfCounters(std::cout);
+        glTraceReport(std::cout);
+        bloom.report(std::cout);
+        particles.report(std::cout);
+        if (hitches.hitches() > 0) hitches.report(std::cout);
+        if (publisher) {
+            PublisherStats ps = publisher->stats();
+            std::cout << "[SPECTATE] published " << ps.published << " snapshots, " << ps.bytesSent << " bytes, "
+                << ps.dropped << " dropped for slow subscribers" << std::endl;
+        }
+    }
+
+    videoRecorder.stop();
+    bloom.shutdown();
+    particles.shutdown();
+    publisher.reset();
+    if (metricsServer.scrapes() > 0) std::cout << "[METRICS] served " << metricsServer.scrapes() << " scrapes" << std::endl;
+    metricsServer.stop();
+    arcadeFloor.reset();
+    if (telemetry.isOpen()) {
+        telemetry.close();
+        std::cout << "[TELEMETRY] " << telemetry.eventsWritten() << " play events written to " << opts.telemetryPath << std::endl;
+    }
+    spriteBatch.reset();
+    scheduler.reset();
 
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    if (!opts.ledgerDir.empty()) {
+        ledger.close();
+        LedgerStats ls = ledger.stats();
+        std::printf("[LEDGER] %llu events in %llu group commits (%.2f ms per fdatasync), append avg %.2f us max %.2f us\n",
+            static_cast<unsigned long long>(ls.appended), static_cast<unsigned long long>(ls.batches),
+            ls.avgSyncMs, ls.avgAppendUs, ls.maxAppendUs);
+    }
+    if (hashLog) {
+        std::fclose(hashLog);
+        std::cout << "[HASH] " << simTick << " tick hashes written to " << opts.hashLogPath << std::endl;
+    }
+    closeLiveStats();
+    closeFlightRecorder();
+    return status;
 }
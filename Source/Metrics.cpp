@@ -0,0 +1,380 @@
+#include "../Header/Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+GameMetrics gameMetrics;
+
+namespace {
+enum class MetricKind : uint8_t {
+    Counter,
+    Gauge,
+    Histogram
+};
+
+struct MetricInfo {
+    std::string name;
+    std::string help;
+    MetricKind kind = MetricKind::Counter;
+    std::vector<double> bounds;
+};
+
+// One thread's share of every counter and histogram. Only the owning thread
+// writes it, except for the last shard, which overflow threads share.
+struct alignas(64) MetricShard {
+    std::atomic<uint64_t> counters[kMaxMetrics];
+    std::atomic<uint64_t> buckets[kMaxMetrics][kMaxMetricBuckets + 1];
+    std::atomic<double> sums[kMaxMetrics];
+};
+
+MetricInfo infos[kMaxMetrics];
+int metricCount = 0;
+std::atomic<uint64_t> gauges[kMaxMetrics];   // Bit patterns of doubles
+MetricShard shards[kMaxMetricShards];
+std::atomic<int> shardCount{ 0 };
+
+struct LocalShard {
+    MetricShard* shard = nullptr;
+    bool shared = false;
+};
+
+LocalShard& localShard()
+{
+    thread_local LocalShard local;
+    if (!local.shard) {
+        int i = shardCount.fetch_add(1, std::memory_order_relaxed);
+        local.shared = i >= kMaxMetricShards - 1;
+        local.shard = &shards[std::min(i, kMaxMetricShards - 1)];
+    }
+    return local;
+}
+
+// A single writer can load and store; a shared shard needs read-modify-write.
+void bump(std::atomic<uint64_t>& a, uint64_t n, bool shared)
+{
+    if (shared) a.fetch_add(n, std::memory_order_relaxed);
+    else a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void accumulate(std::atomic<double>& a, double v, bool shared)
+{
+    double old = a.load(std::memory_order_relaxed);
+    if (!shared) {
+        a.store(old + v, std::memory_order_relaxed);
+        return;
+    }
+    while (!a.compare_exchange_weak(old, old + v, std::memory_order_relaxed)) {}
+}
+
+MetricId registerMetric(const char* name, const char* help, MetricKind kind, std::initializer_list<double> bounds)
+{
+    if (metricCount >= kMaxMetrics || bounds.size() > std::size_t(kMaxMetricBuckets)) {
+        std::cout << "[METRICS] cannot register " << name << std::endl;
+        return -1;
+    }
+    MetricInfo& info = infos[metricCount];
+    info.name = name;
+    info.help = help;
+    info.kind = kind;
+    info.bounds.assign(bounds.begin(), bounds.end());
+    return metricCount++;
+}
+
+bool valid(MetricId id, MetricKind kind)
+{
+    return id >= 0 && id < metricCount && infos[id].kind == kind;
+}
+
+void appendf(std::string& out, const char* format, ...)
+{
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int n = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) out.append(line, std::min<std::size_t>(std::size_t(n), sizeof(line) - 1));
+}
+}
+
+MetricId registerCounter(const char* name, const char* help)
+{
+    return registerMetric(name, help, MetricKind::Counter, {});
+}
+
+MetricId registerGauge(const char* name, const char* help)
+{
+    return registerMetric(name, help, MetricKind::Gauge, {});
+}
+
+MetricId registerHistogram(const char* name, const char* help, std::initializer_list<double> bounds)
+{
+    return registerMetric(name, help, MetricKind::Histogram, bounds);
+}
+
+void metricAdd(MetricId id, uint64_t n)
+{
+    if (!valid(id, MetricKind::Counter)) return;
+    LocalShard& local = localShard();
+    bump(local.shard->counters[id], n, local.shared);
+}
+
+void metricSet(MetricId id, double value)
+{
+    if (!valid(id, MetricKind::Gauge)) return;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    gauges[id].store(bits, std::memory_order_relaxed);
+}
+
+void metricObserve(MetricId id, double value)
+{
+    if (!valid(id, MetricKind::Histogram)) return;
+    const std::vector<double>& bounds = infos[id].bounds;
+    std::size_t b = 0;
+    while (b < bounds.size() && value > bounds[b]) ++b;
+    LocalShard& local = localShard();
+    bump(local.shard->buckets[id][b], 1, local.shared);
+    accumulate(local.shard->sums[id], value, local.shared);
+}
+
+std::string renderMetrics()
+{
+    const int shardsInUse = std::min(shardCount.load(), kMaxMetricShards);
+    std::string out;
+    out.reserve(4096);
+    for (int id = 0; id < metricCount; ++id) {
+        const MetricInfo& info = infos[id];
+        const char* type = info.kind == MetricKind::Counter ? "counter" : info.kind == MetricKind::Gauge ? "gauge" : "histogram";
+        appendf(out, "# HELP %s %s\n# TYPE %s %s\n", info.name.c_str(), info.help.c_str(), info.name.c_str(), type);
+        if (info.kind == MetricKind::Counter) {
+            uint64_t total = 0;
+            for (int s = 0; s < shardsInUse; ++s) total += shards[s].counters[id].load(std::memory_order_relaxed);
+            appendf(out, "%s %llu\n", info.name.c_str(), static_cast<unsigned long long>(total));
+        }
+        else if (info.kind == MetricKind::Gauge) {
+            uint64_t bits = gauges[id].load(std::memory_order_relaxed);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            appendf(out, "%s %.17g\n", info.name.c_str(), value);
+        }
+        else {
+            uint64_t cumulative = 0;
+            double sum = 0.0;
+            for (std::size_t b = 0; b <= info.bounds.size(); ++b) {
+                for (int s = 0; s < shardsInUse; ++s) cumulative += shards[s].buckets[id][b].load(std::memory_order_relaxed);
+                if (b < info.bounds.size()) appendf(out, "%s_bucket{le=\"%g\"} %llu\n", info.name.c_str(), info.bounds[b], static_cast<unsigned long long>(cumulative));
+                else appendf(out, "%s_bucket{le=\"+Inf\"} %llu\n", info.name.c_str(), static_cast<unsigned long long>(cumulative));
+            }
+            for (int s = 0; s < shardsInUse; ++s) sum += shards[s].sums[id].load(std::memory_order_relaxed);
+            appendf(out, "%s_sum %.17g\n%s_count %llu\n", info.name.c_str(), sum, info.name.c_str(), static_cast<unsigned long long>(cumulative));
+        }
+    }
+    return out;
+}
+
+void registerGameMetrics()
+{
+    if (gameMetrics.frameSeconds >= 0) return;
+    gameMetrics.frameSeconds = registerHistogram("clawmachine_frame_seconds", "Wall time of a main loop frame, before the frame cap sleep.",
+        { 0.002, 0.004, 0.008, 0.0133, 0.0167, 0.02, 0.025, 0.0333, 0.05, 0.1, 0.25 });
+    gameMetrics.simSteps = registerCounter("clawmachine_sim_steps_total", "Machine simulation steps, summed over every simulated machine.");
+    gameMetrics.drawCalls = registerCounter("clawmachine_draw_calls_total", "GL draw calls issued.");
+    gameMetrics.playsStarted = registerCounter("clawmachine_plays_started_total", "Coins inserted by the player.");
+    gameMetrics.prizesWon = registerCounter("clawmachine_prizes_won_total", "Prizes collected by the player.");
+    gameMetrics.textureBytes = registerGauge("clawmachine_texture_memory_bytes", "Bytes of texture storage the game has allocated.");
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+#ifdef __linux__
+
+namespace {
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr std::size_t kMaxRequestBytes = 8192;
+constexpr std::size_t kMaxConnections = 32;
+constexpr int64_t kConnectionTimeoutMs = 5000;
+}
+
+bool MetricsServer::start(int listenPort)
+{
+    stop();
+    port = listenPort;
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    bool ok = listenFd >= 0 && epollFd >= 0 && wakeFd >= 0;
+    if (ok) {
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ok = bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 && listen(listenFd, 16) == 0;
+    }
+    if (!ok) {
+        std::cout << "[METRICS] could not listen on 127.0.0.1:" << port << ": " << std::strerror(errno) << std::endl;
+        stop();
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    running = true;
+    worker = std::thread(&MetricsServer::run, this);
+    std::cout << "[METRICS] serving http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (running.exchange(false)) {
+        uint64_t one = 1;
+        (void)!write(wakeFd, &one, sizeof(one));
+        worker.join();
+    }
+    while (!connections.empty()) closeConnection(connections.size() - 1);
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+    listenFd = epollFd = wakeFd = -1;
+}
+
+void MetricsServer::run()
+{
+    epoll_event events[32];
+    while (running) {
+        int n = epoll_wait(epollFd, events, 32, 250);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {}
+                continue;
+            }
+            auto it = std::find_if(connections.begin(), connections.end(), [fd](const Connection& c) { return c.fd == fd; });
+            if (it == connections.end()) continue;
+            bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP))) alive = readRequest(*it);
+            if (alive && !it->response.empty()) alive = writeResponse(*it);
+            if (!alive) closeConnection(static_cast<std::size_t>(it - connections.begin()));
+        }
+        // Scrapers that connect and then go quiet are dropped.
+        const int64_t now = nowMs();
+        for (std::size_t i = connections.size(); i-- > 0;) {
+            if (now - connections[i].openedMs > kConnectionTimeoutMs) closeConnection(i);
+        }
+    }
+}
+
+void MetricsServer::acceptConnections()
+{
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: the edge is fully consumed
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if (connections.size() >= kMaxConnections || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            continue;
+        }
+        Connection c;
+        c.fd = fd;
+        c.openedMs = nowMs();
+        connections.push_back(std::move(c));
+    }
+}
+
+// Reads until EAGAIN. Once the request head is complete the response is
+// built; the body is rendered here, on this thread, never by the game.
+bool MetricsServer::readRequest(Connection& c)
+{
+    char scratch[1024];
+    for (;;) {
+        ssize_t r = recv(c.fd, scratch, sizeof(scratch), 0);
+        if (r > 0) {
+            if (c.response.empty()) c.request.append(scratch, std::size_t(r));
+            if (c.request.size() > kMaxRequestBytes) return false;
+            continue;
+        }
+        if (r < 0 && errno == EINTR) continue;
+        if (r == 0) return !c.response.empty();
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+        break;
+    }
+    if (!c.response.empty() || c.request.find("\r\n\r\n") == std::string::npos) return true;
+
+    const bool metrics = c.request.compare(0, 13, "GET /metrics ") == 0 || c.request.compare(0, 6, "GET / ") == 0;
+    std::string body = metrics ? renderMetrics() : "not found\n";
+    char head[256];
+    std::snprintf(head, sizeof(head),
+        "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+        metrics ? "200 OK" : "404 Not Found", metrics ? "text/plain; version=0.0.4" : "text/plain", body.size());
+    c.response = head;
+    c.response += body;
+    if (metrics) scrapeCount++;
+    return true;
+}
+
+// Writes until the socket is full; the connection closes once it is all out.
+bool MetricsServer::writeResponse(Connection& c)
+{
+    while (c.sent < c.response.size()) {
+        ssize_t n = send(c.fd, c.response.data() + c.sent, c.response.size() - c.sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.sent += std::size_t(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return false;
+}
+
+void MetricsServer::closeConnection(std::size_t i)
+{
+    close(connections[i].fd);
+    connections.erase(connections.begin() + i);
+}
+
+#else
+
+bool MetricsServer::start(int)
+{
+    std::cout << "[METRICS] the metrics endpoint needs Linux (epoll)" << std::endl;
+    return false;
+}
+
+void MetricsServer::stop() {}
+
+#endif
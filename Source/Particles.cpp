@@ -0,0 +1,331 @@
+#include "../Header/Particles.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "../Header/Hitch.h"
+#include "../Header/Philox.h"
+#include "../Header/Renderer.h"
+#include "../Header/Util.h"
+
+namespace {
+constexpr uint32_t kParticleSeed = 1u;
+// Two Philox blocks: angle, speed, x, y, life, color, size and spin.
+constexpr std::size_t kParticleDraws = 8;
+}
+
+ParticleBurst confettiBurst(const Vec2& at)
+{
+    ParticleBurst b;
+    b.count = 25000;
+    b.pos = at;
+    b.jitter = { 0.05f, 0.02f };
+    b.direction = 1.5707963f;
+    b.spread = 0.7f;
+    b.speedMin = 0.6f;
+    b.speedMax = 1.6f;
+    b.lifeMin = 1.5f;
+    b.lifeMax = 3.0f;
+    b.gravity = 1.4f;
+    b.drag = 1.2f;
+    b.size = 0.012f;
+    b.spin = 12.0f;
+    b.palette = { { 240, 70, 90, 255 }, { 250, 200, 60, 255 }, { 80, 200, 120, 255 }, { 70, 150, 250, 255 }, { 200, 110, 240, 255 } };
+    return b;
+}
+
+ParticleBurst sparkleBurst(const Vec2& at)
+{
+    ParticleBurst b;
+    b.count = 4000;
+    b.pos = at;
+    b.jitter = { 0.02f, 0.01f };
+    b.speedMin = 0.05f;
+    b.speedMax = 0.45f;
+    b.lifeMin = 0.3f;
+    b.lifeMax = 0.9f;
+    b.gravity = 0.3f;
+    b.drag = 2.0f;
+    b.size = 0.006f;
+    b.palette = { { 255, 240, 160, 255 }, { 255, 210, 90, 255 }, { 255, 255, 255, 220 } };
+    return b;
+}
+
+ParticleSystem::~ParticleSystem()
+{
+    shutdown();
+}
+
+bool ParticleSystem::init(int particleCapacity, bool cpuFallback)
+{
+    shutdown();
+    if (particleCapacity <= 0) return true;
+    capacity = particleCapacity;
+
+    if (!cpuFallback) feedbackShader = createFeedbackShader("Source/Shaders/particle_update.vert", { "vPosVel", "vLife" });
+    drawShader = createShader("Source/Shaders/particle.vert", "Source/Shaders/particle.frag");
+    if (!cpuFallback && feedbackShader == 0) std::printf("[PARTICLES] transform feedback unavailable; updating on the CPU\n");
+
+    const GLsizeiptr stateBytes = GLsizeiptr(capacity) * sizeof(State);
+    glGenBuffers(2, stateBuffers);
+    glGenBuffers(1, &lookBuffer);
+    for (unsigned int buffer : stateBuffers) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, stateBytes, nullptr, feedbackShader ? GL_DYNAMIC_COPY : GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, lookBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity) * sizeof(Look), nullptr, GL_DYNAMIC_DRAW);
+
+    glGenVertexArrays(2, updateVaos);
+    glGenVertexArrays(2, drawVaos);
+    for (int i = 0; i < 2; ++i) {
+        glBindVertexArray(updateVaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(State), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(State), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        setupDrawVao(drawVaos[i], stateBuffers[i]);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (!feedbackShader) {
+        for (auto* field : { &px, &py, &pvx, &pvy, &page, &plife, &pgravity, &pdrag }) field->assign(capacity, 0.0f);
+    }
+    return drawShader != 0;
+}
+
+void ParticleSystem::setupDrawVao(unsigned int vao, unsigned int stateBuffer)
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVertexBuffer());
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffer);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(State), (void*)0);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(State), (void*)(4 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, lookBuffer);
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Look), (void*)offsetof(Look, rgba));
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, sizeof(Look), (void*)offsetof(Look, size));
+    for (GLuint loc = 2; loc <= 5; ++loc) {
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+}
+
+void ParticleSystem::shutdown()
+{
+    if (capacity > 0) {
+        glDeleteVertexArrays(2, updateVaos);
+        glDeleteVertexArrays(2, drawVaos);
+        glDeleteBuffers(2, stateBuffers);
+        glDeleteBuffers(1, &lookBuffer);
+        if (feedbackShader) glDeleteProgram(feedbackShader);
+        if (drawShader) glDeleteProgram(drawShader);
+    }
+    for (int i = 0; i < 2; ++i) stateBuffers[i] = updateVaos[i] = drawVaos[i] = 0;
+    lookBuffer = feedbackShader = drawShader = 0;
+    capacity = 0;
+    current = 0;
+    cursor = used = 0;
+    aliveFor = 0.0f;
+    for (auto* field : { &px, &py, &pvx, &pvy, &page, &plife, &pgravity, &pdrag }) field->clear();
+    peakUsed = 0;
+    bursts = emitted = updates = 0;
+    updateMsTotal = updateMsMax = 0.0;
+}
+
+void ParticleSystem::emit(const ParticleBurst& burst)
+{
+    if (!enabled() || burst.count == 0 || burst.palette.empty()) return;
+    const uint32_t count = std::min<uint32_t>(burst.count, uint32_t(capacity));
+    // Particle n since reset takes Philox blocks 2n and 2n + 1, so its draws
+    // do not depend on how the bursts before it were split.
+    randomStaging.resize(std::size_t(count) * kParticleDraws);
+    philoxFill(kParticleSeed, 0, emitted * (kParticleDraws / 4), randomStaging.data(), std::size_t(count) * (kParticleDraws / 4));
+    auto range = [](uint32_t r, float lo, float hi) { return lo + (hi - lo) * philoxUnit(r); };
+
+    stateStaging.resize(count);
+    lookStaging.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t* r = &randomStaging[std::size_t(i) * kParticleDraws];
+        const float angle = burst.direction + range(r[0], -burst.spread, burst.spread);
+        const float speed = range(r[1], burst.speedMin, burst.speedMax);
+        State& s = stateStaging[i];
+        s.x = burst.pos.x + range(r[2], -burst.jitter.x, burst.jitter.x);
+        s.y = burst.pos.y + range(r[3], -burst.jitter.y, burst.jitter.y);
+        s.vx = std::cos(angle) * speed;
+        s.vy = std::sin(angle) * speed;
+        s.age = 0.0f;
+        s.life = range(r[4], burst.lifeMin, burst.lifeMax);
+        s.gravity = burst.gravity;
+        s.drag = burst.drag;
+        Look& l = lookStaging[i];
+        std::memcpy(l.rgba, burst.palette[r[5] % burst.palette.size()].data(), 4);
+        l.size = burst.size * range(r[6], 0.7f, 1.3f);
+        l.spin = burst.spin * range(r[7], -1.0f, 1.0f);
+    }
+
+    // Overwrite the oldest slots, wrapping at the end of the pool.
+    const uint32_t first = std::min(count, uint32_t(capacity) - cursor);
+    writeSlots(cursor, stateStaging.data(), lookStaging.data(), first);
+    if (first < count) writeSlots(0, stateStaging.data() + first, lookStaging.data() + first, count - first);
+    if (cursor + count >= uint32_t(capacity)) used = uint32_t(capacity);
+    else used = std::max(used, cursor + count);
+    cursor = (cursor + count) % uint32_t(capacity);
+
+    aliveFor = std::max(aliveFor, burst.lifeMax);
+    peakUsed = std::max(peakUsed, used);
+    bursts++;
+    emitted += count;
+}
+
+void ParticleSystem::writeSlots(uint32_t first, const State* states, const Look* looks, uint32_t count)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, lookBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, GLintptr(first) * sizeof(Look), GLsizeiptr(count) * sizeof(Look), looks);
+    if (feedbackShader) {
+        glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[current]);
+        glBufferSubData(GL_ARRAY_BUFFER, GLintptr(first) * sizeof(State), GLsizeiptr(count) * sizeof(State), states);
+    }
+    else {
+        for (uint32_t i = 0; i < count; ++i) {
+            const State& s = states[i];
+            const uint32_t k = first + i;
+            px[k] = s.x;
+            py[k] = s.y;
+            pvx[k] = s.vx;
+            pvy[k] = s.vy;
+            page[k] = s.age;
+            plife[k] = s.life;
+            pgravity[k] = s.gravity;
+            pdrag[k] = s.drag;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::update(float dt)
+{
+    if (!enabled()) return;
+    if (used == 0) return;
+    aliveFor -= dt;
+    if (aliveFor <= 0.0f) {
+        // Everything has died: start again from slot 0 so the next burst
+        // only touches the slots it uses.
+        used = 0;
+        cursor = 0;
+        aliveFor = 0.0f;
+        return;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (feedbackShader) {
+        const int next = 1 - current;
+        glUseProgram(feedbackShader);
+        glUniform1f(glGetUniformLocation(feedbackShader, "uDt"), dt);
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBindVertexArray(updateVaos[current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, stateBuffers[next]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(used));
+        countDrawCalls();
+        glEndTransformFeedback();
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        glDisable(GL_RASTERIZER_DISCARD);
+        current = next;
+    }
+    else {
+        updateOnCpu(dt);
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    updateMsTotal += ms;
+    updateMsMax = std::max(updateMsMax, ms);
+    updates++;
+}
+
+// Same step as particle_update.vert. Dead particles advance by zero rather
+// than being skipped, so the loop has no branch. The arrays are __restrict
+// parameters because GCC will not emit runtime overlap checks for eight of
+// them; promised they never overlap, it vectorizes the loop at -O3.
+static void stepParticles(int n, float dt, float* __restrict x, float* __restrict y, float* __restrict vx,
+                          float* __restrict vy, float* __restrict age, const float* __restrict life,
+                          const float* __restrict gravity, const float* __restrict drag)
+{
+    for (int i = 0; i < n; ++i) {
+        const float step = age[i] < life[i] ? dt : 0.0f;
+        const float keep = std::max(1.0f - drag[i] * step, 0.0f);
+        vy[i] -= gravity[i] * step;
+        vx[i] *= keep;
+        vy[i] *= keep;
+        x[i] += vx[i] * step;
+        y[i] += vy[i] * step;
+        age[i] += step;
+    }
+}
+
+void ParticleSystem::updateOnCpu(float dt)
+{
+    const int n = static_cast<int>(used);
+    const float* x = px.data();
+    const float* y = py.data();
+    const float* vx = pvx.data();
+    const float* vy = pvy.data();
+    const float* age = page.data();
+    const float* life = plife.data();
+    const float* gravity = pgravity.data();
+    const float* drag = pdrag.data();
+    stepParticles(n, dt, px.data(), py.data(), pvx.data(), pvy.data(), page.data(), life, gravity, drag);
+
+    stateStaging.resize(used);
+    for (int i = 0; i < n; ++i) stateStaging[i] = State{ x[i], y[i], vx[i], vy[i], age[i], life[i], gravity[i], drag[i] };
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[0]);
+    // Orphan so the driver does not stall on last frame's draw.
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity) * sizeof(State), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(used) * sizeof(State), stateStaging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::render()
+{
+    if (!enabled() || used == 0) return;
+    glUseProgram(drawShader);
+    glBindVertexArray(drawVaos[current]);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, static_cast<GLsizei>(used));
+    recordGLCall("glDrawArraysInstanced particles", used);
+    countDrawCalls();
+    glBindVertexArray(0);
+}
+
+ParticleStats ParticleSystem::stats() const
+{
+    ParticleStats s;
+    s.gpu = feedbackShader != 0;
+    s.capacity = capacity;
+    s.used = used;
+    s.peakUsed = peakUsed;
+    s.bursts = bursts;
+    s.emitted = emitted;
+    s.updates = updates;
+    s.avgUpdateMs = updates > 0 ? updateMsTotal / double(updates) : 0.0;
+    s.maxUpdateMs = updateMsMax;
+    return s;
+}
+
+void ParticleSystem::report(std::ostream& out) const
+{
+    if (!enabled()) return;
+    ParticleStats s = stats();
+    char line[200];
+    std::snprintf(line, sizeof(line), "[PARTICLES] %s update, %d slots: %llu bursts, %llu particles, peak %u live slots, update avg %.3f ms max %.3f ms\n",
+        s.gpu ? "transform feedback" : "CPU", s.capacity, static_cast<unsigned long long>(s.bursts),
+        static_cast<unsigned long long>(s.emitted), s.peakUsed, s.avgUpdateMs, s.maxUpdateMs);
+    out << line;
+}
@@ -0,0 +1,240 @@
+#include "../Header/PerfCounters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+struct PerfRegionData {
+    std::string name;
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> counts[kPerfCounterCount];
+};
+
+PerfRegionData regions[kMaxPerfRegions];
+std::atomic<int> regionCount{ 0 };
+std::mutex regionMutex;
+std::atomic<bool> enabled{ false };
+std::atomic<uint32_t> availableMask{ 0 };   // Counters the first group opened
+}
+
+int perfRegion(const char* name)
+{
+    std::lock_guard<std::mutex> lock(regionMutex);
+    const int count = regionCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (regions[i].name == name) return i;
+    }
+    if (count >= kMaxPerfRegions) return -1;
+    regions[count].name = name;
+    regionCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+bool perfCountersEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void reportPerfCounters(std::ostream& out)
+{
+    if (!perfCountersEnabled()) return;
+    const uint32_t mask = availableMask.load();
+    auto has = [mask](PerfCounter c) { return (mask & (1u << c)) != 0; };
+    out << "[PERF] per region, inclusive of nested regions; MPKI = misses per 1000 instructions\n";
+    char line[200];
+    std::snprintf(line, sizeof(line), "  %-22s %9s %11s %11s %6s %8s %8s %8s %10s %7s\n",
+        "region", "calls", "Mcycles", "Minstr", "IPC", "L1D MPKI", "LLC MPKI", "br MPKI", "us/call", "faults");
+    out << line;
+    auto column = [](char* buf, std::size_t size, bool ok, double value, const char* format) {
+        if (ok) std::snprintf(buf, size, format, value);
+        else std::snprintf(buf, size, "-");
+    };
+    const int count = regionCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        const PerfRegionData& r = regions[i];
+        const uint64_t calls = r.calls.load();
+        if (calls == 0) continue;
+        double v[kPerfCounterCount];
+        for (int c = 0; c < kPerfCounterCount; ++c) v[c] = double(r.counts[c].load());
+        const double instr = v[PerfInstructions];
+        const bool perInstr = has(PerfInstructions) && instr > 0.0;
+        char cycles[16], instrs[16], ipc[16], l1[16], llc[16], br[16], cpu[16], faults[16];
+        column(cycles, sizeof(cycles), has(PerfCycles), v[PerfCycles] / 1e6, "%.3f");
+        column(instrs, sizeof(instrs), has(PerfInstructions), instr / 1e6, "%.3f");
+        column(ipc, sizeof(ipc), has(PerfCycles) && perInstr && v[PerfCycles] > 0.0, instr / std::max(v[PerfCycles], 1.0), "%.2f");
+        column(l1, sizeof(l1), has(PerfL1DMisses) && perInstr, 1000.0 * v[PerfL1DMisses] / std::max(instr, 1.0), "%.2f");
+        column(llc, sizeof(llc), has(PerfLLCMisses) && perInstr, 1000.0 * v[PerfLLCMisses] / std::max(instr, 1.0), "%.2f");
+        column(br, sizeof(br), has(PerfBranchMisses) && perInstr, 1000.0 * v[PerfBranchMisses] / std::max(instr, 1.0), "%.2f");
+        column(cpu, sizeof(cpu), has(PerfTaskClock), v[PerfTaskClock] / 1e3 / double(calls), "%.2f");
+        column(faults, sizeof(faults), has(PerfPageFaults), v[PerfPageFaults], "%.0f");
+        std::snprintf(line, sizeof(line), "  %-22s %9llu %11s %11s %6s %8s %8s %8s %10s %7s\n",
+            r.name.c_str(), static_cast<unsigned long long>(calls), cycles, instrs, ipc, l1, llc, br, cpu, faults);
+        out << line;
+    }
+    out.flush();
+}
+
+#ifdef __linux__
+
+namespace {
+struct CounterSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+const CounterSpec kSpecs[kPerfCounterCount] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+};
+
+const char* const kCounterNames[kPerfCounterCount] = {
+    "cycles", "instructions", "L1D read misses", "LLC misses", "branch misses", "task clock", "page faults"
+};
+
+// One group per thread: the leader is the first counter that opened, and a
+// group read returns every member in the order it was added.
+struct ThreadGroup {
+    bool tried = false;
+    int fds[kPerfCounterCount];
+    int order[kPerfCounterCount];   // Counter of each value in a group read
+    int members = 0;
+    int error = 0;                  // errno of the first failure
+
+    ~ThreadGroup()
+    {
+        for (int i = 0; i < members; ++i) close(fds[i]);
+    }
+};
+
+int openCounter(const CounterSpec& spec, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+ThreadGroup& threadGroup()
+{
+    thread_local ThreadGroup group;
+    if (!group.tried) {
+        group.tried = true;
+        for (int c = 0; c < kPerfCounterCount; ++c) {
+            int fd = openCounter(kSpecs[c], group.members > 0 ? group.fds[0] : -1);
+            if (fd < 0) {
+                if (group.error == 0) group.error = errno;
+                continue;
+            }
+            group.fds[group.members] = fd;
+            group.order[group.members] = c;
+            group.members++;
+        }
+    }
+    return group;
+}
+
+// Reads the group into counts indexed by PerfCounter, scaled up when the
+// kernel had to multiplex the group off the PMU for part of the time.
+bool readGroup(ThreadGroup& g, uint64_t* counts)
+{
+    uint64_t buffer[3 + kPerfCounterCount];
+    ssize_t want = static_cast<ssize_t>(sizeof(uint64_t) * (3 + g.members));
+    if (read(g.fds[0], buffer, sizeof(buffer)) < want) return false;
+    const uint64_t timeEnabled = buffer[1];
+    const uint64_t timeRunning = buffer[2];
+    const double scale = (timeRunning > 0 && timeRunning < timeEnabled) ? double(timeEnabled) / double(timeRunning) : 1.0;
+    std::memset(counts, 0, sizeof(uint64_t) * kPerfCounterCount);
+    for (int i = 0; i < g.members; ++i) counts[g.order[i]] = static_cast<uint64_t>(double(buffer[3 + i]) * scale);
+    return true;
+}
+
+const char* explainError(int error)
+{
+    switch (error) {
+    case EACCES:
+    case EPERM: return "not permitted; lower /proc/sys/kernel/perf_event_paranoid or grant CAP_PERFMON";
+    case ENOENT:
+    case EOPNOTSUPP:
+    case ENODEV: return "not supported here (no PMU, e.g. in a VM)";
+    case ENOSYS: return "perf_event_open is not available";
+    default: return std::strerror(error);
+    }
+}
+}
+
+bool enablePerfCounters()
+{
+    ThreadGroup& g = threadGroup();
+    uint32_t mask = 0;
+    for (int i = 0; i < g.members; ++i) mask |= 1u << g.order[i];
+    availableMask = mask;
+    if (g.members == 0) {
+        std::cout << "[PERF] no counters could be opened: " << explainError(g.error) << std::endl;
+        return false;
+    }
+    std::cout << "[PERF] counting";
+    for (int c = 0; c < kPerfCounterCount; ++c) {
+        if (mask & (1u << c)) std::cout << (c == g.order[0] ? " " : ", ") << kCounterNames[c];
+    }
+    std::cout << std::endl;
+    if (!(mask & (1u << PerfCycles))) {
+        std::cout << "[PERF] hardware counters unavailable (" << explainError(g.error) << "); reporting software counters only" << std::endl;
+    }
+    enabled = true;
+    return true;
+}
+
+PerfScope::PerfScope(int id)
+{
+    if (!enabled.load(std::memory_order_relaxed) || id < 0) return;
+    ThreadGroup& g = threadGroup();
+    if (g.members == 0 || !readGroup(g, start)) return;
+    region = id;
+}
+
+PerfScope::~PerfScope()
+{
+    if (region < 0) return;
+    uint64_t end[kPerfCounterCount];
+    if (!readGroup(threadGroup(), end)) return;
+    PerfRegionData& r = regions[region];
+    r.calls.fetch_add(1, std::memory_order_relaxed);
+    for (int c = 0; c < kPerfCounterCount; ++c) {
+        if (end[c] > start[c]) r.counts[c].fetch_add(end[c] - start[c], std::memory_order_relaxed);
+    }
+}
+
+#else
+
+bool enablePerfCounters()
+{
+    std::cout << "[PERF] hardware counters need Linux (perf_event_open)" << std::endl;
+    return false;
+}
+
+PerfScope::PerfScope(int) {}
+PerfScope::~PerfScope() {}
+
+#endif
@@ -0,0 +1,191 @@
+#include "../Header/Plush.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Header/Scheduler.h"
+
+namespace {
+// Rest offset of each lattice point from the centre, as a fraction of size.
+struct RestLattice {
+    std::array<float, kPlushPoints> u{}, v{};
+    RestLattice()
+    {
+        for (int i = 0; i < kPlushPoints; ++i) {
+            u[i] = float(i % kPlushGrid) / float(kPlushGrid - 1) - 0.5f;
+            v[i] = float(i / kPlushGrid) / float(kPlushGrid - 1) - 0.5f;
+        }
+    }
+};
+const RestLattice kRest;
+
+// Bodies per parallelFor chunk; a body is a few hundred floats of work.
+constexpr std::size_t kChunk = 32;
+}
+
+int PlushSolver::add(Entity owner, const PlushTarget& t)
+{
+    owners.push_back(owner);
+    targets.push_back(t);
+    const std::size_t n = owners.size() * kPlushPoints;
+    x.resize(n);
+    y.resize(n);
+    px.resize(n);
+    py.resize(n);
+    const int index = count() - 1;
+    reset(index);
+    return index;
+}
+
+void PlushSolver::remove(int index)
+{
+    const int last = count() - 1;
+    if (index < 0 || index > last) return;
+    if (index != last) {
+        owners[index] = owners[last];
+        targets[index] = targets[last];
+        const std::size_t to = std::size_t(index) * kPlushPoints;
+        const std::size_t from = std::size_t(last) * kPlushPoints;
+        std::copy_n(&x[from], kPlushPoints, &x[to]);
+        std::copy_n(&y[from], kPlushPoints, &y[to]);
+        std::copy_n(&px[from], kPlushPoints, &px[to]);
+        std::copy_n(&py[from], kPlushPoints, &py[to]);
+    }
+    owners.pop_back();
+    targets.pop_back();
+    const std::size_t n = owners.size() * kPlushPoints;
+    x.resize(n);
+    y.resize(n);
+    px.resize(n);
+    py.resize(n);
+}
+
+void PlushSolver::clear()
+{
+    owners.clear();
+    targets.clear();
+    x.clear();
+    y.clear();
+    px.clear();
+    py.clear();
+}
+
+int PlushSolver::find(Entity e) const
+{
+    for (std::size_t i = 0; i < owners.size(); ++i) {
+        if (owners[i] == e) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Rest shape on the target, not moving.
+void PlushSolver::reset(int index)
+{
+    const PlushTarget& t = targets[index];
+    const std::size_t base = std::size_t(index) * kPlushPoints;
+    for (int i = 0; i < kPlushPoints; ++i) {
+        x[base + i] = px[base + i] = t.pos.x + kRest.u[i] * t.size.x;
+        y[base + i] = py[base + i] = t.pos.y + kRest.v[i] * t.size.y;
+    }
+}
+
+void PlushSolver::step(float dt, WorkStealingPool* pool)
+{
+    const std::size_t bodies = owners.size();
+    if (pool) pool->parallelFor(bodies, kChunk, [this, dt](std::size_t first, std::size_t last) { stepRange(first, last, dt); });
+    else stepRange(0, bodies, dt);
+}
+
+// One body at a time. GCC at -O3 vectorizes the per-particle passes (the
+// Verlet step, the rotation fit and the pull to the goal shape); the
+// centroid sums stay scalar, as float adds may not be reordered.
+void PlushSolver::stepRange(std::size_t first, std::size_t last, float dt)
+{
+    const float keep = std::max(1.0f - damping * dt, 0.0f);
+    const float fall = gravity * dt * dt;
+    const float* restU = kRest.u.data();
+    const float* restV = kRest.v.data();
+    for (std::size_t b = first; b < last; ++b) {
+        // Locals, so the compiler need not reload them after every store.
+        const PlushTarget& t = targets[b];
+        const float posX = t.pos.x, posY = t.pos.y;
+        const float sizeX = t.size.x, sizeY = t.size.y;
+        const float floorY = t.floorY, grip = t.grip;
+        float* bx = &x[b * kPlushPoints];
+        float* by = &y[b * kPlushPoints];
+        float* bpx = &px[b * kPlushPoints];
+        float* bpy = &py[b * kPlushPoints];
+
+        float cx = 0.0f, cy = 0.0f;
+        for (int i = 0; i < kPlushPoints; ++i) {
+            cx += bx[i];
+            cy += by[i];
+        }
+        cx /= float(kPlushPoints);
+        cy /= float(kPlushPoints);
+        // Gameplay teleported the toy (into the prize window, or a restore).
+        if (std::abs(cx - posX) > sizeX || std::abs(cy - posY) > sizeY) {
+            reset(static_cast<int>(b));
+            continue;
+        }
+
+        for (int i = 0; i < kPlushPoints; ++i) {
+            const float vx = (bx[i] - bpx[i]) * keep;
+            const float vy = (by[i] - bpy[i]) * keep;
+            bpx[i] = bx[i];
+            bpy[i] = by[i];
+            bx[i] += vx;
+            by[i] += vy + fall;
+        }
+
+        for (int it = 0; it < iterations; ++it) {
+            cx = 0.0f;
+            cy = 0.0f;
+            for (int i = 0; i < kPlushPoints; ++i) {
+                cx += bx[i];
+                cy += by[i];
+            }
+            cx /= float(kPlushPoints);
+            cy /= float(kPlushPoints);
+
+            // Best-fit rotation of the rest lattice onto the current one.
+            float dot = 0.0f, cross = 0.0f;
+            for (int i = 0; i < kPlushPoints; ++i) {
+                const float qx = restU[i] * sizeX;
+                const float qy = restV[i] * sizeY;
+                const float rx = bx[i] - cx;
+                const float ry = by[i] - cy;
+                dot += qx * rx + qy * ry;
+                cross += qx * ry - qy * rx;
+            }
+            const float angle = std::atan2(cross, dot) * (1.0f - upright);
+            const float c = std::cos(angle);
+            const float s = std::sin(angle);
+
+            // Plush keeps its area: squashed, the goal widens; stretched, it narrows.
+            float height = 0.0f;
+            for (int i = 0; i < kPlushGrid; ++i) height += by[kPlushPoints - kPlushGrid + i] - by[i];
+            const float squash = std::clamp(height / (float(kPlushGrid) * sizeY), 0.5f, 1.5f);
+            const float widthX = sizeX / squash;
+
+            // Towards the matched shape, and the whole body towards the rigid pose.
+            const float ax = (posX - cx) * anchor;
+            const float ay = (posY - cy) * anchor;
+            for (int i = 0; i < kPlushPoints; ++i) {
+                const float qx = restU[i] * widthX;
+                const float qy = restV[i] * sizeY;
+                const float gx = cx + c * qx - s * qy;
+                const float gy = cy + s * qx + c * qy;
+                bx[i] += (gx - bx[i]) * shape + ax;
+                by[i] += (gy - by[i]) * shape + ay;
+            }
+
+            for (int i = 0; i < kPlushPoints; ++i) by[i] = std::max(by[i], floorY);
+            if (grip > 0.0f) {
+                const float lo = posX - grip;
+                const float hi = posX + grip;
+                for (int i = kPlushPoints / 2; i < kPlushPoints; ++i) bx[i] = std::clamp(bx[i], lo, hi);
+            }
+        }
+    }
+}
@@ -0,0 +1,280 @@
+#include "../Header/Renderer.h"
+
+#include <cmath>
+#include <vector>
+
+#include "../Header/Hitch.h"
+#include "../Header/Util.h"
+
+namespace {
+// A quad shader with its uniform locations, looked up once after linking, and
+// the animation last uploaded to it so unchanged ones are not sent again.
+struct QuadShader {
+    unsigned int program = 0;
+    GLint pos = -1;
+    GLint size = -1;
+    GLint rotation = -1;
+    GLint color = -1;   // uColor or uTint
+    GLint anim = -1;
+    GLint animTo = -1;
+    GLint time = -1;
+    bool uploaded = false;
+    std::array<float, 4> lastAnim{};
+    std::array<float, 4> lastAnimTo{};
+    float lastTime = -1.0f;
+};
+
+QuadShader colorShader;
+QuadShader textureShader;
+unsigned int quadVAO = 0;
+unsigned int quadVBO = 0;
+unsigned int ropeVAO = 0;
+unsigned int ropeVBO = 0;
+std::vector<float> ropeVertices;
+unsigned int plushVAO = 0;
+unsigned int plushVBO = 0;
+unsigned int plushEBO = 0;
+int plushIndexCount = 0;
+float plushVertices[kPlushPoints * 4];
+float animTime = 0.0f;   // uTime for this frame: animationClock() of the machine's clock
+
+bool loadQuadShader(QuadShader& q, const char* vertexPath, const char* fragmentPath, const char* colorName)
+{
+    q = QuadShader{};
+    q.program = createShader(vertexPath, fragmentPath);
+    if (q.program == 0) return false;
+    q.pos = glGetUniformLocation(q.program, "uPos");
+    q.size = glGetUniformLocation(q.program, "uSize");
+    q.rotation = glGetUniformLocation(q.program, "uRotation");
+    q.color = glGetUniformLocation(q.program, colorName);
+    q.anim = glGetUniformLocation(q.program, "uAnim");
+    q.animTo = glGetUniformLocation(q.program, "uAnimTo");
+    q.time = glGetUniformLocation(q.program, "uTime");
+    return true;
+}
+
+// Expects q in use. A sprite's animation only changes when gameplay starts
+// or stops one, so most draws upload nothing; every sprite without one sends
+// the same zeros. uTime goes up once a frame, uAnimTo only for blinks.
+void setAnimationUniforms(QuadShader& q, const SpriteAnim& anim)
+{
+    std::array<float, 4> value{};
+    if (anim.curve != AnimCurve::None) value = { float(anim.curve), anim.start, anim.period, anim.amplitude };
+    if (anim.curve != AnimCurve::None && q.lastTime != animTime) {
+        glUniform1f(q.time, animTime);
+        q.lastTime = animTime;
+    }
+    if (!q.uploaded || value != q.lastAnim) {
+        glUniform4f(q.anim, value[0], value[1], value[2], value[3]);
+        q.lastAnim = value;
+    }
+    if (anim.curve == AnimCurve::Blink && (!q.uploaded || anim.to != q.lastAnimTo)) {
+        glUniform4f(q.animTo, anim.to[0], anim.to[1], anim.to[2], anim.to[3]);
+        q.lastAnimTo = anim.to;
+    }
+    q.uploaded = true;
+}
+}
+
+bool initRenderer()
+{
+    float quadVertices[] = {
+        -0.5f, -0.5f, 0.0f, 0.0f,
+         0.5f, -0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f, 1.0f, 1.0f,
+        -0.5f,  0.5f, 0.0f, 1.0f,
+    };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+
+    glGenVertexArrays(1, &ropeVAO);
+    glGenBuffers(1, &ropeVBO);
+    glBindVertexArray(ropeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, ropeVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+
+    // The lattice's cells as triangle pairs; positions change every draw, UVs never.
+    std::vector<unsigned short> plushIndices;
+    for (int r = 0; r + 1 < kPlushGrid; ++r) {
+        for (int c = 0; c + 1 < kPlushGrid; ++c) {
+            const unsigned short i = static_cast<unsigned short>(r * kPlushGrid + c);
+            const unsigned short up = static_cast<unsigned short>(i + kPlushGrid);
+            plushIndices.insert(plushIndices.end(), { i, static_cast<unsigned short>(i + 1), static_cast<unsigned short>(up + 1), i, static_cast<unsigned short>(up + 1), up });
+        }
+    }
+    plushIndexCount = static_cast<int>(plushIndices.size());
+    glGenVertexArrays(1, &plushVAO);
+    glGenBuffers(1, &plushVBO);
+    glGenBuffers(1, &plushEBO);
+    glBindVertexArray(plushVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, plushVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(plushVertices), nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, plushEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, plushIndices.size() * sizeof(unsigned short), plushIndices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    if (!loadQuadShader(colorShader, "Source/Shaders/color.vert", "Source/Shaders/color.frag", "uColor")) return false;
+    if (!loadQuadShader(textureShader, "Source/Shaders/texture.vert", "Source/Shaders/texture.frag", "uTint")) return false;
+    // Every textured quad samples unit 0.
+    glUseProgram(textureShader.program);
+    glUniform1i(glGetUniformLocation(textureShader.program, "uTex"), 0);
+    return true;
+}
+
+unsigned int quadVertexBuffer()
+{
+    return quadVBO;
+}
+
+void drawQuadColor(const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& color, const SpriteAnim& anim)
+{
+    glUseProgram(colorShader.program);
+    glUniform2f(colorShader.pos, pos.x, pos.y);
+    glUniform2f(colorShader.size, size.x, size.y);
+    glUniform1f(colorShader.rotation, rot);
+    glUniform4f(colorShader.color, color[0], color[1], color[2], color[3]);
+    setAnimationUniforms(colorShader, anim);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    recordGLCall("glDrawArrays color");
+    countDrawCalls();
+}
+
+void drawQuadTexture(unsigned int tex, const Vec2& pos, const Vec2& size, float rot, const std::array<float, 4>& tint,
+    const SpriteAnim& anim)
+{
+    glUseProgram(textureShader.program);
+    glUniform2f(textureShader.pos, pos.x, pos.y);
+    glUniform2f(textureShader.size, size.x, size.y);
+    glUniform1f(textureShader.rotation, rot);
+    glUniform4f(textureShader.color, tint[0], tint[1], tint[2], tint[3]);
+    setAnimationUniforms(textureShader, anim);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    recordGLCall("glDrawArrays texture", tex);
+    countDrawCalls();
+}
+
+void drawRope(const Rope& rope, float width, const std::array<float, 4>& color)
+{
+    const int n = rope.segments;
+    if (n <= 0) return;
+    // Two vertices per point, offset either side along the normal of the
+    // chord through its neighbours.
+    ropeVertices.resize(std::size_t(n + 1) * 4);
+    const float half = width * 0.5f;
+    for (int i = 0; i <= n; ++i) {
+        const int a = i > 0 ? i - 1 : 0;
+        const int b = i < n ? i + 1 : n;
+        float tx = rope.x[b] - rope.x[a];
+        float ty = rope.y[b] - rope.y[a];
+        const float len = std::sqrt(tx * tx + ty * ty);
+        if (len > 1e-6f) {
+            tx /= len;
+            ty /= len;
+        }
+        else {
+            tx = 0.0f;
+            ty = -1.0f;
+        }
+        float* v = &ropeVertices[std::size_t(i) * 4];
+        v[0] = rope.x[i] - ty * half;
+        v[1] = rope.y[i] + tx * half;
+        v[2] = rope.x[i] + ty * half;
+        v[3] = rope.y[i] - tx * half;
+    }
+
+    glUseProgram(colorShader.program);
+    glUniform2f(colorShader.pos, 0.0f, 0.0f);
+    glUniform2f(colorShader.size, 1.0f, 1.0f);
+    glUniform1f(colorShader.rotation, 0.0f);
+    glUniform4f(colorShader.color, color[0], color[1], color[2], color[3]);
+    setAnimationUniforms(colorShader, SpriteAnim{});
+    glBindVertexArray(ropeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, ropeVBO);
+    // Orphan so the driver does not stall on last frame's draw.
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(ropeVertices.size() * sizeof(float)), ropeVertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, (n + 1) * 2);
+    recordGLCall("glDrawArrays rope", n);
+    glBindVertexArray(0);
+    countDrawCalls();
+}
+
+void drawPlush(unsigned int tex, const float* xs, const float* ys, const std::array<float, 4>& tint)
+{
+    for (int i = 0; i < kPlushPoints; ++i) {
+        float* v = &plushVertices[i * 4];
+        v[0] = xs[i];
+        v[1] = ys[i];
+        v[2] = float(i % kPlushGrid) / float(kPlushGrid - 1);
+        v[3] = float(i / kPlushGrid) / float(kPlushGrid - 1);
+    }
+    glUseProgram(textureShader.program);
+    glUniform2f(textureShader.pos, 0.0f, 0.0f);
+    glUniform2f(textureShader.size, 1.0f, 1.0f);
+    glUniform1f(textureShader.rotation, 0.0f);
+    glUniform4f(textureShader.color, tint[0], tint[1], tint[2], tint[3]);
+    setAnimationUniforms(textureShader, SpriteAnim{});
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glBindVertexArray(plushVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, plushVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(plushVertices), plushVertices);
+    glDrawElements(GL_TRIANGLES, plushIndexCount, GL_UNSIGNED_SHORT, nullptr);
+    recordGLCall("glDrawElements plush", tex);
+    glBindVertexArray(0);
+    countDrawCalls();
+}
+
+void renderSystem(Registry& reg, double time, const PlushSolver* plush)
+{
+    animTime = animationClock(time);
+    reg.sortSprites();
+    for (std::size_t i = 0; i < reg.sprites.size(); ++i) {
+        const Sprite& s = reg.sprites.at(i);
+        if (!s.visible) continue;
+        const Entity e = reg.sprites.entityAt(i);
+        const Transform* t = reg.transforms.get(e);
+        if (!t) continue;
+        const int body = plush && s.texture != 0 ? plush->find(e) : -1;
+        if (body >= 0) drawPlush(s.texture, plush->xs(body), plush->ys(body), s.color);
+        else if (s.texture != 0) drawQuadTexture(s.texture, t->pos, t->size, t->rotation, s.color, s.anim);
+        else drawQuadColor(t->pos, t->size, t->rotation, s.color, s.anim);
+    }
+}
+
+void renderEmissive(Registry& reg, double time)
+{
+    animTime = animationClock(time);
+    reg.sortSprites();
+    for (std::size_t i = 0; i < reg.sprites.size(); ++i) {
+        const Sprite& s = reg.sprites.at(i);
+        if (!s.visible || s.emissive <= 0.0f) continue;
+        const Transform* t = reg.transforms.get(reg.sprites.entityAt(i));
+        if (!t) continue;
+        std::array<float, 4> color = s.color;
+        SpriteAnim anim = s.anim;
+        for (int c = 0; c < 3; ++c) {
+            color[c] *= s.emissive;
+            anim.to[c] *= s.emissive;
+        }
+        if (s.texture != 0) drawQuadTexture(s.texture, t->pos, t->size, t->rotation, color, anim);
+        else drawQuadColor(t->pos, t->size, t->rotation, color, anim);
+    }
+}
@@ -0,0 +1,149 @@
+#include "../Header/Rewind.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+// Generous next to the ~10 bytes a typical delta takes; keyframes are ~130.
+constexpr std::size_t kArenaBytesPerTick = 32;
+}
+
+void RewindBuffer::init(float seconds, float tickRate)
+{
+    std::size_t ticks = static_cast<std::size_t>(std::ceil(seconds * tickRate));
+    entries.assign(std::max<std::size_t>(ticks, kKeyframeInterval * 2), Entry{});
+    arena.assign(entries.size() * kArenaBytesPerTick, 0);
+    clear();
+}
+
+void RewindBuffer::clear()
+{
+    first = 0;
+    count = 0;
+    writePos = 0;
+    bytesUsed = 0;
+    sinceKeyframe = 0;
+    havePrevious = false;
+    totalRecordUs = 0.0;
+    maxRecordUs = 0.0;
+    recordCount = 0;
+}
+
+void RewindBuffer::evictOldestGroup()
+{
+    do {
+        bytesUsed -= entry(0).length;
+        first = (first + 1) % entries.size();
+        count--;
+    } while (count > 0 && !entry(0).keyframe);
+}
+
+// Finds room for a contiguous record after the newest one, wrapping to the
+// start of the arena when the tail is too short, and evicts whatever is in
+// the way. The oldest record is always the next one ahead of the write head.
+bool RewindBuffer::reserve(std::size_t length, uint32_t& offset)
+{
+    if (length > arena.size()) return false;
+    bool wrap = writePos + length > arena.size();
+    std::size_t span = wrap ? arena.size() - writePos + length : length;
+    while (count > 0) {
+        std::size_t ahead = (entry(0).offset + arena.size() - writePos) % arena.size();
+        if (ahead >= span) break;
+        evictOldestGroup();
+    }
+    offset = static_cast<uint32_t>(wrap ? 0 : writePos);
+    writePos = offset + length;
+    return true;
+}
+
+void RewindBuffer::record(const Machine& m, uint32_t tick, double time)
+{
+    if (entries.empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    MachineSnapshot snap;
+    captureSnapshot(m, tick, snap);
+    bool keyframe = !havePrevious || count == 0 || sinceKeyframe + 1 >= kKeyframeInterval;
+    if (keyframe) encodeKeyframe(snap, scratch);
+    else encodeDelta(previous, snap, scratch);
+
+    if (count == entries.size()) evictOldestGroup();
+    uint32_t offset = 0;
+    if (!reserve(scratch.size(), offset)) return;
+    // A delta needs its keyframe; if eviction took it, start a new group.
+    if (!keyframe && count == 0) {
+        keyframe = true;
+        encodeKeyframe(snap, scratch);
+        if (!reserve(scratch.size(), offset)) return;
+    }
+    if (!scratch.empty()) std::memcpy(arena.data() + offset, scratch.data(), scratch.size());
+
+    Entry& e = entries[(first + count) % entries.size()];
+    e.tick = tick;
+    e.time = time;
+    e.offset = offset;
+    e.length = static_cast<uint16_t>(scratch.size());
+    e.keyframe = keyframe ? 1 : 0;
+    count++;
+    bytesUsed += scratch.size();
+    sinceKeyframe = keyframe ? 0 : sinceKeyframe + 1;
+    previous = snap;
+    havePrevious = true;
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    totalRecordUs += us;
+    maxRecordUs = std::max(maxRecordUs, us);
+    recordCount++;
+}
+
+bool RewindBuffer::stateAt(std::size_t index, MachineSnapshot& out) const
+{
+    if (index >= count) return false;
+    std::size_t k = index;
+    while (k > 0 && !entry(k).keyframe) --k;
+    const Entry& key = entry(k);
+    if (!key.keyframe || !decodeKeyframe(arena.data() + key.offset, key.length, out)) return false;
+    MachineSnapshot next;
+    for (std::size_t i = k + 1; i <= index; ++i) {
+        const Entry& e = entry(i);
+        if (!decodeDelta(out, arena.data() + e.offset, e.length, next)) return false;
+        out = next;
+    }
+    return true;
+}
+
+double RewindBuffer::timeAt(std::size_t index) const
+{
+    return index < count ? entry(index).time : 0.0;
+}
+
+void RewindBuffer::truncateAfter(std::size_t index)
+{
+    if (index + 1 >= count) return;
+    MachineSnapshot snap;
+    if (!stateAt(index, snap)) return;
+    while (count > index + 1) {
+        bytesUsed -= entry(count - 1).length;
+        count--;
+    }
+    const Entry& last = entry(count - 1);
+    writePos = last.offset + last.length;
+    sinceKeyframe = 0;
+    for (std::size_t k = count - 1; k > 0 && !entry(k).keyframe; --k) sinceKeyframe++;
+    previous = snap;
+    havePrevious = true;
+}
+
+RewindStats RewindBuffer::stats() const
+{
+    RewindStats s;
+    s.memoryBytes = arena.size() + entries.size() * sizeof(Entry);
+    s.bytesUsed = bytesUsed;
+    s.ticks = count;
+    s.secondsCovered = count > 1 ? entry(count - 1).time - entry(0).time : 0.0;
+    s.avgRecordUs = recordCount ? totalRecordUs / recordCount : 0.0;
+    s.maxRecordUs = maxRecordUs;
+    return s;
+}
@@ -0,0 +1,214 @@
+#include "../Header/Rope.h"
+#include "../Header/Fixed.h"
+
+#include <algorithm>
+#include <cmath>
+
+void initRope(Rope& r, int segments)
+{
+    r.segments = std::max(segments, 0);
+    const std::size_t points = r.segments > 0 ? std::size_t(r.segments) + 1 : 0;
+    r.x.assign(points, 0.0f);
+    r.y.assign(points, 0.0f);
+    r.px.assign(points, 0.0f);
+    r.py.assign(points, 0.0f);
+    r.w.assign(points, 1.0f);
+    if (points > 0) r.w.front() = r.w.back() = 0.0f;
+}
+
+void resetRope(Rope& r, const Vec2& top, const Vec2& bottom)
+{
+    const int n = r.segments;
+    for (int i = 0; i <= n && n > 0; ++i) {
+        const float t = float(i) / float(n);
+        r.x[i] = r.px[i] = top.x + (bottom.x - top.x) * t;
+        r.y[i] = r.py[i] = top.y + (bottom.y - top.y) * t;
+    }
+}
+
+// Ends held further apart than length, as a tilted claw does for an instant,
+// stretch every segment evenly rather than fight the pins.
+static float restLength(const Rope& r, float length)
+{
+    const int n = r.segments;
+    const float span = std::hypot(r.x[n] - r.x[0], r.y[n] - r.y[0]);
+    return std::max(length, span) / float(n);
+}
+
+// Segments first, first + 2, ... towards their rest length, split by inverse
+// mass. With both ends pinned w[k] + w[k + 1] is 0 only for a single-segment
+// rope, where the max() keeps the division finite and w zeroes the result.
+static void solveBatch(Rope& r, int first, float rest)
+{
+    float* x = r.x.data();
+    float* y = r.y.data();
+    const float* w = r.w.data();
+    const int n = r.segments;
+    for (int k = first; k < n; k += 2) {
+        const float dx = x[k + 1] - x[k];
+        const float dy = y[k + 1] - y[k];
+        const float d = std::sqrt(dx * dx + dy * dy);
+        const float s = (d - rest) / std::max(d * (w[k] + w[k + 1]), 1e-9f);
+        x[k] += w[k] * s * dx;
+        y[k] += w[k] * s * dy;
+        x[k + 1] -= w[k + 1] * s * dx;
+        y[k + 1] -= w[k + 1] * s * dy;
+    }
+}
+
+// Long range tethers: point i may be no further than i segments from the
+// top and n - i from the bottom. Every point is clamped on its own, so
+// stretch no longer has to creep down the chain one segment per sweep,
+// which is what lets long ropes stay taut.
+static void solveTethers(Rope& r, const Vec2& top, const Vec2& bottom, float rest)
+{
+    float* x = r.x.data();
+    float* y = r.y.data();
+    const int n = r.segments;
+    for (int i = 1; i < n; ++i) {
+        float dx = x[i] - top.x;
+        float dy = y[i] - top.y;
+        float d = std::sqrt(dx * dx + dy * dy);
+        float s = std::max(d - rest * float(i), 0.0f) / std::max(d, 1e-9f);
+        x[i] -= dx * s;
+        y[i] -= dy * s;
+        dx = x[i] - bottom.x;
+        dy = y[i] - bottom.y;
+        d = std::sqrt(dx * dx + dy * dy);
+        s = std::max(d - rest * float(n - i), 0.0f) / std::max(d, 1e-9f);
+        x[i] -= dx * s;
+        y[i] -= dy * s;
+    }
+}
+
+void stepRope(Rope& r, const Vec2& top, const Vec2& bottom, float length, float gravity, float dt)
+{
+    const int n = r.segments;
+    if (n <= 0) return;
+    float* x = r.x.data();
+    float* y = r.y.data();
+    float* px = r.px.data();
+    float* py = r.py.data();
+    x[0] = px[0] = top.x;
+    y[0] = py[0] = top.y;
+    x[n] = px[n] = bottom.x;
+    y[n] = py[n] = bottom.y;
+
+    const float keep = std::max(1.0f - r.damping * dt, 0.0f);
+    const float fall = gravity * dt * dt;
+    for (int i = 1; i < n; ++i) {
+        const float vx = (x[i] - px[i]) * keep;
+        const float vy = (y[i] - py[i]) * keep;
+        px[i] = x[i];
+        py[i] = y[i];
+        x[i] += vx;
+        y[i] += vy + fall;
+    }
+
+    const float rest = restLength(r, length);
+    for (int it = 0; it < r.iterations; ++it) {
+        solveTethers(r, top, bottom, rest);
+        solveBatch(r, 0, rest);
+        solveBatch(r, 1, rest);
+    }
+}
+
+// ---------------------- Fixed-point path ---------------------- //
+// The same steps as above. Corrections are taken as one a * b / c each, so
+// a short segment keeps the bits a separate scale factor would round away.
+
+static Fixed restLengthFixed(const Rope& r, Fixed length)
+{
+    const int n = r.segments;
+    const Fixed span = fixedLength(FixedVec2{ fixedFromFloat(r.x[n]) - fixedFromFloat(r.x[0]), fixedFromFloat(r.y[n]) - fixedFromFloat(r.y[0]) });
+    return fixedDiv(fixedMax(length, span), fixedInt(n));
+}
+
+static void solveBatchFixed(Rope& r, int first, Fixed rest)
+{
+    const int n = r.segments;
+    for (int k = first; k < n; k += 2) {
+        const Fixed x0 = fixedFromFloat(r.x[k]), y0 = fixedFromFloat(r.y[k]);
+        const Fixed x1 = fixedFromFloat(r.x[k + 1]), y1 = fixedFromFloat(r.y[k + 1]);
+        const Fixed w0 = fixedFromFloat(r.w[k]), w1 = fixedFromFloat(r.w[k + 1]);
+        const FixedVec2 delta{ x1 - x0, y1 - y0 };
+        const Fixed d = fixedLength(delta);
+        const Fixed denom = fixedMax(d * (w0 + w1), fixedRaw(1));
+        const Fixed cx = fixedMulDiv(d - rest, delta.x, denom);
+        const Fixed cy = fixedMulDiv(d - rest, delta.y, denom);
+        r.x[k] = fixedToFloat(x0 + w0 * cx);
+        r.y[k] = fixedToFloat(y0 + w0 * cy);
+        r.x[k + 1] = fixedToFloat(x1 - w1 * cx);
+        r.y[k + 1] = fixedToFloat(y1 - w1 * cy);
+    }
+}
+
+// Pulls p back to within reach of from; no change when it already is.
+static void tetherFixed(FixedVec2& p, const FixedVec2& from, Fixed reach)
+{
+    const FixedVec2 delta = p - from;
+    const Fixed d = fixedLength(delta);
+    const Fixed excess = fixedMax(d - reach, Fixed{});
+    const Fixed safe = fixedMax(d, fixedRaw(1));
+    p.x = p.x - fixedMulDiv(delta.x, excess, safe);
+    p.y = p.y - fixedMulDiv(delta.y, excess, safe);
+}
+
+static void solveTethersFixed(Rope& r, const FixedVec2& top, const FixedVec2& bottom, Fixed rest)
+{
+    const int n = r.segments;
+    for (int i = 1; i < n; ++i) {
+        FixedVec2 p{ fixedFromFloat(r.x[i]), fixedFromFloat(r.y[i]) };
+        tetherFixed(p, top, rest * fixedInt(i));
+        tetherFixed(p, bottom, rest * fixedInt(n - i));
+        r.x[i] = fixedToFloat(p.x);
+        r.y[i] = fixedToFloat(p.y);
+    }
+}
+
+void stepRopeFixed(Rope& r, const Vec2& top, const Vec2& bottom, float length, float gravity, float dt)
+{
+    const int n = r.segments;
+    if (n <= 0) return;
+    const FixedVec2 fixedTop = fixedFromVec2(top);
+    const FixedVec2 fixedBottom = fixedFromVec2(bottom);
+    r.x[0] = r.px[0] = fixedToFloat(fixedTop.x);
+    r.y[0] = r.py[0] = fixedToFloat(fixedTop.y);
+    r.x[n] = r.px[n] = fixedToFloat(fixedBottom.x);
+    r.y[n] = r.py[n] = fixedToFloat(fixedBottom.y);
+
+    const Fixed step = fixedFromFloat(dt);
+    const Fixed keep = fixedMax(fixedInt(1) - fixedFromFloat(r.damping) * step, Fixed{});
+    // Gravity times dt, then times dt again, as the claw's swing does.
+    const Fixed fall = fixedFromFloat(gravity) * step * step;
+    for (int i = 1; i < n; ++i) {
+        const Fixed x = fixedFromFloat(r.x[i]), y = fixedFromFloat(r.y[i]);
+        const Fixed vx = (x - fixedFromFloat(r.px[i])) * keep;
+        const Fixed vy = (y - fixedFromFloat(r.py[i])) * keep;
+        r.px[i] = fixedToFloat(x);
+        r.py[i] = fixedToFloat(y);
+        r.x[i] = fixedToFloat(x + vx);
+        r.y[i] = fixedToFloat(y + vy + fall);
+    }
+
+    const Fixed rest = restLengthFixed(r, fixedFromFloat(length));
+    for (int it = 0; it < r.iterations; ++it) {
+        solveTethersFixed(r, fixedTop, fixedBottom, rest);
+        solveBatchFixed(r, 0, rest);
+        solveBatchFixed(r, 1, rest);
+    }
+}
+
+float ropeStretch(const Rope& r, float length)
+{
+    const int n = r.segments;
+    if (n <= 0) return 0.0f;
+    const float rest = restLength(r, length);
+    if (rest <= 0.0f) return 0.0f;
+    float worst = 0.0f;
+    for (int k = 0; k < n; ++k) {
+        const float d = std::hypot(r.x[k + 1] - r.x[k], r.y[k + 1] - r.y[k]);
+        worst = std::max(worst, std::abs(d - rest) / rest);
+    }
+    return worst;
+}
@@ -0,0 +1,243 @@
+#include "../Header/Scheduler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "../Header/PerfCounters.h"
+
+namespace {
+thread_local const WorkStealingPool* tlsPool = nullptr;
+thread_local unsigned tlsWorker = 0;
+
+double msSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point now)
+{
+    return std::chrono::duration<double, std::milli>(now - start).count();
+}
+}
+
+// ---------------------- WorkStealingPool ---------------------- //
+WorkStealingPool::WorkStealingPool(unsigned workerCount)
+{
+    for (unsigned i = 0; i <= workerCount; ++i) queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < workerCount; ++i) threads.emplace_back([this, i] { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    unsigned q = (tlsPool == this) ? tlsWorker : static_cast<unsigned>(queues.size() - 1);
+    {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        queues[q]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // Taking the sleep lock orders this against a worker that is about to wait.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::popOrSteal(unsigned self, std::function<void()>& out)
+{
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (std::size_t k = 1; k < queues.size(); ++k) {
+        Queue& victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::runOne()
+{
+    unsigned self = (tlsPool == this) ? tlsWorker : static_cast<unsigned>(queues.size() - 1);
+    std::function<void()> task;
+    if (!popOrSteal(self, task)) return false;
+    queued.fetch_sub(1);
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(unsigned index)
+{
+    tlsPool = this;
+    tlsWorker = index;
+    std::function<void()> task;
+    while (true) {
+        if (popOrSteal(index, task)) {
+            queued.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, std::size_t chunk, const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if (count == 0) return;
+    chunk = std::max<std::size_t>(chunk, 1);
+    std::size_t chunks = (count + chunk - 1) / chunk;
+    if (chunks == 1 || threads.empty()) {
+        body(0, count);
+        return;
+    }
+    std::atomic<std::size_t> done{ 0 };
+    for (std::size_t c = 1; c < chunks; ++c) {
+        std::size_t begin = c * chunk;
+        std::size_t end = std::min(count, begin + chunk);
+        submit([&body, &done, begin, end] { body(begin, end); done.fetch_add(1); });
+    }
+    body(0, std::min(count, chunk));
+    done.fetch_add(1);
+    while (done.load() < chunks) {
+        if (!runOne()) std::this_thread::yield();
+    }
+}
+
+// ---------------------- Scheduler ---------------------- //
+Scheduler::Scheduler(unsigned workerCount)
+    : pool(workerCount)
+{
+}
+
+void Scheduler::add(const std::string& name, AccessMask reads, AccessMask writes, std::function<void(float)> run)
+{
+    systems.push_back({ name, reads, writes, std::move(run), perfRegion(("system " + name).c_str()) });
+    SystemStats s;
+    s.name = name;
+    systemStats.push_back(s);
+    graphBuilt = false;
+}
+
+void Scheduler::buildGraph()
+{
+    std::size_t n = systems.size();
+    successors.assign(n, {});
+    predecessorCount.assign(n, 0);
+    for (std::size_t j = 0; j < n; ++j) {
+        for (std::size_t i = 0; i < j; ++i) {
+            const System& a = systems[i];
+            const System& b = systems[j];
+            bool conflict = (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+            if (conflict) {
+                successors[i].push_back(j);
+                predecessorCount[j]++;
+            }
+        }
+    }
+    tasks.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        tasks.push_back([this, i] {
+            runSystem(i);
+            for (std::size_t s : successors[i]) {
+                if (pendingPredecessors[s].fetch_sub(1) == 1) launch(s);
+            }
+            remaining.fetch_sub(1);
+        });
+    }
+    pendingPredecessors = std::make_unique<std::atomic<int>[]>(n);
+    startMs.assign(n, 0.0);
+    durationMs.assign(n, 0.0);
+    longestMs.assign(n, 0.0);
+    graphBuilt = true;
+}
+
+void Scheduler::runSystem(std::size_t index)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        PerfScope scope(systems[index].perfRegion);
+        systems[index].run(tickDt);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    startMs[index] = msSince(tickStart, t0);
+    durationMs[index] = msSince(t0, t1);
+}
+
+void Scheduler::launch(std::size_t index)
+{
+    pool.submit(tasks[index]);
+}
+
+void Scheduler::runParallel()
+{
+    std::size_t n = systems.size();
+    remaining = static_cast<int>(n);
+    for (std::size_t i = 0; i < n; ++i) pendingPredecessors[i] = static_cast<int>(predecessorCount[i]);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (predecessorCount[i] == 0) launch(i);
+    }
+    while (remaining.load() > 0) {
+        if (!pool.runOne()) std::this_thread::yield();
+    }
+}
+
+void Scheduler::tick(float dt)
+{
+    tickStart = std::chrono::steady_clock::now();
+    tickDt = dt;
+    if (!graphBuilt) buildGraph();
+    if (deterministic || pool.workerCount() == 0) {
+        for (std::size_t i = 0; i < systems.size(); ++i) runSystem(i);
+    }
+    else {
+        runParallel();
+    }
+    tickMs = msSince(tickStart, std::chrono::steady_clock::now());
+
+    // Registration order is a topological order, so one forward pass finds
+    // the heaviest chain.
+    std::copy(durationMs.begin(), durationMs.end(), longestMs.begin());
+    criticalMs = 0.0;
+    for (std::size_t i = 0; i < systems.size(); ++i) {
+        for (std::size_t s : successors[i]) longestMs[s] = std::max(longestMs[s], longestMs[i] + durationMs[s]);
+        criticalMs = std::max(criticalMs, longestMs[i]);
+    }
+
+    for (std::size_t i = 0; i < systems.size(); ++i) {
+        SystemStats& st = systemStats[i];
+        st.lastMs = durationMs[i];
+        st.avgMs = (tickCount == 0) ? durationMs[i] : st.avgMs * 0.95 + durationMs[i] * 0.05;
+        st.maxMs = std::max(st.maxMs, durationMs[i]);
+    }
+    tickCount++;
+}
+
+void Scheduler::report(std::ostream& out) const
+{
+    out << "[SCHED] mode=" << (deterministic ? "deterministic" : "parallel")
+        << " workers=" << pool.workerCount() << " ticks=" << tickCount << "\n";
+    out << std::fixed << std::setprecision(4);
+    out << "  " << std::left << std::setw(18) << "system" << std::right
+        << std::setw(10) << "last ms" << std::setw(10) << "avg ms" << std::setw(10) << "max ms" << "\n";
+    for (const auto& s : systemStats) {
+        out << "  " << std::left << std::setw(18) << s.name << std::right
+            << std::setw(10) << s.lastMs << std::setw(10) << s.avgMs << std::setw(10) << s.maxMs << "\n";
+    }
+    out << "  tick=" << tickMs << " ms, critical path=" << criticalMs << " ms" << std::endl;
+    out.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,64 @@
+#include "../Header/Session.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+uint8_t packSessionKeys(const InputState& input)
+{
+    return uint8_t((input.left ? SessionLeft : 0) | (input.right ? SessionRight : 0) |
+        (input.down ? SessionDown : 0) | (input.up ? SessionUp : 0));
+}
+
+InputState unpackSessionKeys(uint8_t keys)
+{
+    InputState input;
+    input.left = (keys & SessionLeft) != 0;
+    input.right = (keys & SessionRight) != 0;
+    input.down = (keys & SessionDown) != 0;
+    input.up = (keys & SessionUp) != 0;
+    return input;
+}
+
+void truncateSession(Session& s, uint32_t tick)
+{
+    if (s.ticks.size() > tick) s.ticks.resize(tick);
+    s.clicks.erase(std::remove_if(s.clicks.begin(), s.clicks.end(), [tick](const SessionClick& c) { return c.tick >= tick; }),
+        s.clicks.end());
+}
+
+bool saveSession(const std::string& path, const Session& s)
+{
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cout << "[SESSION] could not write " << path << std::endl;
+        return false;
+    }
+    SessionFileHeader h{ kSessionMagic, kSessionVersion, uint32_t(s.ticks.size()), uint32_t(s.clicks.size()) };
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1
+        && std::fwrite(s.ticks.data(), sizeof(SessionTick), s.ticks.size(), f) == s.ticks.size()
+        && std::fwrite(s.clicks.data(), sizeof(SessionClick), s.clicks.size(), f) == s.clicks.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) std::cout << "[SESSION] write to " << path << " failed" << std::endl;
+    return ok;
+}
+
+bool loadSession(const std::string& path, Session& s)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cout << "[SESSION] cannot read " << path << std::endl;
+        return false;
+    }
+    SessionFileHeader h{};
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 && h.magic == kSessionMagic && h.version == kSessionVersion;
+    if (ok) {
+        s.ticks.resize(h.ticks);
+        s.clicks.resize(h.clicks);
+        ok = std::fread(s.ticks.data(), sizeof(SessionTick), s.ticks.size(), f) == s.ticks.size()
+            && std::fread(s.clicks.data(), sizeof(SessionClick), s.clicks.size(), f) == s.clicks.size();
+    }
+    std::fclose(f);
+    if (!ok) std::cout << "[SESSION] " << path << " is not a complete session file" << std::endl;
+    return ok;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+in vec2 vUV;
+out vec4 FragColor;
+
+uniform sampler2D uTex;
+uniform vec2 uStep;     // One texel along the blur axis
+
+// 9-tap Gaussian in 5 fetches: each off-centre fetch lands between two
+// texels so bilinear filtering weighs them both.
+const float kOffsets[3] = float[](0.0, 1.3846153846, 3.2307692308);
+const float kWeights[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main()
+{
+    vec4 sum = texture(uTex, vUV) * kWeights[0];
+    for (int i = 1; i < 3; ++i) {
+        sum += texture(uTex, vUV + uStep * kOffsets[i]) * kWeights[i];
+        sum += texture(uTex, vUV - uStep * kOffsets[i]) * kWeights[i];
+    }
+    FragColor = sum;
+}
@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 vUV;
+out vec4 FragColor;
+
+uniform sampler2D uTex;
+uniform float uStrength;
+
+void main()
+{
+    FragColor = vec4(texture(uTex, vUV).rgb * uStrength, 0.0);
+}
@@ -1,7 +1,19 @@
 #version 330 core
 out vec4 FragColor;
 uniform vec4 uColor;
+uniform vec4 uAnim;     // Curve (0 none, 1 pulse, 2 blink), start, period, amplitude
+uniform vec4 uAnimTo;
+uniform float uTime;    // Seconds since the animation epoch
+
+vec4 animate(vec4 color)
+{
+    float t = max(uTime - uAnim.y, 0.0);
+    if (uAnim.x == 1.0) color.a += uAnim.w * sin(6.2831853 * t / uAnim.z);
+    else if (uAnim.x == 2.0 && fract(t / uAnim.z) >= 0.5) color = uAnimTo;
+    return color;
+}
+
 void main()
 {
-    FragColor = uColor;
+    FragColor = animate(uColor);
 }
@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 2) in vec4 iPosVel;   // x, y, vx, vy
+layout (location = 3) in vec4 iLife;     // age, lifetime, gravity, drag
+layout (location = 4) in vec4 iColor;
+layout (location = 5) in vec2 iSizeSpin;
+
+out vec4 vColor;
+
+void main()
+{
+    if (iLife.x >= iLife.y) {
+        // Dead: outside the clip volume, so nothing is rasterized.
+        vColor = vec4(0.0);
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    float t = iLife.x / iLife.y;
+    float a = iSizeSpin.y * iLife.x;
+    float c = cos(a);
+    float s = sin(a);
+    mat2 rot = mat2(c, -s, s, c);
+    // Spinning pieces are confetti strips; the rest are square sparks.
+    vec2 extent = iSizeSpin.x * (iSizeSpin.y != 0.0 ? vec2(1.0, 0.5) : vec2(1.0));
+    vColor = vec4(iColor.rgb, iColor.a * (1.0 - t * t));
+    gl_Position = vec4(rot * (aPos * extent) + iPosVel.xy, 0.0, 1.0);
+}
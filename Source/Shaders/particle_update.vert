@@ -0,0 +1,22 @@
+#version 330 core
+layout (location = 0) in vec4 aPosVel;   // x, y, vx, vy
+layout (location = 1) in vec4 aLife;     // age, lifetime, gravity, drag
+
+out vec4 vPosVel;
+out vec4 vLife;
+
+uniform float uDt;
+
+void main()
+{
+    vec4 p = aPosVel;
+    vec4 l = aLife;
+    if (l.x < l.y) {
+        p.w -= l.z * uDt;
+        p.zw *= max(1.0 - l.w * uDt, 0.0);
+        p.xy += p.zw * uDt;
+        l.x += uDt;
+    }
+    vPosVel = p;
+    vLife = l;
+}
@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 vUV;
+in vec4 vTint;
+out vec4 FragColor;
+
+uniform sampler2D uTex;
+
+void main()
+{
+    FragColor = texture(uTex, vUV) * vTint;
+}
@@ -0,0 +1,36 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aUV;
+layout (location = 2) in vec4 iPosSize;
+layout (location = 3) in vec4 iUVRect;
+layout (location = 4) in vec4 iColor;
+layout (location = 5) in float iRotation;
+layout (location = 6) in vec4 iAnim;     // Curve (0 none, 1 pulse, 2 blink), start, period, amplitude
+layout (location = 7) in vec4 iAnimTo;
+
+out vec2 vUV;
+out vec4 vTint;
+
+uniform vec2 uViewCenter;
+uniform vec2 uViewScale;
+uniform float uTime;    // Seconds since the animation epoch
+
+vec4 animate(vec4 color)
+{
+    float t = max(uTime - iAnim.y, 0.0);
+    if (iAnim.x == 1.0) color.a += iAnim.w * sin(6.2831853 * t / iAnim.z);
+    else if (iAnim.x == 2.0 && fract(t / iAnim.z) >= 0.5) color = iAnimTo;
+    return color;
+}
+
+void main()
+{
+    float c = cos(iRotation);
+    float s = sin(iRotation);
+    mat2 rot = mat2(c, -s, s, c);
+    vec2 scaled = aPos * iPosSize.zw;
+    vec2 world = rot * scaled + iPosSize.xy;
+    vUV = mix(iUVRect.xy, iUVRect.zw, aUV);
+    vTint = animate(iColor);
+    gl_Position = vec4((world - uViewCenter) * uViewScale, 0.0, 1.0);
+}
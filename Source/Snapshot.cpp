@@ -0,0 +1,263 @@
+#include "../Header/Snapshot.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr std::size_t kSnapshotBytes = sizeof(MachineSnapshot);
+
+const uint8_t* bytesOf(const MachineSnapshot& s) { return reinterpret_cast<const uint8_t*>(&s); }
+uint8_t* bytesOf(MachineSnapshot& s) { return reinterpret_cast<uint8_t*>(&s); }
+
+const MachineSnapshot& zeroSnapshot()
+{
+    static const MachineSnapshot zero{};
+    return zero;
+}
+
+bool validHeader(const MachineSnapshot& s)
+{
+    return s.magic == kSnapshotMagic && s.version == kSnapshotVersion && s.size == kSnapshotBytes && s.toyCount <= kSnapshotMaxToys;
+}
+
+// Enum fields that would be cast straight into the machine. A snapshot off the
+// spectator stream or a corrupt rewind entry can hold anything.
+bool validFields(const MachineSnapshot& s)
+{
+    if (s.gameState > static_cast<uint8_t>(GameState::PrizeWaiting)) return false;
+    if (s.lampMode > static_cast<uint8_t>(LampMode::Blink)) return false;
+    for (int i = 0; i < s.toyCount; ++i) {
+        if (s.toys[i].state > static_cast<uint8_t>(ToyState::InPrize)) return false;
+        if (s.toys[i].layer >= kLayerCount) return false;
+    }
+    return true;
+}
+
+void putVarint(std::vector<uint8_t>& out, std::size_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, std::size_t& v)
+{
+    v = 0;
+    for (int shift = 0; p < end && shift < 28; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<std::size_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint8_t toyIndex(Entity e, const std::array<Entity, kSnapshotMaxToys>& toys, int count)
+{
+    if (e.isNull()) return kSnapshotNoToy;
+    for (int i = 0; i < count; ++i) {
+        if (toys[i] == e) return static_cast<uint8_t>(i);
+    }
+    return kSnapshotNoToy;
+}
+}
+
+void captureSnapshot(const Machine& m, uint32_t tick, MachineSnapshot& out)
+{
+    std::memset(&out, 0, sizeof(out));
+    out.magic = kSnapshotMagic;
+    out.version = kSnapshotVersion;
+    out.size = static_cast<uint16_t>(kSnapshotBytes);
+    out.tick = tick;
+    out.rngSeed = m.rng.initialSeed();
+    out.rngDraws = m.rng.draws();
+    out.gameState = static_cast<uint8_t>(m.gameState);
+    out.lampMode = static_cast<uint8_t>(m.lamp.mode);
+    out.flags = (m.claw.open ? SnapClawOpen : 0) | (m.claw.movingDown ? SnapClawMovingDown : 0) |
+        (m.claw.movingUp ? SnapClawMovingUp : 0) | (m.prize.hasToy ? SnapPrizeHasToy : 0) |
+        (m.sWasDown ? SnapSWasDown : 0) | (m.pendingPrizeClick ? SnapPendingPrizeClick : 0) |
+        (lampBlinkOn(m) ? SnapLampBlinkOn : 0);
+    out.nextSpawnSlot = static_cast<uint8_t>(m.nextSpawnSlot);
+    // Ages only while animating, so idle states stay byte-identical tick to tick.
+    out.lampTimer = m.lamp.mode == LampMode::Blink ? float(std::fmod(m.clock - m.lamp.blinkStart, double(m.lamp.interval) * 2.0)) : 0.0f;
+    out.clawX = m.claw.anchor.x;
+    out.clawY = m.claw.anchor.y;
+    out.ropeLength = m.claw.ropeLength;
+    out.prizePulseTime = m.prize.hasToy ? float(std::fmod(m.clock - m.prizePulseStart, double(kPrizePulsePeriod))) : 0.0f;
+    out.clawPosX = m.claw.pos.x;
+    out.clawPosY = m.claw.pos.y;
+    out.clawPrevX = m.claw.prevPos.x;
+    out.clawPrevY = m.claw.prevPos.y;
+
+    // Toys in draw order, so a restore recreates them with the same stacking.
+    const Registry& reg = m.registry;
+    std::array<Entity, kSnapshotMaxToys> toys;
+    std::array<uint32_t, kSnapshotMaxToys> order{};
+    int count = 0;
+    for (std::size_t i = 0; i < reg.gameplay.size() && count < kSnapshotMaxToys; ++i) {
+        if (reg.gameplay.at(i).kind != EntityKind::Toy) continue;
+        Entity e = reg.gameplay.entityAt(i);
+        const Sprite* s = reg.sprites.get(e);
+        uint32_t o = s ? s->order : 0;
+        int j = count++;
+        for (; j > 0 && order[j - 1] > o; --j) {
+            toys[j] = toys[j - 1];
+            order[j] = order[j - 1];
+        }
+        toys[j] = e;
+        order[j] = o;
+    }
+
+    out.toyCount = static_cast<uint8_t>(count);
+    for (int i = 0; i < count; ++i) {
+        SnapshotToy& st = out.toys[i];
+        if (const Transform* t = reg.transforms.get(toys[i])) {
+            st.x = t->pos.x;
+            st.y = t->pos.y;
+            st.w = t->size.x;
+            st.h = t->size.y;
+        }
+        if (const Body* b = reg.bodies.get(toys[i])) {
+            st.vx = b->velocity.x;
+            st.vy = b->velocity.y;
+            st.gravity = b->gravity;
+            st.simulate = b->simulate ? 1 : 0;
+        }
+        if (const Gameplay* g = reg.gameplay.get(toys[i])) st.state = static_cast<uint8_t>(g->toy);
+        if (const Sprite* s = reg.sprites.get(toys[i])) {
+            st.layer = static_cast<uint8_t>(s->layer);
+            st.textureSlot = s->texture == m.textures.toyB ? 1 : (s->texture == m.textures.toyC ? 2 : 0);
+        }
+    }
+    out.grabbedToy = toyIndex(m.grabbedToy, toys, count);
+    out.fallingToy = toyIndex(m.fallingToy, toys, count);
+    out.prizeToy = toyIndex(m.prize.toy, toys, count);
+}
+
+bool restoreSnapshot(Machine& m, const MachineSnapshot& s)
+{
+    if (!validHeader(s) || !validFields(s)) return false;
+
+    m.gameState = static_cast<GameState>(s.gameState);
+    m.lamp.mode = static_cast<LampMode>(s.lampMode);
+    // Animation times are stored as phases, so they restore onto any clock.
+    m.lamp.blinkStart = m.clock - s.lampTimer;
+    m.claw.anchor = { s.clawX, s.clawY };
+    m.claw.ropeLength = s.ropeLength;
+    m.claw.pos = { s.clawPosX, s.clawPosY };
+    m.claw.prevPos = { s.clawPrevX, s.clawPrevY };
+    m.claw.open = (s.flags & SnapClawOpen) != 0;
+    m.claw.movingDown = (s.flags & SnapClawMovingDown) != 0;
+    m.claw.movingUp = (s.flags & SnapClawMovingUp) != 0;
+    m.prize.hasToy = (s.flags & SnapPrizeHasToy) != 0;
+    m.sWasDown = (s.flags & SnapSWasDown) != 0;
+    m.pendingPrizeClick = (s.flags & SnapPendingPrizeClick) != 0;
+    m.prizePulseStart = m.clock - s.prizePulseTime;
+    m.nextSpawnSlot = s.nextSpawnSlot % static_cast<int>(spawnPositions.size());
+    m.rng.restore(s.rngSeed, s.rngDraws);
+
+    // Walk backwards: destroying swap-removes an already visited entry into slot i.
+    Registry& reg = m.registry;
+    for (std::size_t i = reg.gameplay.size(); i-- > 0;) {
+        if (reg.gameplay.at(i).kind == EntityKind::Toy) reg.destroy(reg.gameplay.entityAt(i));
+    }
+    m.grabbedToy = Entity{};
+    m.fallingToy = Entity{};
+    m.prize.toy = Entity{};
+
+    std::array<unsigned int, 3> textures = { m.textures.toyA, m.textures.toyB, m.textures.toyC };
+    for (int i = 0; i < s.toyCount; ++i) {
+        const SnapshotToy& st = s.toys[i];
+        Entity e = spawnToy(m, { st.x, st.y }, textures[st.textureSlot % textures.size()]);
+        if (e.isNull()) return false;
+        Transform& t = *reg.transforms.get(e);
+        t.pos = { st.x, st.y };
+        t.size = { st.w, st.h };
+        Body& b = *reg.bodies.get(e);
+        b.velocity = { st.vx, st.vy };
+        b.gravity = st.gravity;
+        b.simulate = st.simulate != 0;
+        reg.gameplay.get(e)->toy = static_cast<ToyState>(st.state);
+        reg.sprites.get(e)->layer = st.layer;
+        if (i == s.grabbedToy) m.grabbedToy = e;
+        if (i == s.fallingToy) m.fallingToy = e;
+        if (i == s.prizeToy) m.prize.toy = e;
+    }
+
+    // The drawn rope and soft bodies are not stored; they restart at rest.
+    setRopeSegments(m, m.rope.segments);
+    setPlushEnabled(m, m.plushEnabled);
+    clawPoseSystem(m);
+    machineSpriteSystem(m);
+    return true;
+}
+
+const MachineSnapshot* viewSnapshot(const void* data, std::size_t size)
+{
+    if (!data || size < kSnapshotBytes) return nullptr;
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(MachineSnapshot) != 0) return nullptr;
+    const MachineSnapshot* s = static_cast<const MachineSnapshot*>(data);
+    return validHeader(*s) ? s : nullptr;
+}
+
+void encodeDelta(const MachineSnapshot& base, const MachineSnapshot& current, std::vector<uint8_t>& out)
+{
+    out.clear();
+    const uint8_t* a = bytesOf(base);
+    const uint8_t* b = bytesOf(current);
+    std::size_t i = 0;
+    while (i < kSnapshotBytes) {
+        std::size_t zeroStart = i;
+        while (i < kSnapshotBytes && a[i] == b[i]) ++i;
+        if (i == kSnapshotBytes) break;  // Trailing zeroes are implied
+        std::size_t literalStart = i;
+        // A lone unchanged byte is cheaper inside the literal than a new group.
+        while (i < kSnapshotBytes && (a[i] != b[i] || (i + 1 < kSnapshotBytes && a[i + 1] != b[i + 1]))) ++i;
+        putVarint(out, literalStart - zeroStart);
+        putVarint(out, i - literalStart);
+        for (std::size_t k = literalStart; k < i; ++k) out.push_back(a[k] ^ b[k]);
+    }
+}
+
+bool decodeDelta(const MachineSnapshot& base, const uint8_t* data, std::size_t size, MachineSnapshot& out)
+{
+    std::memcpy(&out, &base, kSnapshotBytes);
+    uint8_t* o = bytesOf(out);
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    std::size_t pos = 0;
+    while (p < end) {
+        std::size_t zeros, length;
+        if (!getVarint(p, end, zeros) || !getVarint(p, end, length)) return false;
+        if (zeros > kSnapshotBytes - pos) return false;
+        pos += zeros;
+        if (length > kSnapshotBytes - pos || length > static_cast<std::size_t>(end - p)) return false;
+        for (std::size_t k = 0; k < length; ++k) o[pos + k] ^= p[k];
+        p += length;
+        pos += length;
+    }
+    return validHeader(out);
+}
+
+void encodeKeyframe(const MachineSnapshot& current, std::vector<uint8_t>& out)
+{
+    encodeDelta(zeroSnapshot(), current, out);
+}
+
+bool decodeKeyframe(const uint8_t* data, std::size_t size, MachineSnapshot& out)
+{
+    return decodeDelta(zeroSnapshot(), data, size, out);
+}
+
+uint64_t snapshotHash(const MachineSnapshot& s)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&s);
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < sizeof(s); ++i) {
+        h ^= bytes[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
@@ -0,0 +1,460 @@
+#include "../Header/Soak.h"
+#include "../Header/Hitch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// ---------------------- Bot ---------------------- //
+namespace {
+constexpr float kRandomPlaySeconds = 30.0f;   // A mixed bot's random play turns skilled after this
+
+float uniform(BotPlayer& b, float lo, float hi)
+{
+    return lo + philoxUnit(b.rng()) * (hi - lo);
+}
+
+bool chance(BotPlayer& b, float p)
+{
+    return philoxUnit(b.rng()) < p;
+}
+
+// Somewhere inside the middle of a rect, as a hand would click it.
+Vec2 pointIn(BotPlayer& b, const Vec2& center, const Vec2& size)
+{
+    return { center.x + uniform(b, -0.4f, 0.4f) * size.x, center.y + uniform(b, -0.4f, 0.4f) * size.y };
+}
+
+float reaction(BotPlayer& b)
+{
+    return b.playing == BotStrategy::Impatient ? uniform(b, 0.05f, 0.20f) : uniform(b, 0.15f, 0.60f);
+}
+
+// A resting toy to go for, or a spawn slot when none is left in reach.
+void pickTarget(const Machine& m, BotPlayer& b)
+{
+    float xs[kMaxEntities];
+    int n = 0;
+    const Registry& reg = m.registry;
+    for (std::size_t i = 0; i < reg.gameplay.size(); ++i) {
+        const Gameplay& g = reg.gameplay.at(i);
+        if (g.kind != EntityKind::Toy || g.toy != ToyState::Resting) continue;
+        if (const Transform* t = reg.transforms.get(reg.gameplay.entityAt(i))) xs[n++] = t->pos.x;
+    }
+    float x = n > 0 ? xs[std::min(int(uniform(b, 0.0f, float(n))), n - 1)]
+                    : spawnPositions[std::min(int(uniform(b, 0.0f, float(spawnPositions.size()))), int(spawnPositions.size()) - 1)].x;
+    // Same travel limits as updateClawMotion, or the claw never arrives.
+    b.targetX = std::clamp(x, boxLeft + 0.10f, boxRight - 0.10f);
+}
+
+void click(BotPlayer& b, BotAction& a, Vec2 p)
+{
+    b.mouse = p;
+    a.click = true;
+}
+
+void tapS(BotPlayer& b, BotAction& a)
+{
+    b.holdS = uniform(b, 0.05f, 0.15f);
+    a.keys.down = true;
+}
+
+void playRandom(const Machine& m, BotPlayer& b, BotAction& a, float dt)
+{
+    b.holdTime -= dt;
+    if (b.holdTime <= 0.0f) {
+        b.held = InputState{ chance(b, 0.3f), chance(b, 0.3f), chance(b, 0.3f), chance(b, 0.15f) };
+        b.holdTime = uniform(b, 0.05f, 1.0f);
+    }
+    a.keys = b.held;
+    b.clickTime -= dt;
+    if (b.clickTime <= 0.0f) {
+        const float r = uniform(b, 0.0f, 3.0f);
+        if (r < 1.0f) click(b, a, pointIn(b, m.tokenSlot.pos, m.tokenSlot.size));
+        else if (r < 2.0f) click(b, a, pointIn(b, m.prize.pos, m.prize.size));
+        else click(b, a, { uniform(b, -1.0f, 1.0f), uniform(b, -1.0f, 1.0f) });
+        b.clickTime = uniform(b, 0.2f, 2.0f);
+    }
+}
+}
+
+const char* botStrategyName(BotStrategy s)
+{
+    switch (s) {
+    case BotStrategy::Skilled: return "skilled";
+    case BotStrategy::Impatient: return "impatient";
+    case BotStrategy::Random: return "random";
+    case BotStrategy::Mixed: return "mixed";
+    }
+    return "?";
+}
+
+bool parseBotStrategy(const std::string& name, BotStrategy& out)
+{
+    for (BotStrategy s : { BotStrategy::Skilled, BotStrategy::Impatient, BotStrategy::Random, BotStrategy::Mixed }) {
+        if (name == botStrategyName(s)) {
+            out = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+void initBot(BotPlayer& b, BotStrategy strategy, uint32_t seed)
+{
+    b = BotPlayer{};
+    b.strategy = strategy;
+    b.playing = strategy == BotStrategy::Mixed ? BotStrategy::Skilled : strategy;
+    b.rng.seed(seed);
+    b.wait = uniform(b, 0.5f, 3.0f);
+    b.mouse = { 0.0f, 0.0f };
+}
+
+BotAction driveBot(const Machine& m, BotPlayer& b, float dt)
+{
+    BotAction a;
+    if (m.gameState != b.seen) {
+        if (b.seen == GameState::Idle) {
+            // A coin went in: choose how to play it.
+            b.playTime = 0.0f;
+            if (b.strategy == BotStrategy::Mixed) {
+                const float r = uniform(b, 0.0f, 3.0f);
+                b.playing = r < 1.0f ? BotStrategy::Skilled : r < 2.0f ? BotStrategy::Impatient : BotStrategy::Random;
+            }
+            pickTarget(m, b);
+        }
+        b.seen = m.gameState;
+        // Walking up to the machine takes longer than reacting to it.
+        b.wait = m.gameState == GameState::Idle ? uniform(b, 0.5f, 3.0f) : reaction(b);
+    }
+    if (m.gameState != GameState::Idle) b.playTime += dt;
+    if (b.strategy == BotStrategy::Mixed && b.playing == BotStrategy::Random && b.playTime > kRandomPlaySeconds) {
+        b.playing = BotStrategy::Skilled;
+        b.held = InputState{};
+        pickTarget(m, b);
+    }
+
+    // S stays down for a human-length tap, whatever else happens.
+    if (b.holdS > 0.0f) {
+        b.holdS -= dt;
+        a.keys.down = true;
+    }
+
+    const bool random = m.gameState == GameState::Idle ? b.strategy == BotStrategy::Random : b.playing == BotStrategy::Random;
+    if (random) {
+        playRandom(m, b, a, dt);
+        a.mouse = b.mouse;
+        return a;
+    }
+
+    const bool impatient = b.playing == BotStrategy::Impatient;
+    if (impatient && m.gameState != GameState::Idle && m.gameState != GameState::PrizeWaiting) {
+        // Pokes at the prize window and the slot while the play goes on.
+        b.clickTime -= dt;
+        if (b.clickTime <= 0.0f) {
+            if (chance(b, 0.5f)) click(b, a, pointIn(b, m.prize.pos, m.prize.size));
+            else click(b, a, pointIn(b, m.tokenSlot.pos, m.tokenSlot.size));
+            b.clickTime = uniform(b, 0.2f, 1.0f);
+        }
+    }
+
+    b.wait -= dt;
+    if (b.wait > 0.0f || b.holdS > 0.0f) {
+        a.mouse = b.mouse;
+        return a;
+    }
+
+    const bool moving = m.claw.movingDown || m.claw.movingUp;
+    switch (m.gameState) {
+    case GameState::Idle:
+        click(b, a, pointIn(b, m.tokenSlot.pos, m.tokenSlot.size));
+        // Try again if the click somehow did not start a game.
+        b.wait = uniform(b, 1.0f, 3.0f);
+        break;
+    case GameState::ActiveNoToy:
+        if (!moving && steerClaw(m, a.keys, b.targetX, impatient ? 0.05f : 0.02f) && (impatient || clawSettled(m))) {
+            tapS(b, a);
+            pickTarget(m, b);
+            b.wait = reaction(b);
+        }
+        break;
+    case GameState::ActiveCarrying:
+        if (!m.claw.movingUp && steerClaw(m, a.keys, m.hole.center.x, impatient ? 0.05f : 0.02f) && (impatient || clawSettled(m))) {
+            tapS(b, a);
+            b.wait = reaction(b);
+        }
+        break;
+    case GameState::PrizeWaiting:
+        click(b, a, pointIn(b, m.prize.pos, m.prize.size));
+        b.wait = reaction(b);
+        break;
+    default:
+        break;
+    }
+    a.mouse = b.mouse;
+    return a;
+}
+
+// ---------------------- Monitor ---------------------- //
+int64_t residentBytes()
+{
+#ifdef __linux__
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    long long size = 0, resident = 0;
+    const int read = std::fscanf(f, "%lld %lld", &size, &resident);
+    std::fclose(f);
+    return read == 2 ? int64_t(resident) * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+namespace {
+constexpr double kClockTolerance = 0.5;   // Seconds the machine clock may be off simulated time
+// Drift has to clear these as well as the factor, so timer noise on a cheap
+// tick or frame is not a regression.
+constexpr double kTickNoiseUs = 1.0;
+constexpr double kFrameNoiseMs = 0.25;
+
+double median(std::vector<double>& v)
+{
+    if (v.empty()) return 0.0;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+// Reported once each, so a regression that persists is one line.
+enum SoakCheck : uint32_t {
+    CheckStuckState = 1u << 0,   // Shifted by the state
+    CheckPlay = 1u << 5,
+    CheckPending = 1u << 6,
+    CheckTickDrift = 1u << 7,
+    CheckFrameDrift = 1u << 8,
+    CheckGL = 1u << 9,
+    CheckRSS = 1u << 10,
+    CheckClock = 1u << 11,
+    CheckClockStep = 1u << 12
+};
+
+// The transitions a finished play goes through; a soak that never makes one
+// of them did not cover the game. A skilled bot never misses, so it is not
+// held to the miss.
+struct PlayTransition {
+    GameState from;
+    GameState to;
+    bool miss;
+};
+const PlayTransition kPlayTransitions[] = {
+    { GameState::Idle, GameState::ActiveNoToy, false },
+    { GameState::ActiveNoToy, GameState::ActiveCarrying, false },
+    { GameState::ActiveCarrying, GameState::ToyFalling, false },
+    { GameState::ToyFalling, GameState::ActiveNoToy, true },
+    { GameState::ToyFalling, GameState::PrizeWaiting, false },
+    { GameState::PrizeWaiting, GameState::Idle, false },
+};
+
+std::string hours(double seconds)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f h", seconds / 3600.0);
+    return text;
+}
+}
+
+void SoakMonitor::fail(const std::string& what)
+{
+    failed.push_back(what);
+    std::printf("[SOAK] FAIL at %s: %s\n", hours(simulated).c_str(), what.c_str());
+}
+
+void SoakMonitor::begin(const SoakOptions& options, const Machine& m)
+{
+    *this = SoakMonitor{};
+    opts = options;
+    state = m.gameState;
+    visits[int(state)] = 1;
+    clockStart = m.clock;
+}
+
+void SoakMonitor::tick(const Machine& m, float dt, double seconds)
+{
+    simulated += dt;
+    // The clock has to resolve a tick, or animations and timers built on it
+    // start to stall and jump once uptime runs long.
+    const double clockStep = std::nextafter(m.clock, INFINITY) - m.clock;
+    if (clockStep >= dt && !(reported & CheckClockStep)) {
+        reported |= CheckClockStep;
+        char text[96];
+        std::snprintf(text, sizeof(text), "machine clock steps by %.3g s, a tick is %.3g s", clockStep, double(dt));
+        fail(text);
+    }
+    if (m.gameState != state) {
+        transitions[int(state)][int(m.gameState)]++;
+        visits[int(m.gameState)]++;
+        if (m.gameState == GameState::Idle) maxPlay = std::max(maxPlay, simulated - playSince);
+        if (state == GameState::Idle) playSince = simulated;
+        state = m.gameState;
+        stateSince = simulated;
+    }
+    const double dwell = simulated - stateSince;
+    maxDwell[int(state)] = std::max(maxDwell[int(state)], dwell);
+    // Any bot leaves these within seconds; a state the game itself must end
+    // is the usual way a machine hangs.
+    const bool mustLeave = state == GameState::Idle || state == GameState::ToyFalling || state == GameState::PrizeWaiting;
+    const uint32_t stuckBit = CheckStuckState << int(state);
+    if (mustLeave && dwell > opts.stuckSeconds && !(reported & stuckBit)) {
+        reported |= stuckBit;
+        fail(std::string(gameStateName(state)) + " has lasted " + std::to_string(int(dwell)) + " s");
+    }
+    if (state != GameState::Idle && opts.strategy != BotStrategy::Random && simulated - playSince > opts.playSeconds && !(reported & CheckPlay)) {
+        reported |= CheckPlay;
+        fail("one play has lasted " + std::to_string(int(simulated - playSince)) + " s");
+    }
+    if (m.pendingPrizeClick) {
+        if (pendingSince < 0.0) {
+            pendingSince = simulated;
+            pendingSets++;
+        }
+        maxPending = std::max(maxPending, simulated - pendingSince);
+        if (simulated - pendingSince > opts.stuckSeconds && !(reported & CheckPending)) {
+            reported |= CheckPending;
+            fail("a prize click has been pending for " + std::to_string(int(simulated - pendingSince)) + " s");
+        }
+    }
+    else {
+        pendingSince = -1.0;
+    }
+
+    secondCost += seconds;
+    secondTicks++;
+    secondSim += dt;
+    if (secondSim >= 1.0) {
+        tickSamples.push_back(secondCost / secondTicks);
+        secondCost = secondSim = 0.0;
+        secondTicks = 0;
+    }
+}
+
+void SoakMonitor::frame(double seconds)
+{
+    frameSamples.push_back(seconds);
+}
+
+void SoakMonitor::endWindow(const Machine& m, double wallSeconds, const GLObjectCounts& gl)
+{
+    SoakWindow w;
+    w.simSeconds = simulated;
+    w.wallSeconds = wallSeconds;
+    w.tickUs = median(tickSamples) * 1e6;
+    w.frameMs = median(frameSamples) * 1e3;
+    for (double f : frameSamples) w.frameMaxMs = std::max(w.frameMaxMs, f * 1e3);
+    w.rssBytes = residentBytes();
+    w.heapLive = int64_t(heapAllocations()) - int64_t(heapFrees());
+    w.gl = gl;
+    w.plays = m.coinsInserted;
+    w.prizes = m.prizesPaid;
+    tickSamples.clear();
+    frameSamples.clear();
+    windows.push_back(w);
+
+    char text[160];
+    const double clockError = m.clock - clockStart - simulated;
+    if (std::abs(clockError) > kClockTolerance && !(reported & CheckClock)) {
+        reported |= CheckClock;
+        std::snprintf(text, sizeof(text), "machine clock is %.2f s off simulated time", clockError);
+        fail(text);
+    }
+    // The first window is the baseline; it has warmed every cache and pool.
+    if (windows.size() < 2) return;
+    const SoakWindow& first = windows.front();
+    if (w.tickUs > first.tickUs * opts.driftLimit && w.tickUs > first.tickUs + kTickNoiseUs && !(reported & CheckTickDrift)) {
+        reported |= CheckTickDrift;
+        std::snprintf(text, sizeof(text), "tick cost drifted from %.2f us to %.2f us", first.tickUs, w.tickUs);
+        fail(text);
+    }
+    if (w.frameMs > first.frameMs * opts.driftLimit && w.frameMs > first.frameMs + kFrameNoiseMs && !(reported & CheckFrameDrift)) {
+        reported |= CheckFrameDrift;
+        std::snprintf(text, sizeof(text), "frame cost drifted from %.3f ms to %.3f ms", first.frameMs, w.frameMs);
+        fail(text);
+    }
+    if (w.gl.total() > first.gl.total() && !(reported & CheckGL)) {
+        reported |= CheckGL;
+        std::snprintf(text, sizeof(text), "GL objects grew from %d to %d (textures %d, buffers %d, vertex arrays %d, framebuffers %d)",
+            first.gl.total(), w.gl.total(), w.gl.textures, w.gl.buffers, w.gl.vertexArrays, w.gl.framebuffers);
+        fail(text);
+    }
+    const double grownMB = double(w.rssBytes - first.rssBytes) / (1024.0 * 1024.0);
+    if (grownMB > opts.rssLimitMB && !(reported & CheckRSS)) {
+        reported |= CheckRSS;
+        std::snprintf(text, sizeof(text), "resident memory grew %.1f MB since the first window", grownMB);
+        fail(text);
+    }
+}
+
+void SoakMonitor::finish()
+{
+    // A random bot may never win, so it is not held to covering the game.
+    if (opts.strategy == BotStrategy::Random) return;
+    for (const PlayTransition& t : kPlayTransitions) {
+        if (t.miss && opts.strategy == BotStrategy::Skilled) continue;
+        if (transitions[int(t.from)][int(t.to)] == 0) {
+            fail(std::string("never went from ") + gameStateName(t.from) + " to " + gameStateName(t.to));
+        }
+    }
+}
+
+void SoakMonitor::report(std::ostream& out) const
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "[SOAK] %8s %9s %7s %8s %9s %8s %8s %10s %5s %7s %7s\n",
+        "sim h", "wall s", "speed", "tick us", "frame ms", "max ms", "RSS MB", "heap live", "GL", "plays", "prizes");
+    out << line;
+    for (const SoakWindow& w : windows) {
+        std::snprintf(line, sizeof(line), "[SOAK] %8.2f %9.1f %6.0fx %8.2f %9.3f %8.3f %8.1f %10lld %5d %7u %7u\n",
+            w.simSeconds / 3600.0, w.wallSeconds, w.wallSeconds > 0.0 ? w.simSeconds / w.wallSeconds : 0.0,
+            w.tickUs, w.frameMs, w.frameMaxMs, double(w.rssBytes) / (1024.0 * 1024.0), static_cast<long long>(w.heapLive),
+            w.gl.total(), w.plays, w.prizes);
+        out << line;
+    }
+
+    std::snprintf(line, sizeof(line), "[SOAK] %-15s %10s %12s\n", "state", "visits", "max dwell s");
+    out << line;
+    for (int s = 0; s < kStates; ++s) {
+        std::snprintf(line, sizeof(line), "[SOAK] %-15s %10llu %12.1f\n", gameStateName(GameState(s)),
+            static_cast<unsigned long long>(visits[s]), maxDwell[s]);
+        out << line;
+    }
+    std::ostringstream seen;
+    for (int from = 0; from < kStates; ++from) {
+        for (int to = 0; to < kStates; ++to) {
+            if (transitions[from][to] > 0) seen << " " << gameStateName(GameState(from)) << "->" << gameStateName(GameState(to)) << " " << transitions[from][to];
+        }
+    }
+    out << "[SOAK] transitions:" << seen.str() << std::endl;
+    std::snprintf(line, sizeof(line), "[SOAK] longest play %.1f s; pending prize clicks %llu, longest %.2f s\n",
+        maxPlay, static_cast<unsigned long long>(pendingSets), maxPending);
+    out << line;
+    if (failed.empty()) out << "[SOAK] PASS: " << hours(simulated) << " simulated, no regressions" << std::endl;
+    else out << "[SOAK] FAIL: " << failed.size() << " regressions in " << hours(simulated) << std::endl;
+}
+
+bool SoakMonitor::writeCsv(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "sim_s,wall_s,tick_us,frame_ms,frame_max_ms,rss_bytes,heap_live,gl_textures,gl_buffers,gl_vertex_arrays,"
+        "gl_framebuffers,gl_renderbuffers,gl_programs,gl_shaders,gl_queries,plays,prizes\n");
+    for (const SoakWindow& w : windows) {
+        std::fprintf(f, "%.1f,%.3f,%.4f,%.4f,%.4f,%lld,%lld,%d,%d,%d,%d,%d,%d,%d,%d,%u,%u\n", w.simSeconds, w.wallSeconds,
+            w.tickUs, w.frameMs, w.frameMaxMs, static_cast<long long>(w.rssBytes), static_cast<long long>(w.heapLive),
+            w.gl.textures, w.gl.buffers, w.gl.vertexArrays, w.gl.framebuffers, w.gl.renderbuffers, w.gl.programs,
+            w.gl.shaders, w.gl.queries, w.plays, w.prizes);
+    }
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,417 @@
+#include "../Header/Spectator.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+void buildMessage(std::vector<uint8_t>& out, StreamMessage type, uint32_t tick, const std::vector<uint8_t>& body)
+{
+    StreamHeader h{ kStreamMagic, static_cast<uint8_t>(type), 0, static_cast<uint16_t>(body.size()), tick };
+    out.resize(sizeof(h) + body.size());
+    std::memcpy(out.data(), &h, sizeof(h));
+    if (!body.empty()) std::memcpy(out.data() + sizeof(h), body.data(), body.size());
+}
+}
+
+void queueMessage(StreamQueue& q, const std::vector<uint8_t>& message)
+{
+    q.bytes.insert(q.bytes.end(), message.begin(), message.end());
+    q.messageEnds.push_back(q.bytes.size());
+}
+
+void queueSent(StreamQueue& q, std::size_t n)
+{
+    q.sent += n;
+    std::size_t gone = 0;
+    while (gone < q.messageEnds.size() && q.messageEnds[gone] <= q.sent) ++gone;
+    if (gone > 0) {
+        q.head = q.messageEnds[gone - 1];
+        q.messageEnds.erase(q.messageEnds.begin(), q.messageEnds.begin() + gone);
+    }
+    if (q.messageEnds.empty()) {
+        q.bytes.clear();
+        q.head = q.sent = 0;
+    }
+    else if (q.head > q.bytes.size() / 2) {
+        // Every end left is past head, so none of them wraps.
+        q.bytes.erase(q.bytes.begin(), q.bytes.begin() + q.head);
+        for (std::size_t& end : q.messageEnds) end -= q.head;
+        q.sent -= q.head;
+        q.head = 0;
+    }
+}
+
+std::size_t queueDropUnstarted(StreamQueue& q)
+{
+    const std::size_t kept = !q.messageEnds.empty() && q.sent > q.head ? 1 : 0;
+    const std::size_t dropped = q.messageEnds.size() - kept;
+    q.messageEnds.resize(kept);
+    q.bytes.resize(kept > 0 ? q.messageEnds.back() : q.head);
+    return dropped;
+}
+
+SpectatorPublisher::~SpectatorPublisher()
+{
+    stop();
+}
+
+SpectatorClient::~SpectatorClient()
+{
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+#ifdef __linux__
+
+namespace {
+int openSocket(const StreamEndpoint& ep, bool listening)
+{
+    int fd = -1;
+    int rc = -1;
+    if (ep.tcpPort > 0) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(ep.tcpPort));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (listening) {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            rc = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        }
+        else {
+            rc = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        }
+    }
+    else {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, ep.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (listening) {
+            unlink(ep.socketPath.c_str());
+            rc = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        }
+        else {
+            rc = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        }
+    }
+    if (rc == 0 && listening) rc = listen(fd, 16);
+    if (rc != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+}
+
+bool SpectatorPublisher::start(const PublisherOptions& options)
+{
+    stop();
+    opts = options;
+    listenFd = openSocket(opts.endpoint, true);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (listenFd < 0 || epollFd < 0 || wakeFd < 0) {
+        std::cout << "[SPECTATE] could not listen: " << std::strerror(errno) << std::endl;
+        stop();
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    haveLast = false;
+    sinceLastPublish = 0.0f;
+    running = true;
+    worker = std::thread(&SpectatorPublisher::run, this);
+    if (opts.endpoint.tcpPort > 0) std::cout << "[SPECTATE] publishing on 127.0.0.1:" << opts.endpoint.tcpPort << std::endl;
+    else std::cout << "[SPECTATE] publishing on " << opts.endpoint.socketPath << std::endl;
+    return true;
+}
+
+void SpectatorPublisher::stop()
+{
+    if (running.exchange(false)) {
+        uint64_t one = 1;
+        (void)!write(wakeFd, &one, sizeof(one));
+        worker.join();
+    }
+    while (!subscribers.empty()) closeSubscriber(subscribers.size() - 1);
+    if (listenFd >= 0) {
+        close(listenFd);
+        if (opts.endpoint.tcpPort <= 0) unlink(opts.endpoint.socketPath.c_str());
+    }
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+    listenFd = epollFd = wakeFd = -1;
+}
+
+void SpectatorPublisher::publish(const Machine& m, uint32_t tick, float dt)
+{
+    if (!running) return;
+    sinceLastPublish += dt;
+    float interval = opts.rateHz > 0.0f ? 1.0f / opts.rateHz : 0.0f;
+    if (sinceLastPublish < interval) return;
+    // Do not try to catch up after a hitch; just send the current state.
+    sinceLastPublish = sinceLastPublish >= 2.0f * interval ? 0.0f : sinceLastPublish - interval;
+    if (subscriberCount.load(std::memory_order_relaxed) == 0) return;
+
+    MachineSnapshot snap;
+    captureSnapshot(m, tick, snap);
+    {
+        // The publisher thread holds this only to copy the mailbox out; if it
+        // happens to, skip this snapshot rather than wait.
+        std::unique_lock<std::mutex> lock(mailboxMutex, std::try_to_lock);
+        if (!lock) return;
+        mailbox = snap;
+        mailboxFull = true;
+    }
+    uint64_t one = 1;
+    (void)!write(wakeFd, &one, sizeof(one));
+}
+
+PublisherStats SpectatorPublisher::stats() const
+{
+    PublisherStats s;
+    s.published = publishedCount.load();
+    s.bytesSent = bytesSent.load();
+    s.dropped = droppedCount.load();
+    s.subscribers = subscriberCount.load();
+    s.keyframeOnly = keyframeOnlyCount.load();
+    return s;
+}
+
+void SpectatorPublisher::run()
+{
+    epoll_event events[32];
+    while (running) {
+        int n = epoll_wait(epollFd, events, 32, 250);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptSubscribers();
+            }
+            else if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {}
+                MachineSnapshot snap;
+                bool have = false;
+                {
+                    std::lock_guard<std::mutex> lock(mailboxMutex);
+                    if (mailboxFull) {
+                        snap = mailbox;
+                        mailboxFull = false;
+                        have = true;
+                    }
+                }
+                if (have) broadcast(snap);
+            }
+            else if (Subscriber* s = findSubscriber(fd)) {
+                bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP));
+                if (alive && (events[i].events & EPOLLIN)) {
+                    // Spectators have nothing to say; drain and ignore.
+                    char scratch[256];
+                    ssize_t r;
+                    while ((r = recv(fd, scratch, sizeof(scratch), 0)) > 0) {}
+                    if (r == 0) alive = false;
+                }
+                if (alive && (events[i].events & EPOLLOUT)) alive = flush(*s);
+                if (!alive) closeSubscriber(static_cast<std::size_t>(s - subscribers.data()));
+            }
+        }
+    }
+}
+
+void SpectatorPublisher::acceptSubscribers()
+{
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: the edge is fully consumed
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            continue;
+        }
+        Subscriber s;
+        s.fd = fd;
+        subscribers.push_back(std::move(s));
+        subscriberCount = static_cast<int>(subscribers.size());
+        std::cout << "[SPECTATE] subscriber connected (" << subscribers.size() << " watching)" << std::endl;
+    }
+}
+
+void SpectatorPublisher::broadcast(const MachineSnapshot& snap)
+{
+    bool forceKeyframe = !haveLast || ++sinceKeyframe >= opts.keyframeInterval;
+    encodeKeyframe(snap, payload);
+    buildMessage(keyframeMessage, StreamMessage::Keyframe, snap.tick, payload);
+    if (!forceKeyframe) {
+        encodeDelta(lastSnapshot, snap, payload);
+        buildMessage(deltaMessage, StreamMessage::Delta, snap.tick, payload);
+    }
+
+    for (std::size_t i = subscribers.size(); i-- > 0;) {
+        Subscriber& s = subscribers[i];
+        if (s.keyframeOnly) {
+            // Only send when the previous keyframe has fully left.
+            if (queueUnsent(s.queue) > 0) {
+                droppedCount++;
+                continue;
+            }
+            queueMessage(s.queue, keyframeMessage);
+        }
+        else {
+            queueMessage(s.queue, (forceKeyframe || s.needsKeyframe) ? keyframeMessage : deltaMessage);
+            s.needsKeyframe = false;
+        }
+        if (!flush(s)) {
+            closeSubscriber(i);
+            continue;
+        }
+        if (!s.keyframeOnly && queueUnsent(s.queue) > opts.maxQueuedBytes) demote(s);
+    }
+
+    lastSnapshot = snap;
+    haveLast = true;
+    if (forceKeyframe) sinceKeyframe = 0;
+    publishedCount++;
+}
+
+// Writes until the socket is full. With edge-triggered epoll the next EPOLLOUT
+// only arrives after EAGAIN, so stopping early would stall the subscriber.
+bool SpectatorPublisher::flush(Subscriber& s)
+{
+    StreamQueue& q = s.queue;
+    while (queueUnsent(q) > 0) {
+        ssize_t n = send(s.fd, q.bytes.data() + q.sent, queueUnsent(q), MSG_NOSIGNAL);
+        if (n > 0) {
+            queueSent(q, static_cast<std::size_t>(n));
+            bytesSent += static_cast<uint64_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0 && errno == EINTR) continue;
+        return false;
+    }
+    return true;
+}
+
+// From here on the subscriber only receives keyframes.
+void SpectatorPublisher::demote(Subscriber& s)
+{
+    droppedCount += queueDropUnstarted(s.queue);
+    s.keyframeOnly = true;
+    keyframeOnlyCount++;
+    std::cout << "[SPECTATE] subscriber too slow, switched to keyframe-only" << std::endl;
+}
+
+void SpectatorPublisher::closeSubscriber(std::size_t i)
+{
+    if (subscribers[i].keyframeOnly) keyframeOnlyCount--;
+    close(subscribers[i].fd);
+    subscribers.erase(subscribers.begin() + i);
+    subscriberCount = static_cast<int>(subscribers.size());
+}
+
+SpectatorPublisher::Subscriber* SpectatorPublisher::findSubscriber(int fd)
+{
+    for (Subscriber& s : subscribers) {
+        if (s.fd == fd) return &s;
+    }
+    return nullptr;
+}
+
+bool SpectatorClient::connect(const StreamEndpoint& endpoint)
+{
+    if (fd >= 0) close(fd);
+    fd = openSocket(endpoint, false);
+    buffer.clear();
+    haveState = false;
+    return fd >= 0;
+}
+
+int SpectatorClient::poll()
+{
+    if (fd < 0) return -1;
+    bool closed = false;
+    uint8_t chunk[4096];
+    for (;;) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+    }
+
+    int applied = 0;
+    std::size_t offset = 0;
+    while (buffer.size() - offset >= sizeof(StreamHeader)) {
+        StreamHeader h;
+        std::memcpy(&h, buffer.data() + offset, sizeof(h));
+        if (h.magic != kStreamMagic) return -1;
+        if (buffer.size() - offset - sizeof(h) < h.length) break;
+        const uint8_t* body = buffer.data() + offset + sizeof(h);
+        MachineSnapshot next;
+        if (h.type == static_cast<uint8_t>(StreamMessage::Keyframe) && decodeKeyframe(body, h.length, next)) {
+            current = next;
+            haveState = true;
+            keyframeCount++;
+            applied++;
+        }
+        else if (h.type == static_cast<uint8_t>(StreamMessage::Delta) && haveState && decodeDelta(current, body, h.length, next)) {
+            current = next;
+            deltaCount++;
+            applied++;
+        }
+        offset += sizeof(h) + h.length;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+    return closed ? -1 : applied;
+}
+
+#else
+
+bool SpectatorPublisher::start(const PublisherOptions&)
+{
+    std::cout << "[SPECTATE] spectator streaming needs Linux (epoll)" << std::endl;
+    return false;
+}
+
+void SpectatorPublisher::stop() {}
+void SpectatorPublisher::publish(const Machine&, uint32_t, float) {}
+PublisherStats SpectatorPublisher::stats() const { return PublisherStats{}; }
+
+bool SpectatorClient::connect(const StreamEndpoint&)
+{
+    std::cout << "[SPECTATE] spectator streaming needs Linux" << std::endl;
+    return false;
+}
+
+int SpectatorClient::poll() { return -1; }
+
+#endif
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Header/Spectator.h"
+
+// Checks a subscriber's send queue the way a slow spectator drives it:
+// writes that stop partway through a message, compaction, and demotion to
+// keyframe-only with messages still queued. Everything written is collected
+// as the subscriber would receive it and must parse as whole messages, in
+// order, each sent at most once.
+
+struct CheckOptions {
+    int rounds = 2000;
+    uint32_t seed = 1;
+};
+
+CheckOptions parseArgs(int argc, char** argv)
+{
+    CheckOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rounds" && i + 1 < argc) opts.rounds = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc) opts.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    return opts;
+}
+
+// A message is its id, its length and then the id's low byte repeated.
+std::vector<uint8_t> makeMessage(uint32_t id, std::size_t length)
+{
+    std::vector<uint8_t> m(std::max<std::size_t>(length, 8), uint8_t(id));
+    const uint32_t size = uint32_t(m.size());
+    std::memcpy(m.data(), &id, 4);
+    std::memcpy(m.data() + 4, &size, 4);
+    return m;
+}
+
+// Writes up to n bytes of q to the wire.
+void sendSome(StreamQueue& q, std::size_t n, std::vector<uint8_t>& wire)
+{
+    n = std::min(n, queueUnsent(q));
+    wire.insert(wire.end(), q.bytes.begin() + q.sent, q.bytes.begin() + q.sent + n);
+    queueSent(q, n);
+}
+
+// Parses the wire into message ids; false if any message is torn or out of order.
+bool readWire(const std::vector<uint8_t>& wire, std::vector<uint32_t>& ids)
+{
+    std::size_t at = 0;
+    while (at < wire.size()) {
+        uint32_t id, size;
+        if (wire.size() - at < 8) return false;
+        std::memcpy(&id, wire.data() + at, 4);
+        std::memcpy(&size, wire.data() + at + 4, 4);
+        if (size < 8 || wire.size() - at < size) return false;
+        for (std::size_t i = 8; i < size; ++i) {
+            if (wire[at + i] != uint8_t(id)) return false;
+        }
+        if (!ids.empty() && id <= ids.back()) return false;
+        ids.push_back(id);
+        at += size;
+    }
+    return true;
+}
+
+// The case that used to wrap the queue's offsets: a partial send that
+// compacts past finished messages, then a demote.
+bool checkCompactThenDemote()
+{
+    StreamQueue q;
+    std::vector<uint8_t> wire;
+    for (uint32_t id = 1; id <= 3; ++id) queueMessage(q, makeMessage(id, 100));
+    sendSome(q, 250, wire);   // 1 and 2 gone, half of 3 on the wire
+    queueMessage(q, makeMessage(4, 100));
+    queueMessage(q, makeMessage(5, 100));
+    const std::size_t dropped = queueDropUnstarted(q);
+    const bool kept = dropped == 2 && q.messageEnds.size() == 1 && queueUnsent(q) == 50;
+    sendSome(q, queueUnsent(q), wire);
+    std::vector<uint32_t> ids;
+    const bool ok = kept && readWire(wire, ids) && ids == std::vector<uint32_t>{ 1, 2, 3 } && q.bytes.empty();
+    std::printf("[CHECK] partial send, compaction, demote: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// Random pushes, partial sends and demotes; the wire must stay whole and
+// every message must be either delivered or counted as dropped.
+bool checkRound(std::mt19937& rng)
+{
+    StreamQueue q;
+    std::vector<uint8_t> wire;
+    uint32_t pushed = 0;
+    std::size_t dropped = 0;
+    for (int step = 0; step < 200; ++step) {
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            queueMessage(q, makeMessage(++pushed, 8 + rng() % 300));
+            break;
+        case 2:
+            sendSome(q, rng() % 400, wire);
+            break;
+        default:
+            if (rng() % 8 == 0) dropped += queueDropUnstarted(q);
+            break;
+        }
+        if (q.sent > q.bytes.size() || (!q.messageEnds.empty() && q.messageEnds.back() != q.bytes.size())) return false;
+    }
+    sendSome(q, queueUnsent(q), wire);
+    std::vector<uint32_t> ids;
+    return readWire(wire, ids) && ids.size() + dropped == pushed && q.bytes.empty();
+}
+
+int main(int argc, char** argv)
+{
+    CheckOptions opts = parseArgs(argc, argv);
+    int failures = checkCompactThenDemote() ? 0 : 1;
+    std::mt19937 rng(opts.seed);
+    int failedRounds = 0;
+    for (int round = 0; round < opts.rounds; ++round) {
+        if (!checkRound(rng)) failedRounds++;
+    }
+    failures += failedRounds;
+    std::printf("[CHECK] %d random rounds, %d failed\n", opts.rounds, failedRounds);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "../Header/SpriteBatch.h"
+
+#include <vector>
+
+#include "../Header/Hitch.h"
+#include "../Header/Renderer.h"
+#include "../Header/Util.h"
+
+bool SpriteBatch::init()
+{
+    shader = createShader("Source/Shaders/sprite_instanced.vert", "Source/Shaders/sprite_instanced.frag");
+    whiteTexture = createTextureFromRGBA(std::vector<unsigned char>{ 255, 255, 255, 255 }, 1, 1);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &instanceVBO);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVertexBuffer());
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (GLuint loc = 2; loc <= 7; ++loc) {
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    glBindVertexArray(0);
+    return shader != 0;
+}
+
+void SpriteBatch::begin(double time)
+{
+    animTime = animationClock(time);
+    for (auto& buckets : layers) {
+        for (auto& b : buckets) b.items.clear();
+    }
+}
+
+std::vector<SpriteInstance>& SpriteBatch::bucketFor(unsigned int texture, int layer)
+{
+    if (layer < 0 || layer >= kLayerCount) layer = LayerBackground;
+    auto& buckets = layers[layer];
+    for (auto& b : buckets) {
+        if (b.texture == texture) return b.items;
+    }
+    buckets.push_back(Bucket{ texture, {} });
+    return buckets.back().items;
+}
+
+void SpriteBatch::addInstance(unsigned int texture, int layer, const SpriteInstance& inst)
+{
+    bucketFor(texture, layer).push_back(inst);
+}
+
+void SpriteBatch::addRegistry(Registry& reg, const Vec2& offset, float scale)
+{
+    reg.sortSprites();
+    std::vector<SpriteInstance>* items = nullptr;
+    unsigned int lastTexture = 0;
+    int lastLayer = -1;
+    for (std::size_t i = 0; i < reg.sprites.size(); ++i) {
+        const Sprite& s = reg.sprites.at(i);
+        if (!s.visible) continue;
+        const Transform* t = reg.transforms.get(reg.sprites.entityAt(i));
+        if (!t) continue;
+        // Sorted input means runs of the same bucket; only look up on change.
+        if (!items || s.texture != lastTexture || s.layer != lastLayer) {
+            items = &bucketFor(s.texture, s.layer);
+            lastTexture = s.texture;
+            lastLayer = s.layer;
+        }
+        SpriteInstance inst;
+        inst.x = offset.x + t->pos.x * scale;
+        inst.y = offset.y + t->pos.y * scale;
+        inst.w = t->size.x * scale;
+        inst.h = t->size.y * scale;
+        inst.r = s.color[0];
+        inst.g = s.color[1];
+        inst.b = s.color[2];
+        inst.a = s.color[3];
+        inst.rotation = t->rotation;
+        inst.animCurve = float(s.anim.curve);
+        inst.animStart = s.anim.start;
+        inst.animPeriod = s.anim.period;
+        inst.animAmplitude = s.anim.amplitude;
+        inst.toR = s.anim.to[0];
+        inst.toG = s.anim.to[1];
+        inst.toB = s.anim.to[2];
+        inst.toA = s.anim.to[3];
+        items->push_back(inst);
+    }
+}
+
+void SpriteBatch::flush(const ViewTransform& view)
+{
+    staging.clear();
+    for (auto& buckets : layers) {
+        for (auto& b : buckets) staging.insert(staging.end(), b.items.begin(), b.items.end());
+    }
+    drawCalls = 0;
+    instanceCount = staging.size();
+    if (staging.empty()) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    std::size_t bytes = staging.size() * sizeof(SpriteInstance);
+    if (bytes > vboCapacity) vboCapacity = bytes * 2;
+    // Orphan so the driver does not stall on last frame's draws.
+    glBufferData(GL_ARRAY_BUFFER, vboCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, staging.data());
+
+    glUseProgram(shader);
+    glUniform2f(glGetUniformLocation(shader, "uViewCenter"), view.center.x, view.center.y);
+    glUniform2f(glGetUniformLocation(shader, "uViewScale"), view.scale.x, view.scale.y);
+    glUniform1i(glGetUniformLocation(shader, "uTex"), 0);
+    glUniform1f(glGetUniformLocation(shader, "uTime"), animTime);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(vao);
+
+    const GLsizei stride = sizeof(SpriteInstance);
+    std::size_t base = 0;
+    for (auto& buckets : layers) {
+        for (auto& b : buckets) {
+            if (b.items.empty()) continue;
+            std::size_t offset = base * sizeof(SpriteInstance);
+            // GL 3.3 has no base-instance draws, so re-point the attributes.
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset));
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 4 * sizeof(float)));
+            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 8 * sizeof(float)));
+            glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 12 * sizeof(float)));
+            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 13 * sizeof(float)));
+            glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 17 * sizeof(float)));
+            glBindTexture(GL_TEXTURE_2D, b.texture != 0 ? b.texture : whiteTexture);
+            glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, static_cast<GLsizei>(b.items.size()));
+            recordGLCall("glDrawArraysInstanced", static_cast<uint32_t>(b.items.size()));
+            drawCalls++;
+            countDrawCalls();
+            base += b.items.size();
+        }
+    }
+    glBindVertexArray(0);
+}
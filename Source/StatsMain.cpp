@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+
+#include "../Header/LiveStats.h"
+#include "../Header/Machine.h"
+
+// Sidecar monitor for the live stats segment. Samples the running game's
+// shared memory at a fixed rate and prints one line per sample; --bench
+// instead publishes from a headless machine while a second thread reads, and
+// reports the cost of both sides and any torn reads.
+
+struct StatsOptions {
+    std::string name = kLiveStatsDefaultName;
+    double hz = 10.0;
+    double seconds = 0.0;    // 0: until the writer goes away
+    bool bench = false;
+};
+
+StatsOptions parseArgs(int argc, char** argv)
+{
+    StatsOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) opts.name = argv[++i];
+        else if (arg == "--hz" && i + 1 < argc) opts.hz = std::max(0.1, std::atof(argv[++i]));
+        else if (arg == "--seconds" && i + 1 < argc) opts.seconds = std::atof(argv[++i]);
+        else if (arg == "--bench") opts.bench = true;
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    return opts;
+}
+
+const char* lampModeName(uint8_t mode)
+{
+    switch (static_cast<LampMode>(mode)) {
+    case LampMode::Off: return "off";
+    case LampMode::Blue: return "blue";
+    case LampMode::Blink: return "blink";
+    default: return "?";
+    }
+}
+
+bool writerAlive(uint32_t pid)
+{
+    return pid != 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+}
+
+int monitor(const StatsOptions& opts)
+{
+    LiveStatsReader reader;
+    if (!reader.open(opts.name)) {
+        std::cout << "[STATS] no live stats at " << opts.name << "; is the game running?" << std::endl;
+        return 1;
+    }
+    std::printf("[STATS] reading %s from pid %u\n", opts.name.c_str(), reader.writerPid());
+    std::printf("%10s %8s %-14s %6s %7s %7s %7s %7s %7s %7s %7s %-6s %5s %5s\n",
+        "frame", "tick", "state", "fps", "frame", "p50", "p95", "p99", "max", "claw x", "claw y", "lamp", "coins", "wins");
+
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / opts.hz));
+    const auto start = Clock::now();
+    auto next = start;
+    uint64_t lastFrame = 0;
+    auto lastChange = start;
+    for (;;) {
+        LiveStats s;
+        auto now = Clock::now();
+        if (reader.sample(s)) {
+            std::printf("%10llu %8u %-14s %6.1f %7.2f %7.2f %7.2f %7.2f %7.2f %7.3f %7.3f %-6s %5u %5u%s\n",
+                static_cast<unsigned long long>(s.frame), s.tick, gameStateName(static_cast<GameState>(s.gameState)),
+                s.fps, s.frameMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs, s.clawX, s.clawY, lampModeName(s.lampMode),
+                s.coinsInserted, s.prizesPaid, s.rewinding ? "  (rewind)" : "");
+            if (s.frame != lastFrame) {
+                lastFrame = s.frame;
+                lastChange = now;
+            }
+        }
+        if (now - lastChange > std::chrono::seconds(2) && !writerAlive(reader.writerPid())) {
+            std::cout << "[STATS] writer is gone" << std::endl;
+            return 1;
+        }
+        if (opts.seconds > 0.0 && now - start >= std::chrono::duration<double>(opts.seconds)) break;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    std::printf("[STATS] %llu retries on in-flight writes\n", static_cast<unsigned long long>(reader.retries()));
+    return 0;
+}
+
+// Publishes as fast as a headless machine can step while another thread
+// samples without pause. Every payload is written with tick == frame, so a
+// sample mixing two writes shows up as a mismatch.
+int bench(const StatsOptions& opts)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::string name = opts.name + "-bench";
+    if (!openLiveStats(name)) return 1;
+
+    Machine m;
+    m.logEvents = false;
+    initMachine(m, MachineTextures{ 1, 2, 3, 4 }, 1337u);
+    AttractPlayer player;
+    initAttract(player, 1u);
+    const float step = 1.0f / 75.0f;
+    const double seconds = opts.seconds > 0.0 ? opts.seconds : 2.0;
+
+    std::atomic<bool> running{ true };
+    uint64_t samples = 0, torn = 0, retries = 0;
+    double sampleSec = 0.0;
+    std::thread readerThread([&] {
+        LiveStatsReader reader;
+        if (!reader.open(name)) return;
+        LiveStats s;
+        auto t0 = Clock::now();
+        while (running.load(std::memory_order_relaxed)) {
+            if (!reader.sample(s)) continue;
+            samples++;
+            if (s.frame != s.tick) torn++;
+        }
+        sampleSec = std::chrono::duration<double>(Clock::now() - t0).count();
+        retries = reader.retries();
+    });
+
+    uint64_t published = 0;
+    double publishSec = 0.0, maxUs = 0.0;
+    const auto end = Clock::now() + std::chrono::duration<double>(seconds);
+    while (Clock::now() < end) {
+        driveAttract(m, player, step);
+        stepMachine(m, step);
+        auto t0 = Clock::now();
+        publishLiveStats(m, static_cast<uint32_t>(published + 1), 4.0f + float(published % 7), step, false);
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        publishSec += sec;
+        maxUs = std::max(maxUs, sec * 1e6);
+        published++;
+    }
+    running = false;
+    readerThread.join();
+    closeLiveStats();
+
+    std::printf("[STATS] publish: %llu frames, avg %.1f ns, max %.2f us\n",
+        static_cast<unsigned long long>(published), publishSec * 1e9 / double(std::max<uint64_t>(published, 1)), maxUs);
+    std::printf("[STATS] sample:  %llu reads, avg %.1f ns, %llu retries, %llu torn\n",
+        static_cast<unsigned long long>(samples), sampleSec * 1e9 / double(std::max<uint64_t>(samples, 1)),
+        static_cast<unsigned long long>(retries), static_cast<unsigned long long>(torn));
+    return torn == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    StatsOptions opts = parseArgs(argc, argv);
+    return opts.bench ? bench(opts) : monitor(opts);
+}
@@ -0,0 +1,128 @@
+#include "../Header/Telemetry.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+std::size_t padded(std::size_t bytes)
+{
+    return (bytes + 63) & ~std::size_t(63);
+}
+}
+
+const char* playEventName(PlayEventType type)
+{
+    switch (type) {
+    case PlayEventType::Start: return "start";
+    case PlayEventType::Drop: return "drop";
+    case PlayEventType::Grab: return "grab";
+    case PlayEventType::Release: return "release";
+    case PlayEventType::Landing: return "landing";
+    case PlayEventType::Collect: return "collect";
+    default: return "unknown";
+    }
+}
+
+TelemetryColumns telemetryColumns(uint32_t count)
+{
+    TelemetryColumns c;
+    std::size_t offset = 0;
+    c.machine = offset; offset += padded(count * sizeof(uint32_t));
+    c.play = offset;    offset += padded(count * sizeof(uint32_t));
+    c.time = offset;    offset += padded(count * sizeof(float));
+    c.value = offset;   offset += padded(count * sizeof(float));
+    c.type = offset;    offset += padded(count * sizeof(uint8_t));
+    c.flag = offset;    offset += padded(count * sizeof(uint8_t));
+    c.bytes = offset;
+    return c;
+}
+
+TelemetryLog::~TelemetryLog()
+{
+    close();
+}
+
+bool TelemetryLog::open(const std::string& path, uint32_t chunkEvents)
+{
+    close();
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cout << "[TELEMETRY] could not open " << path << std::endl;
+        return false;
+    }
+    // Appending to an existing log keeps its header; a new file gets one.
+    std::fseek(file, 0, SEEK_END);
+    if (std::ftell(file) == 0) {
+        TelemetryFileHeader h{};
+        h.magic = kTelemetryMagic;
+        h.version = kTelemetryVersion;
+        h.startUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::fwrite(&h, sizeof(h), 1, file);
+    }
+    capacity = chunkEvents > 0 ? chunkEvents : kTelemetryChunkEvents;
+    machines.reserve(capacity);
+    plays.reserve(capacity);
+    times.reserve(capacity);
+    values.reserve(capacity);
+    types.reserve(capacity);
+    flags.reserve(capacity);
+    return true;
+}
+
+void TelemetryLog::close()
+{
+    if (!file) return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void TelemetryLog::append(uint32_t machine, const PlayEvent& e)
+{
+    if (!file) return;
+    machines.push_back(machine);
+    plays.push_back(e.play);
+    times.push_back(e.time);
+    values.push_back(e.value);
+    types.push_back(static_cast<uint8_t>(e.type));
+    flags.push_back(e.flag);
+    if (machines.size() >= capacity) flush();
+}
+
+void TelemetryLog::append(uint32_t machine, std::vector<PlayEvent>& events)
+{
+    for (const PlayEvent& e : events) append(machine, e);
+    events.clear();
+}
+
+void TelemetryLog::flush()
+{
+    if (!file || machines.empty()) return;
+    const uint32_t count = static_cast<uint32_t>(machines.size());
+    const TelemetryColumns c = telemetryColumns(count);
+    chunk.assign(c.bytes, 0);
+    std::memcpy(chunk.data() + c.machine, machines.data(), count * sizeof(uint32_t));
+    std::memcpy(chunk.data() + c.play, plays.data(), count * sizeof(uint32_t));
+    std::memcpy(chunk.data() + c.time, times.data(), count * sizeof(float));
+    std::memcpy(chunk.data() + c.value, values.data(), count * sizeof(float));
+    std::memcpy(chunk.data() + c.type, types.data(), count);
+    std::memcpy(chunk.data() + c.flag, flags.data(), count);
+
+    TelemetryChunkHeader h{};
+    h.magic = kTelemetryChunkMagic;
+    h.count = count;
+    h.bytes = c.bytes;
+    std::fwrite(&h, sizeof(h), 1, file);
+    std::fwrite(chunk.data(), 1, chunk.size(), file);
+    std::fflush(file);
+    written += count;
+
+    machines.clear();
+    plays.clear();
+    times.clear();
+    values.clear();
+    types.clear();
+    flags.clear();
+}
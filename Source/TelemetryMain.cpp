@@ -0,0 +1,404 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Header/Machine.h"
+#include "../Header/Scheduler.h"
+#include "../Header/Telemetry.h"
+
+// Offline analytics over telemetry logs. Maps every file, splits the work by
+// chunk across a work-stealing pool and scans each chunk column by column,
+// so the bin arithmetic runs over whole columns apart from the scattered
+// counter increments (see scanChunk). Also writes logs, either from
+// headless self-playing machines or synthesized in bulk for load testing.
+
+namespace {
+constexpr int kTypes = static_cast<int>(PlayEventType::Count);
+constexpr int kBins = 40;
+
+struct BinRange {
+    float lo;
+    float hi;
+    const char* unit;
+};
+
+// Histogram range of each event type's value.
+const BinRange kRanges[kTypes] = {
+    { 0.0f, 1.0f, "" },       // unused
+    { 0.0f, 1.0f, "" },       // Start
+    { 0.0f, 10.0f, "s" },     // Drop: time to drop
+    { -0.6f, 0.6f, "x" },     // Grab: claw x
+    { -0.6f, 0.6f, "x" },     // Release: claw x
+    { 0.0f, 1.5f, "s" },      // Landing: fall time
+    { 0.0f, 5.0f, "s" },      // Collect: latency
+};
+
+struct Aggregate {
+    uint64_t events = 0;
+    std::array<uint64_t, kTypes> count{};
+    std::array<uint64_t, kTypes> flagged{};
+    std::array<double, kTypes> sum{};
+    std::array<std::array<uint64_t, kBins>, kTypes> bins{};
+
+    void merge(const Aggregate& o)
+    {
+        events += o.events;
+        for (int t = 0; t < kTypes; ++t) {
+            count[t] += o.count[t];
+            flagged[t] += o.flagged[t];
+            sum[t] += o.sum[t];
+            for (int b = 0; b < kBins; ++b) bins[t][b] += o.bins[t][b];
+        }
+    }
+};
+
+struct MappedLog {
+    std::string path;
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+    std::mutex cabinetMutex;
+    std::vector<uint64_t> plays;   // Indexed by machine id
+    std::vector<uint64_t> wins;
+};
+
+struct ChunkRef {
+    std::size_t file;
+    const uint8_t* columns;
+    uint32_t count;
+};
+
+// Per-chunk scratch, reused by whichever thread runs the chunk.
+struct Scratch {
+    std::vector<uint16_t> slot;    // type * kBins + bin for every event
+    std::vector<uint64_t> plays;
+    std::vector<uint64_t> wins;
+};
+
+void scanChunk(const ChunkRef& c, MappedLog& log, Aggregate& agg, Scratch& s)
+{
+    const TelemetryColumns cols = telemetryColumns(c.count);
+    const uint32_t* machine = reinterpret_cast<const uint32_t*>(c.columns + cols.machine);
+    const float* value = reinterpret_cast<const float*>(c.columns + cols.value);
+    const uint8_t* type = c.columns + cols.type;
+    const uint8_t* flag = c.columns + cols.flag;
+    const uint32_t n = c.count;
+
+    // Bin index of every event against its own type's range. At -O3 GCC
+    // vectorizes this loop four events wide, behind a runtime check that the
+    // slot column does not overlap the mapped log; the max over the machine
+    // column below vectorizes too. Then one scalar pass for the scattered
+    // increments, split over four copies so neighbouring events of the same
+    // type do not serialize on one counter. Per-type counts fall out of the
+    // histogram.
+    float lo[8] = {};
+    float scale[8] = {};
+    for (int t = 0; t < kTypes; ++t) {
+        lo[t] = kRanges[t].lo;
+        scale[t] = kBins / (kRanges[t].hi - kRanges[t].lo);
+    }
+    s.slot.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t t = type[i] & 7;
+        float f = (value[i] - lo[t]) * scale[t];
+        f = std::min(std::max(f, 0.0f), float(kBins - 1));
+        s.slot[i] = static_cast<uint16_t>(t * kBins + static_cast<int>(f));
+    }
+    static thread_local std::array<std::array<uint32_t, 8 * kBins>, 4> split;
+    static thread_local std::array<std::array<float, 8>, 4> sums;
+    static thread_local std::array<std::array<uint32_t, 8>, 4> flags;
+    for (int k = 0; k < 4; ++k) {
+        split[k].fill(0);
+        sums[k].fill(0.0f);
+        flags[k].fill(0);
+    }
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            uint32_t t = type[i + k] & 7;
+            split[k][s.slot[i + k]]++;
+            sums[k][t] += value[i + k];
+            flags[k][t] += flag[i + k];
+        }
+    }
+    for (; i < n; ++i) {
+        uint32_t t = type[i] & 7;
+        split[0][s.slot[i]]++;
+        sums[0][t] += value[i];
+        flags[0][t] += flag[i];
+    }
+    for (int t = 1; t < kTypes; ++t) {
+        for (int k = 0; k < 4; ++k) {
+            agg.sum[t] += sums[k][t];
+            agg.flagged[t] += flags[k][t];
+        }
+        for (int b = 0; b < kBins; ++b) {
+            int k = t * kBins + b;
+            uint64_t v = uint64_t(split[0][k]) + split[1][k] + split[2][k] + split[3][k];
+            agg.bins[t][b] += v;
+            agg.count[t] += v;
+        }
+    }
+    agg.events += n;
+
+    // Plays and wins per cabinet, for the win-rate distribution.
+    uint32_t maxMachine = 0;
+    for (uint32_t j = 0; j < n; ++j) maxMachine = std::max(maxMachine, machine[j]);
+    s.plays.assign(maxMachine + 1, 0);
+    s.wins.assign(maxMachine + 1, 0);
+    const uint8_t start = static_cast<uint8_t>(PlayEventType::Start);
+    const uint8_t landing = static_cast<uint8_t>(PlayEventType::Landing);
+    for (uint32_t j = 0; j < n; ++j) {
+        s.plays[machine[j]] += type[j] == start;
+        s.wins[machine[j]] += (type[j] == landing) & flag[j];
+    }
+    std::lock_guard<std::mutex> lock(log.cabinetMutex);
+    if (log.plays.size() < s.plays.size()) {
+        log.plays.resize(s.plays.size(), 0);
+        log.wins.resize(s.wins.size(), 0);
+    }
+    for (uint32_t m = 0; m <= maxMachine; ++m) {
+        log.plays[m] += s.plays[m];
+        log.wins[m] += s.wins[m];
+    }
+}
+
+bool mapLog(MappedLog& log, std::vector<ChunkRef>& chunks, std::size_t fileIndex)
+{
+    int fd = open(log.path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(TelemetryFileHeader)) {
+        close(fd);
+        return false;
+    }
+    log.size = std::size_t(st.st_size);
+    void* base = mmap(nullptr, log.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+    madvise(base, log.size, MADV_WILLNEED);
+    log.data = static_cast<const uint8_t*>(base);
+
+    TelemetryFileHeader h;
+    std::memcpy(&h, log.data, sizeof(h));
+    if (h.magic != kTelemetryMagic || h.version != kTelemetryVersion) return false;
+
+    // Only chunk headers are touched here; a truncated last chunk is ignored.
+    std::size_t offset = sizeof(TelemetryFileHeader);
+    while (offset + sizeof(TelemetryChunkHeader) <= log.size) {
+        TelemetryChunkHeader ch;
+        std::memcpy(&ch, log.data + offset, sizeof(ch));
+        if (ch.magic != kTelemetryChunkMagic || ch.bytes != telemetryColumns(ch.count).bytes) break;
+        std::size_t end = offset + sizeof(ch) + ch.bytes;
+        if (end > log.size) break;
+        chunks.push_back({ fileIndex, log.data + offset + sizeof(ch), ch.count });
+        offset = end;
+    }
+    return true;
+}
+
+void printHistogram(const Aggregate& agg, PlayEventType type, const char* title)
+{
+    const int t = static_cast<int>(type);
+    const BinRange& r = kRanges[t];
+    uint64_t peak = *std::max_element(agg.bins[t].begin(), agg.bins[t].end());
+    std::printf("\n%s (%llu events, mean %.3f%s)\n", title, static_cast<unsigned long long>(agg.count[t]),
+        agg.count[t] ? agg.sum[t] / agg.count[t] : 0.0, r.unit);
+    if (peak == 0) return;
+    const float width = (r.hi - r.lo) / kBins;
+    for (int b = 0; b < kBins; b += 2) {
+        uint64_t v = agg.bins[t][b] + agg.bins[t][b + 1];
+        int bar = static_cast<int>(50.0 * double(v) / double(peak * 2));
+        std::printf("  %7.2f%-1s %12llu %s\n", r.lo + b * width, r.unit, static_cast<unsigned long long>(v), std::string(bar, '#').c_str());
+    }
+}
+
+double rate(uint64_t part, uint64_t whole)
+{
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+}
+
+int aggregate(const std::vector<std::string>& paths, unsigned threads)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<MappedLog>> logs;
+    std::vector<ChunkRef> chunks;
+    for (const std::string& p : paths) {
+        logs.push_back(std::make_unique<MappedLog>());
+        logs.back()->path = p;
+        if (!mapLog(*logs.back(), chunks, logs.size() - 1)) std::cout << "Skipping unreadable log " << p << std::endl;
+    }
+    std::size_t bytes = 0;
+    for (const auto& l : logs) bytes += l->size;
+
+    WorkStealingPool pool(threads > 0 ? threads - 1 : 0);
+    std::mutex totalMutex;
+    Aggregate total;
+    pool.parallelFor(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        Aggregate local;
+        Scratch scratch;
+        for (std::size_t i = begin; i < end; ++i) scanChunk(chunks[i], *logs[chunks[i].file], local, scratch);
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total.merge(local);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Win rate per cabinet, bucketed in 5% steps.
+    std::array<uint64_t, 21> winBuckets{};
+    uint64_t cabinets = 0;
+    for (const auto& l : logs) {
+        for (std::size_t m = 0; m < l->plays.size(); ++m) {
+            if (l->plays[m] == 0) continue;
+            cabinets++;
+            winBuckets[std::min<std::size_t>(20, std::size_t(20.0 * double(l->wins[m]) / double(l->plays[m])))]++;
+        }
+    }
+
+    const auto& c = total.count;
+    const auto& f = total.flagged;
+    const uint64_t plays = c[int(PlayEventType::Start)];
+    const uint64_t wins = f[int(PlayEventType::Landing)];
+    std::printf("[TELEMETRY] %zu files, %zu chunks, %llu events, %.1f MB in %.3f s (%.0f M events/s, %u threads)\n",
+        logs.size(), chunks.size(), static_cast<unsigned long long>(total.events), bytes / (1024.0 * 1024.0), seconds,
+        total.events / seconds / 1e6, pool.workerCount() + 1);
+    std::printf("[TELEMETRY] %llu plays on %llu cabinets, %.2f drops per play\n",
+        static_cast<unsigned long long>(plays), static_cast<unsigned long long>(cabinets),
+        plays ? double(c[int(PlayEventType::Drop)]) / plays : 0.0);
+    std::printf("[TELEMETRY] grab success %.1f%%, releases into the hole %.1f%%, win rate %.1f%% of plays, %.1f%% of wins collected\n",
+        rate(f[int(PlayEventType::Grab)], c[int(PlayEventType::Grab)]),
+        rate(wins, c[int(PlayEventType::Landing)]), rate(wins, plays), rate(c[int(PlayEventType::Collect)], wins));
+
+    printHistogram(total, PlayEventType::Drop, "Time to drop");
+    printHistogram(total, PlayEventType::Grab, "Claw x at grab");
+    printHistogram(total, PlayEventType::Landing, "Fall time after release");
+    printHistogram(total, PlayEventType::Collect, "Collect latency");
+    std::printf("\nWin rate per cabinet\n");
+    for (int b = 0; b <= 20; ++b) {
+        if (winBuckets[b]) std::printf("  %3d%% %10llu\n", b * 5, static_cast<unsigned long long>(winBuckets[b]));
+    }
+
+    for (const auto& l : logs) {
+        if (l->data) munmap(const_cast<uint8_t*>(l->data), l->size);
+    }
+    return 0;
+}
+
+// Plays `machines` headless self-playing cabinets for `seconds` of game time
+// and logs their real events.
+int simulate(const std::string& path, int machines, float seconds)
+{
+    TelemetryLog log;
+    if (!log.open(path)) return -1;
+    std::vector<std::unique_ptr<Machine>> fleet;
+    std::vector<AttractPlayer> players(machines);
+    for (int i = 0; i < machines; ++i) {
+        fleet.push_back(std::make_unique<Machine>());
+        Machine& m = *fleet.back();
+        m.logEvents = false;
+        m.recordPlays = true;
+        initMachine(m, MachineTextures{ 1, 2, 3, 4 }, 1000 + i);
+        initAttract(players[i], 7000 + i);
+    }
+    const float step = 1.0f / 75.0f;
+    for (float t = 0.0f; t < seconds; t += step) {
+        for (int i = 0; i < machines; ++i) {
+            driveAttract(*fleet[i], players[i], step);
+            stepMachine(*fleet[i], step);
+            log.append(static_cast<uint32_t>(i + 1), fleet[i]->playEvents);
+        }
+    }
+    log.close();
+    std::printf("[TELEMETRY] %d machines x %.0f s: %llu events in %s\n", machines, seconds,
+        static_cast<unsigned long long>(log.eventsWritten()), path.c_str());
+    return 0;
+}
+
+// Writes `files` logs of `events` events each, shaped like real play, fast
+// enough to build a month of fleet data for load testing.
+int synthesize(const std::string& dir, int files, uint64_t events)
+{
+    for (int fi = 0; fi < files; ++fi) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/telemetry-%03d.bin", fi);
+        TelemetryLog log;
+        if (!log.open(dir + name)) return -1;
+        std::minstd_rand rng(12345 + fi);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const uint32_t cabinets = 200;
+        std::vector<uint32_t> playCount(cabinets + 1, 0);
+        float clock = 0.0f;
+        uint64_t written = 0;
+        while (written < events) {
+            uint32_t cab = 1 + rng() % cabinets;
+            uint32_t play = ++playCount[cab];
+            clock += unit(rng);
+            log.append(cab, { PlayEventType::Start, 0, play, clock, 0.0f });
+            bool won = false;
+            int drops = 1 + int(unit(rng) * 2.5f);
+            for (int d = 0; d < drops && !won; ++d) {
+                float x = unit(rng) * 1.0f - 0.5f;
+                log.append(cab, { PlayEventType::Drop, 0, play, clock, 1.0f + unit(rng) * unit(rng) * 8.0f });
+                bool caught = unit(rng) < 0.55f;
+                log.append(cab, { PlayEventType::Grab, uint8_t(caught), play, clock, x });
+                written += 2;
+                if (!caught) continue;
+                log.append(cab, { PlayEventType::Release, 0, play, clock, x + (unit(rng) - 0.5f) * 0.2f });
+                won = unit(rng) < 0.45f + 0.1f * (cab % 4);
+                log.append(cab, { PlayEventType::Landing, uint8_t(won), play, clock, 0.3f + unit(rng) * 0.6f });
+                written += 2;
+            }
+            if (won) {
+                log.append(cab, { PlayEventType::Collect, 0, play, clock, 0.4f + unit(rng) * unit(rng) * 4.0f });
+                written++;
+            }
+            written++;
+        }
+        log.close();
+    }
+    std::printf("[TELEMETRY] wrote %d files of ~%llu events to %s\n", files, static_cast<unsigned long long>(events), dir.c_str());
+    return 0;
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--simulate" && i + 3 < argc) {
+            std::string path = argv[i + 1];
+            int machines = std::max(1, std::atoi(argv[i + 2]));
+            float seconds = static_cast<float>(std::atof(argv[i + 3]));
+            return simulate(path, machines, seconds);
+        }
+        else if (arg == "--synth" && i + 3 < argc) {
+            return synthesize(argv[i + 1], std::max(1, std::atoi(argv[i + 2])), std::strtoull(argv[i + 3], nullptr, 10));
+        }
+        else if (!arg.empty() && arg[0] != '-') paths.push_back(arg);
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    if (paths.empty()) {
+        std::cout << "Usage: ClawTelemetry [--threads N] LOG...\n"
+                     "       ClawTelemetry --simulate LOG MACHINES SECONDS\n"
+                     "       ClawTelemetry --synth DIR FILES EVENTS_PER_FILE" << std::endl;
+        return -1;
+    }
+    return aggregate(paths, threads);
+}
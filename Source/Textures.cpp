@@ -0,0 +1,313 @@
+#include "../Header/Textures.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "../Header/PerfCounters.h"
+#include "../Header/Util.h"
+
+// ---------------------- Texture generation helpers ---------------------- //
+std::vector<unsigned char> makeCircleTexture(int size, const std::array<unsigned char, 4>& fill)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    Vec2 center = { size * 0.5f, size * 0.5f };
+    float radius = size * 0.48f;
+    float r2 = radius * radius;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float dx = x - center.x;
+            float dy = y - center.y;
+            if (dx * dx + dy * dy <= r2) {
+                int idx = (y * size + x) * 4;
+                data[idx + 0] = fill[0];
+                data[idx + 1] = fill[1];
+                data[idx + 2] = fill[2];
+                data[idx + 3] = fill[3];
+            }
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeRingTexture(int size, const std::array<unsigned char, 4>& inner, const std::array<unsigned char, 4>& outer)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    Vec2 c = { size * 0.5f, size * 0.5f };
+    float outerR = size * 0.48f;
+    float innerR = size * 0.26f;
+    float o2 = outerR * outerR;
+    float i2 = innerR * innerR;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float dx = x - c.x;
+            float dy = y - c.y;
+            float d2 = dx * dx + dy * dy;
+            int idx = (y * size + x) * 4;
+            if (d2 <= i2) {
+                data[idx + 0] = inner[0];
+                data[idx + 1] = inner[1];
+                data[idx + 2] = inner[2];
+                data[idx + 3] = inner[3];
+            }
+            else if (d2 <= o2) {
+                data[idx + 0] = outer[0];
+                data[idx + 1] = outer[1];
+                data[idx + 2] = outer[2];
+                data[idx + 3] = outer[3];
+            }
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeToyTextureDots(int size)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            int idx = (y * size + x) * 4;
+            data[idx + 0] = 190;
+            data[idx + 1] = 110;
+            data[idx + 2] = 200;
+            data[idx + 3] = 255;
+        }
+    }
+    for (int by = 0; by < size; by += 8) {
+        for (int bx = 0; bx < size; bx += 8) {
+            Vec2 center = { float(bx + 4), float(by + 4) };
+            for (int y = by; y < by + 8 && y < size; ++y) {
+                for (int x = bx; x < bx + 8 && x < size; ++x) {
+                    float dx = x - center.x;
+                    float dy = y - center.y;
+                    if (dx * dx + dy * dy < 10.5f) {
+                        int idx = (y * size + x) * 4;
+                        data[idx + 0] = 250;
+                        data[idx + 1] = 220;
+                        data[idx + 2] = 120;
+                        data[idx + 3] = 255;
+                    }
+                }
+            }
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeToyTextureStripes(int size)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            int idx = (y * size + x) * 4;
+            bool bright = ((x / 6) % 2) == 0;
+            data[idx + 0] = bright ? 90 : 60;
+            data[idx + 1] = bright ? 170 : 120;
+            data[idx + 2] = bright ? 230 : 180;
+            data[idx + 3] = 255;
+        }
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (((y / 6) % 2) == 0) {
+                int idx = (y * size + x) * 4;
+                data[idx + 0] = std::min<int>(255, data[idx + 0] + 30);
+                data[idx + 1] = std::min<int>(255, data[idx + 1] + 30);
+                data[idx + 2] = std::min<int>(255, data[idx + 2] + 10);
+            }
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeToyTextureChecks(int size)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    std::array<unsigned char, 4> c1 = { 70, 170, 220, 255 };
+    std::array<unsigned char, 4> c2 = { 35, 120, 180, 255 };
+    int block = 6;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            bool alt = ((x / block) + (y / block)) % 2 == 0;
+            const auto& c = alt ? c1 : c2;
+            int idx = (y * size + x) * 4;
+            data[idx + 0] = c[0];
+            data[idx + 1] = c[1];
+            data[idx + 2] = c[2];
+            data[idx + 3] = c[3];
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeCoinTexture(int size)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    Vec2 c{ size * 0.5f, size * 0.5f };
+    float r = size * 0.45f;
+    float r2 = r * r;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float dx = x - c.x;
+            float dy = y - c.y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 <= r2) {
+                float shade = 0.75f + 0.25f * (dy / r);
+                shade = std::clamp(shade, 0.6f, 1.0f);
+                int idx = (y * size + x) * 4;
+                data[idx + 0] = static_cast<unsigned char>(230 * shade);
+                data[idx + 1] = static_cast<unsigned char>(190 * shade);
+                data[idx + 2] = static_cast<unsigned char>(70 * shade);
+                data[idx + 3] = 255;
+            }
+        }
+    }
+    return data;
+}
+
+std::vector<unsigned char> makeLeverTexture(int size)
+{
+    std::vector<unsigned char> data(size * size * 4, 0);
+    auto setPix = [&](int x, int y, const std::array<unsigned char, 4>& c) {
+        if (x < 0 || x >= size || y < 0 || y >= size) return;
+        int idx = (y * size + x) * 4;
+        data[idx + 0] = c[0];
+        data[idx + 1] = c[1];
+        data[idx + 2] = c[2];
+        data[idx + 3] = c[3];
+    };
+    std::array<unsigned char, 4> body = { 200, 200, 210, 255 };
+    std::array<unsigned char, 4> grip = { 90, 120, 230, 255 };
+
+    for (int y = 4; y < size - 4; ++y) {
+        for (int x = 6; x < 14; ++x) {
+            setPix(x, y, body);
+        }
+    }
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 20; ++x) {
+            if (x + y < 16) setPix(x, y, grip);
+        }
+    }
+    return data;
+}
+
+std::unordered_map<char, std::array<uint8_t, 7>> fontGlyphs()
+{
+    return {
+        { 'A',{0b01110,0b10001,0b10001,0b11111,0b10001,0b10001,0b10001} },
+        { 'B',{0b11110,0b10001,0b11110,0b10001,0b10001,0b10001,0b11110} },
+        { 'C',{0b01110,0b10001,0b10000,0b10000,0b10000,0b10001,0b01110} },
+        { 'D',{0b11100,0b10010,0b10001,0b10001,0b10001,0b10010,0b11100} },
+        { 'E',{0b11111,0b10000,0b11100,0b10000,0b10000,0b10000,0b11111} },
+        { 'F',{0b11111,0b10000,0b11100,0b10000,0b10000,0b10000,0b10000} },
+        { 'G',{0b01110,0b10001,0b10000,0b10111,0b10001,0b10001,0b01110} },
+        { 'H',{0b10001,0b10001,0b10001,0b11111,0b10001,0b10001,0b10001} },
+        { 'I',{0b11111,0b00100,0b00100,0b00100,0b00100,0b00100,0b11111} },
+        { 'J',{0b00111,0b00010,0b00010,0b00010,0b10010,0b10010,0b01100} },
+        { 'K',{0b10001,0b10010,0b10100,0b11000,0b10100,0b10010,0b10001} },
+        { 'L',{0b10000,0b10000,0b10000,0b10000,0b10000,0b10000,0b11111} },
+        { 'M',{0b10001,0b11011,0b10101,0b10101,0b10001,0b10001,0b10001} },
+        { 'N',{0b10001,0b11001,0b10101,0b10101,0b10011,0b10001,0b10001} },
+        { 'O',{0b01110,0b10001,0b10001,0b10001,0b10001,0b10001,0b01110} },
+        { 'P',{0b11110,0b10001,0b11110,0b10000,0b10000,0b10000,0b10000} },
+        { 'Q',{0b01110,0b10001,0b10001,0b10001,0b10101,0b10010,0b01101} },
+        { 'R',{0b11110,0b10001,0b11110,0b10001,0b10001,0b10001,0b10001} },
+        { 'S',{0b01111,0b10000,0b10000,0b01110,0b00001,0b00001,0b11110} },
+        { 'T',{0b11111,0b00100,0b00100,0b00100,0b00100,0b00100,0b00100} },
+        { 'U',{0b10001,0b10001,0b10001,0b10001,0b10001,0b10001,0b01110} },
+        { 'V',{0b10001,0b10001,0b10001,0b10001,0b01010,0b01010,0b00100} },
+        { 'W',{0b10001,0b10001,0b10001,0b10101,0b10101,0b11011,0b10001} },
+        { 'X',{0b10001,0b01010,0b00100,0b00100,0b00100,0b01010,0b10001} },
+        { 'Y',{0b10001,0b10001,0b01010,0b00100,0b00100,0b00100,0b00100} },
+        { 'Z',{0b11111,0b00001,0b00010,0b00100,0b01000,0b10000,0b11111} },
+        { ' ',{0,0,0,0,0,0,0} },
+        { '/',{0b00001,0b00010,0b00100,0b01000,0b10000,0,0} },
+        { '0',{0b01110,0b10001,0b10011,0b10101,0b11001,0b10001,0b01110} },
+        { '1',{0b00100,0b01100,0b00100,0b00100,0b00100,0b00100,0b01110} },
+        { '2',{0b01110,0b10001,0b00001,0b00010,0b00100,0b01000,0b11111} },
+        { '3',{0b11110,0b00001,0b00001,0b01110,0b00001,0b00001,0b11110} },
+        { '4',{0b10010,0b10010,0b10010,0b11111,0b00010,0b00010,0b00010} },
+        { '5',{0b11111,0b10000,0b11110,0b00001,0b00001,0b10001,0b01110} },
+        { '6',{0b01110,0b10000,0b11110,0b10001,0b10001,0b10001,0b01110} },
+        { '7',{0b11111,0b00001,0b00010,0b00100,0b01000,0b01000,0b01000} },
+        { '8',{0b01110,0b10001,0b01110,0b10001,0b10001,0b10001,0b01110} },
+        { '9',{0b01110,0b10001,0b10001,0b01111,0b00001,0b00001,0b11110} },
+        { '-',{0b00000,0b00000,0b00000,0b11111,0b00000,0b00000,0b00000} },
+        { ':',{0b00000,0b00100,0b00100,0b00000,0b00100,0b00100,0b00000} },
+    };
+}
+
+std::vector<unsigned char> makeLabelTexture(int width, int height, const std::string& text)
+{
+    std::vector<unsigned char> data(width * height * 4, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int idx = (y * width + x) * 4;
+            data[idx + 0] = 20;
+            data[idx + 1] = 24;
+            data[idx + 2] = 32;
+            data[idx + 3] = 180;
+        }
+    }
+
+    auto glyphs = fontGlyphs();
+    int scale = 2;
+    int lineHeight = 7 * scale + 6;
+    int marginX = 16;
+    int cursorX = marginX;
+    int cursorY = 28;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+        if (c == '\n') {
+            cursorX = marginX;
+            cursorY += lineHeight;
+            continue;
+        }
+        if (glyphs.find(c) == glyphs.end()) continue;
+        const auto& rows = glyphs[c];
+        for (int row = 0; row < 7; ++row) {
+            for (int col = 0; col < 5; ++col) {
+                if (rows[row] & (1 << (4 - col))) {
+                    for (int sy = 0; sy < scale; ++sy) {
+                        for (int sx = 0; sx < scale; ++sx) {
+                            int px = cursorX + col * scale + sx;
+                            int py = cursorY + row * scale + sy;
+                            if (px >= 0 && px < width && py >= 0 && py < height) {
+                                int idx = (py * width + px) * 4;
+                                data[idx + 0] = 235;
+                                data[idx + 1] = 235;
+                                data[idx + 2] = 245;
+                                data[idx + 3] = 255;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        cursorX += 6 * scale;
+    }
+    return data;
+}
+
+// Generation and upload are separate regions so the pixel loops can be told
+// apart from the driver.
+MachineTextures createMachineTextures()
+{
+    static const int generateRegion = perfRegion("make toy/hole textures");
+    static const int uploadRegion = perfRegion("upload textures");
+    std::vector<unsigned char> dots, stripes, checks, ring;
+    {
+        PerfScope scope(generateRegion);
+        dots = makeToyTextureDots(64);
+        stripes = makeToyTextureStripes(64);
+        checks = makeToyTextureChecks(64);
+        ring = makeRingTexture(96, { 20,25,32,210 }, { 80,90,110,190 });
+    }
+    PerfScope scope(uploadRegion);
+    MachineTextures t;
+    t.toyA = createTextureFromRGBA(dots, 64, 64);
+    t.toyB = createTextureFromRGBA(stripes, 64, 64);
+    t.toyC = createTextureFromRGBA(checks, 64, 64);
+    t.hole = createTextureFromRGBA(ring, 96, 96);
+    return t;
+}
@@ -1,4 +1,5 @@
 #include "../Header/Util.h"
+#include "../Header/FlightRecorder.h"
 
 #define _CRT_SECURE_NO_WARNINGS
 #include <fstream>
@@ -6,7 +7,11 @@
 #include <iostream>
 #include <array>
 #include <filesystem>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <unistd.h>
+#endif
 #include <cstring>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -14,10 +19,28 @@
 
 int endProgram(const std::string& message) {
     std::cout << message << std::endl;
+    flightMessage(FlightMessage::Fatal, message.c_str());
     glfwTerminate();
     return -1;
 }
 
+static std::filesystem::path executableDir()
+{
+#ifdef _WIN32
+    char exePathBuf[MAX_PATH];
+    DWORD len = GetModuleFileNameA(nullptr, exePathBuf, MAX_PATH);
+    if (len > 0 && len < MAX_PATH) return std::filesystem::path(exePathBuf).parent_path();
+#else
+    char exePathBuf[4096];
+    ssize_t len = readlink("/proc/self/exe", exePathBuf, sizeof(exePathBuf) - 1);
+    if (len > 0) {
+        exePathBuf[len] = '\0';
+        return std::filesystem::path(exePathBuf).parent_path();
+    }
+#endif
+    return {};
+}
+
 // Try to resolve asset paths regardless of the working directory.
 static std::string resolveAssetPath(const std::string& relative)
 {
@@ -27,10 +50,8 @@ static std::string resolveAssetPath(const std::string& relative)
     if (fs::exists(candidate)) return candidate.string();
 
     // Then, look relative to the executable location and its parent (build/).
-    char exePathBuf[MAX_PATH];
-    DWORD len = GetModuleFileNameA(nullptr, exePathBuf, MAX_PATH);
-    if (len > 0 && len < MAX_PATH) {
-        fs::path exeDir = fs::path(exePathBuf).parent_path();
+    fs::path exeDir = executableDir();
+    if (!exeDir.empty()) {
         std::array<fs::path, 2> bases = { exeDir, exeDir.parent_path() };
         for (const auto& base : bases) {
             if (base.empty()) continue;
@@ -58,6 +79,7 @@ unsigned int compileShader(GLenum type, const char* source)
     else {
         ss << "";
         std::cout << "Failed to read shader file: \"" << resolvedPath << "\"\n";
+        flightMessage(FlightMessage::ShaderRead, source);
     }
     std::string temp = ss.str();
     const char* sourceCode = temp.c_str();
@@ -75,6 +97,7 @@ unsigned int compileShader(GLenum type, const char* source)
         glGetShaderInfoLog(shader, 512, NULL, infoLog);
         std::cout << (type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT") << " shader error:\n";
         std::cout << infoLog << std::endl;
+        flightMessage(FlightMessage::ShaderCompile, infoLog);
     }
     return shader;
 }
@@ -97,6 +120,7 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     {
         glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cout << "Program validation failed:\n" << infoLog << std::endl;
+        flightMessage(FlightMessage::ProgramValidate, infoLog);
     }
 
     glDetachShader(program, vertexShader);
@@ -107,6 +131,56 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     return program;
 }
 
+unsigned int createFeedbackShader(const char* vsSource, const std::vector<const char*>& varyings)
+{
+    unsigned int program = glCreateProgram();
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vsSource);
+
+    glAttachShader(program, vertexShader);
+    glTransformFeedbackVaryings(program, static_cast<GLsizei>(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(program);
+    glDetachShader(program, vertexShader);
+    glDeleteShader(vertexShader);
+
+    int success;
+    char infoLog[512];
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cout << "Feedback program link failed:\n" << infoLog << std::endl;
+        flightMessage(FlightMessage::ProgramValidate, infoLog);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+namespace {
+int64_t textureBytes = 0;
+uint64_t drawCallCount = 0;
+}
+
+void trackTextureMemory(int64_t bytes)
+{
+    textureBytes += bytes;
+}
+
+int64_t textureMemoryBytes()
+{
+    return textureBytes;
+}
+
+void countDrawCalls(uint64_t calls)
+{
+    drawCallCount += calls;
+}
+
+uint64_t drawCallsIssued()
+{
+    return drawCallCount;
+}
+
 unsigned loadImageToTexture(const char* filePath) {
     int TextureWidth;
     int TextureHeight;
@@ -133,11 +207,13 @@ unsigned loadImageToTexture(const char* filePath) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glBindTexture(GL_TEXTURE_2D, 0);
         stbi_image_free(ImageData);
+        trackTextureMemory(int64_t(TextureWidth) * TextureHeight * TextureChannels);
         return Texture;
     }
     else
     {
         std::cout << "Texture not loaded! Path: " << filePath << std::endl;
+        flightMessage(FlightMessage::TextureLoad, filePath);
         stbi_image_free(ImageData);
         return 0;
     }
@@ -159,6 +235,7 @@ unsigned int createTextureFromRGBA(const std::vector<unsigned char>& data, int w
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
+    trackTextureMemory(int64_t(width) * height * 4);
     return tex;
 }
 
@@ -185,7 +262,26 @@ GLFWcursor* loadImageToCursor(const char* filePath) {
     }
     else {
         std::cout << "Cursor image not loaded! Path: " << filePath << std::endl;
+        flightMessage(FlightMessage::CursorLoad, filePath);
         stbi_image_free(ImageData);
         return nullptr;
     }
 }
+
+// Names are handed out from 1 upwards and reused after deletion, so a leak
+// shows up as more live names within the range, whatever their values.
+GLObjectCounts countGLObjects(unsigned int maxName)
+{
+    GLObjectCounts c;
+    for (unsigned int name = 1; name <= maxName; ++name) {
+        c.textures += glIsTexture(name) ? 1 : 0;
+        c.buffers += glIsBuffer(name) ? 1 : 0;
+        c.vertexArrays += glIsVertexArray(name) ? 1 : 0;
+        c.framebuffers += glIsFramebuffer(name) ? 1 : 0;
+        c.renderbuffers += glIsRenderbuffer(name) ? 1 : 0;
+        c.programs += glIsProgram(name) ? 1 : 0;
+        c.shaders += glIsShader(name) ? 1 : 0;
+        c.queries += glIsQuery(name) ? 1 : 0;
+    }
+    return c;
+}
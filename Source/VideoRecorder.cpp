@@ -0,0 +1,294 @@
+#include "../Header/VideoRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "../Header/GLTrace.h"
+#include "../Header/Golden.h"
+
+VideoRecorder::~VideoRecorder()
+{
+    stop();
+}
+
+bool VideoRecorder::start(const VideoOptions& options, int w, int h)
+{
+    stop();
+    opts = options;
+    opts.scale = opts.scale >= 4 ? 4 : opts.scale >= 2 ? 2 : 1;
+    srcWidth = w;
+    srcHeight = h;
+    width = (w / opts.scale) & ~1;
+    height = (h / opts.scale) & ~1;
+    if (width <= 0 || height <= 0) return false;
+
+    const std::string& p = opts.path;
+    y4m = p.size() > 4 && p.compare(p.size() - 4, 4, ".y4m") == 0;
+    if (y4m) {
+        out = std::fopen(p.c_str(), "wb");
+        if (!out) {
+            std::cout << "[VIDEO] could not write " << p << std::endl;
+            return false;
+        }
+        std::fprintf(out, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, opts.fps);
+        yuv.resize(std::size_t(width) * height * 3 / 2);
+    }
+    else {
+        std::error_code ec;
+        std::filesystem::create_directories(p, ec);
+        if (ec) {
+            std::cout << "[VIDEO] could not create " << p << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+
+    const GLsizeiptr frameBytes = GLsizeiptr(width) * height * 4;
+    for (Slot& s : slots) {
+        s = Slot{};
+        glGenBuffers(1, &s.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (opts.scale > 1) {
+        glGenRenderbuffers(1, &downscaleRbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, downscaleRbo);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenFramebuffers(1, &downscaleFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, downscaleFbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, downscaleRbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    reading.clear();
+    queue.clear();
+    frameIndex = 0;
+    captured = written = dropped = bytes = captureCalls = 0;
+    captureMsTotal = captureMsMax = 0.0;
+    finishing = false;
+    encoder = std::thread(&VideoRecorder::encodeLoop, this);
+    active = true;
+    std::printf("[VIDEO] recording %dx%d to %s\n", width, height, p.c_str());
+    return true;
+}
+
+void VideoRecorder::capture()
+{
+    if (!active) return;
+    auto t0 = std::chrono::steady_clock::now();
+
+    releaseWritten();
+    // Map finished readbacks oldest first, so frames stay in order.
+    while (!reading.empty() && glClientWaitSync(static_cast<GLsync>(slots[reading.front()].fence), 0, 0) != GL_TIMEOUT_EXPIRED) {
+        collect(reading.front());
+        reading.pop_front();
+    }
+
+    int free = -1;
+    for (int i = 0; i < kRing && free < 0; ++i) {
+        if (slots[i].state == SlotState::Free) free = i;
+    }
+    if (free < 0) {
+        // Every buffer is waiting on the GPU or the encoder; skip this frame.
+        std::lock_guard<std::mutex> lock(mutex);
+        dropped++;
+    }
+    else {
+        Slot& s = slots[free];
+        if (downscaleFbo) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, downscaleFbo);
+            glBlitFramebuffer(0, 0, srcWidth, srcHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, downscaleFbo);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (downscaleFbo) glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s.state = SlotState::Reading;
+        reading.push_back(free);
+        captured++;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    captureMsTotal += ms;
+    captureMsMax = std::max(captureMsMax, ms);
+    captureCalls++;
+}
+
+// Unmaps the buffers the encoder is done with; GL calls stay on this thread.
+void VideoRecorder::releaseWritten()
+{
+    for (Slot& s : slots) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (s.state != SlotState::Written) continue;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        s.pixels = nullptr;
+        s.state = SlotState::Free;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// Maps a finished readback and queues it for the encoder, which reads the
+// mapped memory directly.
+void VideoRecorder::collect(int index)
+{
+    Slot& s = slots[index];
+    glDeleteSync(static_cast<GLsync>(s.fence));
+    s.fence = nullptr;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+    s.pixels = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(width) * height * 4, GL_MAP_READ_BIT));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!s.pixels) {
+        s.state = SlotState::Free;
+        dropped++;
+        return;
+    }
+    s.state = SlotState::Mapped;
+    queue.push_back(index);
+    wake.notify_one();
+}
+
+void VideoRecorder::stop()
+{
+    if (!active) return;
+    for (int index : reading) {
+        glClientWaitSync(static_cast<GLsync>(slots[index].fence), GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        collect(index);
+    }
+    reading.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishing = true;
+    }
+    wake.notify_one();
+    encoder.join();
+    releaseWritten();
+    active = false;
+
+    for (Slot& s : slots) {
+        glDeleteBuffers(1, &s.pbo);
+        s.pbo = 0;
+    }
+    if (downscaleFbo) {
+        glDeleteFramebuffers(1, &downscaleFbo);
+        glDeleteRenderbuffers(1, &downscaleRbo);
+        downscaleFbo = downscaleRbo = 0;
+    }
+    if (out) {
+        std::fclose(out);
+        out = nullptr;
+    }
+    VideoStats vs = stats();
+    std::printf("[VIDEO] %llu frames written, %llu dropped, %.1f MB; capture avg %.3f ms max %.3f ms on the render thread\n",
+        static_cast<unsigned long long>(vs.written), static_cast<unsigned long long>(vs.dropped), double(vs.bytes) / 1e6,
+        vs.avgCaptureMs, vs.maxCaptureMs);
+}
+
+VideoStats VideoRecorder::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    VideoStats s;
+    s.captured = captured;
+    s.written = written;
+    s.dropped = dropped;
+    s.bytes = bytes;
+    s.avgCaptureMs = captureCalls > 0 ? captureMsTotal / double(captureCalls) : 0.0;
+    s.maxCaptureMs = captureMsMax;
+    return s;
+}
+
+void VideoRecorder::encodeLoop()
+{
+    for (;;) {
+        int index;
+        const unsigned char* pixels;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return finishing || !queue.empty(); });
+            if (queue.empty()) return;
+            index = queue.front();
+            queue.pop_front();
+            pixels = slots[index].pixels;
+        }
+        bool ok = writeFrame(pixels);
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[index].state = SlotState::Written;
+        if (ok) written++;
+        else dropped++;
+    }
+}
+
+// Frames arrive bottom row first, as glReadPixels returns them.
+bool VideoRecorder::writeFrame(const unsigned char* rgba)
+{
+    const int w = width, h = height;
+    auto row = [&](int y) { return &rgba[std::size_t(h - 1 - y) * w * 4]; };
+    if (!y4m) {
+        Image image;
+        image.width = w;
+        image.height = h;
+        image.rgb.swap(rgb);
+        image.rgb.resize(std::size_t(w) * h * 3);
+        for (int y = 0; y < h; ++y) {
+            const unsigned char* src = row(y);
+            unsigned char* dst = &image.rgb[std::size_t(y) * w * 3];
+            for (int x = 0; x < w; ++x) {
+                dst[x * 3] = src[x * 4];
+                dst[x * 3 + 1] = src[x * 4 + 1];
+                dst[x * 3 + 2] = src[x * 4 + 2];
+            }
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame-%06llu.ppm", static_cast<unsigned long long>(frameIndex++));
+        const bool ok = writePPM((std::filesystem::path(opts.path) / name).string(), image);
+        image.rgb.swap(rgb);
+        if (!ok) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        bytes += rgb.size();
+        return true;
+    }
+
+    // Full range BT.601 in 8.8 fixed point; chroma averages each 2x2 block.
+    unsigned char* yPlane = yuv.data();
+    unsigned char* uPlane = yPlane + std::size_t(w) * h;
+    unsigned char* vPlane = uPlane + std::size_t(w / 2) * (h / 2);
+    for (int y = 0; y < h; y += 2) {
+        const unsigned char* r0 = row(y);
+        const unsigned char* r1 = row(y + 1);
+        unsigned char* y0 = yPlane + std::size_t(y) * w;
+        unsigned char* y1 = y0 + w;
+        for (int x = 0; x < w; x += 2) {
+            int rs = 0, gs = 0, bs = 0;
+            for (int k = 0; k < 4; ++k) {
+                const unsigned char* p = (k < 2 ? r0 : r1) + (x + (k & 1)) * 4;
+                const int r = p[0], g = p[1], b = p[2];
+                (k < 2 ? y0 : y1)[x + (k & 1)] = static_cast<unsigned char>((77 * r + 150 * g + 29 * b + 128) >> 8);
+                rs += r;
+                gs += g;
+                bs += b;
+            }
+            const int u = (-43 * rs - 85 * gs + 128 * bs + 512) / 1024 + 128;
+            const int v = (128 * rs - 107 * gs - 21 * bs + 512) / 1024 + 128;
+            const std::size_t c = std::size_t(y / 2) * (w / 2) + x / 2;
+            uPlane[c] = static_cast<unsigned char>(std::clamp(u, 0, 255));
+            vPlane[c] = static_cast<unsigned char>(std::clamp(v, 0, 255));
+        }
+    }
+    if (std::fwrite("FRAME\n", 1, 6, out) != 6 || std::fwrite(yuv.data(), 1, yuv.size(), out) != yuv.size()) return false;
+    frameIndex++;
+    std::lock_guard<std::mutex> lock(mutex);
+    bytes += yuv.size() + 6;
+    return true;
+}
@@ -0,0 +1,127 @@
+#include "../Header/GLTrace.h"   // Before GLFW, as GLEW must come before gl.h
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../Header/Machine.h"
+#include "../Header/Renderer.h"
+#include "../Header/Snapshot.h"
+#include "../Header/Spectator.h"
+#include "../Header/Textures.h"
+#include "../Header/Util.h"
+
+// Spectator viewer: mirrors a running cabinet from its stream. The machine
+// here is never stepped; each received snapshot is restored into it and drawn
+// with the game's renderer.
+
+struct ViewerOptions {
+    StreamEndpoint endpoint;
+    bool headless = false;   // Print state changes instead of opening a window
+};
+
+ViewerOptions parseArgs(int argc, char** argv)
+{
+    ViewerOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) opts.endpoint.socketPath = argv[++i];
+        else if (arg == "--tcp" && i + 1 < argc) opts.endpoint.tcpPort = std::atoi(argv[++i]);
+        else if (arg == "--headless") opts.headless = true;
+        else std::cout << "Ignoring unknown option: " << arg << std::endl;
+    }
+    return opts;
+}
+
+int runHeadless(SpectatorClient& client)
+{
+    GameState lastState = GameState::Idle;
+    bool first = true;
+    for (;;) {
+        int applied = client.poll();
+        if (applied < 0) break;
+        if (applied > 0) {
+            const MachineSnapshot& s = client.state();
+            GameState state = static_cast<GameState>(s.gameState);
+            if (first || state != lastState) {
+                std::cout << "[VIEWER] tick " << s.tick << " " << gameStateName(state)
+                    << " claw=(" << s.clawPosX << ", " << s.clawPosY << ") toys=" << int(s.toyCount) << std::endl;
+                lastState = state;
+                first = false;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::cout << "[VIEWER] stream closed after " << client.keyframes() << " keyframes, " << client.deltas() << " deltas" << std::endl;
+    return 0;
+}
+
+int runWindowed(SpectatorClient& client)
+{
+    if (!glfwInit()) return endProgram("GLFW init failed.");
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    const int width = 960;
+    const int height = 720;
+    GLFWwindow* window = glfwCreateWindow(width, height, "CLAW MACHINE - SPECTATOR", NULL, NULL);
+    if (!window) return endProgram("Window creation failed.");
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) return endProgram("GLEW init failed.");
+    if (!initRenderer()) return endProgram("Renderer init failed.");
+
+    glViewport(0, 0, width, height);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    std::unique_ptr<Machine> mirror = std::make_unique<Machine>();
+    mirror->logEvents = false;
+    initMachine(*mirror, createMachineTextures(), 0);
+
+    bool connected = true;
+    while (!glfwWindowShouldClose(window)) {
+        if (connected) {
+            int applied = client.poll();
+            if (applied < 0) {
+                connected = false;
+                glfwSetWindowTitle(window, "CLAW MACHINE - SPECTATOR - stream closed");
+            }
+            else if (applied > 0) {
+                restoreSnapshot(*mirror, client.state());
+                char title[96];
+                std::snprintf(title, sizeof(title), "CLAW MACHINE - SPECTATOR - tick %u - %s",
+                    client.state().tick, gameStateName(mirror->gameState));
+                glfwSetWindowTitle(window, title);
+            }
+        }
+
+        glClearColor(0.05f, 0.06f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        if (client.hasState()) renderSystem(mirror->registry, mirror->clock);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    ViewerOptions opts = parseArgs(argc, argv);
+    SpectatorClient client;
+    if (!client.connect(opts.endpoint)) {
+        std::cout << "Could not connect to the cabinet stream." << std::endl;
+        return -1;
+    }
+    return opts.headless ? runHeadless(client) : runWindowed(client);
+}